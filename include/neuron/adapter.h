@@ -35,6 +35,8 @@ extern "C" {
 typedef struct neu_adapter_driver neu_adapter_driver_t;
 typedef struct neu_adapter_app    neu_adapter_app_t;
 
+struct neu_plugin_group;
+
 typedef int (*neu_adapter_update_metric_cb_t)(neu_adapter_t *adapter,
                                               const char *   metric_name,
                                               uint64_t n, const char *group);
@@ -105,6 +107,19 @@ typedef struct adapter_callbacks {
                                       uint16_t n_bytes, bool more);
             void (*fdown_open_response)(neu_adapter_t *adapter, void *req,
                                         int error);
+            // update n tags of a group at once, tags must not be NULL
+            void (*update_many)(neu_adapter_t *adapter, const char *group,
+                                const neu_tag_update_t *items, int n);
+            // end of a read that group_timer or group_sync left running, see
+            // NEU_PLUGIN_GROUP_READ_PENDING
+            void (*group_read_end)(neu_adapter_t *          adapter,
+                                   struct neu_plugin_group *group);
+            // metrics of a group that only some plugins report
+            int (*register_group_metric)(neu_adapter_t *adapter,
+                                         const char *group, const char *name,
+                                         const char *      help,
+                                         neu_metric_type_e type,
+                                         uint64_t          init);
         } driver;
     };
 } adapter_callbacks_t;
@@ -60,6 +60,8 @@
 #define NEU_TAG_META_SIZE 32
 #define NEU_TAG_FORMAT_LENGTH 16
 #define NEU_TAG_UNIT_LENGTH 16
+// samples kept per tag by the driver cache at most
+#define NEU_TAG_WINDOW_DEPTH_MAX 10000
 
 #define NEU_LOG_LEVEL_DEBUG "debug"
 #define NEU_LOG_LEVEL_INFO "info"
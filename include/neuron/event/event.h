@@ -57,6 +57,9 @@ typedef struct neu_event_timer_param {
     // timer trigger period
     int64_t second;
     int64_t millisecond;
+    // milliseconds before the first fire, one period if 0, the kqueue loop
+    // always waits one period
+    int64_t delay;
     // Parameters passed to callback when timer fires
     void *usr_data;
     // Callback function that fires every time the timer fires
@@ -77,12 +80,33 @@ neu_event_timer_t *neu_event_add_timer(neu_events_t *          events,
 /**
  * @brief Remove timer from event.
  *
+ * If the callback of the timer is running on the event loop, this blocks
+ * until it returns, so the callback never runs once the call returned. The
+ * caller must not hold a lock the callback takes, or both wait for each
+ * other. From within the callback itself, on the loop thread, the timer is
+ * released once the callback returned and the call does not block.
+ *
  * @param[in] events
  * @param[in] timer
  * @return 0 on success.
  */
 int neu_event_del_timer(neu_events_t *events, neu_event_timer_t *timer);
 
+/**
+ * @brief Fire a periodic timer as soon as possible.
+ *
+ * The callback runs once on the event loop without waiting for the rest of
+ * the period, the following periods are counted from that fire. Posted
+ * while the callback is running, it runs again right after it returned.
+ * Posting a timer already due does nothing.
+ *
+ * @param[in] events
+ * @param[in] timer
+ * @return 0 on success, -1 if the loop can not bring a fire forward, the
+ * kqueue loop can not.
+ */
+int neu_event_post_timer(neu_events_t *events, neu_event_timer_t *timer);
+
 enum neu_event_io_type {
     NEU_EVENT_IO_READ   = 0x1,
     NEU_EVENT_IO_CLOSED = 0x2,
@@ -0,0 +1,118 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef NEURON_EVENT_SCHED_H
+#define NEURON_EVENT_SCHED_H
+
+#include <stdint.h>
+
+#include "event/event.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Shared worker pool that runs timer driven work of many nodes on a fixed
+ * number of threads.
+ *
+ * Work is submitted to a strand. Tasks of one strand never run concurrently
+ * and run in submission order, so state owned by a strand stays single
+ * threaded. Each worker keeps a deque of runnable strands and steals from the
+ * other workers when its own deque is empty.
+ *
+ * Only the group read, report and write timers of drivers run on the pool.
+ * The pool has no io, so every node keeps the event loop thread of its
+ * adapter for its control and trans data sockets, and plugins may start
+ * loops of their own. The number of threads still grows with the number of
+ * nodes, those threads are idle outside of control traffic.
+ */
+typedef struct neu_sched        neu_sched_t;
+typedef struct neu_sched_strand neu_sched_strand_t;
+typedef struct neu_sched_task   neu_sched_task_t;
+
+/**
+ * @brief Create a scheduler.
+ *
+ * @param[in] name log category of the scheduler.
+ * @param[in] n_worker number of workers, the number of online cores if <= 0.
+ * @return the newly created scheduler.
+ */
+neu_sched_t *neu_sched_new(const char *name, int n_worker);
+
+/**
+ * @brief Stop the workers and release the scheduler.
+ *
+ * All strands must be released before.
+ */
+void neu_sched_close(neu_sched_t *sched);
+
+int neu_sched_worker_num(neu_sched_t *sched);
+
+neu_sched_strand_t *neu_sched_strand_new(neu_sched_t *sched);
+
+/**
+ * @brief Release a strand, all tasks of the strand must be deleted before.
+ */
+void neu_sched_strand_free(neu_sched_t *sched, neu_sched_strand_t *strand);
+
+/**
+ * @brief Add a periodic task to a strand.
+ *
+ * Every time the timer fires the task is queued on the strand. A tick is
+ * skipped while the previous run of the task is still queued or running, so
+ * NEU_EVENT_TIMER_BLOCK and NEU_EVENT_TIMER_NOBLOCK tasks never overlap with
+ * themselves.
+ *
+ * @return the added task.
+ */
+neu_sched_task_t *neu_sched_add_timer(neu_sched_t *           sched,
+                                      neu_sched_strand_t *    strand,
+                                      neu_event_timer_param_t timer);
+
+/**
+ * @brief Add a task to a strand that only runs when posted.
+ *
+ * @return the added task.
+ */
+neu_sched_task_t *neu_sched_add_task(neu_sched_t *            sched,
+                                     neu_sched_strand_t *     strand,
+                                     neu_event_timer_callback cb,
+                                     void *                   usr_data);
+
+/**
+ * @brief Queue a task on its strand, nothing is done if the task is already
+ * queued.
+ */
+void neu_sched_post(neu_sched_task_t *task);
+
+/**
+ * @brief Delete a task added by neu_sched_add_timer or neu_sched_add_task.
+ *
+ * Waits for a running callback of the task unless called from that callback.
+ *
+ * @return 0 on success.
+ */
+int neu_sched_del_task(neu_sched_t *sched, neu_sched_task_t *task);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -54,6 +54,7 @@ typedef struct {
     int                  n_meta;
     neu_json_tag_meta_t *metas;
     neu_datatag_t        datatag;
+    neu_tag_history_t *  history;
 } neu_json_read_resp_tag_t;
 
 typedef struct {
@@ -158,6 +159,10 @@ typedef struct {
     bool   sync;
     int    n_tags;
     char **tags;
+
+    // the samples kept by the windows of the tags, see neu_tag_window_t
+    bool                    history;
+    neu_tag_history_query_t history_query;
 } neu_json_read_req_t;
 
 int  neu_json_decode_read_req(char *buf, neu_json_read_req_t **result);
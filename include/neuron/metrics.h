@@ -30,6 +30,7 @@ extern "C" {
 
 #include "define.h"
 #include "type.h"
+#include "utils/mem_pool.h"
 #include "utils/rolling_counter.h"
 #include "utils/utextend.h"
 #include "utils/uthash.h"
@@ -76,6 +77,23 @@ typedef enum {
 #define NEU_METRIC_RECV_BYTES_TYPE NEU_METRIC_TYPE_COUNTER_SET
 #define NEU_METRIC_RECV_BYTES_HELP "Total number of bytes received"
 
+// percent of time a shared serial line was busy since the last sample
+#define NEU_METRIC_BUS_UTILIZATION "bus_utilization_percent"
+#define NEU_METRIC_BUS_UTILIZATION_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_BUS_UTILIZATION_HELP \
+    "Percent of time the shared serial line was busy"
+
+// milliseconds the last request waited for its turn on a shared serial line
+#define NEU_METRIC_BUS_LAST_WAIT_MS "bus_last_wait_ms"
+#define NEU_METRIC_BUS_LAST_WAIT_MS_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_BUS_LAST_WAIT_MS_HELP \
+    "Time in milliseconds the last request waited for the serial line"
+
+// number of nodes sharing a serial line
+#define NEU_METRIC_BUS_NODES "bus_nodes"
+#define NEU_METRIC_BUS_NODES_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_BUS_NODES_HELP "Number of nodes sharing the serial line"
+
 // maintained by neuron core
 // number of tag read including errors
 #define NEU_METRIC_TAG_READS_TOTAL "tag_reads_total"
@@ -109,6 +127,12 @@ typedef enum {
 #define NEU_METRIC_GROUP_LAST_SEND_MSGS_HELP \
     "Number of messages sent on last group timer invocation"
 
+// number of bytes read in last group timer only to bridge gaps between tags
+#define NEU_METRIC_GROUP_LAST_GAP_BYTES "group_last_gap_bytes"
+#define NEU_METRIC_GROUP_LAST_GAP_BYTES_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_GROUP_LAST_GAP_BYTES_HELP \
+    "Number of bytes read on last group timer invocation to bridge tag gaps"
+
 // maintained by neuron core
 // milliseconds consumed in last group timer invocation
 #define NEU_METRIC_GROUP_LAST_TIMER_MS "group_last_timer_ms"
@@ -130,6 +154,63 @@ typedef enum {
 #define NEU_METRIC_GROUP_LAST_ERROR_TS_HELP \
     "Timestamp (ms) of the last encountered error in group data acquisition"
 
+// maintained by neuron core
+// number of read cycles that took longer than the group interval
+#define NEU_METRIC_GROUP_LATE_CYCLES_TOTAL "group_late_cycles_total"
+#define NEU_METRIC_GROUP_LATE_CYCLES_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_LATE_CYCLES_TOTAL_HELP \
+    "Total number of read cycles exceeding the group interval"
+
+// maintained by neuron core
+// number of read cycles missed because the previous ones overran
+#define NEU_METRIC_GROUP_SKIPPED_CYCLES_TOTAL "group_skipped_cycles_total"
+#define NEU_METRIC_GROUP_SKIPPED_CYCLES_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_SKIPPED_CYCLES_TOTAL_HELP \
+    "Total number of read cycles missed due to overruns"
+
+// maintained by neuron core
+// interval the group is read at, bigger than the group interval on back-off
+#define NEU_METRIC_GROUP_EFFECTIVE_INTERVAL_MS "group_effective_interval_ms"
+#define NEU_METRIC_GROUP_EFFECTIVE_INTERVAL_MS_TYPE \
+    (NEU_METRIC_TYPE_GAUAGE | NEU_METRIC_TYPE_FLAG_NO_RESET)
+#define NEU_METRIC_GROUP_EFFECTIVE_INTERVAL_MS_HELP \
+    "Interval in milliseconds the group is actually read at"
+
+// maintained by neuron core
+// histogram of the deviation between two read cycles and the interval, one
+// counter per bucket
+#define NEU_METRIC_GROUP_JITTER_LE_5MS "group_jitter_le_5ms_total"
+#define NEU_METRIC_GROUP_JITTER_LE_5MS_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_JITTER_LE_5MS_HELP \
+    "Number of read cycles started within 5ms of their deadline"
+#define NEU_METRIC_GROUP_JITTER_LE_20MS "group_jitter_le_20ms_total"
+#define NEU_METRIC_GROUP_JITTER_LE_20MS_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_JITTER_LE_20MS_HELP \
+    "Number of read cycles started 5ms to 20ms off their deadline"
+#define NEU_METRIC_GROUP_JITTER_LE_100MS "group_jitter_le_100ms_total"
+#define NEU_METRIC_GROUP_JITTER_LE_100MS_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_JITTER_LE_100MS_HELP \
+    "Number of read cycles started 20ms to 100ms off their deadline"
+#define NEU_METRIC_GROUP_JITTER_LE_500MS "group_jitter_le_500ms_total"
+#define NEU_METRIC_GROUP_JITTER_LE_500MS_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_JITTER_LE_500MS_HELP \
+    "Number of read cycles started 100ms to 500ms off their deadline"
+#define NEU_METRIC_GROUP_JITTER_GT_500MS "group_jitter_gt_500ms_total"
+#define NEU_METRIC_GROUP_JITTER_GT_500MS_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_JITTER_GT_500MS_HELP \
+    "Number of read cycles started more than 500ms off their deadline"
+
+// maintained by neuron core
+// changes of deadband filtered tags reported and held back
+#define NEU_METRIC_GROUP_FORWARDED_VALUES_TOTAL "group_forwarded_values_total"
+#define NEU_METRIC_GROUP_FORWARDED_VALUES_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_FORWARDED_VALUES_TOTAL_HELP \
+    "Total number of deadband filtered values reported"
+#define NEU_METRIC_GROUP_SUPPRESSED_VALUES_TOTAL "group_suppressed_values_total"
+#define NEU_METRIC_GROUP_SUPPRESSED_VALUES_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_GROUP_SUPPRESSED_VALUES_TOTAL_HELP \
+    "Total number of value changes held back by a deadband"
+
 // number of messages sent
 #define NEU_METRIC_SEND_MSGS_TOTAL "send_msgs_total"
 #define NEU_METRIC_SEND_MSGS_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
@@ -248,6 +329,30 @@ typedef enum {
 #define NEU_METRIC_CACHE_DROPPED_MSGS_TOTAL_HELP \
     "Total number of messages dropped due to cache queue being full"
 
+// current number of messages in the app message queue
+#define NEU_METRIC_MSG_QUEUE_DEPTH "msg_queue_depth"
+#define NEU_METRIC_MSG_QUEUE_DEPTH_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_MSG_QUEUE_DEPTH_HELP \
+    "Current number of messages in the app message queue"
+
+// queueing latency of the last message taken from the app message queue
+#define NEU_METRIC_MSG_QUEUE_LATENCY_MS "msg_queue_latency_ms"
+#define NEU_METRIC_MSG_QUEUE_LATENCY_MS_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_MSG_QUEUE_LATENCY_MS_HELP \
+    "Queueing latency of the last message in milliseconds"
+
+// max queueing latency since the last update
+#define NEU_METRIC_MSG_QUEUE_MAX_LATENCY_MS "msg_queue_max_latency_ms"
+#define NEU_METRIC_MSG_QUEUE_MAX_LATENCY_MS_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_MSG_QUEUE_MAX_LATENCY_MS_HELP \
+    "Max queueing latency since the last update in milliseconds"
+
+// total number of messages dropped by the app message queue overflow policy
+#define NEU_METRIC_MSG_QUEUE_DROPPED_TOTAL "msg_queue_dropped_msgs_total"
+#define NEU_METRIC_MSG_QUEUE_DROPPED_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_MSG_QUEUE_DROPPED_TOTAL_HELP \
+    "Total number of messages dropped due to app message queue being full"
+
 typedef enum {
     NEU_METRICS_CATEGORY_GLOBAL,
     NEU_METRICS_CATEGORY_DRIVER,
@@ -285,31 +390,32 @@ typedef struct {
 } neu_node_metrics_t;
 
 typedef struct {
-    char                distro[32];
-    char                kernel[80];
-    char                machine[80];
-    char                clib[32];
-    char                clib_version[32];
-    unsigned            cpu_percent;
-    unsigned            cpu_cores;
-    size_t              mem_total_bytes;
-    size_t              mem_used_bytes;
-    size_t              mem_cache_bytes;
-    size_t              disk_size_gibibytes;
-    size_t              disk_used_gibibytes;
-    size_t              disk_avail_gibibytes;
-    bool                core_dumped;
-    uint64_t            license_max_tags;
-    uint64_t            license_used_tags;
-    uint64_t            uptime_seconds;
-    size_t              north_nodes;
-    size_t              north_running_nodes;
-    size_t              north_disconnected_nodes;
-    size_t              south_nodes;
-    size_t              south_running_nodes;
-    size_t              south_disconnected_nodes;
-    neu_node_metrics_t *node_metrics;
-    neu_metric_entry_t *registered_metrics;
+    char                 distro[32];
+    char                 kernel[80];
+    char                 machine[80];
+    char                 clib[32];
+    char                 clib_version[32];
+    unsigned             cpu_percent;
+    unsigned             cpu_cores;
+    size_t               mem_total_bytes;
+    size_t               mem_used_bytes;
+    size_t               mem_cache_bytes;
+    size_t               disk_size_gibibytes;
+    size_t               disk_used_gibibytes;
+    size_t               disk_avail_gibibytes;
+    bool                 core_dumped;
+    uint64_t             license_max_tags;
+    uint64_t             license_used_tags;
+    uint64_t             uptime_seconds;
+    size_t               north_nodes;
+    size_t               north_running_nodes;
+    size_t               north_disconnected_nodes;
+    size_t               south_nodes;
+    size_t               south_running_nodes;
+    size_t               south_disconnected_nodes;
+    neu_mem_pool_stats_t mem_pools[NEU_MEM_POOL_MAX];
+    neu_node_metrics_t * node_metrics;
+    neu_metric_entry_t * registered_metrics;
 } neu_metrics_t;
 
 void neu_metrics_init();
@@ -33,6 +33,7 @@ extern "C" {
 #include "errcodes.h"
 #include "tag.h"
 #include "type.h"
+#include "utils/mem_pool.h"
 #include <math.h>
 
 typedef struct {
@@ -584,6 +585,9 @@ typedef struct {
     char     driver[NEU_NODE_NAME_LEN];
     char     group[NEU_GROUP_NAME_LEN];
     uint32_t interval;
+    // milliseconds per report of the min, max, mean, sum, count, first, last
+    // and stddev of the values read meanwhile, 0 reports the values as read
+    uint32_t aggregate;
 } neu_req_add_group_t;
 
 typedef struct {
@@ -591,6 +595,8 @@ typedef struct {
     char     group[NEU_GROUP_NAME_LEN];
     char     new_name[NEU_GROUP_NAME_LEN];
     uint32_t interval;
+    bool     set_aggregate;
+    uint32_t aggregate;
 } neu_req_update_group_t;
 
 typedef struct {
@@ -618,6 +624,7 @@ typedef struct neu_resp_group_info {
     char     name[NEU_GROUP_NAME_LEN];
     uint16_t tag_count;
     uint32_t interval;
+    uint32_t aggregate;
 } neu_resp_group_info_t;
 
 typedef struct neu_resp_get_group {
@@ -981,6 +988,10 @@ typedef struct neu_req_read_group {
     bool     sync;
     uint16_t n_tag;
     char **  tags;
+
+    // also answer the samples kept by the windows of the tags
+    bool                    history;
+    neu_tag_history_query_t history_query;
 } neu_req_read_group_t;
 
 static inline void neu_req_read_group_fini(neu_req_read_group_t *req)
@@ -1039,11 +1050,12 @@ typedef struct neu_resp_tag_value {
 typedef neu_resp_tag_value_t neu_tag_value_t;
 
 typedef struct neu_resp_tag_value_meta {
-    char            tag[NEU_TAG_NAME_LEN];
-    neu_dvalue_t    value;
-    neu_tag_meta_t *metas;
-    int             n_meta;
-    neu_datatag_t   datatag;
+    char               tag[NEU_TAG_NAME_LEN];
+    neu_dvalue_t       value;
+    neu_tag_meta_t *   metas;
+    int                n_meta;
+    neu_datatag_t      datatag;
+    neu_tag_history_t *history;
 } neu_resp_tag_value_meta_t;
 
 static inline UT_icd *neu_resp_tag_value_meta_icd()
@@ -1163,6 +1175,11 @@ static inline void neu_resp_read_free(neu_resp_read_group_t *resp)
             }
             free(tag_value->metas);
         }
+
+        if (tag_value->history != NULL) {
+            free(tag_value->history->samples);
+            free(tag_value->history);
+        }
     }
     free(resp->driver);
     free(resp->group);
@@ -1200,9 +1217,93 @@ neu_resp_read_paginate_free(neu_resp_read_group_paginate_t *resp)
     utarray_free(resp->tags);
 }
 
-typedef struct {
-    uint16_t        index;
-    pthread_mutex_t mtx;
+/*
+ * Interned tag names shared by group snapshots. A table is built once for
+ * the readable tags of a group and is referenced by every snapshot built
+ * from that tag set, so tag names are not copied on each report cycle.
+ */
+typedef struct neu_tag_names neu_tag_names_t;
+
+neu_tag_names_t *neu_tag_names_new(UT_array *tags);
+neu_tag_names_t *neu_tag_names_ref(neu_tag_names_t *names);
+void             neu_tag_names_unref(neu_tag_names_t *names);
+uint32_t         neu_tag_names_size(const neu_tag_names_t *names);
+const char *     neu_tag_names_name(const neu_tag_names_t *names, uint32_t id);
+double           neu_tag_names_bias(const neu_tag_names_t *names, uint32_t id);
+
+/*
+ * Compact tag value, 16 bytes instead of the 256-byte neu_value_u. Strings
+ * and bytes live in the snapshot arena, arrays and pointers are owned by the
+ * snapshot.
+ */
+typedef union {
+    bool                     boolean;
+    int8_t                   i8;
+    uint8_t                  u8;
+    int16_t                  i16;
+    uint16_t                 u16;
+    int32_t                  i32;
+    uint32_t                 u32;
+    int64_t                  i64;
+    uint64_t                 u64;
+    float                    f32;
+    double                   d64;
+    char *                   str;
+    neu_value_array_uint8_t  bytes;
+    neu_value_ptr_t          ptr;
+    json_t *                 json;
+    neu_value_array_int8_t   i8s;
+    neu_value_array_uint8_t  u8s;
+    neu_value_array_int16_t  i16s;
+    neu_value_array_uint16_t u16s;
+    neu_value_array_int32_t  i32s;
+    neu_value_array_uint32_t u32s;
+    neu_value_array_int64_t  i64s;
+    neu_value_array_uint64_t u64s;
+    neu_value_array_float_t  f32s;
+    neu_value_array_double_t f64s;
+    neu_value_array_bool_t   bools;
+    neu_value_array_string_t strs;
+} neu_snapshot_value_u;
+
+/*
+ * Immutable, columnar snapshot of one group report. It is built once per
+ * cycle by the driver, shared by all subscribed apps and freed together with
+ * the last reference of the trans data ctx.
+ */
+typedef struct neu_group_snapshot neu_group_snapshot_t;
+
+// takes a reference on names, which holds at most as many tags
+neu_group_snapshot_t *neu_group_snapshot_new(neu_tag_names_t *names);
+/*
+ * Append the value of tag `id`. Heap memory held by `value` and `metas` is
+ * moved into the snapshot, the caller must not free it.
+ */
+void neu_group_snapshot_push(neu_group_snapshot_t *snap, uint32_t id,
+                             neu_dvalue_t *value, neu_tag_meta_t *metas,
+                             int n_meta);
+// resolve strings and bytes once all values have been pushed
+void neu_group_snapshot_seal(neu_group_snapshot_t *snap);
+void neu_group_snapshot_free(neu_group_snapshot_t *snap);
+
+uint32_t neu_group_snapshot_size(const neu_group_snapshot_t *snap);
+
+// the tag, type and value of the i-th pushed value
+const char *neu_group_snapshot_tag(const neu_group_snapshot_t *snap,
+                                   uint32_t                    i);
+double      neu_group_snapshot_bias(const neu_group_snapshot_t *snap,
+                                    uint32_t                    i);
+neu_type_e  neu_group_snapshot_type(const neu_group_snapshot_t *snap,
+                                    uint32_t                    i);
+uint8_t     neu_group_snapshot_precision(const neu_group_snapshot_t *snap,
+                                         uint32_t                    i);
+const neu_snapshot_value_u *
+neu_group_snapshot_value(const neu_group_snapshot_t *snap, uint32_t i);
+neu_tag_meta_t *neu_group_snapshot_metas(const neu_group_snapshot_t *snap,
+                                         uint32_t i, int *n_meta);
+
+typedef struct {
+    uint16_t index; // apps still holding the data, updated atomically
 } neu_reqresp_trans_data_ctx_t;
 
 typedef struct {
@@ -1211,7 +1312,7 @@ typedef struct {
     void *trace_ctx;
 
     neu_reqresp_trans_data_ctx_t *ctx;
-    UT_array *                    tags; // neu_resp_tag_value_meta_t
+    neu_group_snapshot_t *        snapshot;
 } neu_reqresp_trans_data_t;
 
 typedef struct {
@@ -1253,46 +1354,36 @@ static inline void neu_req_driver_array_fini(neu_req_driver_array_t *req)
     free(req->drivers);
 }
 
-static inline void neu_trans_data_free(neu_reqresp_trans_data_t *data)
+static inline neu_reqresp_trans_data_ctx_t *
+neu_trans_data_ctx_new(uint16_t index)
 {
-    pthread_mutex_lock(&data->ctx->mtx);
-    if (data->ctx->index > 0) {
-        data->ctx->index -= 1;
-    }
+    neu_reqresp_trans_data_ctx_t *ctx =
+        (neu_reqresp_trans_data_ctx_t *) neu_mem_pool_alloc(
+            NEU_MEM_POOL_TRANS_CTX, sizeof(neu_reqresp_trans_data_ctx_t));
+    ctx->index = index;
+    return ctx;
+}
 
-    if (data->ctx->index == 0) {
-        utarray_foreach(data->tags, neu_resp_tag_value_meta_t *, tag_value)
-        {
-            if (tag_value->value.type == NEU_TYPE_PTR) {
-                free(tag_value->value.value.ptr.ptr);
-            } else if (tag_value->value.type == NEU_TYPE_ARRAY_STRING) {
-                for (size_t i = 0; i < tag_value->value.value.strs.length;
-                     ++i) {
-                    free(tag_value->value.value.strs.strs[i]);
-                }
-                free(tag_value->value.value.strs.strs);
-            } else if (NEU_TYPE_ARRAY_CHAR < tag_value->value.type &&
-                       tag_value->value.type < NEU_TYPE_ARRAY_STRING) {
-                free(tag_value->value.value.bools.bools);
-            } else if (NEU_TYPE_CUSTOM == tag_value->value.type) {
-                json_decref(tag_value->value.value.json);
-            }
+/**
+ * Driver and group of trans data are interned strings, see neu_str_intern.
+ */
+static inline void neu_trans_data_free(neu_reqresp_trans_data_t *data)
+{
+    uint16_t index = __atomic_load_n(&data->ctx->index, __ATOMIC_ACQUIRE);
 
-            if (tag_value->metas != NULL) {
-                for (int i = 0; i < tag_value->n_meta; i++) {
-                    neu_free_dvalue(&tag_value->metas[i].value);
-                }
-                free(tag_value->metas);
-            }
+    do {
+        if (index == 0) {
+            break;
         }
-        utarray_free(data->tags);
-        free(data->group);
-        free(data->driver);
-        pthread_mutex_unlock(&data->ctx->mtx);
-        pthread_mutex_destroy(&data->ctx->mtx);
-        free(data->ctx);
-    } else {
-        pthread_mutex_unlock(&data->ctx->mtx);
+    } while (!__atomic_compare_exchange_n(&data->ctx->index, &index,
+                                          index - 1, true, __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE));
+
+    if (index <= 1) {
+        neu_group_snapshot_free(data->snapshot);
+        neu_str_release(data->group);
+        neu_str_release(data->driver);
+        neu_mem_pool_free(data->ctx);
     }
 }
 
@@ -1319,6 +1410,7 @@ static inline void neu_tag_value_to_json(neu_resp_tag_value_meta_t *tag_value,
     neu_json_metas_to_json(tag_value->metas, tag_value->n_meta, tag_json);
 
     tag_json->datatag.bias = tag_value->datatag.bias;
+    tag_json->history      = tag_value->history;
 
     switch (tag_value->value.type) {
     case NEU_TYPE_ERROR:
@@ -1496,6 +1588,13 @@ static inline void neu_tag_value_to_json(neu_resp_tag_value_meta_t *tag_value,
     }
 }
 
+/*
+ * Same conversion as neu_tag_value_to_json, but the json tag points into the
+ * snapshot, which must outlive it.
+ */
+void neu_group_snapshot_to_json(const neu_group_snapshot_t *snap, uint32_t i,
+                                neu_json_read_resp_tag_t *  tag_json);
+
 static inline void
 neu_tag_value_to_json_paginate(neu_resp_tag_value_meta_paginate_t *tag_value,
                                neu_json_read_paginate_resp_tag_t * tag_json)
@@ -43,6 +43,7 @@ typedef struct {
     uint32_t interval;
     char *   name;
     char *   context;
+    uint32_t aggregate;
 } neu_persist_group_info_t;
 
 typedef struct {
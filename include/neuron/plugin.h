@@ -40,10 +40,24 @@ extern "C" {
     plugin->common.adapter_callbacks->register_metric( \
         plugin->common.adapter, name, name##_HELP, name##_TYPE, init)
 
+#define NEU_PLUGIN_REGISTER_GROUP_METRIC(plugin, grp, name, init)   \
+    plugin->common.adapter_callbacks->driver.register_group_metric( \
+        plugin->common.adapter, grp, name, name##_HELP, name##_TYPE, init)
+
 #define NEU_PLUGIN_UPDATE_METRIC(plugin, name, val, grp)                    \
     plugin->common.adapter_callbacks->update_metric(plugin->common.adapter, \
                                                     name, val, grp)
 
+/*
+ * group_timer and group_sync return 0 once the values of the group are
+ * updated, or one of these.
+ */
+// the read goes on after the call, the plugin calls driver.group_read_end
+// once it is done, possibly before the call returns
+#define NEU_PLUGIN_GROUP_READ_PENDING 1
+// the last read of the group is still running, nothing was started
+#define NEU_PLUGIN_GROUP_READ_BUSY 2
+
 extern int64_t global_timestamp;
 
 typedef struct neu_plugin_common {
@@ -86,6 +86,27 @@ typedef union {
     } bit;
 } neu_datatag_addr_option_u;
 
+/*
+ * Report by exception settings of a subscribed tag, a new value is only
+ * reported once it moved beyond every deadband set from the last reported
+ * value. All zero reports every change.
+ */
+typedef struct {
+    double   absolute;     // change a value must exceed
+    double   percent;      // change in percent of the last reported value
+    uint32_t min_interval; // ms, changes are not reported more often
+    uint32_t max_interval; // ms, the value is reported at least this often
+} neu_tag_deadband_t;
+
+/*
+ * Recent values of a tag kept by the driver cache, see
+ * neu_driver_cache_set_window. All zero keeps no history.
+ */
+typedef struct {
+    uint32_t depth;    // samples kept, derived from duration if 0
+    uint32_t duration; // ms, older samples are dropped
+} neu_tag_window_t;
+
 typedef struct {
     char *                    name;
     char *                    address;
@@ -100,6 +121,8 @@ typedef struct {
     uint8_t                   meta[NEU_TAG_META_LENGTH];
     uint8_t                   format[NEU_TAG_FORMAT_LENGTH];
     uint8_t                   n_format;
+    neu_tag_deadband_t        deadband;
+    neu_tag_window_t          window;
 } neu_datatag_t;
 
 typedef struct neu_tag_meta {
@@ -107,6 +130,38 @@ typedef struct neu_tag_meta {
     neu_dvalue_t value;
 } neu_tag_meta_t;
 
+// a numeric value of a tag kept in its window
+typedef struct {
+    int64_t timestamp;
+    double  value;
+} neu_tag_sample_t;
+
+// selects samples of the window of a tag
+typedef struct {
+    uint32_t last;      // the last samples only, 0 for all
+    int64_t  from;      // ms, 0 for no bound
+    int64_t  to;        // ms, 0 for no bound
+    bool     aggregate; // aggregates only, without the samples
+} neu_tag_history_query_t;
+
+typedef struct {
+    uint32_t          count;
+    double            min;
+    double            max;
+    double            avg;
+    double            last;
+    uint32_t          n_sample;
+    neu_tag_sample_t *samples; // oldest first
+} neu_tag_history_t;
+
+// a read value of a tag, delivered in batches by update_many
+typedef struct {
+    const char *    tag;
+    neu_dvalue_t    value;
+    neu_tag_meta_t *metas;
+    int             n_meta;
+} neu_tag_update_t;
+
 UT_icd *neu_tag_get_icd();
 
 void neu_tag_format_str(const neu_datatag_t *tag, char *buf, int len);
@@ -117,6 +172,17 @@ void           neu_tag_copy(neu_datatag_t *tag, const neu_datatag_t *other);
 void           neu_tag_fini(neu_datatag_t *tag);
 void           neu_tag_free(neu_datatag_t *tag);
 
+inline static bool neu_tag_deadband_is_set(const neu_tag_deadband_t *deadband)
+{
+    return deadband->absolute > 0 || deadband->percent > 0 ||
+        deadband->min_interval > 0 || deadband->max_interval > 0;
+}
+
+inline static bool neu_tag_window_is_set(const neu_tag_window_t *window)
+{
+    return window->depth > 0 || window->duration > 0;
+}
+
 inline static bool neu_tag_attribute_test(const neu_datatag_t *tag,
                                           neu_attribute_e      attribute)
 {
@@ -40,7 +40,7 @@ typedef int (*neu_tag_sort_cmp)(neu_tag_sort_elem_t *tag1,
 
 typedef struct {
     struct {
-        uint16_t size;
+        uint32_t size;
         void *   context;
     } info;
 
@@ -48,7 +48,7 @@ typedef struct {
 } neu_tag_sort_t;
 
 typedef struct {
-    uint16_t        n_sort;
+    uint32_t        n_sort;
     neu_tag_sort_t *sorts;
 } neu_tag_sort_result_t;
 
@@ -58,6 +58,11 @@ typedef bool (*neu_tag_sort_fn)(neu_tag_sort_t *sort, void *tag,
 /**
  * @brief Use sort and cmp to sort and classify tags.
  *
+ * Tags are sorted by cmp, stable for equal tags, then offered one by one to
+ * the current batch by calling sort with the last tag of the batch. A tag
+ * the batch refuses starts a new one, so tags that belong together must be
+ * adjacent in the order of cmp.
+ *
  * @param[in] tags The tags that needs to be processed.
  * @param[in] sort Function for tag sort.
  * @param[in] cmp Function for tags comparison.
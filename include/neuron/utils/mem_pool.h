@@ -0,0 +1,85 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef NEURON_UTILS_MEM_POOL_H
+#define NEURON_UTILS_MEM_POOL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Size class pools for the objects allocated on every report.
+ *
+ * Each thread keeps a cache of free blocks per size class and exchanges them
+ * in batches with a shared depot, so blocks freed by the consumer thread of a
+ * message come back to the producer thread without going through malloc.
+ * Blocks larger than the biggest class are passed to malloc.
+ */
+typedef enum {
+    NEU_MEM_POOL_MSG = 0,   // neu_msg_t
+    NEU_MEM_POOL_TRANS_CTX, // neu_reqresp_trans_data_ctx_t
+    NEU_MEM_POOL_NAME,      // interned strings
+    NEU_MEM_POOL_MAX,
+} neu_mem_pool_e;
+
+typedef struct {
+    uint64_t in_use;  // live objects, keeps growing on leaks
+    uint64_t allocs;  // allocations since start
+    uint64_t mallocs; // allocations not served by a cache
+    uint64_t cached;  // free blocks in the shared depot
+} neu_mem_pool_stats_t;
+
+/**
+ * @brief Allocate a zeroed object of a pool.
+ */
+void *neu_mem_pool_alloc(neu_mem_pool_e pool, size_t size);
+void  neu_mem_pool_free(void *ptr);
+
+const char *neu_mem_pool_name(neu_mem_pool_e pool);
+void        neu_mem_pool_stats(neu_mem_pool_e        pool,
+                               neu_mem_pool_stats_t *stats);
+
+/**
+ * Interned strings, equal strings share one refcounted copy.
+ */
+
+/**
+ * @brief Get the interned copy of a string and take a reference.
+ */
+char *neu_str_intern(const char *str);
+
+/**
+ * @brief Take another reference of an interned string.
+ */
+char *neu_str_ref(char *str);
+
+/**
+ * @brief Drop a reference of an interned string, NULL is ignored.
+ */
+void neu_str_release(char *str);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,8 @@
+BEGIN TRANSACTION;
+
+alter TABLE tags add column deadband REAL NOT NULL DEFAULT 0 check(deadband >= 0);
+alter TABLE tags add column deadband_percent REAL NOT NULL DEFAULT 0 check(deadband_percent >= 0);
+alter TABLE tags add column min_interval INTEGER NOT NULL DEFAULT 0 check(min_interval >= 0);
+alter TABLE tags add column max_interval INTEGER NOT NULL DEFAULT 0 check(max_interval >= 0);
+
+COMMIT;
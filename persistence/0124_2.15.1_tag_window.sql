@@ -0,0 +1,6 @@
+BEGIN TRANSACTION;
+
+alter TABLE tags add column window_depth INTEGER NOT NULL DEFAULT 0 check(window_depth >= 0);
+alter TABLE tags add column window_duration INTEGER NOT NULL DEFAULT 0 check(window_duration >= 0);
+
+COMMIT;
@@ -0,0 +1,5 @@
+BEGIN TRANSACTION;
+
+alter TABLE groups add column aggregate INTEGER NOT NULL DEFAULT 0 check(aggregate >= 0);
+
+COMMIT;
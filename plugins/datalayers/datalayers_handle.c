@@ -263,100 +263,103 @@ static void tag_array_init(void *_elt)
 static UT_icd ut_datatag_icd = { sizeof(datatag), tag_array_init,
                                  tag_array_copy, tag_array_free };
 
-void process_array_to_json_string(json_t *                   array,
-                                  neu_resp_tag_value_meta_t *tag_meta,
-                                  UT_array *                 string_tags,
-                                  neu_reqresp_trans_data_t * trans_data)
+void process_array_to_json_string(json_t *                    array,
+                                  const neu_group_snapshot_t *snap,
+                                  uint32_t                    idx,
+                                  UT_array *                  string_tags,
+                                  neu_reqresp_trans_data_t *  trans_data)
 {
-    switch (tag_meta->value.type) {
+    const neu_snapshot_value_u *v = neu_group_snapshot_value(snap, idx);
+
+    switch (neu_group_snapshot_type(snap, idx)) {
     case NEU_TYPE_ARRAY_INT8:
-        for (size_t i = 0; i < tag_meta->value.value.i8s.length; ++i) {
+        for (size_t i = 0; i < v->i8s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.i8s.i8s[i]));
+                array, json_integer(v->i8s.i8s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_UINT8:
-        for (size_t i = 0; i < tag_meta->value.value.u8s.length; ++i) {
+        for (size_t i = 0; i < v->u8s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.u8s.u8s[i]));
+                array, json_integer(v->u8s.u8s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_INT16:
-        for (size_t i = 0; i < tag_meta->value.value.i16s.length; ++i) {
+        for (size_t i = 0; i < v->i16s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.i16s.i16s[i]));
+                array, json_integer(v->i16s.i16s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_UINT16:
-        for (size_t i = 0; i < tag_meta->value.value.u16s.length; ++i) {
+        for (size_t i = 0; i < v->u16s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.u16s.u16s[i]));
+                array, json_integer(v->u16s.u16s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_INT32:
-        for (size_t i = 0; i < tag_meta->value.value.i32s.length; ++i) {
+        for (size_t i = 0; i < v->i32s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.i32s.i32s[i]));
+                array, json_integer(v->i32s.i32s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_UINT32:
-        for (size_t i = 0; i < tag_meta->value.value.u32s.length; ++i) {
+        for (size_t i = 0; i < v->u32s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.u32s.u32s[i]));
+                array, json_integer(v->u32s.u32s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_INT64:
-        for (size_t i = 0; i < tag_meta->value.value.i64s.length; ++i) {
+        for (size_t i = 0; i < v->i64s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.i64s.i64s[i]));
+                array, json_integer(v->i64s.i64s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_UINT64:
-        for (size_t i = 0; i < tag_meta->value.value.u64s.length; ++i) {
+        for (size_t i = 0; i < v->u64s.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.u64s.u64s[i]));
+                array, json_integer(v->u64s.u64s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_FLOAT:
-        for (size_t i = 0; i < tag_meta->value.value.f32s.length; ++i) {
+        for (size_t i = 0; i < v->f32s.length; ++i) {
             json_array_append_new(
-                array, json_real(tag_meta->value.value.f32s.f32s[i]));
+                array, json_real(v->f32s.f32s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_DOUBLE:
-        for (size_t i = 0; i < tag_meta->value.value.f64s.length; ++i) {
+        for (size_t i = 0; i < v->f64s.length; ++i) {
             json_array_append_new(
-                array, json_real(tag_meta->value.value.f64s.f64s[i]));
+                array, json_real(v->f64s.f64s[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_STRING:
-        for (size_t i = 0; i < tag_meta->value.value.strs.length; ++i) {
+        for (size_t i = 0; i < v->strs.length; ++i) {
             json_array_append_new(
-                array, json_string(tag_meta->value.value.strs.strs[i]));
+                array, json_string(v->strs.strs[i]));
         }
         break;
 
     case NEU_TYPE_ARRAY_BOOL:
-        for (size_t i = 0; i < tag_meta->value.value.bools.length; ++i) {
+        for (size_t i = 0; i < v->bools.length; ++i) {
             json_array_append_new(
-                array, json_boolean(tag_meta->value.value.bools.bools[i]));
+                array, json_boolean(v->bools.bools[i]));
         }
         break;
 
     case NEU_TYPE_BYTES:
-        for (size_t i = 0; i < tag_meta->value.value.bytes.length; ++i) {
+        for (size_t i = 0; i < v->bytes.length; ++i) {
             json_array_append_new(
-                array, json_integer(tag_meta->value.value.bytes.bytes[i]));
+                array, json_integer(v->bytes.u8s[i]));
         }
         break;
 
@@ -369,7 +372,7 @@ void process_array_to_json_string(json_t *                   array,
 
     datatag tag = { trans_data->driver,
                     trans_data->group,
-                    tag_meta->tag,
+                    neu_group_snapshot_tag(snap, idx),
                     { .string_value = json_str },
                     STRING_TYPE };
     utarray_push_back(string_tags, &tag);
@@ -412,108 +415,111 @@ int handle_trans_data(neu_plugin_t *            plugin,
 
     bool has_valid_tags = false;
 
-    utarray_foreach(trans_data->tags, neu_resp_tag_value_meta_t *, tag_meta)
-    {
-        if (tag_meta->value.type == NEU_TYPE_ERROR) {
+    const neu_group_snapshot_t *snap = trans_data->snapshot;
+    for (uint32_t k = 0; k < neu_group_snapshot_size(snap); k++) {
+        const neu_snapshot_value_u *v    = neu_group_snapshot_value(snap, k);
+        const char *                name = neu_group_snapshot_tag(snap, k);
+
+        if (neu_group_snapshot_type(snap, k) == NEU_TYPE_ERROR) {
             continue;
         }
 
         has_valid_tags = true;
 
-        switch (tag_meta->value.type) {
+        switch (neu_group_snapshot_type(snap, k)) {
         case NEU_TYPE_BIT: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.u8 },
+                            name,
+                            { .int_value = v->u8 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_INT8: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.i8 },
+                            name,
+                            { .int_value = v->i8 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_UINT8: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.u8 },
+                            name,
+                            { .int_value = v->u8 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_INT16: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.i16 },
+                            name,
+                            { .int_value = v->i16 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_UINT16: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.u16 },
+                            name,
+                            { .int_value = v->u16 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_INT32: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.i32 },
+                            name,
+                            { .int_value = v->i32 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_UINT32: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.u32 },
+                            name,
+                            { .int_value = v->u32 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_INT64: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.i64 },
+                            name,
+                            { .int_value = v->i64 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_UINT64: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .int_value = tag_meta->value.value.u64 },
+                            name,
+                            { .int_value = v->u64 },
                             INT_TYPE };
             utarray_push_back(int_tags, &tag);
         } break;
         case NEU_TYPE_FLOAT: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .float_value = tag_meta->value.value.f32 },
+                            name,
+                            { .float_value = v->f32 },
                             FLOAT_TYPE };
             utarray_push_back(float_tags, &tag);
         } break;
         case NEU_TYPE_DOUBLE: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .float_value = tag_meta->value.value.d64 },
+                            name,
+                            { .float_value = v->d64 },
                             FLOAT_TYPE };
             utarray_push_back(float_tags, &tag);
         } break;
         case NEU_TYPE_BOOL: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .bool_value = tag_meta->value.value.boolean },
+                            name,
+                            { .bool_value = v->boolean },
                             BOOL_TYPE };
             utarray_push_back(bool_tags, &tag);
         } break;
@@ -522,8 +528,8 @@ int handle_trans_data(neu_plugin_t *            plugin,
         case NEU_TYPE_TIME: {
             datatag tag = { trans_data->driver,
                             trans_data->group,
-                            tag_meta->tag,
-                            { .string_value = tag_meta->value.value.str },
+                            name,
+                            { .string_value = v->str },
                             STRING_TYPE };
             utarray_push_back(string_tags, &tag);
         } break;
@@ -540,7 +546,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
         case NEU_TYPE_ARRAY_FLOAT:
         case NEU_TYPE_ARRAY_DOUBLE: {
             json_t *array = json_array();
-            process_array_to_json_string(array, tag_meta, string_tags,
+            process_array_to_json_string(array, snap, k, string_tags,
                                          trans_data);
         } break;
         default:
@@ -81,17 +81,17 @@ int json_encode_read_resp_tags(void *json_object, void *param)
         return -1;
     }
 
-    utarray_foreach(trans_data->tags, neu_resp_tag_value_meta_t *, tag_value)
-    {
+    const neu_group_snapshot_t *snap = trans_data->snapshot;
+    for (uint32_t i = 0; i < neu_group_snapshot_size(snap); i++) {
         neu_json_read_resp_tag_t json_tag = { 0 };
 
-        neu_tag_value_to_json(tag_value, &json_tag);
+        neu_group_snapshot_to_json(snap, i, &json_tag);
 
         neu_json_elem_t tag_elem = {
             .name      = json_tag.name,
             .t         = json_tag.t,
             .v         = json_tag.value,
-            .precision = tag_value->value.precision,
+            .precision = neu_group_snapshot_precision(snap, i),
         };
 
         if (json_tag.n_meta > 0) {
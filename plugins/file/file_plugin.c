@@ -176,6 +176,9 @@ static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group)
 {
     neu_adapter_update_metric_cb_t update_metric =
         plugin->common.adapter_callbacks->update_metric;
+    neu_tag_update_t *items =
+        calloc(utarray_len(group->tags), sizeof(neu_tag_update_t));
+    int n_item = 0;
 
     utarray_foreach(group->tags, neu_datatag_t *, tag)
     {
@@ -208,10 +211,15 @@ static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group)
             free(buf);
         }
 
-        plugin->common.adapter_callbacks->driver.update(
-            plugin->common.adapter, group->group_name, tag->name, dvalue);
+        items[n_item].tag   = tag->name;
+        items[n_item].value = dvalue;
+        n_item += 1;
     }
 
+    plugin->common.adapter_callbacks->driver.update_many(
+        plugin->common.adapter, group->group_name, items, n_item);
+    free(items);
+
     update_metric(plugin->common.adapter, NEU_METRIC_SEND_BYTES, 0, NULL);
     update_metric(plugin->common.adapter, NEU_METRIC_RECV_BYTES, 0, NULL);
     update_metric(plugin->common.adapter, NEU_METRIC_LAST_RTT_MS, 1, NULL);
@@ -26,21 +26,18 @@
 #include "kafka_handle.h"
 #include "kafka_plugin.h"
 
-static int tag_values_to_json(UT_array *tags, neu_json_read_resp_t *json,
-                              bool filter_error)
+static int snapshot_to_json(const neu_group_snapshot_t *snap,
+                            neu_json_read_resp_t *json, bool filter_error)
 {
-    int index   = 0;
-    int n_valid = 0;
-
-    if (filter_error) {
-        utarray_foreach(tags, neu_resp_tag_value_meta_t *, tv)
-        {
-            if (tv->value.type != NEU_TYPE_ERROR) {
-                n_valid += 1;
-            }
+    int      index   = 0;
+    uint32_t n_valid = 0;
+    uint32_t n_tag   = neu_group_snapshot_size(snap);
+
+    for (uint32_t i = 0; i < n_tag; i++) {
+        if (!filter_error ||
+            neu_group_snapshot_type(snap, i) != NEU_TYPE_ERROR) {
+            n_valid += 1;
         }
-    } else {
-        n_valid = utarray_len(tags);
     }
 
     if (0 == n_valid) {
@@ -54,12 +51,12 @@ static int tag_values_to_json(UT_array *tags, neu_json_read_resp_t *json,
         return -1;
     }
 
-    utarray_foreach(tags, neu_resp_tag_value_meta_t *, tv)
-    {
-        if (filter_error && tv->value.type == NEU_TYPE_ERROR) {
+    for (uint32_t i = 0; i < n_tag; i++) {
+        if (filter_error &&
+            neu_group_snapshot_type(snap, i) == NEU_TYPE_ERROR) {
             continue;
         }
-        neu_tag_value_to_json(tv, &json->tags[index]);
+        neu_group_snapshot_to_json(snap, i, &json->tags[index]);
         index += 1;
     }
 
@@ -79,8 +76,8 @@ static char *generate_upload_json(neu_plugin_t *            plugin,
     neu_json_read_resp_t json = { 0 };
 
     if (0 !=
-        tag_values_to_json(data->tags, &json, !plugin->config.upload_err)) {
-        plog_error(plugin, "tag_values_to_json fail");
+        snapshot_to_json(data->snapshot, &json, !plugin->config.upload_err)) {
+        plog_error(plugin, "snapshot_to_json fail");
         return NULL;
     }
 
@@ -0,0 +1,357 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/time.h"
+#include "utils/utlist.h"
+
+#include "modbus_bus.h"
+
+// the silence is fixed above 19200 bauds
+#define FAST_BAUD 19200
+#define FAST_SILENCE_US 1750
+
+struct modbus_bus_member {
+    modbus_bus_t *    bus;
+    void *            data;
+    neu_conn_callback connected;
+    neu_conn_callback disconnected;
+    bool              running;
+    int64_t           wait_us;
+    int64_t           sample_us;      // time of the last stats
+    int64_t           sample_busy_us; // busy time of the bus at that time
+
+    struct modbus_bus_member *prev;
+    struct modbus_bus_member *next;
+};
+
+struct modbus_bus {
+    char *                device;
+    neu_conn_tty_baud_e   baud;
+    neu_conn_tty_data_e   data;
+    neu_conn_tty_parity_e parity;
+    neu_conn_tty_stop_e   stop;
+    uint32_t              silence_us;
+    neu_conn_t *          conn;
+    bool                  running;
+
+    pthread_mutex_t      mtx;
+    pthread_cond_t       cond;
+    uint64_t             next_ticket;
+    uint64_t             serving; // ticket holding the turn
+    int64_t              turn_us; // start of the exchange of the turn
+    int64_t              end_us;  // end of the last exchange
+    int64_t              busy_us;
+    uint16_t             n_member;
+    modbus_bus_member_t *members;
+
+    struct modbus_bus *prev;
+    struct modbus_bus *next;
+};
+
+static modbus_bus_t *  buses     = NULL;
+static pthread_mutex_t buses_mtx = PTHREAD_MUTEX_INITIALIZER;
+
+static const uint32_t bauds[] = {
+    [NEU_CONN_TTY_BAUD_115200] = 115200, [NEU_CONN_TTY_BAUD_57600] = 57600,
+    [NEU_CONN_TTY_BAUD_38400]  = 38400,  [NEU_CONN_TTY_BAUD_19200] = 19200,
+    [NEU_CONN_TTY_BAUD_9600]   = 9600,   [NEU_CONN_TTY_BAUD_4800]  = 4800,
+    [NEU_CONN_TTY_BAUD_2400]   = 2400,   [NEU_CONN_TTY_BAUD_1800]  = 1800,
+    [NEU_CONN_TTY_BAUD_1200]   = 1200,   [NEU_CONN_TTY_BAUD_600]   = 600,
+    [NEU_CONN_TTY_BAUD_300]    = 300,    [NEU_CONN_TTY_BAUD_200]   = 200,
+    [NEU_CONN_TTY_BAUD_150]    = 150,
+};
+
+static int64_t now_us(void)
+{
+    return neu_time_ns() / 1000;
+}
+
+uint32_t modbus_bus_silence_us(neu_conn_tty_baud_e   baud,
+                               neu_conn_tty_data_e   data,
+                               neu_conn_tty_parity_e parity,
+                               neu_conn_tty_stop_e   stop)
+{
+    uint64_t rate = 9600;
+    uint64_t bits = 0;
+
+    if (baud <= NEU_CONN_TTY_BAUD_150) {
+        rate = bauds[baud];
+    }
+    if (rate > FAST_BAUD) {
+        return FAST_SILENCE_US;
+    }
+
+    // start bit, data bits, parity bit and stop bits of a character
+    bits = 1 + 5 + data;
+    bits += parity != NEU_CONN_TTY_PARITY_NONE ? 1 : 0;
+    bits += stop == NEU_CONN_TTY_STOP_2 ? 2 : 1;
+
+    return (uint32_t)((35 * bits * 1000000 + 10 * rate - 1) / (10 * rate));
+}
+
+static bool line_match(const modbus_bus_t *bus, const neu_conn_param_t *param)
+{
+    return bus->baud == param->params.tty_client.baud &&
+        bus->data == param->params.tty_client.data &&
+        bus->parity == param->params.tty_client.parity &&
+        bus->stop == param->params.tty_client.stop;
+}
+
+static void bus_connected(void *ctx, int fd)
+{
+    modbus_bus_t *       bus = (modbus_bus_t *) ctx;
+    modbus_bus_member_t *el  = NULL;
+
+    pthread_mutex_lock(&bus->mtx);
+    DL_FOREACH(bus->members, el)
+    {
+        el->connected(el->data, fd);
+    }
+    pthread_mutex_unlock(&bus->mtx);
+}
+
+static void bus_disconnected(void *ctx, int fd)
+{
+    modbus_bus_t *       bus = (modbus_bus_t *) ctx;
+    modbus_bus_member_t *el  = NULL;
+
+    pthread_mutex_lock(&bus->mtx);
+    DL_FOREACH(bus->members, el)
+    {
+        el->disconnected(el->data, fd);
+    }
+    pthread_mutex_unlock(&bus->mtx);
+}
+
+static modbus_bus_t *bus_new(neu_conn_param_t *param)
+{
+    modbus_bus_t *bus = calloc(1, sizeof(modbus_bus_t));
+
+    bus->device     = strdup(param->params.tty_client.device);
+    bus->baud       = param->params.tty_client.baud;
+    bus->data       = param->params.tty_client.data;
+    bus->parity     = param->params.tty_client.parity;
+    bus->stop       = param->params.tty_client.stop;
+    bus->silence_us = modbus_bus_silence_us(bus->baud, bus->data, bus->parity,
+                                            bus->stop);
+    bus->running    = true;
+    pthread_mutex_init(&bus->mtx, NULL);
+    pthread_cond_init(&bus->cond, NULL);
+
+    bus->conn = neu_conn_new(param, (void *) bus, bus_connected,
+                             bus_disconnected);
+    return bus;
+}
+
+static void bus_free(modbus_bus_t *bus)
+{
+    neu_conn_destory(bus->conn);
+    pthread_cond_destroy(&bus->cond);
+    pthread_mutex_destroy(&bus->mtx);
+    free(bus->device);
+    free(bus);
+}
+
+// start or stop the line as its members are, called with buses_mtx held
+static void bus_run(modbus_bus_t *bus)
+{
+    modbus_bus_member_t *el      = NULL;
+    bool                 running = false;
+
+    pthread_mutex_lock(&bus->mtx);
+    DL_FOREACH(bus->members, el)
+    {
+        running = running || el->running;
+    }
+    pthread_mutex_unlock(&bus->mtx);
+
+    // outside of the bus lock, stopping calls back the members
+    if (running && !bus->running) {
+        neu_conn_start(bus->conn);
+    } else if (!running && bus->running) {
+        neu_conn_stop(bus->conn);
+    }
+    bus->running = running;
+}
+
+modbus_bus_member_t *modbus_bus_attach(neu_conn_param_t *param, void *data,
+                                       neu_conn_callback connected,
+                                       neu_conn_callback disconnected)
+{
+    modbus_bus_t *       bus    = NULL;
+    modbus_bus_member_t *member = NULL;
+
+    pthread_mutex_lock(&buses_mtx);
+    DL_FOREACH(buses, bus)
+    {
+        if (strcmp(bus->device, param->params.tty_client.device) == 0) {
+            break;
+        }
+    }
+
+    if (bus != NULL && !line_match(bus, param)) {
+        pthread_mutex_unlock(&buses_mtx);
+        return NULL;
+    }
+
+    if (bus == NULL) {
+        bus = bus_new(param);
+        DL_APPEND(buses, bus);
+    }
+
+    member               = calloc(1, sizeof(modbus_bus_member_t));
+    member->bus          = bus;
+    member->data         = data;
+    member->connected    = connected;
+    member->disconnected = disconnected;
+    member->running      = true;
+    member->sample_us    = now_us();
+
+    pthread_mutex_lock(&bus->mtx);
+    member->sample_busy_us = bus->busy_us;
+    DL_APPEND(bus->members, member);
+    bus->n_member += 1;
+    pthread_mutex_unlock(&bus->mtx);
+
+    // the line may have been opened by another node before
+    if (neu_conn_is_connected(bus->conn)) {
+        connected(data, neu_conn_fd(bus->conn));
+    }
+
+    bus_run(bus);
+    pthread_mutex_unlock(&buses_mtx);
+
+    return member;
+}
+
+void modbus_bus_detach(modbus_bus_member_t *member)
+{
+    modbus_bus_t *bus = member->bus;
+
+    pthread_mutex_lock(&buses_mtx);
+    pthread_mutex_lock(&bus->mtx);
+    DL_DELETE(bus->members, member);
+    bus->n_member -= 1;
+    pthread_mutex_unlock(&bus->mtx);
+
+    if (bus->n_member == 0) {
+        DL_DELETE(buses, bus);
+        bus_free(bus);
+    } else {
+        bus_run(bus);
+    }
+    pthread_mutex_unlock(&buses_mtx);
+
+    free(member);
+}
+
+neu_conn_t *modbus_bus_conn(const modbus_bus_member_t *member)
+{
+    return member->bus->conn;
+}
+
+bool modbus_bus_match(const modbus_bus_member_t *member,
+                      const neu_conn_param_t *   param)
+{
+    const modbus_bus_t *bus = member->bus;
+
+    return strcmp(bus->device, param->params.tty_client.device) == 0 &&
+        line_match(bus, param);
+}
+
+void modbus_bus_start(modbus_bus_member_t *member)
+{
+    pthread_mutex_lock(&buses_mtx);
+    member->running = true;
+    bus_run(member->bus);
+    pthread_mutex_unlock(&buses_mtx);
+}
+
+void modbus_bus_stop(modbus_bus_member_t *member)
+{
+    pthread_mutex_lock(&buses_mtx);
+    member->running = false;
+    bus_run(member->bus);
+    pthread_mutex_unlock(&buses_mtx);
+}
+
+int64_t modbus_bus_acquire(modbus_bus_member_t *member)
+{
+    modbus_bus_t *bus    = member->bus;
+    int64_t       start  = now_us();
+    int64_t       idle   = 0;
+    uint64_t      ticket = 0;
+
+    pthread_mutex_lock(&bus->mtx);
+    ticket = bus->next_ticket++;
+    while (ticket != bus->serving) {
+        pthread_cond_wait(&bus->cond, &bus->mtx);
+    }
+    idle = now_us() - bus->end_us;
+    pthread_mutex_unlock(&bus->mtx);
+
+    // only the rest of the silence, time spent queueing already counts
+    if (idle < bus->silence_us) {
+        int64_t         wait = bus->silence_us - idle;
+        struct timespec t1   = { .tv_sec  = wait / 1000000,
+                               .tv_nsec = 1000 * (wait % 1000000) };
+        struct timespec t2   = { 0 };
+        nanosleep(&t1, &t2);
+    }
+
+    bus->turn_us    = now_us();
+    member->wait_us = bus->turn_us - start;
+    return member->wait_us;
+}
+
+void modbus_bus_release(modbus_bus_member_t *member)
+{
+    modbus_bus_t *bus = member->bus;
+
+    pthread_mutex_lock(&bus->mtx);
+    bus->end_us = now_us();
+    bus->busy_us += bus->end_us - bus->turn_us;
+    bus->serving += 1;
+    pthread_cond_broadcast(&bus->cond);
+    pthread_mutex_unlock(&bus->mtx);
+}
+
+void modbus_bus_stats(modbus_bus_member_t *member, modbus_bus_stats_t *stats)
+{
+    modbus_bus_t *bus  = member->bus;
+    int64_t       now  = now_us();
+    int64_t       busy = 0;
+    int64_t       span = now - member->sample_us;
+
+    pthread_mutex_lock(&bus->mtx);
+    busy                   = bus->busy_us - member->sample_busy_us;
+    member->sample_busy_us = bus->busy_us;
+    stats->n_member        = bus->n_member;
+    pthread_mutex_unlock(&bus->mtx);
+
+    member->sample_us  = now;
+    stats->utilization = 0;
+    if (span > 0) {
+        stats->utilization = busy >= span ? 100 : (uint32_t)(busy * 100 / span);
+    }
+    stats->wait_ms = (uint32_t)(member->wait_us / 1000);
+}
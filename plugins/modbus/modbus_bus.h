@@ -0,0 +1,95 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_PLUGIN_MODBUS_BUS_H_
+#define _NEU_PLUGIN_MODBUS_BUS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "utils/log.h"
+
+#include "connection/neu_connection.h"
+
+/*
+ * A serial line shared by the modbus rtu nodes configured on the same device.
+ *
+ * The bus owns the tty, nodes attach to it as members and take turns for
+ * each request/response exchange. Turns are granted in the order they are
+ * asked for, so a node polling back to back cannot starve the others, and a
+ * turn only waits for what is left of the 3.5 character silence that must
+ * separate two rtu frames since the end of the previous exchange.
+ */
+typedef struct modbus_bus        modbus_bus_t;
+typedef struct modbus_bus_member modbus_bus_member_t;
+
+typedef struct modbus_bus_stats {
+    uint32_t utilization; // percent of time the line was busy
+    uint32_t wait_ms;     // last wait of the member for a turn
+    uint16_t n_member;
+} modbus_bus_stats_t;
+
+// microseconds of silence between two frames at the given line settings
+uint32_t modbus_bus_silence_us(neu_conn_tty_baud_e   baud,
+                               neu_conn_tty_data_e   data,
+                               neu_conn_tty_parity_e parity,
+                               neu_conn_tty_stop_e   stop);
+
+/*
+ * Attach a node to the bus of the tty device of param, the bus is opened by
+ * its first member. Connection callbacks of the bus are forwarded to every
+ * member with its data.
+ *
+ * @return NULL if the device is already open with other line settings.
+ */
+modbus_bus_member_t *modbus_bus_attach(neu_conn_param_t *param, void *data,
+                                       neu_conn_callback connected,
+                                       neu_conn_callback disconnected);
+// the bus is closed with its last member
+void modbus_bus_detach(modbus_bus_member_t *member);
+
+neu_conn_t *modbus_bus_conn(const modbus_bus_member_t *member);
+// whether member shares the bus of param with the same line settings
+bool modbus_bus_match(const modbus_bus_member_t *member,
+                      const neu_conn_param_t *   param);
+
+// the line is started with the first running member, stopped with the last
+void modbus_bus_start(modbus_bus_member_t *member);
+void modbus_bus_stop(modbus_bus_member_t *member);
+
+/*
+ * Wait for the turn of member, and the inter-frame silence.
+ *
+ * @return microseconds waited.
+ */
+int64_t modbus_bus_acquire(modbus_bus_member_t *member);
+// end the turn of member, once its exchange is over
+void modbus_bus_release(modbus_bus_member_t *member);
+
+// utilization is measured since the previous call for the same member
+void modbus_bus_stats(modbus_bus_member_t *member, modbus_bus_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,236 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdlib.h>
+#include <string.h>
+
+#include "modbus_coalesce.h"
+
+typedef struct {
+    modbus_point_write_t write; // first member, entries are sorted as points
+    uint32_t             req;   // index of the request
+    int32_t              by;    // index of the entry replacing it, -1 if none
+    int                  error;
+    int64_t              queue_ms;
+} entry_t;
+
+typedef struct {
+    void *req;
+    int   error;
+} req_t;
+
+struct modbus_coalesce {
+    UT_array *entries;
+    UT_array *reqs;
+};
+
+static const UT_icd entry_icd = { sizeof(entry_t), NULL, NULL, NULL };
+static const UT_icd req_icd   = { sizeof(req_t), NULL, NULL, NULL };
+
+modbus_coalesce_t *modbus_coalesce_new(void)
+{
+    modbus_coalesce_t *coalesce = calloc(1, sizeof(modbus_coalesce_t));
+
+    utarray_new(coalesce->entries, &entry_icd);
+    utarray_new(coalesce->reqs, &req_icd);
+
+    return coalesce;
+}
+
+void modbus_coalesce_free(modbus_coalesce_t *coalesce)
+{
+    if (coalesce != NULL) {
+        utarray_free(coalesce->entries);
+        utarray_free(coalesce->reqs);
+        free(coalesce);
+    }
+}
+
+bool modbus_coalesce_mergeable(const modbus_point_t *point)
+{
+    return point->area == MODBUS_AREA_COIL ||
+        (point->area == MODBUS_AREA_HOLD_REGISTER &&
+         point->type != NEU_TYPE_BIT);
+}
+
+static bool overlap(const modbus_point_t *p1, const modbus_point_t *p2)
+{
+    return p1->slave_id == p2->slave_id && p1->area == p2->area &&
+        p1->start_address < p2->start_address + p2->n_register &&
+        p2->start_address < p1->start_address + p1->n_register;
+}
+
+static bool same_point(const modbus_point_t *p1, const modbus_point_t *p2)
+{
+    return overlap(p1, p2) && p1->start_address == p2->start_address &&
+        p1->n_register == p2->n_register && modbus_coalesce_mergeable(p1) &&
+        modbus_coalesce_mergeable(p2);
+}
+
+int modbus_coalesce_add(modbus_coalesce_t *coalesce, void *req,
+                        const modbus_point_write_t *points, uint16_t n_point,
+                        int64_t now)
+{
+    req_t r = { .req = req, .error = NEU_ERR_SUCCESS };
+
+    for (uint16_t i = 0; i < n_point; i++) {
+        utarray_foreach(coalesce->entries, entry_t *, e)
+        {
+            if (e->by < 0 && overlap(&e->write.point, &points[i].point) &&
+                !same_point(&e->write.point, &points[i].point)) {
+                return -1;
+            }
+        }
+    }
+
+    utarray_push_back(coalesce->reqs, &r);
+    for (uint16_t i = 0; i < n_point; i++) {
+        entry_t entry = {
+            .write    = points[i],
+            .req      = utarray_len(coalesce->reqs) - 1,
+            .by       = -1,
+            .error    = NEU_ERR_PLUGIN_WRITE_FAILURE,
+            .queue_ms = now,
+        };
+        int32_t index = (int32_t) utarray_len(coalesce->entries);
+
+        utarray_foreach(coalesce->entries, entry_t *, e)
+        {
+            if (e->by < 0 && same_point(&e->write.point, &points[i].point)) {
+                e->by = index;
+            }
+        }
+        utarray_push_back(coalesce->entries, &entry);
+    }
+
+    return 0;
+}
+
+uint16_t modbus_coalesce_pending(const modbus_coalesce_t *coalesce)
+{
+    return utarray_len(coalesce->entries);
+}
+
+int64_t modbus_coalesce_oldest(const modbus_coalesce_t *coalesce)
+{
+    if (utarray_len(coalesce->entries) == 0) {
+        return -1;
+    }
+
+    return ((entry_t *) utarray_front(coalesce->entries))->queue_ms;
+}
+
+static void batch_append(modbus_write_batch_t *batch, UT_array *points,
+                         modbus_endianess    endianess,
+                         modbus_endianess_64 endianess_64)
+{
+    modbus_write_cmd_sort_t *sort =
+        modbus_write_tags_sort(points, endianess, endianess_64);
+
+    batch->cmd = realloc(batch->cmd,
+                         (batch->n_cmd + sort->n_cmd) *
+                             sizeof(modbus_write_cmd_t));
+    memcpy(batch->cmd + batch->n_cmd, sort->cmd,
+           sort->n_cmd * sizeof(modbus_write_cmd_t));
+    batch->n_cmd += sort->n_cmd;
+
+    free(sort->cmd);
+    free(sort);
+}
+
+modbus_write_batch_t *modbus_coalesce_take(modbus_coalesce_t * coalesce,
+                                           modbus_endianess    endianess,
+                                           modbus_endianess_64 endianess_64)
+{
+    modbus_write_batch_t *batch  = NULL;
+    UT_array *            points = NULL;
+
+    if (utarray_len(coalesce->entries) == 0) {
+        return NULL;
+    }
+
+    batch          = calloc(1, sizeof(modbus_write_batch_t));
+    batch->entries = coalesce->entries;
+    batch->reqs    = coalesce->reqs;
+    utarray_new(coalesce->entries, &entry_icd);
+    utarray_new(coalesce->reqs, &req_icd);
+
+    utarray_new(points, &ut_ptr_icd);
+    utarray_foreach(batch->entries, entry_t *, e)
+    {
+        if (e->by < 0 && modbus_coalesce_mergeable(&e->write.point)) {
+            modbus_point_write_t *p = &e->write;
+            utarray_push_back(points, &p);
+        }
+    }
+    if (utarray_len(points) > 0) {
+        batch_append(batch, points, endianess, endianess_64);
+    }
+
+    utarray_foreach(batch->entries, entry_t *, e)
+    {
+        if (e->by < 0 && !modbus_coalesce_mergeable(&e->write.point)) {
+            modbus_point_write_t *p = &e->write;
+            utarray_clear(points);
+            utarray_push_back(points, &p);
+            batch_append(batch, points, endianess, endianess_64);
+        }
+    }
+
+    utarray_free(points);
+    return batch;
+}
+
+void modbus_write_batch_done(modbus_write_batch_t *batch, uint32_t cmd,
+                             int error)
+{
+    utarray_foreach(batch->cmd[cmd].tags, modbus_point_write_t **, p)
+    {
+        ((entry_t *) *p)->error = error;
+    }
+}
+
+void modbus_write_batch_free(modbus_write_batch_t *  batch,
+                             modbus_stack_write_resp resp, void *ctx)
+{
+    utarray_foreach(batch->entries, entry_t *, e)
+    {
+        entry_t *last = e;
+        req_t *  r    = (req_t *) utarray_eltptr(batch->reqs, e->req);
+
+        // a replaced point is written by the point replacing it
+        while (last->by >= 0) {
+            last = (entry_t *) utarray_eltptr(batch->entries,
+                                              (unsigned int) last->by);
+        }
+        if (r->error == NEU_ERR_SUCCESS) {
+            r->error = last->error;
+        }
+    }
+
+    utarray_foreach(batch->reqs, req_t *, r) { resp(ctx, r->req, r->error); }
+
+    for (uint32_t i = 0; i < batch->n_cmd; i++) {
+        utarray_free(batch->cmd[i].tags);
+        free(batch->cmd[i].bytes);
+    }
+    free(batch->cmd);
+    utarray_free(batch->entries);
+    utarray_free(batch->reqs);
+    free(batch);
+}
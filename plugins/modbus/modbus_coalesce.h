@@ -0,0 +1,92 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_PLUGIN_MODBUS_COALESCE_H_
+#define _NEU_PLUGIN_MODBUS_COALESCE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "modbus_point.h"
+#include "modbus_stack.h"
+
+/*
+ * Writes waiting to be sent.
+ *
+ * Coils and whole holding registers written to contiguous addresses of a
+ * slave are merged into one multiple write, whichever request they come
+ * from. A later write to the same point replaces the pending value. A point
+ * overlapping a pending point of another request otherwise is refused, so
+ * that writes to a register are never reordered. Each request is answered
+ * once, when all of its points are sent.
+ */
+typedef struct modbus_coalesce modbus_coalesce_t;
+
+typedef struct modbus_write_batch {
+    uint32_t            n_cmd;
+    modbus_write_cmd_t *cmd; // tags are the modbus_point_write_t of the batch
+
+    UT_array *entries;
+    UT_array *reqs;
+} modbus_write_batch_t;
+
+modbus_coalesce_t *modbus_coalesce_new(void);
+void               modbus_coalesce_free(modbus_coalesce_t *coalesce);
+
+// coils and holding registers but their bits
+bool modbus_coalesce_mergeable(const modbus_point_t *point);
+
+/*
+ * Queue the points of a write request.
+ *
+ * @return 0, -1 if a point overlaps a pending point of another request and
+ *         nothing was queued.
+ */
+int modbus_coalesce_add(modbus_coalesce_t *coalesce, void *req,
+                        const modbus_point_write_t *points, uint16_t n_point,
+                        int64_t now);
+// points waiting, replaced ones included
+uint16_t modbus_coalesce_pending(const modbus_coalesce_t *coalesce);
+// when the oldest pending point was queued, -1 if there is none
+int64_t modbus_coalesce_oldest(const modbus_coalesce_t *coalesce);
+
+/*
+ * Take the pending points as write commands, NULL if there is none.
+ *
+ * The merged commands come first, then one command per point that cannot be
+ * merged, in the order they were queued.
+ */
+modbus_write_batch_t *modbus_coalesce_take(modbus_coalesce_t * coalesce,
+                                           modbus_endianess    endianess,
+                                           modbus_endianess_64 endianess_64);
+// record the result of a command of the batch
+void modbus_write_batch_done(modbus_write_batch_t *batch, uint32_t cmd,
+                             int error);
+// answer the requests of the batch with the first error of their points
+void modbus_write_batch_free(modbus_write_batch_t *  batch,
+                             modbus_stack_write_resp resp, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
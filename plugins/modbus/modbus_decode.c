@@ -0,0 +1,436 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "modbus_decode.h"
+
+typedef enum {
+    DECODE_GENERIC = 0, // copied and fixed up on its own
+    DECODE_SWAP,        // read from the swapped bytes of a run
+    DECODE_REG_BIT,     // a bit of a register
+    DECODE_COIL,        // a coil or a discrete input
+    DECODE_FAIL,        // outside the command
+} decode_op_e;
+
+typedef struct {
+    uint8_t               op;
+    uint8_t               slave_id;
+    uint8_t               width;
+    uint8_t               bit;
+    uint16_t              offset; // byte offset, bit offset of a coil
+    uint16_t              end;    // response bytes needed by the point
+    const modbus_point_t *point;
+} decode_step_t;
+
+typedef struct {
+    uint16_t offset;
+    uint16_t length;
+    uint8_t  width;
+    uint8_t  mask[16]; // byte shuffle of 16 bytes of the run
+} decode_run_t;
+
+typedef void (*decode_shuffle_fn)(uint8_t *dst, const uint8_t *src,
+                                  uint16_t len, const uint8_t *mask);
+
+struct modbus_decode_plan {
+    uint16_t            n_step;
+    decode_step_t *     steps;
+    uint16_t            n_run;
+    decode_run_t *      runs;
+    uint8_t *           swapped; // response data after the swap of the runs
+    modbus_endianess    endianess;
+    modbus_endianess_64 endianess_64;
+    decode_shuffle_fn   shuffle;
+    neu_tag_update_t    values[];
+};
+
+static void shuffle_scalar(uint8_t *dst, const uint8_t *src, uint16_t len,
+                           const uint8_t *mask)
+{
+    for (uint16_t i = 0; i < len; i += 16) {
+        uint16_t n = len - i < 16 ? len - i : 16;
+
+        for (uint16_t j = 0; j < n; j++) {
+            dst[i + j] = src[i + mask[j]];
+        }
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("ssse3"))) static void
+shuffle_ssse3(uint8_t *dst, const uint8_t *src, uint16_t len,
+              const uint8_t *mask)
+{
+    __m128i  m = _mm_loadu_si128((const __m128i *) mask);
+    uint16_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (src + i));
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_shuffle_epi8(v, m));
+    }
+    shuffle_scalar(dst + i, src + i, len - i, mask);
+}
+#elif defined(__aarch64__)
+static void shuffle_neon(uint8_t *dst, const uint8_t *src, uint16_t len,
+                         const uint8_t *mask)
+{
+    uint8x16_t m = vld1q_u8(mask);
+    uint16_t   i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        vst1q_u8(dst + i, vqtbl1q_u8(vld1q_u8(src + i), m));
+    }
+    shuffle_scalar(dst + i, src + i, len - i, mask);
+}
+#endif
+
+static decode_shuffle_fn shuffle_select(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (__builtin_cpu_supports("ssse3")) {
+        return shuffle_ssse3;
+    }
+#elif defined(__aarch64__)
+    return shuffle_neon;
+#endif
+    return shuffle_scalar;
+}
+
+static uint8_t swap_width(neu_type_e type)
+{
+    switch (type) {
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_INT16:
+        return sizeof(uint16_t);
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+        return sizeof(uint32_t);
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+        return sizeof(uint64_t);
+    default:
+        return 0;
+    }
+}
+
+/*
+ * The byte shuffle of a value: the host value byte i is the register byte
+ * perm[i]. It is found by running the conversions of the value on the byte
+ * indexes, so it follows them whatever they are.
+ */
+static void swap_perm(const modbus_point_t *point, uint8_t width,
+                      modbus_endianess    endianess,
+                      modbus_endianess_64 endianess_64, uint8_t *perm)
+{
+    neu_value_u value = { 0 };
+
+    for (uint8_t i = 0; i < width; i++) {
+        value.bytes.bytes[i] = i;
+    }
+
+    switch (width) {
+    case sizeof(uint16_t):
+        value.u16 = ntohs(value.u16);
+        break;
+    case sizeof(uint32_t):
+        if (point->option.value32.is_default) {
+            modbus_convert_endianess(&value, endianess);
+        }
+        value.u32 = ntohl(value.u32);
+        break;
+    case sizeof(uint64_t):
+        if (point->option.value64.is_default) {
+            modbus_convert_endianess_64(&value, endianess_64);
+        }
+        value.u64 = neu_ntohll(value.u64);
+        break;
+    }
+
+    memcpy(perm, value.bytes.bytes, width);
+}
+
+static void compile_step(decode_step_t *step, const modbus_point_t *point,
+                         const modbus_read_cmd_t *cmd)
+{
+    step->point    = point;
+    step->slave_id = point->slave_id;
+
+    if (point->start_address + point->n_register >
+        cmd->start_address + cmd->n_register) {
+        step->op = DECODE_FAIL;
+        return;
+    }
+
+    switch (point->area) {
+    case MODBUS_AREA_HOLD_REGISTER:
+    case MODBUS_AREA_INPUT_REGISTER:
+        step->offset = (point->start_address - cmd->start_address) * 2;
+        step->end    = step->offset + point->n_register * 2;
+        step->width  = swap_width(point->type);
+        if (point->type == NEU_TYPE_BIT) {
+            step->op  = DECODE_REG_BIT;
+            step->bit = point->option.bit.bit;
+        } else if (step->width > 0 && step->width == point->n_register * 2) {
+            step->op = DECODE_SWAP;
+        }
+        break;
+    case MODBUS_AREA_COIL:
+    case MODBUS_AREA_INPUT:
+        step->offset = point->start_address - cmd->start_address;
+        step->end    = step->offset / 8 + 1;
+        if (point->type == NEU_TYPE_BIT) {
+            step->op = DECODE_COIL;
+        }
+        break;
+    }
+}
+
+/*
+ * Join the swapped values into runs, a value laid out right after the last
+ * one with the same width and shuffle extends its run. A value overlapping a
+ * run is decoded on its own.
+ */
+static void compile_runs(modbus_decode_plan_t *plan)
+{
+    decode_run_t *run = NULL;
+    uint8_t       last[sizeof(uint64_t)] = { 0 };
+    uint16_t      covered = 0;
+
+    for (uint16_t i = 0; i < plan->n_step; i++) {
+        decode_step_t *step = &plan->steps[i];
+        uint8_t        perm[sizeof(uint64_t)];
+
+        if (step->op != DECODE_SWAP) {
+            continue;
+        }
+
+        swap_perm(step->point, step->width, plan->endianess,
+                  plan->endianess_64, perm);
+
+        if (run != NULL && step->offset == run->offset + run->length &&
+            step->width == run->width &&
+            memcmp(perm, last, step->width) == 0) {
+            run->length += step->width;
+        } else if (step->offset >= covered) {
+            run         = &plan->runs[plan->n_run++];
+            run->offset = step->offset;
+            run->length = step->width;
+            run->width  = step->width;
+            for (uint8_t j = 0; j < sizeof(run->mask); j++) {
+                run->mask[j] = j / step->width * step->width +
+                    perm[j % step->width];
+            }
+            memcpy(last, perm, step->width);
+        } else {
+            step->op = DECODE_GENERIC;
+            continue;
+        }
+
+        covered = run->offset + run->length;
+    }
+}
+
+modbus_decode_plan_t *modbus_decode_plan_new(const modbus_read_cmd_t *cmd,
+                                             modbus_endianess    endianess,
+                                             modbus_endianess_64 endianess_64)
+{
+    uint16_t              n_step = utarray_len(cmd->tags);
+    size_t                size =
+        sizeof(modbus_decode_plan_t) + n_step * sizeof(neu_tag_update_t);
+    modbus_decode_plan_t *plan = calloc(1, size);
+    uint16_t              i    = 0;
+
+    plan->n_step       = n_step;
+    plan->steps        = calloc(n_step, sizeof(decode_step_t));
+    plan->runs         = calloc(n_step, sizeof(decode_run_t));
+    plan->swapped      = calloc(cmd->n_register * 2 + 1, sizeof(uint8_t));
+    plan->endianess    = endianess;
+    plan->endianess_64 = endianess_64;
+    plan->shuffle      = shuffle_select();
+
+    utarray_foreach(cmd->tags, modbus_point_t **, p_tag)
+    {
+        compile_step(&plan->steps[i], *p_tag, cmd);
+        plan->values[i].tag = (*p_tag)->name;
+        i += 1;
+    }
+    compile_runs(plan);
+
+    return plan;
+}
+
+void modbus_decode_plan_free(modbus_decode_plan_t *plan)
+{
+    if (plan != NULL) {
+        free(plan->steps);
+        free(plan->runs);
+        free(plan->swapped);
+        free(plan);
+    }
+}
+
+uint16_t modbus_decode_plan_runs(const modbus_decode_plan_t *plan)
+{
+    return plan->n_run;
+}
+
+// a point decoded by itself, the way a read was decoded before the plans
+static void decode_generic(const modbus_decode_plan_t *plan,
+                           const decode_step_t *step, const uint8_t *bytes,
+                           uint16_t n_byte, neu_dvalue_t *dvalue)
+{
+    const modbus_point_t *point = step->point;
+
+    switch (point->area) {
+    case MODBUS_AREA_HOLD_REGISTER:
+    case MODBUS_AREA_INPUT_REGISTER:
+        if (n_byte >= step->end) {
+            memcpy(dvalue->value.bytes.bytes, bytes + step->offset,
+                   point->n_register * 2);
+            dvalue->value.bytes.length = point->n_register * 2;
+        }
+        break;
+    case MODBUS_AREA_COIL:
+    case MODBUS_AREA_INPUT:
+        if (n_byte >= step->end) {
+            neu_value8_u u8 = { .value = bytes[step->offset / 8] };
+
+            dvalue->value.u8 = neu_value8_get_bit(u8, step->offset % 8);
+        }
+        break;
+    }
+
+    switch (point->type) {
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_INT16:
+        dvalue->value.u16 = ntohs(dvalue->value.u16);
+        break;
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+        if (point->option.value32.is_default) {
+            modbus_convert_endianess(&dvalue->value, plan->endianess);
+        }
+        dvalue->value.u32 = ntohl(dvalue->value.u32);
+        break;
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+        if (point->option.value64.is_default) {
+            modbus_convert_endianess_64(&dvalue->value, plan->endianess_64);
+        }
+        dvalue->value.u64 = neu_ntohll(dvalue->value.u64);
+        break;
+    case NEU_TYPE_STRING:
+        if (point->option.string.type == NEU_DATATAG_STRING_TYPE_L) {
+            neu_datatag_string_ltoh(dvalue->value.str,
+                                    strlen(dvalue->value.str));
+        }
+
+        if (!neu_datatag_string_is_utf8(dvalue->value.str,
+                                        strlen(dvalue->value.str))) {
+            dvalue->value.str[0] = '?';
+            dvalue->value.str[1] = 0;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+const neu_tag_update_t *
+modbus_decode_plan_run(modbus_decode_plan_t *plan, uint8_t slave_id,
+                       const uint8_t *bytes, uint16_t n_byte,
+                       uint16_t *n_value)
+{
+    for (uint16_t i = 0; i < plan->n_run; i++) {
+        const decode_run_t *run = &plan->runs[i];
+        uint16_t            len = 0;
+
+        if (run->offset < n_byte) {
+            len = n_byte - run->offset < run->length ? n_byte - run->offset
+                                                     : run->length;
+            len -= len % run->width;
+            plan->shuffle(plan->swapped + run->offset, bytes + run->offset,
+                          len, run->mask);
+        }
+    }
+
+    /*
+     * A value only ever sets the fields of its own kind on top of a zeroed
+     * value, so clearing those fields is enough to start from zero again.
+     */
+    for (uint16_t i = 0; i < plan->n_step; i++) {
+        const decode_step_t *step   = &plan->steps[i];
+        neu_dvalue_t *       dvalue = &plan->values[i].value;
+
+        if (step->op == DECODE_GENERIC) {
+            memset(&dvalue->value, 0, sizeof(dvalue->value));
+        } else {
+            dvalue->value.u64          = 0;
+            dvalue->value.bytes.length = 0;
+        }
+        if (step->op == DECODE_FAIL || step->slave_id != slave_id) {
+            dvalue->type      = NEU_TYPE_ERROR;
+            dvalue->value.i32 = NEU_ERR_PLUGIN_READ_FAILURE;
+            continue;
+        }
+
+        dvalue->type = step->point->type;
+        if (n_byte < step->end && step->op != DECODE_GENERIC) {
+            continue;
+        }
+
+        switch (step->op) {
+        case DECODE_SWAP:
+            memcpy(&dvalue->value, plan->swapped + step->offset, step->width);
+            dvalue->value.bytes.length = step->width;
+            break;
+        case DECODE_REG_BIT: {
+            neu_value16_u v16 = { 0 };
+
+            v16.value = (uint16_t)(bytes[step->offset] << 8 |
+                                   bytes[step->offset + 1]);
+            dvalue->value.u8 = neu_value16_get_bit(v16, step->bit);
+            break;
+        }
+        case DECODE_COIL: {
+            neu_value8_u u8 = { .value = bytes[step->offset / 8] };
+
+            dvalue->value.u8 = neu_value8_get_bit(u8, step->offset % 8);
+            break;
+        }
+        default:
+            decode_generic(plan, step, bytes, n_byte, dvalue);
+            break;
+        }
+    }
+
+    *n_value = plan->n_step;
+    return plan->values;
+}
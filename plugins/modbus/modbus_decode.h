@@ -0,0 +1,68 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_PLUGIN_MODBUS_DECODE_H_
+#define _NEU_PLUGIN_MODBUS_DECODE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include <neuron.h>
+
+#include "modbus_point.h"
+
+/*
+ * Decode plan of a read command.
+ *
+ * The plan is compiled once when a group is planned. Each point of the
+ * command gets the offset of its value in the response data, its width, the
+ * byte shuffle turning the registers into a host value, folding the endianess
+ * of the node and of the tag, and its slot in the decoded values. Values of
+ * the same width and shuffle laid out back to back form a run, a run is
+ * swapped in one pass, 16 bytes at a time with a SIMD byte shuffle when the
+ * cpu has one.
+ */
+typedef struct modbus_decode_plan modbus_decode_plan_t;
+
+modbus_decode_plan_t *modbus_decode_plan_new(const modbus_read_cmd_t *cmd,
+                                             modbus_endianess    endianess,
+                                             modbus_endianess_64 endianess_64);
+void                  modbus_decode_plan_free(modbus_decode_plan_t *plan);
+
+// runs of values swapped in one pass
+uint16_t modbus_decode_plan_runs(const modbus_decode_plan_t *plan);
+
+/*
+ * Decode the response data of the command from slave_id, the values are
+ * valid until the next decode.
+ *
+ * @return the values of the points of the command, in their order.
+ */
+const neu_tag_update_t *
+modbus_decode_plan_run(modbus_decode_plan_t *plan, uint8_t slave_id,
+                       const uint8_t *bytes, uint16_t n_byte,
+                       uint16_t *n_value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,174 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdlib.h>
+#include <string.h>
+
+#include "modbus_health.h"
+
+#define MODBUS_SLAVES 256
+
+// waits are never doubled more often than this
+#define MAX_BACKOFF 16
+
+struct modbus_health {
+    uint16_t degrade_cycle;
+    uint32_t wait_ms;
+    uint32_t max_wait_ms;
+    uint8_t  jitter;
+    uint32_t seed;
+
+    modbus_slave_health_t slaves[MODBUS_SLAVES];
+};
+
+modbus_health_t *modbus_health_new(void)
+{
+    modbus_health_t *health = calloc(1, sizeof(modbus_health_t));
+
+    health->degrade_cycle = 1;
+    health->seed          = (uint32_t)(uintptr_t) health | 1;
+    return health;
+}
+
+void modbus_health_free(modbus_health_t *health)
+{
+    free(health);
+}
+
+void modbus_health_config(modbus_health_t *health, uint16_t degrade_cycle,
+                          uint32_t wait_ms, uint32_t max_wait_ms,
+                          uint8_t jitter)
+{
+    health->degrade_cycle = degrade_cycle > 0 ? degrade_cycle : 1;
+    health->wait_ms       = wait_ms;
+    health->max_wait_ms   = max_wait_ms > wait_ms ? max_wait_ms : wait_ms;
+    health->jitter        = jitter > 100 ? 100 : jitter;
+    memset(health->slaves, 0, sizeof(health->slaves));
+}
+
+void modbus_health_seed(modbus_health_t *health, uint32_t seed)
+{
+    health->seed = seed != 0 ? seed : 1;
+}
+
+const modbus_slave_health_t *modbus_health_get(const modbus_health_t *health,
+                                               uint8_t                slave_id)
+{
+    return &health->slaves[slave_id];
+}
+
+// xorshift32
+static uint32_t health_random(modbus_health_t *health)
+{
+    uint32_t x = health->seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    health->seed = x;
+    return x;
+}
+
+static int64_t health_wait(modbus_health_t *health, uint16_t backoff)
+{
+    uint64_t wait = (uint64_t) health->wait_ms << backoff;
+
+    if (wait > health->max_wait_ms) {
+        wait = health->max_wait_ms;
+    }
+
+    if (health->jitter > 0 && wait > 0) {
+        uint64_t range = wait * health->jitter / 100;
+        uint64_t delta = health_random(health) % (2 * range + 1);
+
+        wait = wait - range + delta;
+    }
+
+    return (int64_t) wait;
+}
+
+bool modbus_health_usable(modbus_health_t *health, uint8_t slave_id,
+                          int64_t now)
+{
+    modbus_slave_health_t *slave = &health->slaves[slave_id];
+
+    switch (slave->state) {
+    case MODBUS_SLAVE_UP:
+        return true;
+    case MODBUS_SLAVE_DOWN:
+    case MODBUS_SLAVE_PROBE:
+        // a probe that got no verdict is retried after another wait
+        if (now >= slave->probe_ms) {
+            slave->state    = MODBUS_SLAVE_PROBE;
+            slave->probe_ms = now + health_wait(health, slave->backoff);
+            return true;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void modbus_health_success(modbus_health_t *health, uint8_t slave_id)
+{
+    memset(&health->slaves[slave_id], 0, sizeof(modbus_slave_health_t));
+}
+
+int64_t modbus_health_failure(modbus_health_t *health, uint8_t slave_id,
+                              int64_t now)
+{
+    modbus_slave_health_t *slave = &health->slaves[slave_id];
+    int64_t                wait  = 0;
+
+    switch (slave->state) {
+    case MODBUS_SLAVE_UP:
+        slave->failed_cycles += 1;
+        if (slave->failed_cycles < health->degrade_cycle) {
+            return 0;
+        }
+        slave->failed_cycles = 0;
+        slave->backoff       = 0;
+        break;
+    case MODBUS_SLAVE_PROBE:
+        if (slave->backoff < MAX_BACKOFF) {
+            slave->backoff += 1;
+        }
+        break;
+    case MODBUS_SLAVE_DOWN:
+        // a late failure of a command sent before the slave went down
+        return 0;
+    }
+
+    wait            = health_wait(health, slave->backoff);
+    slave->state    = MODBUS_SLAVE_DOWN;
+    slave->probe_ms = now + wait;
+    return wait;
+}
+
+uint16_t modbus_health_down(const modbus_health_t *health)
+{
+    uint16_t n = 0;
+
+    for (int i = 0; i < MODBUS_SLAVES; i++) {
+        if (health->slaves[i].state != MODBUS_SLAVE_UP) {
+            n += 1;
+        }
+    }
+
+    return n;
+}
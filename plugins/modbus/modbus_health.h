@@ -0,0 +1,97 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_PLUGIN_MODBUS_HEALTH_H_
+#define _NEU_PLUGIN_MODBUS_HEALTH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Health records of the slaves of a node.
+ *
+ * A slave that does not respond for degrade_cycle cycles is taken down and
+ * skipped. Once its wait is over the next read command of the slave is sent
+ * as a probe, a response brings the slave back, no response takes it down
+ * again for twice the wait, up to the max wait. Waits are stretched or
+ * shortened at random by up to jitter percent, so that slaves that went down
+ * together are not probed together.
+ *
+ * Time is passed in by the caller, nothing runs in the background.
+ */
+typedef enum modbus_slave_state {
+    MODBUS_SLAVE_UP = 0,
+    MODBUS_SLAVE_DOWN,
+    MODBUS_SLAVE_PROBE, // a probe is in flight
+} modbus_slave_state_e;
+
+typedef struct modbus_slave_health {
+    modbus_slave_state_e state;
+    uint16_t             failed_cycles;
+    uint16_t             backoff;  // the wait is doubled backoff times
+    int64_t              probe_ms; // next probe, or its deadline if probing
+} modbus_slave_health_t;
+
+typedef struct modbus_health modbus_health_t;
+
+modbus_health_t *modbus_health_new(void);
+void             modbus_health_free(modbus_health_t *health);
+
+/*
+ * Set the thresholds and bring all slaves up.
+ *
+ * @param wait_ms     wait before the first probe of a slave taken down.
+ * @param max_wait_ms the wait is never doubled beyond this.
+ * @param jitter      percent of random change of each wait, 0 to 100.
+ */
+void modbus_health_config(modbus_health_t *health, uint16_t degrade_cycle,
+                          uint32_t wait_ms, uint32_t max_wait_ms,
+                          uint8_t jitter);
+void modbus_health_seed(modbus_health_t *health, uint32_t seed);
+
+const modbus_slave_health_t *modbus_health_get(const modbus_health_t *health,
+                                               uint8_t                slave_id);
+
+/*
+ * Whether a read command may be sent to a slave, the command is the probe
+ * of a down slave whose wait is over.
+ */
+bool modbus_health_usable(modbus_health_t *health, uint8_t slave_id,
+                          int64_t now);
+void modbus_health_success(modbus_health_t *health, uint8_t slave_id);
+/*
+ * Count a cycle without response of a slave.
+ *
+ * @return milliseconds until the next probe if the slave was taken down,
+ *         0 otherwise.
+ */
+int64_t modbus_health_failure(modbus_health_t *health, uint8_t slave_id,
+                              int64_t now);
+
+// number of slaves down or being probed
+uint16_t modbus_health_down(const modbus_health_t *health);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include "modbus_pace.h"
+
+void modbus_pace_init(modbus_pace_t *pace, uint32_t interval_ms,
+                      uint32_t burst)
+{
+    pace->interval_ms = interval_ms;
+    pace->burst       = burst > 0 ? burst : 1;
+    pace->credit_ms   = (int64_t) interval_ms * pace->burst;
+    pace->last_ms     = 0;
+}
+
+static void pace_refill(modbus_pace_t *pace, int64_t now)
+{
+    int64_t max = (int64_t) pace->interval_ms * pace->burst;
+
+    if (now > pace->last_ms) {
+        pace->credit_ms += now - pace->last_ms;
+        pace->last_ms = now;
+    }
+    if (pace->credit_ms > max) {
+        pace->credit_ms = max;
+    }
+}
+
+int64_t modbus_pace_wait(modbus_pace_t *pace, int64_t now)
+{
+    if (pace->interval_ms == 0) {
+        return 0;
+    }
+
+    pace_refill(pace, now);
+    return pace->credit_ms >= pace->interval_ms
+        ? 0
+        : pace->interval_ms - pace->credit_ms;
+}
+
+void modbus_pace_take(modbus_pace_t *pace, int64_t now)
+{
+    if (pace->interval_ms == 0) {
+        return;
+    }
+
+    pace_refill(pace, now);
+    pace->credit_ms -= pace->interval_ms;
+    if (pace->credit_ms < 0) {
+        pace->credit_ms = 0;
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_PLUGIN_MODBUS_PACE_H_
+#define _NEU_PLUGIN_MODBUS_PACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Token bucket pacing the requests to a device.
+ *
+ * A token is refilled every interval and up to burst tokens are held. A token
+ * is taken when an exchange completes, so that the device gets interval of
+ * silence after its response before the next request, as with a fixed gap,
+ * while time spent elsewhere already counts towards the gap.
+ */
+typedef struct modbus_pace {
+    uint32_t interval_ms;
+    uint32_t burst;
+    int64_t  credit_ms; // tokens held, in milliseconds of refill
+    int64_t  last_ms;
+} modbus_pace_t;
+
+// an interval of 0 never waits
+void modbus_pace_init(modbus_pace_t *pace, uint32_t interval_ms,
+                      uint32_t burst);
+// milliseconds until a token is available, 0 if one is
+int64_t modbus_pace_wait(modbus_pace_t *pace, int64_t now);
+void    modbus_pace_take(modbus_pace_t *pace, int64_t now);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
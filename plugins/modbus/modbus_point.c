@@ -25,12 +25,16 @@
 struct modbus_sort_ctx {
     uint16_t start;
     uint16_t end;
+    uint32_t gap_byte;
 };
 
-static __thread uint16_t modbus_read_max_byte = 250;
+static __thread uint16_t                  modbus_read_max_byte = 250;
+static __thread const modbus_read_plan_t *modbus_read_plan     = NULL;
 
 static int  tag_cmp(neu_tag_sort_elem_t *tag1, neu_tag_sort_elem_t *tag2);
 static bool tag_sort(neu_tag_sort_t *sort, void *tag, void *tag_to_be_sorted);
+static bool tag_bridge(const struct modbus_sort_ctx *ctx,
+                       const modbus_point_t *t2, uint32_t *gap_byte);
 static int  tag_cmp_write(neu_tag_sort_elem_t *tag1, neu_tag_sort_elem_t *tag2);
 static bool tag_sort_write(neu_tag_sort_t *sort, void *tag,
                            void *tag_to_be_sorted);
@@ -213,17 +217,117 @@ int modbus_write_tag_to_point(const neu_plugin_tag_value_t *tag,
     return ret;
 }
 
-modbus_read_cmd_sort_t *modbus_tag_sort(UT_array *tags, uint16_t max_byte)
+static int plan_address(uint32_t address, modbus_address_base address_base,
+                        uint32_t *out)
+{
+    if (address > 65536) {
+        return -1;
+    }
+
+    if (address == 65536 && address_base == 0) {
+        *out = 65535;
+    } else if (address == 0 && address_base == 1) {
+        *out = 0;
+    } else {
+        *out = (uint16_t) address - address_base;
+    }
+
+    return 0;
+}
+
+int modbus_read_plan_forbid(modbus_read_plan_t *plan, const char *ranges,
+                            modbus_address_base address_base)
+{
+    char *dup   = strdup(ranges);
+    char *saved = NULL;
+    int   ret   = 0;
+
+    free(plan->forbidden);
+    plan->forbidden   = NULL;
+    plan->n_forbidden = 0;
+
+    for (char *tok = strtok_r(dup, ",", &saved); tok != NULL;
+         tok       = strtok_r(NULL, ",", &saved)) {
+        modbus_range_t range = { 0 };
+        uint32_t       start = 0, end = 0;
+        char           area = 0, end_area = 0;
+
+        if (sscanf(tok, " %hhu!%c%u-%c%u", &range.slave_id, &area, &start,
+                   &end_area, &end) != 5 ||
+            end_area != area ||
+            plan_address(start, address_base, &range.start) != 0 ||
+            plan_address(end, address_base, &range.end) != 0 ||
+            range.end < range.start) {
+            ret = -1;
+            break;
+        }
+
+        switch (area) {
+        case '0':
+            range.area = MODBUS_AREA_COIL;
+            break;
+        case '1':
+            range.area = MODBUS_AREA_INPUT;
+            break;
+        case '3':
+            range.area = MODBUS_AREA_INPUT_REGISTER;
+            break;
+        case '4':
+            range.area = MODBUS_AREA_HOLD_REGISTER;
+            break;
+        default:
+            ret = -1;
+            break;
+        }
+        if (ret != 0) {
+            break;
+        }
+
+        range.end += 1;
+        plan->forbidden = realloc(plan->forbidden,
+                                  (plan->n_forbidden + 1) * sizeof(range));
+        plan->forbidden[plan->n_forbidden++] = range;
+    }
+
+    free(dup);
+    if (ret != 0) {
+        modbus_read_plan_fini(plan);
+    }
+    return ret;
+}
+
+void modbus_read_plan_fini(modbus_read_plan_t *plan)
+{
+    free(plan->forbidden);
+    plan->forbidden   = NULL;
+    plan->n_forbidden = 0;
+}
+
+uint32_t modbus_read_plan_max_gap(const modbus_read_plan_t *plan)
+{
+    if (plan == NULL || plan->rtt == 0) {
+        return 0;
+    }
+
+    // bytes the link transfers during one round trip, plus the framing saved
+    return (uint32_t)((uint64_t) plan->rtt * plan->bandwidth / 1000) +
+        plan->overhead;
+}
+
+modbus_read_cmd_sort_t *modbus_tag_sort(UT_array *tags, uint16_t max_byte,
+                                        const modbus_read_plan_t *plan)
 {
     modbus_read_max_byte          = max_byte;
+    modbus_read_plan              = plan;
     neu_tag_sort_result_t *result = neu_tag_sort(tags, tag_sort, tag_cmp);
+    modbus_read_plan              = NULL;
 
     modbus_read_cmd_sort_t *sort_result =
         calloc(1, sizeof(modbus_read_cmd_sort_t));
     sort_result->n_cmd = result->n_sort;
     sort_result->cmd   = calloc(result->n_sort, sizeof(modbus_read_cmd_t));
 
-    for (uint16_t i = 0; i < result->n_sort; i++) {
+    for (uint32_t i = 0; i < result->n_sort; i++) {
         modbus_point_t *tag =
             *(modbus_point_t **) utarray_front(result->sorts[i].tags);
         struct modbus_sort_ctx *ctx = result->sorts[i].info.context;
@@ -234,6 +338,18 @@ modbus_read_cmd_sort_t *modbus_tag_sort(UT_array *tags, uint16_t max_byte)
         sort_result->cmd[i].start_address = tag->start_address;
         sort_result->cmd[i].n_register    = ctx->end - ctx->start;
 
+        switch (tag->area) {
+        case MODBUS_AREA_COIL:
+        case MODBUS_AREA_INPUT:
+            sort_result->n_byte += (sort_result->cmd[i].n_register + 7) / 8;
+            break;
+        case MODBUS_AREA_INPUT_REGISTER:
+        case MODBUS_AREA_HOLD_REGISTER:
+            sort_result->n_byte += sort_result->cmd[i].n_register * 2;
+            break;
+        }
+        sort_result->n_gap_byte += ctx->gap_byte;
+
         free(result->sorts[i].info.context);
     }
 
@@ -312,7 +428,7 @@ modbus_write_tags_sort(UT_array *tags, modbus_endianess endianess,
         calloc(1, sizeof(modbus_write_cmd_sort_t));
     sort_result->n_cmd = result->n_sort;
     sort_result->cmd   = calloc(result->n_sort, sizeof(modbus_write_cmd_t));
-    for (uint16_t i = 0; i < result->n_sort; i++) {
+    for (uint32_t i = 0; i < result->n_sort; i++) {
         modbus_point_write_t *tag =
             *(modbus_point_write_t **) utarray_front(result->sorts[i].tags);
         struct modbus_sort_ctx *ctx = result->sorts[i].info.context;
@@ -367,7 +483,7 @@ modbus_write_tags_sort(UT_array *tags, modbus_endianess endianess,
 
 void modbus_tag_sort_free(modbus_read_cmd_sort_t *cs)
 {
-    for (uint16_t i = 0; i < cs->n_cmd; i++) {
+    for (uint32_t i = 0; i < cs->n_cmd; i++) {
         utarray_free(cs->cmd[i].tags);
     }
 
@@ -431,21 +547,26 @@ static bool tag_sort(neu_tag_sort_t *sort, void *tag, void *tag_to_be_sorted)
         return false;
     }
 
+    uint32_t gap      = 0;
+    uint32_t gap_byte = 0;
     if (t2->start_address > ctx->end) {
-        return false;
+        if (!tag_bridge(ctx, t2, &gap_byte)) {
+            return false;
+        }
+        gap = t2->start_address - ctx->end;
     }
 
     switch (t1->area) {
     case MODBUS_AREA_COIL:
     case MODBUS_AREA_INPUT:
-        if ((ctx->end - ctx->start + 7) / 8 >= modbus_read_max_byte) {
+        if ((ctx->end + gap - ctx->start + 7) / 8 >= modbus_read_max_byte) {
             return false;
         }
         break;
     case MODBUS_AREA_INPUT_REGISTER:
     case MODBUS_AREA_HOLD_REGISTER: {
-        uint16_t now_bytes = (ctx->end - ctx->start) * 2;
-        uint16_t add_now   = now_bytes + t2->n_register * 2;
+        uint32_t now_bytes = (ctx->end - ctx->start + gap) * 2;
+        uint32_t add_now   = now_bytes + t2->n_register * 2;
         if (add_now >= modbus_read_max_byte) {
             return false;
         }
@@ -457,6 +578,54 @@ static bool tag_sort(neu_tag_sort_t *sort, void *tag, void *tag_to_be_sorted)
     if (t2->start_address + t2->n_register > ctx->end) {
         ctx->end = t2->start_address + t2->n_register;
     }
+    ctx->gap_byte += gap_byte;
+
+    return true;
+}
+
+/*
+ * Whether the hole between a command and the point behind it is worth
+ * reading along, the extra bytes of the command are set to gap_byte.
+ */
+static bool tag_bridge(const struct modbus_sort_ctx *ctx,
+                       const modbus_point_t *t2, uint32_t *gap_byte)
+{
+    const modbus_read_plan_t *plan = modbus_read_plan;
+    uint32_t                  end  = t2->start_address + t2->n_register;
+
+    if (plan == NULL || plan->rtt == 0) {
+        return false;
+    }
+
+    switch (t2->area) {
+    case MODBUS_AREA_COIL:
+    case MODBUS_AREA_INPUT: {
+        // bits are packed, a small hole may not cost a byte at all
+        uint32_t now    = (ctx->end - ctx->start + 7) / 8;
+        uint32_t merged = (end - ctx->start + 7) / 8;
+        uint32_t alone  = (t2->n_register + 7) / 8;
+
+        *gap_byte = merged > now + alone ? merged - now - alone : 0;
+        break;
+    }
+    case MODBUS_AREA_INPUT_REGISTER:
+    case MODBUS_AREA_HOLD_REGISTER:
+        *gap_byte = (t2->start_address - ctx->end) * 2;
+        break;
+    }
+
+    if (*gap_byte >= modbus_read_plan_max_gap(plan)) {
+        return false;
+    }
+
+    for (uint16_t i = 0; i < plan->n_forbidden; i++) {
+        const modbus_range_t *range = &plan->forbidden[i];
+
+        if (range->slave_id == t2->slave_id && range->area == t2->area &&
+            range->start < t2->start_address && range->end > ctx->end) {
+            return false;
+        }
+    }
 
     return true;
 }
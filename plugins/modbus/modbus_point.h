@@ -61,10 +61,47 @@ typedef struct modbus_read_cmd {
 } modbus_read_cmd_t;
 
 typedef struct modbus_read_cmd_sort {
-    uint16_t           n_cmd;
+    uint32_t           n_cmd;
     modbus_read_cmd_t *cmd;
+
+    uint32_t n_byte;     // response data bytes of all commands
+    uint32_t n_gap_byte; // response data bytes read only to bridge holes
 } modbus_read_cmd_sort_t;
 
+typedef struct modbus_range {
+    uint8_t       slave_id;
+    modbus_area_e area;
+    uint32_t      start;
+    uint32_t      end; // exclusive
+} modbus_range_t;
+
+/*
+ * Cost model of the read planner of a node.
+ *
+ * Points that are not contiguous are read by one command, bridging the hole
+ * between them, when transferring the hole takes less time than the round
+ * trip and the framing of one more command. Holes overlapping a forbidden
+ * range, registers the device refuses to read, are never bridged.
+ */
+typedef struct modbus_read_plan {
+    uint32_t rtt;       // round trip of a command in ms, 0 never bridges
+    uint32_t bandwidth; // bytes per second of the link
+    uint16_t overhead;  // framing bytes of a request and its response
+
+    uint16_t        n_forbidden;
+    modbus_range_t *forbidden;
+} modbus_read_plan_t;
+
+/*
+ * Parse forbidden ranges, separated by ',', in the address format of tags:
+ * "1!400100-400199" forbids holding registers 400100 to 400199 of slave 1.
+ */
+int  modbus_read_plan_forbid(modbus_read_plan_t *plan, const char *ranges,
+                             modbus_address_base address_base);
+void modbus_read_plan_fini(modbus_read_plan_t *plan);
+// the biggest number of extra bytes worth reading to save a command
+uint32_t modbus_read_plan_max_gap(const modbus_read_plan_t *plan);
+
 typedef struct modbus_write_cmd {
     uint8_t       slave_id;
     modbus_area_e area;
@@ -77,11 +114,16 @@ typedef struct modbus_write_cmd {
 } modbus_write_cmd_t;
 
 typedef struct modbus_write_cmd_sort {
-    uint16_t            n_cmd;
+    uint32_t            n_cmd;
     modbus_write_cmd_t *cmd;
 } modbus_write_cmd_sort_t;
 
-modbus_read_cmd_sort_t *modbus_tag_sort(UT_array *tags, uint16_t max_byte);
+/*
+ * Group points into read commands of at most max_byte response data bytes,
+ * plan is NULL to only merge contiguous or overlapping points.
+ */
+modbus_read_cmd_sort_t *modbus_tag_sort(UT_array *tags, uint16_t max_byte,
+                                        const modbus_read_plan_t *plan);
 modbus_write_cmd_sort_t *
      modbus_write_tags_sort(UT_array *tags, modbus_endianess endianess,
                             modbus_endianess_64 endianess_64);
@@ -18,6 +18,7 @@
  **/
 #include <time.h>
 
+#include "modbus_decode.h"
 #include "modbus_point.h"
 #include "modbus_stack.h"
 
@@ -25,27 +26,60 @@
 
 #define MAX_SLAVES 256
 
-uint8_t failed_cycles[MAX_SLAVES];
-bool    skip[MAX_SLAVES];
+// a sequential read cycle, stepped between the waits of the request spacing
+// and of the resends
+typedef struct {
+    bool     running;
+    bool     admitted; // the next command passed the slave checks
+    uint32_t next;     // index of the next command
+    uint16_t retries;  // resends of the next command so far
+    int64_t  due_ms;   // resend time of the next command
+    int64_t  rtt;
+    bool     windowed; // pipelined on the windows of the links, tcp only
+    bool     started;  // the windows of the links were set up
+    bool     slave_err_record[MAX_SLAVES];
+} modbus_cycle_t;
+
+// a test read, sent once the pace allows
+typedef struct {
+    void *         req;
+    modbus_point_t point;
+} modbus_test_read_t;
+
+static const UT_icd test_read_icd = { sizeof(modbus_test_read_t), NULL, NULL,
+                                      NULL };
 
 struct modbus_group_data {
     UT_array *              tags;
     char *                  group;
     modbus_read_cmd_sort_t *cmd_sort;
+    modbus_decode_plan_t ** decode; // decode plan of each command
     modbus_address_base     address_base;
-};
+    uint32_t                plan_version;
 
-struct modbus_write_tags_data {
-    UT_array *               tags;
-    modbus_write_cmd_sort_t *cmd_sort;
+    neu_plugin_t *            plugin;
+    neu_plugin_group_t *      grp; // the group of the driver, for read ends
+    modbus_cycle_t            cycle;
+    struct modbus_group_data *prev;
+    struct modbus_group_data *next;
 };
 
 static void plugin_group_free(neu_plugin_group_t *pgp);
+static void group_data_free(struct modbus_group_data *gd);
+static bool    writes_due(neu_plugin_t *plugin, int64_t now);
+static int64_t writes_flush(neu_plugin_t *plugin);
+static int64_t test_reads_run(neu_plugin_t *plugin);
+static int     cycle_timer_cb(void *usr_data);
 static int  process_protocol_buf(neu_plugin_t *plugin, uint8_t slave_id,
                                  uint16_t response_size);
 static int  process_protocol_buf_test(neu_plugin_t *plugin, void *req,
                                       modbus_point_t *point,
                                       uint16_t        response_size);
+static int  process_received_data(neu_plugin_t *plugin, uint8_t *recv_buf,
+                                  ssize_t recv_size, uint16_t expected_size,
+                                  uint8_t slave_id);
+static int  valid_modbus_tcp_response(neu_plugin_t *plugin, uint8_t *recv_buf,
+                                      uint16_t response_size);
 
 static void
 convert_point_endianess_64_for_test(neu_value_u *value, modbus_point_t *point,
@@ -143,12 +177,121 @@ int modbus_tcp_server_io_callback(enum neu_event_io_type type, int fd,
     return 0;
 }
 
+static void link_connected(void *data, int fd)
+{
+    plog_notice((neu_plugin_t *) data, "link connected, fd: %d", fd);
+}
+
+static void link_disconnected(void *data, int fd)
+{
+    plog_notice((neu_plugin_t *) data, "link disconnected, fd: %d", fd);
+}
+
+// the conn of the current link
+static neu_conn_t *link_conn(neu_plugin_t *plugin)
+{
+    return plugin->link == 0 ? plugin->conn : plugin->links[plugin->link].conn;
+}
+
+// take a turn on the serial line before an exchange, if it is shared
+static void bus_acquire(neu_plugin_t *plugin)
+{
+    if (plugin->bus != NULL) {
+        modbus_bus_acquire(plugin->bus);
+    }
+}
+
+static void bus_release(neu_plugin_t *plugin)
+{
+    if (plugin->bus != NULL) {
+        modbus_bus_release(plugin->bus);
+    }
+}
+
+static uint16_t link_of(const neu_plugin_t *plugin, uint8_t slave_id)
+{
+    return plugin->n_link > 1 ? slave_id % plugin->n_link : 0;
+}
+
+static void links_reconfig(neu_plugin_t *plugin, neu_conn_param_t *param)
+{
+    for (uint16_t i = 1; i < plugin->n_link; i++) {
+        plugin->links[i].conn = neu_conn_reconfig(plugin->links[i].conn, param);
+    }
+}
+
+void modbus_links_config(neu_plugin_t *plugin, uint16_t n_link,
+                         neu_conn_param_t *param)
+{
+    uint16_t n_old = plugin->n_link;
+
+    n_link = n_link > 0 ? n_link : 1;
+
+    for (uint16_t i = n_link; i < n_old; i++) {
+        neu_event_del_io(plugin->events, plugin->links[i].io);
+        neu_conn_destory(plugin->links[i].conn);
+        modbus_window_free(plugin->links[i].window);
+    }
+
+    plugin->links  = realloc(plugin->links, n_link * sizeof(modbus_link_t));
+    plugin->n_link = n_link < n_old ? n_link : n_old;
+    links_reconfig(plugin, param);
+
+    for (uint16_t i = n_old; i < n_link; i++) {
+        memset(&plugin->links[i], 0, sizeof(modbus_link_t));
+        if (i > 0) {
+            plugin->links[i].conn = neu_conn_new(
+                param, (void *) plugin, link_connected, link_disconnected);
+        }
+    }
+
+    plugin->links[0].conn = plugin->conn;
+    plugin->n_link        = n_link;
+    plugin->link          = 0;
+}
+
+void modbus_links_start(neu_plugin_t *plugin)
+{
+    for (uint16_t i = 1; i < plugin->n_link; i++) {
+        neu_conn_start(plugin->links[i].conn);
+    }
+}
+
+void modbus_links_stop(neu_plugin_t *plugin)
+{
+    for (uint16_t i = 1; i < plugin->n_link; i++) {
+        neu_conn_stop(plugin->links[i].conn);
+    }
+}
+
+void modbus_links_free(neu_plugin_t *plugin)
+{
+    for (uint16_t i = 0; i < plugin->n_link; i++) {
+        if (i > 0) {
+            neu_conn_destory(plugin->links[i].conn);
+        }
+        modbus_window_free(plugin->links[i].window);
+    }
+
+    free(plugin->links);
+    plugin->links  = NULL;
+    plugin->n_link = 0;
+}
+
 int modbus_send_msg(void *ctx, uint16_t n_byte, uint8_t *bytes)
 {
-    neu_plugin_t *plugin = (neu_plugin_t *) ctx;
-    int           ret    = 0;
+    neu_plugin_t *   plugin = (neu_plugin_t *) ctx;
+    modbus_window_t *window = NULL;
+    int              ret    = 0;
 
-    neu_conn_clear_recv_buffer(plugin->conn);
+    if (plugin->links != NULL) {
+        window = plugin->links[plugin->link].window;
+    }
+
+    // responses of requests in flight are still to be received
+    if (window == NULL || modbus_window_inflight(window) == 0) {
+        neu_conn_clear_recv_buffer(link_conn(plugin));
+    }
 
     plog_send_protocol(plugin, bytes, n_byte);
 
@@ -156,7 +299,9 @@ int modbus_send_msg(void *ctx, uint16_t n_byte, uint8_t *bytes)
         ret = neu_conn_tcp_server_send(plugin->conn, plugin->client_fd, bytes,
                                        n_byte);
     } else {
-        if (plugin->backup && neu_conn_is_connected(plugin->conn) == false) {
+        // the other links follow the primary link to the backup
+        if (plugin->backup && plugin->link == 0 &&
+            neu_conn_is_connected(plugin->conn) == false) {
             if (plugin->current_backup == false && plugin->first_attempt_done) {
                 plog_notice(plugin, "switch to backup ip:port %s:%hu",
                             plugin->param_backup.params.tcp_client.ip,
@@ -164,40 +309,25 @@ int modbus_send_msg(void *ctx, uint16_t n_byte, uint8_t *bytes)
                 plugin->current_backup = true;
                 plugin->conn =
                     neu_conn_reconfig(plugin->conn, &plugin->param_backup);
+                links_reconfig(plugin, &plugin->param_backup);
             } else {
                 plog_notice(plugin, "switch to original ip:port %s:%hu",
                             plugin->param.params.tcp_client.ip,
                             plugin->param.params.tcp_client.port);
                 plugin->current_backup = false;
                 plugin->conn = neu_conn_reconfig(plugin->conn, &plugin->param);
+                links_reconfig(plugin, &plugin->param);
                 plugin->first_attempt_done = true;
             }
         }
-        ret = neu_conn_send(plugin->conn, bytes, n_byte);
+        ret = neu_conn_send(link_conn(plugin), bytes, n_byte);
     }
 
     return ret;
 }
 
-int modbus_stack_read_retry(neu_plugin_t *plugin, struct modbus_group_data *gd,
-                            uint16_t i, uint16_t j, uint16_t *response_size,
-                            uint64_t *read_tms)
-{
-    struct timespec t3 = { .tv_sec = plugin->retry_interval / 1000,
-                           .tv_nsec =
-                               1000 * 1000 * (plugin->retry_interval % 1000) };
-    struct timespec t4 = { 0 };
-    nanosleep(&t3, &t4);
-    plog_notice(plugin, "Resend read req. Times:%hu", j + 1);
-    *read_tms = neu_time_ms();
-    return modbus_stack_read(
-        plugin->stack, gd->cmd_sort->cmd[i].slave_id, gd->cmd_sort->cmd[i].area,
-        gd->cmd_sort->cmd[i].start_address, gd->cmd_sort->cmd[i].n_register,
-        response_size, false);
-}
-
 void handle_modbus_error(neu_plugin_t *plugin, struct modbus_group_data *gd,
-                         uint16_t cmd_index, int error_code,
+                         uint32_t cmd_index, int error_code,
                          const char *error_message)
 {
     modbus_value_handle(plugin, gd->cmd_sort->cmd[cmd_index].slave_id, 0, NULL,
@@ -211,7 +341,7 @@ void handle_modbus_error(neu_plugin_t *plugin, struct modbus_group_data *gd,
 
 void finalize_modbus_read_result(neu_plugin_t *            plugin,
                                  struct modbus_group_data *gd,
-                                 uint16_t cmd_index, int ret_r, int ret_buf,
+                                 uint32_t cmd_index, int ret_r, int ret_buf,
                                  uint64_t read_tms, int64_t *rtt,
                                  bool *slave_err)
 {
@@ -241,208 +371,930 @@ void finalize_modbus_read_result(neu_plugin_t *            plugin,
                                 NEU_ERR_PLUGIN_READ_FAILURE,
                                 "modbus device response error");
             *rtt = neu_time_ms() - read_tms;
+            // an exception response still tells the slave is alive
+            modbus_health_success(plugin->health,
+                                  gd->cmd_sort->cmd[cmd_index].slave_id);
             break;
         default:
             break;
         }
     } else {
         *rtt = neu_time_ms() - read_tms;
-        failed_cycles[gd->cmd_sort->cmd[cmd_index].slave_id] = 0;
+        modbus_health_success(plugin->health,
+                              gd->cmd_sort->cmd[cmd_index].slave_id);
     }
 }
 
-void check_modbus_read_result(neu_plugin_t *            plugin,
-                              struct modbus_group_data *gd, uint16_t cmd_index,
-                              int64_t *rtt, bool *slave_err)
+void update_metrics_after_read(neu_plugin_t *            plugin,
+                               struct modbus_group_data *gd, int64_t rtt)
 {
-    uint16_t response_size = 0;
-    uint64_t read_tms      = neu_time_ms();
+    neu_conn_state_t state = neu_conn_state(plugin->conn);
+    for (uint16_t i = 1; i < plugin->n_link; i++) {
+        neu_conn_state_t link_state = neu_conn_state(plugin->links[i].conn);
 
-    int ret_r = modbus_stack_read(
-        plugin->stack, gd->cmd_sort->cmd[cmd_index].slave_id,
-        gd->cmd_sort->cmd[cmd_index].area,
-        gd->cmd_sort->cmd[cmd_index].start_address,
-        gd->cmd_sort->cmd[cmd_index].n_register, &response_size, false);
-
-    int ret_buf = 0;
-    if (ret_r > 0) {
-        ret_buf = process_protocol_buf(
-            plugin, gd->cmd_sort->cmd[cmd_index].slave_id, response_size);
-    }
-
-    if (ret_r <= 0 || ret_buf == 0) {
-        for (uint16_t j = 0; j < plugin->max_retries; ++j) {
-            ret_r = modbus_stack_read_retry(plugin, gd, cmd_index, j,
-                                            &response_size, &read_tms);
-            if (ret_r > 0) {
-                ret_buf = process_protocol_buf(
-                    plugin, gd->cmd_sort->cmd[cmd_index].slave_id,
-                    response_size);
-                if (ret_buf == 0) {
-                    continue;
-                }
-            }
-            break;
-        }
+        state.send_bytes += link_state.send_bytes;
+        state.recv_bytes += link_state.recv_bytes;
     }
-
-    finalize_modbus_read_result(plugin, gd, cmd_index, ret_r, ret_buf, read_tms,
-                                rtt, slave_err);
-}
-
-void update_metrics_after_read(neu_plugin_t *plugin, int64_t rtt,
-                               neu_plugin_group_t *group,
-                               neu_conn_state_t *  state)
-{
-    *state = neu_conn_state(plugin->conn);
     neu_adapter_update_metric_cb_t update_metric =
         plugin->common.adapter_callbacks->update_metric;
-    struct modbus_group_data *gd =
-        (struct modbus_group_data *) group->user_data;
 
     update_metric(plugin->common.adapter, NEU_METRIC_SEND_BYTES,
-                  state->send_bytes, NULL);
+                  state.send_bytes, NULL);
     update_metric(plugin->common.adapter, NEU_METRIC_RECV_BYTES,
-                  state->recv_bytes, NULL);
+                  state.recv_bytes, NULL);
     update_metric(plugin->common.adapter, NEU_METRIC_LAST_RTT_MS, rtt, NULL);
     update_metric(plugin->common.adapter, NEU_METRIC_GROUP_LAST_SEND_MSGS,
-                  gd->cmd_sort->n_cmd, group->group_name);
+                  gd->cmd_sort->n_cmd, gd->group);
+    update_metric(plugin->common.adapter, NEU_METRIC_GROUP_LAST_GAP_BYTES,
+                  gd->cmd_sort->n_gap_byte, gd->group);
+
+    if (plugin->bus != NULL) {
+        modbus_bus_stats_t stats = { 0 };
+
+        modbus_bus_stats(plugin->bus, &stats);
+        update_metric(plugin->common.adapter, NEU_METRIC_BUS_UTILIZATION,
+                      stats.utilization, NULL);
+        update_metric(plugin->common.adapter, NEU_METRIC_BUS_LAST_WAIT_MS,
+                      stats.wait_ms, NULL);
+        update_metric(plugin->common.adapter, NEU_METRIC_BUS_NODES,
+                      stats.n_member, NULL);
+    }
 }
 
-typedef struct {
-    uint8_t  slave_id;
-    uint16_t degrade_time;
-} degrade_timer_data_t;
+// framing bytes of a read request and its response
+static uint16_t read_overhead(modbus_protocol_e protocol)
+{
+    uint16_t n = sizeof(struct modbus_code) * 2 +
+        sizeof(struct modbus_address) + sizeof(struct modbus_data);
+
+    if (protocol == MODBUS_PROTOCOL_TCP) {
+        n += sizeof(struct modbus_header) * 2;
+    } else {
+        n += sizeof(struct modbus_crc) * 2;
+    }
 
-void *degrade_timer(void *arg)
+    return n;
+}
+
+int modbus_read_plan_config(neu_plugin_t *plugin, const char *config)
 {
-    degrade_timer_data_t *data = (degrade_timer_data_t *) arg;
+    int                ret       = 0;
+    char *             err_param = NULL;
+    modbus_read_plan_t plan      = { 0 };
+    neu_json_elem_t    rtt       = { .name = "plan_rtt", .t = NEU_JSON_INT };
+    neu_json_elem_t    bandwidth = { .name = "plan_bandwidth",
+                                     .t    = NEU_JSON_INT };
+    neu_json_elem_t    forbidden = { .name      = "forbidden_ranges",
+                                     .t         = NEU_JSON_STR,
+                                     .v.val_str = NULL };
+
+    ret = neu_parse_param((char *) config, &err_param, 1, &rtt);
+    if (ret != 0 || rtt.v.val_int < 0) {
+        free(err_param);
+        rtt.v.val_int = 0;
+    }
+
+    ret = neu_parse_param((char *) config, &err_param, 1, &bandwidth);
+    if (ret != 0 || bandwidth.v.val_int < 0) {
+        free(err_param);
+        bandwidth.v.val_int = 0;
+    }
+
+    ret = neu_parse_param((char *) config, &err_param, 1, &forbidden);
+    if (ret != 0) {
+        free(err_param);
+        forbidden.v.val_str = NULL;
+    }
+
+    // the running plan is only replaced once the whole setting is valid
+    ret = modbus_read_plan_forbid(&plan,
+                                  forbidden.v.val_str ? forbidden.v.val_str
+                                                      : "",
+                                  plugin->address_base);
+    if (ret != 0) {
+        plog_error(plugin, "invalid forbidden ranges: %s",
+                   forbidden.v.val_str);
+        free(forbidden.v.val_str);
+        return ret;
+    }
 
-    struct timespec t1 = { .tv_sec = data->degrade_time, .tv_nsec = 0 };
-    struct timespec t2 = { 0 };
-    nanosleep(&t1, &t2);
+    plan.rtt       = rtt.v.val_int;
+    plan.bandwidth = bandwidth.v.val_int;
+    plan.overhead  = read_overhead(plugin->protocol);
 
-    skip[data->slave_id] = false;
+    modbus_read_plan_fini(&plugin->plan);
+    plugin->plan = plan;
+    plugin->plan_version += 1;
 
-    free(data);
-    return NULL;
+    free(forbidden.v.val_str);
+    return 0;
 }
 
-void set_skip_timer(uint8_t slave_id, uint32_t degrade_time)
+static void modbus_slave_degrade(neu_plugin_t *plugin, uint8_t slave_id,
+                                 bool no_response, bool *slave_err_record)
 {
-    degrade_timer_data_t *data =
-        (degrade_timer_data_t *) malloc(sizeof(degrade_timer_data_t));
-    if (data == NULL) {
-        skip[slave_id] = false;
+    if (!plugin->degradation) {
         return;
     }
 
-    data->slave_id     = slave_id;
-    data->degrade_time = degrade_time;
+    if (no_response) {
+        int64_t wait =
+            modbus_health_failure(plugin->health, slave_id, neu_time_ms());
 
-    failed_cycles[slave_id] = 0;
+        slave_err_record[slave_id] = true;
+        if (wait > 0) {
+            plog_warn(plugin, "Skip slave %hhu, probe in %" PRId64 " ms",
+                      slave_id, wait);
+        }
+    }
+}
 
-    pthread_t timer_thread;
-    int       ret = pthread_create(&timer_thread, NULL, degrade_timer, data);
-    if (ret != 0) {
-        free(data);
-        skip[slave_id] = false;
+static int window_send(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                       modbus_txn_t *txn, uint32_t cmd_index, int64_t now)
+{
+    modbus_window_t *  window        = plugin->links[plugin->link].window;
+    modbus_read_cmd_t *cmd           = &gd->cmd_sort->cmd[cmd_index];
+    uint16_t           seq           = modbus_stack_read_seq(plugin->stack);
+    uint16_t           response_size = 0;
+
+    plugin->cmd_idx = cmd_index;
+    int ret = modbus_stack_read(plugin->stack, cmd->slave_id, cmd->area,
+                                cmd->start_address, cmd->n_register,
+                                &response_size, false);
+    if (ret > 0) {
+        modbus_window_sent(window, txn, cmd_index, seq, response_size, now,
+                           plugin->timeout);
+    }
+    modbus_pace_take(&plugin->pace, now);
+
+    return ret;
+}
+
+// give up all transactions and the rest of the cycle of the current link,
+// and drop its connection
+static void window_abort(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                         int error, const char *error_message, int64_t *rtt)
+{
+    modbus_link_t *link    = &plugin->links[plugin->link];
+    modbus_txn_t * txn     = NULL;
+    uint16_t       n_abort = 0;
+
+    while ((txn = modbus_window_expired(link->window, INT64_MAX)) != NULL ||
+           (txn = modbus_window_due(link->window, INT64_MAX)) != NULL) {
+        plugin->cmd_idx = txn->cmd;
+        handle_modbus_error(plugin, gd, txn->cmd, error, NULL);
+        modbus_window_done(link->window, txn);
+        n_abort += 1;
+    }
+    link->next = gd->cmd_sort->n_cmd;
+
+    plog_error(plugin, "%s, abort %hu read reqs in flight on link %hu",
+               error_message, n_abort, plugin->link);
+    *rtt = NEU_METRIC_LAST_RTT_MS_MAX;
+    neu_conn_disconnect(link_conn(plugin));
+
+    // the fd may be reused by the next connection
+    neu_event_del_io(plugin->events, link->io);
+    link->io    = NULL;
+    link->io_fd = -1;
+}
+
+static int window_complete(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                           modbus_txn_t *txn, uint8_t *recv_buf,
+                           ssize_t recv_size, int64_t now, int64_t *rtt)
+{
+    uint32_t cmd_index     = txn->cmd;
+    uint16_t response_size = txn->response_size;
+    uint8_t  slave_id      = gd->cmd_sort->cmd[cmd_index].slave_id;
+
+    *rtt = now - txn->send_ms;
+    modbus_window_done(plugin->links[plugin->link].window, txn);
+
+    plugin->cmd_idx = cmd_index;
+    int ret = process_received_data(plugin, recv_buf, recv_size, response_size,
+                                    slave_id);
+    if (ret > 0) {
+        modbus_health_success(plugin->health, slave_id);
+    } else if (ret == -2) {
+        handle_modbus_error(plugin, gd, cmd_index, NEU_ERR_PLUGIN_READ_FAILURE,
+                            "modbus device response error");
+        modbus_health_success(plugin->health, slave_id);
+    } else {
+        handle_modbus_error(plugin, gd, cmd_index,
+                            NEU_ERR_PLUGIN_PROTOCOL_DECODE_FAILURE, NULL);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void window_expire(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                          modbus_txn_t *txn, int64_t now, int64_t *rtt,
+                          bool *slave_err_record)
+{
+    modbus_window_t *window    = plugin->links[plugin->link].window;
+    uint32_t         cmd_index = txn->cmd;
+    uint8_t          slave_id  = gd->cmd_sort->cmd[cmd_index].slave_id;
+
+    if (txn->retries < plugin->max_retries) {
+        modbus_window_retry(window, txn, now + plugin->retry_interval);
         return;
     }
 
-    pthread_detach(timer_thread);
+    *rtt = now - txn->send_ms;
+    modbus_window_done(window, txn);
+
+    plugin->cmd_idx = cmd_index;
+    handle_modbus_error(plugin, gd, cmd_index,
+                        NEU_ERR_PLUGIN_DEVICE_NOT_RESPONSE,
+                        "no modbus response received");
+    modbus_slave_degrade(plugin, slave_id, true, slave_err_record);
 }
 
-int modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
-                       uint16_t max_byte)
+// send the due resends and the next commands of the current link, pace is
+// set to the wait of the first request the pace held back
+static void window_fill(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                        int64_t now, bool *slave_err_record, int64_t *rtt,
+                        int64_t *pace)
 {
-    neu_conn_state_t          state = { 0 };
-    struct modbus_group_data *gd    = NULL;
-    int64_t                   rtt   = NEU_METRIC_LAST_RTT_MS_MAX;
-    struct modbus_group_data *gdt =
-        (struct modbus_group_data *) group->user_data;
+    modbus_link_t *link = &plugin->links[plugin->link];
+    modbus_txn_t * txn  = NULL;
 
-    if (group->user_data == NULL || gdt->address_base != plugin->address_base) {
-        if (group->user_data != NULL) {
-            plugin_group_free(group);
+    // resends first, they belong to the oldest commands of the cycle
+    while ((txn = modbus_window_due(link->window, now)) != NULL) {
+        if ((*pace = modbus_pace_wait(&plugin->pace, now)) > 0) {
+            return;
         }
-        gd = calloc(1, sizeof(struct modbus_group_data));
+        plog_notice(plugin, "Resend read req. Times:%hu", txn->retries + 1);
+        if (window_send(plugin, gd, txn, txn->cmd, now) <= 0) {
+            window_abort(plugin, gd, NEU_ERR_PLUGIN_DISCONNECTED,
+                         "send message failed", rtt);
+            return;
+        }
+    }
 
-        group->user_data  = gd;
-        group->group_free = plugin_group_free;
-        utarray_new(gd->tags, &ut_ptr_icd);
+    while (link->next < gd->cmd_sort->n_cmd &&
+           (txn = modbus_window_get(link->window)) != NULL) {
+        uint8_t slave_id = gd->cmd_sort->cmd[link->next].slave_id;
 
-        utarray_foreach(group->tags, neu_datatag_t *, tag)
-        {
-            modbus_point_t *p = calloc(1, sizeof(modbus_point_t));
-            int ret = modbus_tag_to_point(tag, p, plugin->address_base);
-            if (ret != NEU_ERR_SUCCESS) {
-                plog_error(plugin, "invalid tag: %s, address: %s", tag->name,
-                           tag->address);
-            }
+        if (link_of(plugin, slave_id) != plugin->link ||
+            slave_err_record[slave_id] ||
+            (plugin->degradation &&
+             !modbus_health_usable(plugin->health, slave_id, now))) {
+            link->next += 1;
+            continue;
+        }
 
-            utarray_push_back(gd->tags, &p);
+        if ((*pace = modbus_pace_wait(&plugin->pace, now)) > 0) {
+            return;
+        }
+        if (window_send(plugin, gd, txn, link->next, now) <= 0) {
+            window_abort(plugin, gd, NEU_ERR_PLUGIN_DISCONNECTED,
+                         "send message failed", rtt);
+            return;
         }
+        link->next += 1;
+    }
+}
+
+// receive one response on the current link
+static void window_recv(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                        uint8_t *recv_buf, int64_t *rtt)
+{
+    modbus_window_t *window = plugin->links[plugin->link].window;
+    int              ret    = valid_modbus_tcp_response(
+        plugin, recv_buf, modbus_window_response_size(window));
+    int64_t now = neu_time_ms();
 
-        gd->group        = strdup(group->group_name);
-        gd->cmd_sort     = modbus_tag_sort(gd->tags, max_byte);
-        gd->address_base = plugin->address_base;
+    if (ret > 0) {
+        struct modbus_header *header = (struct modbus_header *) recv_buf;
+        uint16_t              seq    = ntohs(header->seq);
+        modbus_txn_t *        txn    = modbus_window_match(window, seq);
+
+        if (txn == NULL) {
+            // the late response of a request that was resent or given up
+            plog_warn(plugin, "drop modbus response of seq %hu", seq);
+        } else if (window_complete(plugin, gd, txn, recv_buf, ret, now, rtt) <
+                   0) {
+            window_abort(plugin, gd, NEU_ERR_PLUGIN_PROTOCOL_DECODE_FAILURE,
+                         "modbus message error", rtt);
+        }
+    } else if (ret < 0) {
+        window_abort(plugin, gd, NEU_ERR_PLUGIN_PROTOCOL_DECODE_FAILURE,
+                     "modbus message error", rtt);
+    } else if (!neu_conn_is_connected(link_conn(plugin))) {
+        window_abort(plugin, gd, NEU_ERR_PLUGIN_DISCONNECTED,
+                     "connection lost", rtt);
     }
+}
 
-    gd                        = (struct modbus_group_data *) group->user_data;
-    plugin->plugin_group_data = gd;
+static bool windows_busy(neu_plugin_t *plugin, struct modbus_group_data *gd)
+{
+    for (uint16_t i = 0; i < plugin->n_link; i++) {
+        if (plugin->links[i].next < gd->cmd_sort->n_cmd ||
+            modbus_window_busy(plugin->links[i].window) > 0) {
+            return true;
+        }
+    }
 
-    bool slave_err_record[MAX_SLAVES] = { false };
+    return false;
+}
 
-    for (uint16_t i = 0; i < gd->cmd_sort->n_cmd; i++) {
-        bool    slave_err[MAX_SLAVES] = { false };
-        uint8_t slave_id              = gd->cmd_sort->cmd[i].slave_id;
-        plugin->cmd_idx               = i;
+static bool windows_inflight(neu_plugin_t *plugin)
+{
+    for (uint16_t i = 0; i < plugin->n_link; i++) {
+        if (modbus_window_inflight(plugin->links[i].window) > 0) {
+            return true;
+        }
+    }
 
-        if (slave_err_record[slave_id] == true) {
-            continue;
+    return false;
+}
+
+static int window_io_cb(enum neu_event_io_type type, int fd, void *usr_data);
+
+// watch the conn of the links with requests in flight for their responses
+static void windows_watch(neu_plugin_t *plugin)
+{
+    for (uint16_t i = 0; i < plugin->n_link; i++) {
+        modbus_link_t *link = &plugin->links[i];
+        int            fd   = -1;
+
+        plugin->link = i;
+        if (link->window != NULL && modbus_window_inflight(link->window) > 0) {
+            fd = neu_conn_fd(link_conn(plugin));
         }
 
-        if (plugin->degradation == false || skip[slave_id] == false) {
-            check_modbus_read_result(plugin, gd, i, &rtt, slave_err);
-        } else {
+        if (link->io != NULL && link->io_fd == fd) {
             continue;
         }
 
-        if (plugin->degradation) {
-            if (slave_err[slave_id]) {
-                failed_cycles[slave_id]++;
-                slave_err_record[slave_id] = true;
+        neu_event_del_io(plugin->events, link->io);
+        link->io    = NULL;
+        link->io_fd = -1;
+
+        if (fd >= 0) {
+            neu_event_io_param_t param = {
+                .fd       = fd,
+                .usr_data = (void *) plugin,
+                .cb       = window_io_cb,
+            };
+
+            link->io    = neu_event_add_io(plugin->events, param);
+            link->io_fd = fd;
+        }
+    }
+
+    plugin->link = 0;
+}
+
+// stop the windows of the links, requests still in flight are given up
+static void windows_stop(neu_plugin_t *plugin)
+{
+    for (uint16_t i = 0; i < plugin->n_link; i++) {
+        modbus_link_t *link = &plugin->links[i];
+
+        if (link->window != NULL) {
+            modbus_window_reset(link->window);
+        }
+        neu_event_del_io(plugin->events, link->io);
+        link->io    = NULL;
+        link->io_fd = -1;
+    }
+}
+
+/*
+ * Step a cycle reading the commands of a group with up to max_inflight
+ * requests in flight on each link.
+ *
+ * Responses are matched to their request by transaction id and handled in
+ * the order they arrive, so that a cycle takes about one round trip instead
+ * of one per command. The commands of the slaves of one link never wait for
+ * the responses of another. Expired requests are resent after the retry
+ * interval without holding back the others.
+ *
+ * The cycle runs on the event loop of the node, responses are received by
+ * the io of each link and deadlines are kept by the cycle timer. Sends are
+ * spaced by the pace of the plugin. Due test reads and writes hold back new
+ * sends and take over once the requests in flight are answered.
+ *
+ * @return true if the cycle completed, else false and wait is set to the
+ *         milliseconds until the next deadline, resend or allowed send.
+ */
+static bool window_step(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                        int64_t *wait)
+{
+    modbus_cycle_t *cycle = &gd->cycle;
+    int64_t         now   = neu_time_ms();
+    int64_t         next  = -1;
+    int64_t         pace  = 0;
+
+    plugin->plugin_group_data = gd;
+    if (!cycle->started) {
+        for (uint16_t i = 0; i < plugin->n_link; i++) {
+            modbus_link_t *link = &plugin->links[i];
+
+            if (link->window == NULL ||
+                modbus_window_size(link->window) != plugin->max_inflight) {
+                modbus_window_free(link->window);
+                link->window = modbus_window_new(plugin->max_inflight);
             }
+            modbus_window_reset(link->window);
+            link->next = 0;
+        }
+        cycle->started = true;
+    }
+
+    for (uint16_t i = 0; i < plugin->n_link; i++) {
+        modbus_txn_t *txn = NULL;
 
-            if (failed_cycles[slave_id] >= plugin->degrade_cycle) {
-                skip[slave_id] = true;
-                plog_warn(plugin, "Skip slave %hhu", slave_id);
-                set_skip_timer(slave_id, plugin->degrade_time);
+        plugin->link = i;
+        while ((txn = modbus_window_expired(plugin->links[i].window, now)) !=
+               NULL) {
+            window_expire(plugin, gd, txn, now, &cycle->rtt,
+                          cycle->slave_err_record);
+        }
+    }
+    plugin->link = 0;
+
+    if (utarray_len(plugin->test_reads) > 0 || writes_due(plugin, now)) {
+        if (!windows_inflight(plugin)) {
+            // nothing to watch, the exchanges may reconnect the links
+            windows_watch(plugin);
+            pace = test_reads_run(plugin);
+            if (pace == 0 && writes_due(plugin, neu_time_ms())) {
+                pace = writes_flush(plugin);
+            }
+            now = neu_time_ms();
+        } else {
+            // the responses in flight come first
+            pace = -1;
+        }
+    }
+
+    for (uint16_t i = 0; i < plugin->n_link && pace == 0; i++) {
+        plugin->link = i;
+        window_fill(plugin, gd, now, cycle->slave_err_record, &cycle->rtt,
+                    &pace);
+    }
+    plugin->link = 0;
+
+    windows_watch(plugin);
+    if (!windows_busy(plugin, gd)) {
+        return true;
+    }
+
+    for (uint16_t i = 0; i < plugin->n_link; i++) {
+        int64_t due = modbus_window_next(plugin->links[i].window);
+
+        if (due >= 0 && (next < 0 || due < next)) {
+            next = due;
+        }
+    }
+
+    *wait = next >= 0 ? next - now : pace;
+    if (pace > 0 && pace < *wait) {
+        *wait = pace;
+    }
+    *wait = *wait > 0 ? *wait : 1;
+    return false;
+}
+
+// one exchange of the next command of a cycle, a resend is scheduled if the
+// command is not answered
+static void cycle_read(neu_plugin_t *plugin, struct modbus_group_data *gd)
+{
+    modbus_cycle_t *   cycle                 = &gd->cycle;
+    modbus_read_cmd_t *cmd                   = &gd->cmd_sort->cmd[cycle->next];
+    bool               slave_err[MAX_SLAVES] = { false };
+    uint16_t           response_size         = 0;
+    uint64_t           read_tms              = neu_time_ms();
+    int                ret_buf               = 0;
+
+    if (cycle->retries > 0) {
+        plog_notice(plugin, "Resend read req. Times:%hu", cycle->retries);
+    }
+
+    plugin->plugin_group_data = gd;
+    plugin->cmd_idx           = cycle->next;
+    bus_acquire(plugin);
+    int ret_r = modbus_stack_read(plugin->stack, cmd->slave_id, cmd->area,
+                                  cmd->start_address, cmd->n_register,
+                                  &response_size, false);
+    if (ret_r > 0) {
+        ret_buf = process_protocol_buf(plugin, cmd->slave_id, response_size);
+    }
+    bus_release(plugin);
+    modbus_pace_take(&plugin->pace, neu_time_ms());
+
+    // a failed send is resent once the retry interval passed, as a missing
+    // response is, a failed resend is not
+    if (ret_buf == 0 && (ret_r > 0 || cycle->retries == 0) &&
+        cycle->retries < plugin->max_retries) {
+        cycle->retries += 1;
+        cycle->due_ms = neu_time_ms() + plugin->retry_interval;
+        return;
+    }
+
+    finalize_modbus_read_result(plugin, gd, cycle->next, ret_r, ret_buf,
+                                read_tms, &cycle->rtt, slave_err);
+    modbus_slave_degrade(plugin, cmd->slave_id, slave_err[cmd->slave_id],
+                         cycle->slave_err_record);
+
+    cycle->next += 1;
+    cycle->retries  = 0;
+    cycle->admitted = false;
+}
+
+/*
+ * Run a cycle until it completes or has to wait.
+ *
+ * @return true if the cycle completed, else false and wait is set to the
+ *         milliseconds until the next exchange is allowed.
+ */
+static bool cycle_step(neu_plugin_t *plugin, struct modbus_group_data *gd,
+                       int64_t *wait)
+{
+    modbus_cycle_t *cycle = &gd->cycle;
+
+    if (cycle->windowed) {
+        return window_step(plugin, gd, wait);
+    }
+
+    while (cycle->next < gd->cmd_sort->n_cmd) {
+        uint8_t slave_id = gd->cmd_sort->cmd[cycle->next].slave_id;
+        int64_t now      = neu_time_ms();
+
+        if (!cycle->admitted) {
+            if (cycle->slave_err_record[slave_id] ||
+                (plugin->degradation &&
+                 !modbus_health_usable(plugin->health, slave_id, now))) {
+                cycle->next += 1;
+                continue;
             }
+            cycle->admitted = true;
         }
 
-        if (plugin->interval > 0) {
-            struct timespec t1 = { .tv_sec  = plugin->interval / 1000,
-                                   .tv_nsec = 1000 * 1000 *
-                                       (plugin->interval % 1000) };
-            struct timespec t2 = { 0 };
-            nanosleep(&t1, &t2);
+        *wait = modbus_pace_wait(&plugin->pace, now);
+        if (cycle->retries > 0 && cycle->due_ms - now > *wait) {
+            *wait = cycle->due_ms - now;
+        }
+        if (*wait > 0) {
+            return false;
         }
+
+        // test reads and writes take over between two commands
+        if (utarray_len(plugin->test_reads) > 0) {
+            test_reads_run(plugin);
+            continue;
+        }
+        if (writes_due(plugin, now)) {
+            writes_flush(plugin);
+            continue;
+        }
+
+        cycle_read(plugin, gd);
+    }
+
+    return true;
+}
+
+// the read of the group left pending by group_read is done
+static void cycle_end(neu_plugin_t *plugin, struct modbus_group_data *gd)
+{
+    if (gd->cycle.started) {
+        windows_stop(plugin);
+    }
+    gd->cycle.running = false;
+    DL_DELETE(plugin->cycles, gd);
+    plugin->common.adapter_callbacks->driver.group_read_end(
+        plugin->common.adapter, gd->grp);
+}
+
+// run the cycles in the order they were started, the wait of the first one
+// that cannot go on, 0 if all completed
+static int64_t cycles_run(neu_plugin_t *plugin)
+{
+    struct modbus_group_data *gd   = NULL;
+    int64_t                   wait = 0;
+
+    while ((gd = plugin->cycles) != NULL) {
+        if (!cycle_step(plugin, gd, &wait)) {
+            return wait;
+        }
+
+        update_metrics_after_read(plugin, gd, gd->cycle.rtt);
+        cycle_end(plugin, gd);
     }
 
-    update_metrics_after_read(plugin, rtt, group, &state);
     return 0;
 }
 
+static void cycles_schedule(neu_plugin_t *plugin, int64_t wait)
+{
+    if (wait <= 0 || plugin->cycle_timer != NULL) {
+        return;
+    }
+
+    plugin->cycle_due = neu_time_ms() + wait;
+
+    neu_event_timer_param_t param = {
+        .second      = wait / 1000,
+        .millisecond = wait % 1000,
+        .usr_data    = (void *) plugin,
+        .cb          = cycle_timer_cb,
+        .type        = NEU_EVENT_TIMER_NOBLOCK,
+    };
+
+    plugin->cycle_timer = neu_event_add_timer(plugin->events, param);
+}
+
+// the continuation of the cycles, on the event loop of the node
+static int cycle_timer_cb(void *usr_data)
+{
+    neu_plugin_t *plugin = (neu_plugin_t *) usr_data;
+
+    pthread_mutex_lock(&plugin->mtx);
+    // timers are periodic, the next wait is known after the step
+    if (plugin->cycle_timer != NULL) {
+        neu_event_del_timer(plugin->events, plugin->cycle_timer);
+        plugin->cycle_timer = NULL;
+    }
+    cycles_schedule(plugin, cycles_run(plugin));
+    pthread_mutex_unlock(&plugin->mtx);
+
+    return 0;
+}
+
+// a response arrived on a link with requests in flight
+static int window_io_cb(enum neu_event_io_type type, int fd, void *usr_data)
+{
+    neu_plugin_t *            plugin        = (neu_plugin_t *) usr_data;
+    struct modbus_group_data *gd            = NULL;
+    uint8_t                   recv_buf[512] = { 0 };
+    int64_t                   wait          = 0;
+
+    (void) type;
+    pthread_mutex_lock(&plugin->mtx);
+    gd = plugin->cycles;
+    for (uint16_t i = 0; gd != NULL && gd->cycle.started && i < plugin->n_link;
+         i++) {
+        if (plugin->links[i].io_fd == fd &&
+            modbus_window_inflight(plugin->links[i].window) > 0) {
+            plugin->plugin_group_data = gd;
+            plugin->link              = i;
+            window_recv(plugin, gd, recv_buf, &gd->cycle.rtt);
+            plugin->link = 0;
+            break;
+        }
+    }
+
+    wait = cycles_run(plugin);
+    // the cycle timer cannot be running on the event loop meanwhile, it is
+    // moved up if the cycles have to go on earlier
+    if (plugin->cycle_timer != NULL && wait > 0 &&
+        plugin->cycle_due > neu_time_ms() + wait) {
+        neu_event_del_timer(plugin->events, plugin->cycle_timer);
+        plugin->cycle_timer = NULL;
+    }
+    cycles_schedule(plugin, wait);
+    if (plugin->cycles == NULL || !plugin->cycles->cycle.windowed) {
+        windows_stop(plugin);
+    }
+    pthread_mutex_unlock(&plugin->mtx);
+
+    return 0;
+}
+
+void modbus_cycles_init(neu_plugin_t *plugin)
+{
+    pthread_mutex_init(&plugin->mtx, NULL);
+    plugin->cycles      = NULL;
+    plugin->cycle_timer = NULL;
+    plugin->batch_next  = 0;
+    utarray_new(plugin->batches, &ut_ptr_icd);
+    utarray_new(plugin->test_reads, &test_read_icd);
+
+    pthread_mutex_init(&plugin->wq_mtx, NULL);
+    plugin->coalesce    = modbus_coalesce_new();
+    plugin->write_timer = NULL;
+}
+
+void modbus_cycles_fini(neu_plugin_t *plugin)
+{
+    struct modbus_group_data *gd          = NULL;
+    struct modbus_group_data *tmp         = NULL;
+    neu_event_timer_t *       timer       = NULL;
+    neu_event_timer_t *       write_timer = NULL;
+    modbus_write_batch_t *    batch       = NULL;
+    neu_json_value_u          error_value = { .val_int = 0 };
+
+    pthread_mutex_lock(&plugin->mtx);
+    DL_FOREACH_SAFE(plugin->cycles, gd, tmp)
+    {
+        gd->cycle.running = false;
+        DL_DELETE(plugin->cycles, gd);
+    }
+    timer               = plugin->cycle_timer;
+    plugin->cycle_timer = NULL;
+    windows_stop(plugin);
+
+    pthread_mutex_lock(&plugin->wq_mtx);
+    write_timer         = plugin->write_timer;
+    plugin->write_timer = NULL;
+    batch = modbus_coalesce_take(plugin->coalesce, plugin->endianess,
+                                 plugin->endianess_64);
+    pthread_mutex_unlock(&plugin->wq_mtx);
+    if (batch != NULL) {
+        utarray_push_back(plugin->batches, &batch);
+    }
+    pthread_mutex_unlock(&plugin->mtx);
+
+    // waits for a running callback, that takes the lock
+    if (timer != NULL) {
+        neu_event_del_timer(plugin->events, timer);
+    }
+    if (write_timer != NULL) {
+        neu_event_del_timer(plugin->events, write_timer);
+    }
+
+    utarray_foreach(plugin->batches, modbus_write_batch_t **, b)
+    {
+        for (uint32_t i = plugin->batch_next; i < (*b)->n_cmd; i++) {
+            modbus_write_batch_done(*b, i, NEU_ERR_PLUGIN_NOT_RUNNING);
+        }
+        modbus_write_batch_free(*b, modbus_write_resp, plugin);
+        plugin->batch_next = 0;
+    }
+    utarray_free(plugin->batches);
+
+    utarray_foreach(plugin->test_reads, modbus_test_read_t *, test)
+    {
+        plugin->common.adapter_callbacks->driver.test_read_tag_response(
+            plugin->common.adapter, test->req, NEU_JSON_INT, NEU_TYPE_ERROR,
+            error_value, NEU_ERR_PLUGIN_NOT_RUNNING);
+    }
+    utarray_free(plugin->test_reads);
+
+    modbus_coalesce_free(plugin->coalesce);
+    pthread_mutex_destroy(&plugin->wq_mtx);
+    pthread_mutex_destroy(&plugin->mtx);
+}
+
+// the read data of a group, rebuilt when the group or the plan changed
+static struct modbus_group_data *
+group_data(neu_plugin_t *plugin, neu_plugin_group_t *group, uint16_t max_byte)
+{
+    struct modbus_group_data *gd =
+        (struct modbus_group_data *) group->user_data;
+
+    if (gd != NULL && gd->address_base == plugin->address_base &&
+        gd->plan_version == plugin->plan_version) {
+        return gd;
+    }
+
+    if (gd != NULL) {
+        group_data_free(gd);
+    }
+    gd = calloc(1, sizeof(struct modbus_group_data));
+
+    group->user_data  = gd;
+    group->group_free = plugin_group_free;
+    utarray_new(gd->tags, &ut_ptr_icd);
+
+    utarray_foreach(group->tags, neu_datatag_t *, tag)
+    {
+        modbus_point_t *p = calloc(1, sizeof(modbus_point_t));
+        int ret = modbus_tag_to_point(tag, p, plugin->address_base);
+        if (ret != NEU_ERR_SUCCESS) {
+            plog_error(plugin, "invalid tag: %s, address: %s", tag->name,
+                       tag->address);
+        }
+
+        utarray_push_back(gd->tags, &p);
+    }
+
+    gd->plugin       = plugin;
+    gd->grp          = group;
+    gd->group        = strdup(group->group_name);
+    gd->cmd_sort     = modbus_tag_sort(gd->tags, max_byte, &plugin->plan);
+    gd->decode       = calloc(gd->cmd_sort->n_cmd, sizeof(*gd->decode));
+    gd->address_base = plugin->address_base;
+    gd->plan_version = plugin->plan_version;
+
+    for (uint32_t i = 0; i < gd->cmd_sort->n_cmd; i++) {
+        gd->decode[i] = modbus_decode_plan_new(
+            &gd->cmd_sort->cmd[i], plugin->endianess, plugin->endianess_64);
+    }
+    NEU_PLUGIN_REGISTER_GROUP_METRIC(plugin, gd->group,
+                                     NEU_METRIC_GROUP_LAST_GAP_BYTES,
+                                     gd->cmd_sort->n_gap_byte);
+
+    plog_notice(plugin,
+                "group %s planned %u read cmds of %u bytes, %u bytes "
+                "bridge gaps",
+                gd->group, gd->cmd_sort->n_cmd, gd->cmd_sort->n_byte,
+                gd->cmd_sort->n_gap_byte);
+    return gd;
+}
+
+/*
+ * Read a group.
+ *
+ * The commands of a sequential cycle are spaced by the pace of the plugin
+ * and resent after the retry interval. The cycle runs from a timer of the
+ * node until it has to wait, so that writes and other reads are served in
+ * between, the driver is told when it completed. With several links or
+ * requests in flight, the cycle pipelines its commands on the links instead,
+ * see window_step. A sync read runs the cycles right away instead of waiting
+ * for the timer of the node.
+ *
+ * @return NEU_PLUGIN_GROUP_READ_PENDING, or NEU_PLUGIN_GROUP_READ_BUSY if
+ *         the last read of the group is still running.
+ */
+static int group_read(neu_plugin_t *plugin, neu_plugin_group_t *group,
+                      uint16_t max_byte, bool sync)
+{
+    struct modbus_group_data *gd = NULL;
+
+    pthread_mutex_lock(&plugin->mtx);
+
+    gd = (struct modbus_group_data *) group->user_data;
+    if (gd != NULL && gd->cycle.running && !sync) {
+        plog_warn(plugin, "group %s, the last read cycle is still running",
+                  gd->group);
+        pthread_mutex_unlock(&plugin->mtx);
+        return NEU_PLUGIN_GROUP_READ_BUSY;
+    }
+
+    if (gd == NULL || !gd->cycle.running) {
+        gd = group_data(plugin, group, max_byte);
+    }
+
+    if (!gd->cycle.running) {
+        memset(&gd->cycle, 0, sizeof(gd->cycle));
+        gd->cycle.running  = true;
+        gd->cycle.rtt      = NEU_METRIC_LAST_RTT_MS_MAX;
+        gd->cycle.windowed = plugin->protocol == MODBUS_PROTOCOL_TCP &&
+            plugin->links != NULL &&
+            (plugin->max_inflight > 1 || plugin->n_link > 1);
+        DL_APPEND(plugin->cycles, gd);
+    }
+
+    // the read timer only starts the cycle, so that writes queued meanwhile
+    // are not held up behind it
+    if (!sync) {
+        cycles_schedule(plugin, 1);
+        pthread_mutex_unlock(&plugin->mtx);
+        return NEU_PLUGIN_GROUP_READ_PENDING;
+    }
+
+    // a sync read goes as far as it can right away, the rest of the cycle
+    // runs on the event loop, its end is signaled as for the read timer
+    cycles_schedule(plugin, cycles_run(plugin));
+
+    pthread_mutex_unlock(&plugin->mtx);
+    return NEU_PLUGIN_GROUP_READ_PENDING;
+}
+
+int modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
+                       uint16_t max_byte)
+{
+    return group_read(plugin, group, max_byte, false);
+}
+
+int modbus_group_sync(neu_plugin_t *plugin, neu_plugin_group_t *group,
+                      uint16_t max_byte)
+{
+    return group_read(plugin, group, max_byte, true);
+}
+
+// deliver the decoded values of a command in one update
+static void update_values(neu_plugin_t *plugin, const char *group,
+                          const neu_tag_update_t *values, uint16_t n_value,
+                          void *trace)
+{
+    if (trace == NULL) {
+        plugin->common.adapter_callbacks->driver.update_many(
+            plugin->common.adapter, group, values, n_value);
+        return;
+    }
+
+    for (uint16_t i = 0; i < n_value; i++) {
+        plugin->common.adapter_callbacks->driver.update_with_trace(
+            plugin->common.adapter, group, values[i].tag, values[i].value,
+            NULL, 0, trace);
+    }
+}
+
 int modbus_value_handle(void *ctx, uint8_t slave_id, uint16_t n_byte,
                         uint8_t *bytes, int error, void *trace)
 {
     neu_plugin_t *            plugin = (neu_plugin_t *) ctx;
     struct modbus_group_data *gd =
         (struct modbus_group_data *) plugin->plugin_group_data;
-    uint16_t start_address = gd->cmd_sort->cmd[plugin->cmd_idx].start_address;
-    uint16_t n_register    = gd->cmd_sort->cmd[plugin->cmd_idx].n_register;
+    const neu_tag_update_t *  values  = NULL;
+    uint16_t                  n_value = 0;
 
     if (error == NEU_ERR_PLUGIN_DISCONNECTED) {
         neu_dvalue_t dvalue = { 0 };
@@ -465,116 +1317,9 @@ int modbus_value_handle(void *ctx, uint8_t slave_id, uint16_t n_byte,
         return 0;
     }
 
-    utarray_foreach(gd->cmd_sort->cmd[plugin->cmd_idx].tags, modbus_point_t **,
-                    p_tag)
-    {
-        neu_dvalue_t dvalue = { 0 };
-
-        if ((*p_tag)->start_address + (*p_tag)->n_register >
-                start_address + n_register ||
-            slave_id != (*p_tag)->slave_id) {
-            dvalue.type      = NEU_TYPE_ERROR;
-            dvalue.value.i32 = NEU_ERR_PLUGIN_READ_FAILURE;
-        } else {
-            switch ((*p_tag)->area) {
-            case MODBUS_AREA_HOLD_REGISTER:
-            case MODBUS_AREA_INPUT_REGISTER:
-                if (n_byte >= ((*p_tag)->start_address - start_address) * 2 +
-                        (*p_tag)->n_register * 2) {
-                    memcpy(dvalue.value.bytes.bytes,
-                           bytes +
-                               ((*p_tag)->start_address - start_address) * 2,
-                           (*p_tag)->n_register * 2);
-                    dvalue.value.bytes.length = (*p_tag)->n_register * 2;
-                }
-                break;
-            case MODBUS_AREA_COIL:
-            case MODBUS_AREA_INPUT: {
-                uint16_t offset = (*p_tag)->start_address - start_address;
-                if (n_byte > offset / 8) {
-                    neu_value8_u u8 = { .value = bytes[offset / 8] };
-
-                    dvalue.value.u8 = neu_value8_get_bit(u8, offset % 8);
-                }
-                break;
-            }
-            }
-
-            dvalue.type = (*p_tag)->type;
-            switch ((*p_tag)->type) {
-            case NEU_TYPE_UINT16:
-            case NEU_TYPE_INT16:
-                dvalue.value.u16 = ntohs(dvalue.value.u16);
-                break;
-            case NEU_TYPE_FLOAT:
-            case NEU_TYPE_INT32:
-            case NEU_TYPE_UINT32:
-                if ((*p_tag)->option.value32.is_default) {
-                    modbus_convert_endianess(&dvalue.value, plugin->endianess);
-                }
-                dvalue.value.u32 = ntohl(dvalue.value.u32);
-                break;
-            case NEU_TYPE_DOUBLE:
-            case NEU_TYPE_INT64:
-            case NEU_TYPE_UINT64:
-                if ((*p_tag)->option.value64.is_default) {
-                    modbus_convert_endianess_64(&dvalue.value,
-                                                plugin->endianess_64);
-                }
-                dvalue.value.u64 = neu_ntohll(dvalue.value.u64);
-                break;
-            case NEU_TYPE_BIT: {
-                switch ((*p_tag)->area) {
-                case MODBUS_AREA_HOLD_REGISTER:
-                case MODBUS_AREA_INPUT_REGISTER: {
-                    neu_value16_u v16 = { 0 };
-                    v16.value = htons(*(uint16_t *) dvalue.value.bytes.bytes);
-                    memset(&dvalue.value, 0, sizeof(dvalue.value));
-                    dvalue.value.u8 =
-                        neu_value16_get_bit(v16, (*p_tag)->option.bit.bit);
-                    break;
-                }
-                case MODBUS_AREA_COIL:
-                case MODBUS_AREA_INPUT:
-                    break;
-                }
-                break;
-            }
-            case NEU_TYPE_STRING: {
-                switch ((*p_tag)->option.string.type) {
-                case NEU_DATATAG_STRING_TYPE_H:
-                    break;
-                case NEU_DATATAG_STRING_TYPE_L:
-                    neu_datatag_string_ltoh(dvalue.value.str,
-                                            strlen(dvalue.value.str));
-                    break;
-                case NEU_DATATAG_STRING_TYPE_D:
-                    break;
-                case NEU_DATATAG_STRING_TYPE_E:
-                    break;
-                }
-
-                if (!neu_datatag_string_is_utf8(dvalue.value.str,
-                                                strlen(dvalue.value.str))) {
-                    dvalue.value.str[0] = '?';
-                    dvalue.value.str[1] = 0;
-                }
-                break;
-            }
-            default:
-                break;
-            }
-        }
-
-        if (trace) {
-            plugin->common.adapter_callbacks->driver.update_with_trace(
-                plugin->common.adapter, gd->group, (*p_tag)->name, dvalue, NULL,
-                0, trace);
-        } else {
-            plugin->common.adapter_callbacks->driver.update(
-                plugin->common.adapter, gd->group, (*p_tag)->name, dvalue);
-        }
-    }
+    values = modbus_decode_plan_run(gd->decode[plugin->cmd_idx], slave_id,
+                                    bytes, n_byte, &n_value);
+    update_values(plugin, gd->group, values, n_value, trace);
     return 0;
 }
 
@@ -727,25 +1472,20 @@ int modbus_value_handle_test(neu_plugin_t *plugin, void *req,
     return 0;
 }
 
-int modbus_test_read_tag(neu_plugin_t *plugin, void *req, neu_datatag_t tag)
+static int test_read_tag(neu_plugin_t *plugin, void *req,
+                         modbus_point_t point)
 {
-    modbus_point_t   point = { 0 };
     neu_json_value_u error_value;
     error_value.val_int = 0;
 
-    int err = modbus_tag_to_point(&tag, &point, plugin->address_base);
-    if (err != NEU_ERR_SUCCESS) {
-        plugin->common.adapter_callbacks->driver.test_read_tag_response(
-            plugin->common.adapter, req, NEU_JSON_INT, NEU_TYPE_ERROR,
-            error_value, err);
-        return 0;
-    }
-
     uint16_t response_size = 0;
-    int      ret = modbus_stack_read(plugin->stack, point.slave_id, point.area,
+    bus_acquire(plugin);
+    int ret = modbus_stack_read(plugin->stack, point.slave_id, point.area,
                                 point.start_address, point.n_register,
                                 &response_size, true);
     if (ret <= 0) {
+        bus_release(plugin);
+        modbus_pace_take(&plugin->pace, neu_time_ms());
         plugin->common.adapter_callbacks->driver.test_read_tag_response(
             plugin->common.adapter, req, NEU_JSON_INT, NEU_TYPE_ERROR,
             error_value, NEU_ERR_PLUGIN_READ_FAILURE);
@@ -753,6 +1493,8 @@ int modbus_test_read_tag(neu_plugin_t *plugin, void *req, neu_datatag_t tag)
     }
 
     ret = process_protocol_buf_test(plugin, req, &point, response_size);
+    bus_release(plugin);
+    modbus_pace_take(&plugin->pace, neu_time_ms());
     if (ret == 0) {
         plugin->common.adapter_callbacks->driver.test_read_tag_response(
             plugin->common.adapter, req, NEU_JSON_INT, NEU_TYPE_ERROR,
@@ -773,76 +1515,55 @@ int modbus_test_read_tag(neu_plugin_t *plugin, void *req, neu_datatag_t tag)
     return 0;
 }
 
-static uint8_t convert_value(neu_plugin_t *plugin, neu_value_u *value,
-                             neu_datatag_t *tag, modbus_point_t *point)
+// send the test reads the pace allows, with the plugin locked
+static int64_t test_reads_run(neu_plugin_t *plugin)
 {
-    uint8_t n_byte = 0;
-    switch (tag->type) {
-    case NEU_TYPE_UINT16:
-    case NEU_TYPE_INT16:
-        value->u16 = htons(value->u16);
-        n_byte     = sizeof(uint16_t);
-        break;
-    case NEU_TYPE_FLOAT:
-    case NEU_TYPE_UINT32:
-    case NEU_TYPE_INT32:
-        if (point->option.value32.is_default) {
-            modbus_convert_endianess(value, plugin->endianess);
-        }
-        value->u32 = htonl(value->u32);
-        n_byte     = sizeof(uint32_t);
-        break;
-    case NEU_TYPE_DOUBLE:
-    case NEU_TYPE_INT64:
-    case NEU_TYPE_UINT64:
-        if (tag->option.value64.is_default) {
-            modbus_convert_endianess_64(value, plugin->endianess_64);
+    modbus_test_read_t *test = NULL;
+    int64_t             wait = 0;
+
+    while ((test = (modbus_test_read_t *) utarray_front(plugin->test_reads)) !=
+           NULL) {
+        wait = modbus_pace_wait(&plugin->pace, neu_time_ms());
+        if (wait > 0) {
+            return wait;
         }
-        value->u64 = neu_htonll(value->u64);
-        n_byte     = sizeof(uint64_t);
-        break;
-    case NEU_TYPE_BIT:
-        n_byte = sizeof(uint8_t);
-        break;
-    case NEU_TYPE_STRING: {
-        switch (point->option.string.type) {
-        case NEU_DATATAG_STRING_TYPE_H:
-            break;
-        case NEU_DATATAG_STRING_TYPE_L:
-            neu_datatag_string_ltoh(value->str, point->option.string.length);
-            break;
-        case NEU_DATATAG_STRING_TYPE_D:
-            break;
-        case NEU_DATATAG_STRING_TYPE_E:
-            break;
-        }
-        n_byte = point->option.string.length;
-        break;
-    }
-    case NEU_TYPE_BYTES:
-        n_byte = point->option.bytes.length;
-        break;
-    default:
-        assert(false);
-        break;
+
+        test_read_tag(plugin, test->req, test->point);
+        utarray_erase(plugin->test_reads, 0, 1);
     }
-    return n_byte;
+
+    return 0;
 }
 
-static int write_modbus_point(neu_plugin_t *plugin, void *req,
-                              modbus_point_t *point, neu_value_u value,
-                              uint8_t n_byte)
+static void writes_schedule(neu_plugin_t *plugin, int64_t pace);
+
+int modbus_test_read_tag(neu_plugin_t *plugin, void *req, neu_datatag_t tag)
 {
-    uint16_t response_size = 0;
-    int      ret           = modbus_stack_write(
-        plugin->stack, req, point->slave_id, point->area, point->start_address,
-        point->n_register, value.bytes.bytes, n_byte, &response_size, true);
+    modbus_test_read_t test = { .req = req };
+    int64_t            wait = 0;
 
-    if (ret > 0) {
-        process_protocol_buf(plugin, point->slave_id, response_size);
+    int err = modbus_tag_to_point(&tag, &test.point, plugin->address_base);
+    if (err != NEU_ERR_SUCCESS) {
+        neu_json_value_u error_value = { .val_int = 0 };
+
+        plugin->common.adapter_callbacks->driver.test_read_tag_response(
+            plugin->common.adapter, req, NEU_JSON_INT, NEU_TYPE_ERROR,
+            error_value, err);
+        return 0;
     }
 
-    return ret;
+    // sent later from the write timer when the pace does not allow it yet
+    pthread_mutex_lock(&plugin->mtx);
+    utarray_push_back(plugin->test_reads, &test);
+    wait = test_reads_run(plugin);
+    if (wait > 0) {
+        pthread_mutex_lock(&plugin->wq_mtx);
+        writes_schedule(plugin, wait);
+        pthread_mutex_unlock(&plugin->wq_mtx);
+    }
+    pthread_mutex_unlock(&plugin->mtx);
+
+    return 0;
 }
 
 static int write_modbus_points(neu_plugin_t *      plugin,
@@ -850,6 +1571,8 @@ static int write_modbus_points(neu_plugin_t *      plugin,
 {
     uint16_t response_size = 0;
 
+    plugin->link = link_of(plugin, write_cmd->slave_id);
+    bus_acquire(plugin);
     int ret = modbus_stack_write(plugin->stack, req, write_cmd->slave_id,
                                  write_cmd->area, write_cmd->start_address,
                                  write_cmd->n_register, write_cmd->bytes,
@@ -858,71 +1581,216 @@ static int write_modbus_points(neu_plugin_t *      plugin,
     if (ret > 0) {
         process_protocol_buf(plugin, write_cmd->slave_id, response_size);
     }
+    bus_release(plugin);
+    plugin->link = 0;
+    modbus_pace_take(&plugin->pace, neu_time_ms());
 
     return ret;
 }
 
+// the pending writes waited long enough for others to merge with, or a
+// taken batch is partly sent, with the plugin locked
+static bool writes_due(neu_plugin_t *plugin, int64_t now)
+{
+    if (utarray_len(plugin->batches) > 0) {
+        return true;
+    }
+
+    pthread_mutex_lock(&plugin->wq_mtx);
+    int64_t oldest = modbus_coalesce_oldest(plugin->coalesce);
+    pthread_mutex_unlock(&plugin->wq_mtx);
+
+    return oldest >= 0 && now - oldest >= plugin->write_window;
+}
+
+// take the pending writes behind the batches not sent yet, with the plugin
+// locked
+static void writes_take(neu_plugin_t *plugin)
+{
+    modbus_write_batch_t *batch = NULL;
+
+    pthread_mutex_lock(&plugin->wq_mtx);
+    batch = modbus_coalesce_take(plugin->coalesce, plugin->endianess,
+                                 plugin->endianess_64);
+    pthread_mutex_unlock(&plugin->wq_mtx);
+
+    if (batch != NULL) {
+        utarray_push_back(plugin->batches, &batch);
+    }
+}
+
+/*
+ * Send the pending writes the pace allows, with the plugin locked.
+ *
+ * @return the milliseconds until the pace allows the next command, 0 if all
+ *         writes were sent.
+ */
+static int64_t writes_flush(neu_plugin_t *plugin)
+{
+    modbus_write_batch_t **batch = NULL;
+
+    writes_take(plugin);
+
+    while ((batch = (modbus_write_batch_t **) utarray_front(
+                plugin->batches)) != NULL) {
+        while (plugin->batch_next < (*batch)->n_cmd) {
+            modbus_write_cmd_t *cmd  = &(*batch)->cmd[plugin->batch_next];
+            int64_t             wait = 0;
+            int                 ret  = 0;
+
+            if (cmd->area != MODBUS_AREA_COIL &&
+                cmd->area != MODBUS_AREA_HOLD_REGISTER) {
+                modbus_write_batch_done(*batch, plugin->batch_next++,
+                                        NEU_ERR_PLUGIN_TAG_NOT_ALLOW_WRITE);
+                continue;
+            }
+
+            wait = modbus_pace_wait(&plugin->pace, neu_time_ms());
+            if (wait > 0) {
+                return wait;
+            }
+
+            ret = write_modbus_points(plugin, cmd, NULL);
+            modbus_write_batch_done(*batch, plugin->batch_next++,
+                                    ret > 0 ? NEU_ERR_SUCCESS
+                                            : NEU_ERR_PLUGIN_DISCONNECTED);
+        }
+
+        modbus_write_batch_free(*batch, modbus_write_resp, plugin);
+        utarray_erase(plugin->batches, 0, 1);
+        plugin->batch_next = 0;
+    }
+
+    return 0;
+}
+
+static int write_timer_cb(void *usr_data);
+
+/*
+ * Arm the write timer, with wq_mtx held.
+ *
+ * The timer fires in pace milliseconds when a test read or write had to
+ * wait for the pace, else once the oldest pending write is due.
+ */
+static void writes_schedule(neu_plugin_t *plugin, int64_t pace)
+{
+    int64_t oldest = modbus_coalesce_oldest(plugin->coalesce);
+    int64_t wait   = pace;
+
+    if ((oldest < 0 && pace <= 0) || plugin->write_timer != NULL) {
+        return;
+    }
+
+    if (pace <= 0) {
+        wait = oldest + plugin->write_window - neu_time_ms();
+        wait = wait > 0 ? wait : 1;
+    }
+
+    neu_event_timer_param_t param = {
+        .second      = wait / 1000,
+        .millisecond = wait % 1000,
+        .usr_data    = (void *) plugin,
+        .cb          = write_timer_cb,
+        .type        = NEU_EVENT_TIMER_NOBLOCK,
+    };
+
+    plugin->write_timer = neu_event_add_timer(plugin->events, param);
+}
+
+// sends the test reads and pending writes when no read cycle is running to
+// do it
+static int write_timer_cb(void *usr_data)
+{
+    neu_plugin_t *plugin = (neu_plugin_t *) usr_data;
+    int64_t       wait   = 0;
+
+    pthread_mutex_lock(&plugin->mtx);
+    pthread_mutex_lock(&plugin->wq_mtx);
+    if (plugin->write_timer != NULL) {
+        neu_event_del_timer(plugin->events, plugin->write_timer);
+        plugin->write_timer = NULL;
+    }
+    pthread_mutex_unlock(&plugin->wq_mtx);
+
+    wait = test_reads_run(plugin);
+    if (wait == 0 && writes_due(plugin, neu_time_ms())) {
+        wait = writes_flush(plugin);
+    }
+
+    pthread_mutex_lock(&plugin->wq_mtx);
+    writes_schedule(plugin, wait);
+    pthread_mutex_unlock(&plugin->wq_mtx);
+    pthread_mutex_unlock(&plugin->mtx);
+
+    return 0;
+}
+
+/*
+ * Queue the points of a write request.
+ *
+ * Writes take over from a read cycle between two of its commands, else they
+ * are sent from a timer of the node. Writes queued within the write window
+ * are merged. Without a window, they are sent right away if nothing else
+ * is being exchanged.
+ */
+static void queue_write(neu_plugin_t *plugin, void *req,
+                        const modbus_point_write_t *points, uint16_t n_point)
+{
+    int64_t wait = 0;
+
+    pthread_mutex_lock(&plugin->wq_mtx);
+    while (modbus_coalesce_add(plugin->coalesce, req, points, n_point,
+                               neu_time_ms()) != 0) {
+        // the pending writes to the same registers are taken to go first
+        pthread_mutex_unlock(&plugin->wq_mtx);
+        pthread_mutex_lock(&plugin->mtx);
+        writes_take(plugin);
+        pthread_mutex_unlock(&plugin->mtx);
+        pthread_mutex_lock(&plugin->wq_mtx);
+    }
+    writes_schedule(plugin, 0);
+    pthread_mutex_unlock(&plugin->wq_mtx);
+
+    if (plugin->write_window == 0 && pthread_mutex_trylock(&plugin->mtx) == 0) {
+        wait = writes_flush(plugin);
+        if (wait > 0) {
+            pthread_mutex_lock(&plugin->wq_mtx);
+            writes_schedule(plugin, wait);
+            pthread_mutex_unlock(&plugin->wq_mtx);
+        }
+        pthread_mutex_unlock(&plugin->mtx);
+    }
+}
+
 int modbus_write_tag(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
                      neu_value_u value)
 {
-    modbus_point_t point = { 0 };
-    int            ret = modbus_tag_to_point(tag, &point, plugin->address_base);
+    modbus_point_write_t point = { .value = value };
+    int                  ret   = 0;
+
+    ret = modbus_tag_to_point(tag, &point.point, plugin->address_base);
     assert(ret == 0);
 
-    uint8_t n_byte = convert_value(plugin, &value, tag, &point);
-    return write_modbus_point(plugin, req, &point, value, n_byte);
+    queue_write(plugin, req, &point, 1);
+    return ret;
 }
 
 int modbus_write_tags(neu_plugin_t *plugin, void *req, UT_array *tags)
 {
-    struct modbus_write_tags_data *gtags = NULL;
-    int                            ret   = 0;
-    int                            rv    = 0;
-
-    gtags = calloc(1, sizeof(struct modbus_write_tags_data));
+    uint16_t              n_point = utarray_len(tags);
+    modbus_point_write_t *points  = calloc(n_point, sizeof(*points));
+    uint16_t              i       = 0;
+    int                   ret     = 0;
 
-    utarray_new(gtags->tags, &ut_ptr_icd);
     utarray_foreach(tags, neu_plugin_tag_value_t *, tag)
     {
-        modbus_point_write_t *p = calloc(1, sizeof(modbus_point_write_t));
-        ret = modbus_write_tag_to_point(tag, p, plugin->address_base);
+        ret = modbus_write_tag_to_point(tag, &points[i++],
+                                        plugin->address_base);
         assert(ret == 0);
-
-        utarray_push_back(gtags->tags, &p);
-    }
-    gtags->cmd_sort = modbus_write_tags_sort(gtags->tags, plugin->endianess,
-                                             plugin->endianess_64);
-    for (uint16_t i = 0; i < gtags->cmd_sort->n_cmd; i++) {
-        ret = write_modbus_points(plugin, &gtags->cmd_sort->cmd[i], req);
-        if (ret <= 0) {
-            rv = 1;
-        }
-        if (plugin->interval > 0) {
-            struct timespec t1 = { .tv_sec  = plugin->interval / 1000,
-                                   .tv_nsec = 1000 * 1000 *
-                                       (plugin->interval % 1000) };
-            struct timespec t2 = { 0 };
-            nanosleep(&t1, &t2);
-        }
-    }
-
-    if (rv == 0) {
-        plugin->common.adapter_callbacks->driver.write_response(
-            plugin->common.adapter, req, NEU_ERR_SUCCESS);
-    } else {
-        plugin->common.adapter_callbacks->driver.write_response(
-            plugin->common.adapter, req, NEU_ERR_PLUGIN_DISCONNECTED);
     }
 
-    for (uint16_t i = 0; i < gtags->cmd_sort->n_cmd; i++) {
-        utarray_free(gtags->cmd_sort->cmd[i].tags);
-        free(gtags->cmd_sort->cmd[i].bytes);
-    }
-    free(gtags->cmd_sort->cmd);
-    free(gtags->cmd_sort);
-    utarray_foreach(gtags->tags, modbus_point_write_t **, tag) { free(*tag); }
-    utarray_free(gtags->tags);
-    free(gtags);
+    queue_write(plugin, req, points, n_point);
+    free(points);
     return ret;
 }
 
@@ -935,10 +1803,17 @@ int modbus_write_resp(void *ctx, void *req, int error)
     return 0;
 }
 
-static void plugin_group_free(neu_plugin_group_t *pgp)
+static void group_data_free(struct modbus_group_data *gd)
 {
-    struct modbus_group_data *gd = (struct modbus_group_data *) pgp->user_data;
+    if (gd->cycle.running) {
+        // dropped, the driver must not wait for it
+        cycle_end(gd->plugin, gd);
+    }
 
+    for (uint32_t i = 0; i < gd->cmd_sort->n_cmd; i++) {
+        modbus_decode_plan_free(gd->decode[i]);
+    }
+    free(gd->decode);
     modbus_tag_sort_free(gd->cmd_sort);
 
     utarray_foreach(gd->tags, modbus_point_t **, tag) { free(*tag); }
@@ -949,13 +1824,26 @@ static void plugin_group_free(neu_plugin_group_t *pgp)
     free(gd);
 }
 
+static void plugin_group_free(neu_plugin_group_t *pgp)
+{
+    struct modbus_group_data *gd     = NULL;
+    neu_plugin_t *            plugin = NULL;
+
+    gd     = (struct modbus_group_data *) pgp->user_data;
+    plugin = gd->plugin;
+
+    pthread_mutex_lock(&plugin->mtx);
+    group_data_free(gd);
+    pthread_mutex_unlock(&plugin->mtx);
+}
+
 static ssize_t recv_data(neu_plugin_t *plugin, uint8_t *buffer, size_t size)
 {
     if (plugin->is_server) {
         return neu_conn_tcp_server_recv(plugin->conn, plugin->client_fd, buffer,
                                         size);
     } else {
-        return neu_conn_recv(plugin->conn, buffer, size);
+        return neu_conn_recv(link_conn(plugin), buffer, size);
     }
 }
 
@@ -19,9 +19,35 @@
 #ifndef _NEU_M_PLUGIN_MODBUS_REQ_H_
 #define _NEU_M_PLUGIN_MODBUS_REQ_H_
 
+#include <pthread.h>
+
 #include <neuron.h>
 
+#include "modbus_bus.h"
+#include "modbus_coalesce.h"
+#include "modbus_health.h"
+#include "modbus_pace.h"
 #include "modbus_stack.h"
+#include "modbus_window.h"
+
+#define MODBUS_MAX_LINKS 8
+// percent the probe waits of degraded slaves are spread by
+#define MODBUS_DEGRADE_JITTER 20
+
+/*
+ * A tcp session to the device.
+ *
+ * Gateways bridging several serial buses route concurrent sessions by slave
+ * id. The read commands of a slave always go through link slave_id % n_link,
+ * so that the buses behind the gateway are polled in parallel.
+ */
+typedef struct modbus_link {
+    neu_conn_t *     conn; // links[0].conn is the conn of the node
+    modbus_window_t *window;
+    uint32_t         next;  // next read command of the cycle
+    neu_event_io_t * io;    // watches conn while requests are in flight
+    int              io_fd; // fd io watches
+} modbus_link_t;
 
 struct neu_plugin {
     neu_plugin_common_t common;
@@ -30,7 +56,7 @@ struct neu_plugin {
     modbus_stack_t *stack;
 
     void *   plugin_group_data;
-    uint16_t cmd_idx;
+    uint32_t cmd_idx;
 
     neu_event_io_t *tcp_server_io;
     bool            is_server;
@@ -44,12 +70,43 @@ struct neu_plugin {
     modbus_address_base address_base;
 
     uint16_t interval;
+    uint16_t timeout;
     uint16_t retry_interval;
     uint16_t max_retries;
     uint16_t check_header;
     bool     degradation;
     uint16_t degrade_cycle;
     uint16_t degrade_time;
+    uint16_t degrade_max_time;
+
+    modbus_health_t *health;
+    modbus_pace_t    pace; // spaces the requests by interval
+
+    // serializes the exchanges of read cycles, writes and test reads
+    pthread_mutex_t           mtx;
+    struct modbus_group_data *cycles; // read cycles in progress, in order
+    neu_event_timer_t *       cycle_timer;
+    int64_t                   cycle_due; // when cycle_timer fires
+    UT_array *                batches;    // taken writes, sent as paced
+    uint32_t                  batch_next; // next command of the first batch
+    UT_array *                test_reads; // test reads waiting for the pace
+
+    // writes waiting to be sent between two commands of a read cycle
+    pthread_mutex_t    wq_mtx;
+    modbus_coalesce_t *coalesce;
+    neu_event_timer_t *write_timer;
+    uint16_t           write_window; // ms a write waits for others to merge
+
+    uint16_t       max_inflight; // read requests in flight per link, tcp only
+    uint16_t       n_link;       // tcp sessions, client only
+    modbus_link_t *links;
+    uint16_t       link;         // link requests are sent and received on
+
+    // the serial line shared with the other nodes on the device, rtu only
+    modbus_bus_member_t *bus;
+
+    modbus_read_plan_t plan;
+    uint32_t           plan_version; // bumped when the plan changes
 
     bool             backup;
     bool             current_backup;
@@ -65,8 +122,21 @@ void modbus_tcp_server_stop(void *data, int fd);
 int  modbus_tcp_server_io_callback(enum neu_event_io_type type, int fd,
                                    void *usr_data);
 
-int modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
+void modbus_links_config(neu_plugin_t *plugin, uint16_t n_link,
+                         neu_conn_param_t *param);
+void modbus_links_start(neu_plugin_t *plugin);
+void modbus_links_stop(neu_plugin_t *plugin);
+void modbus_links_free(neu_plugin_t *plugin);
+
+int modbus_read_plan_config(neu_plugin_t *plugin, const char *config);
+
+void modbus_cycles_init(neu_plugin_t *plugin);
+void modbus_cycles_fini(neu_plugin_t *plugin);
+int  modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
+                        uint16_t max_byte);
+int  modbus_group_sync(neu_plugin_t *plugin, neu_plugin_group_t *group,
                        uint16_t max_byte);
+
 int modbus_send_msg(void *ctx, uint16_t n_byte, uint8_t *bytes);
 int modbus_value_handle(void *ctx, uint8_t slave_id, uint16_t n_byte,
                         uint8_t *bytes, int error, void *trace);
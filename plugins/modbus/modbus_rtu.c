@@ -39,6 +39,7 @@ static int driver_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
 
 static int driver_validate_tag(neu_plugin_t *plugin, neu_datatag_t *tag);
 static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group);
+static int driver_group_sync(neu_plugin_t *plugin, neu_plugin_group_t *group);
 static int driver_write(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
                         neu_value_u value);
 static int driver_write_tags(neu_plugin_t *plugin, void *req, UT_array *tags);
@@ -56,7 +57,7 @@ static const neu_plugin_intf_funs_t plugin_intf_funs = {
 
     .driver.validate_tag  = driver_validate_tag,
     .driver.group_timer   = driver_group_timer,
-    .driver.group_sync    = driver_group_timer,
+    .driver.group_sync    = driver_group_sync,
     .driver.write_tag     = driver_write,
     .driver.tag_validator = NULL,
     .driver.write_tags    = driver_write_tags,
@@ -112,6 +113,12 @@ static int driver_init(neu_plugin_t *plugin, bool load)
     plugin->stack    = modbus_stack_create((void *) plugin, MODBUS_PROTOCOL_RTU,
                                         modbus_send_msg, modbus_value_handle,
                                         modbus_write_resp);
+    plugin->health   = modbus_health_new();
+    modbus_cycles_init(plugin);
+
+    NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_BUS_UTILIZATION, 0);
+    NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_BUS_LAST_WAIT_MS, 0);
+    NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_BUS_NODES, 0);
 
     plog_notice(plugin, "%s init success", plugin->common.name);
     return 0;
@@ -120,13 +127,18 @@ static int driver_init(neu_plugin_t *plugin, bool load)
 static int driver_uninit(neu_plugin_t *plugin)
 {
     plog_notice(plugin, "%s uninit start", plugin->common.name);
-    if (plugin->conn != NULL) {
+    modbus_cycles_fini(plugin);
+    if (plugin->bus != NULL) {
+        modbus_bus_detach(plugin->bus);
+    } else if (plugin->conn != NULL) {
         neu_conn_destory(plugin->conn);
     }
 
     if (plugin->stack) {
         modbus_stack_destroy(plugin->stack);
     }
+    modbus_read_plan_fini(&plugin->plan);
+    modbus_health_free(plugin->health);
 
     neu_event_close(plugin->events);
 
@@ -137,18 +149,67 @@ static int driver_uninit(neu_plugin_t *plugin)
 
 static int driver_start(neu_plugin_t *plugin)
 {
-    neu_conn_start(plugin->conn);
+    if (plugin->bus != NULL) {
+        modbus_bus_start(plugin->bus);
+    } else {
+        neu_conn_start(plugin->conn);
+    }
     plog_notice(plugin, "%s start success", plugin->common.name);
     return 0;
 }
 
 static int driver_stop(neu_plugin_t *plugin)
 {
-    neu_conn_stop(plugin->conn);
+    if (plugin->bus != NULL) {
+        modbus_bus_stop(plugin->bus);
+    } else {
+        neu_conn_stop(plugin->conn);
+    }
     plog_notice(plugin, "%s stop success", plugin->common.name);
     return 0;
 }
 
+/*
+ * Attach to the serial line of the device, the line is shared with the other
+ * nodes configured on the same device.
+ */
+static int bus_config(neu_plugin_t *plugin, neu_conn_param_t *param)
+{
+    modbus_bus_member_t *bus = NULL;
+
+    if (plugin->bus != NULL && modbus_bus_match(plugin->bus, param)) {
+        return 0;
+    }
+
+    plugin->common.link_state = NEU_NODE_LINK_STATE_DISCONNECTED;
+    bus = modbus_bus_attach(param, (void *) plugin, modbus_conn_connected,
+                            modbus_conn_disconnected);
+    if (bus == NULL && plugin->bus != NULL) {
+        // new line settings, only allowed if no other node is on the line
+        modbus_bus_detach(plugin->bus);
+        plugin->bus  = NULL;
+        plugin->conn = NULL;
+        bus = modbus_bus_attach(param, (void *) plugin, modbus_conn_connected,
+                                modbus_conn_disconnected);
+    }
+    if (bus == NULL) {
+        plog_error(plugin,
+                   "device %s is used by other nodes with other settings",
+                   param->params.tty_client.device);
+        return -1;
+    }
+
+    if (plugin->bus != NULL) {
+        modbus_bus_detach(plugin->bus);
+    } else if (plugin->conn != NULL) {
+        neu_conn_destory(plugin->conn);
+    }
+    plugin->bus  = bus;
+    plugin->conn = modbus_bus_conn(bus);
+
+    return 0;
+}
+
 static int driver_config(neu_plugin_t *plugin, const char *config)
 {
     int              ret       = 0;
@@ -180,6 +241,12 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
     neu_json_elem_t degrade_time  = { .name = "degrade_time",
                                      .t    = NEU_JSON_INT };
 
+    neu_json_elem_t degrade_max_time = { .name = "degrade_max_time",
+                                         .t    = NEU_JSON_INT };
+
+    neu_json_elem_t write_window = { .name = "write_window",
+                                     .t    = NEU_JSON_INT };
+
     neu_json_elem_t endianess    = { .name = "endianess", .t = NEU_JSON_INT };
     neu_json_elem_t address_base = { .name = "address_base",
                                      .t    = NEU_JSON_INT };
@@ -236,6 +303,18 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
         degrade_time.v.val_int  = 600;
     }
 
+    ret = neu_parse_param((char *) config, &err_param, 1, &degrade_max_time);
+    if (ret != 0) {
+        free(err_param);
+        degrade_max_time.v.val_int = 3600;
+    }
+
+    ret = neu_parse_param((char *) config, &err_param, 1, &write_window);
+    if (ret != 0 || write_window.v.val_int < 0) {
+        free(err_param);
+        write_window.v.val_int = 0;
+    }
+
     ret = neu_parse_param((char *) config, &err_param, 1, &endianess);
     if (ret != 0) {
         free(err_param);
@@ -264,6 +343,19 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
     plugin->address_base   = address_base.v.val_int;
     plugin->endianess_64   = endianess_64.v.val_int;
 
+    plugin->degrade_max_time = degrade_max_time.v.val_int;
+    modbus_health_config(plugin->health, plugin->degrade_cycle,
+                         plugin->degrade_time * 1000,
+                         plugin->degrade_max_time * 1000, MODBUS_DEGRADE_JITTER);
+    modbus_pace_init(&plugin->pace, plugin->interval, 1);
+    plugin->write_window = write_window.v.val_int;
+
+    if (modbus_read_plan_config(plugin, config) != 0) {
+        free(device.v.val_str);
+        free(host.v.val_str);
+        return -1;
+    }
+
     if (link.v.val_int == 0) {
         param.type = NEU_CONN_TTY_CLIENT;
 
@@ -304,6 +396,18 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
                     host.v.val_str, port.v.val_int, mode.v.val_int);
     }
 
+    if (link.v.val_int == 0) {
+        ret = bus_config(plugin, &param);
+        free(device.v.val_str);
+        return ret;
+    }
+
+    if (plugin->bus != NULL) {
+        modbus_bus_detach(plugin->bus);
+        plugin->bus  = NULL;
+        plugin->conn = NULL;
+    }
+
     if (plugin->conn != NULL) {
         plugin->conn = neu_conn_reconfig(plugin->conn, &param);
     } else {
@@ -313,11 +417,7 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
                          modbus_conn_disconnected);
     }
 
-    if (link.v.val_int == 0) {
-        free(device.v.val_str);
-    } else {
-        free(host.v.val_str);
-    }
+    free(host.v.val_str);
 
     return 0;
 }
@@ -362,6 +462,11 @@ static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group)
     return modbus_group_timer(plugin, group, 0xfa);
 }
 
+static int driver_group_sync(neu_plugin_t *plugin, neu_plugin_group_t *group)
+{
+    return modbus_group_sync(plugin, group, 0xfa);
+}
+
 static int driver_write(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
                         neu_value_u value)
 {
@@ -83,8 +83,10 @@ int modbus_stack_recv(modbus_stack_t *stack, uint8_t slave_id,
             return -1;
         }
 
+        // with requests in flight the response is matched by the caller
         neu_plugin_t *plugin = (neu_plugin_t *) stack->ctx;
-        if (plugin->check_header && header.seq + 1 != stack->read_seq &&
+        if (plugin->check_header && plugin->max_inflight <= 1 &&
+            plugin->n_link <= 1 && header.seq + 1 != stack->read_seq &&
             header.seq + 1 != stack->write_seq) {
             return -1;
         }
@@ -99,7 +101,11 @@ int modbus_stack_recv(modbus_stack_t *stack, uint8_t slave_id,
         return -1;
     }
 
-    void *trace_ctx = (void *) ((intptr_t) stack + (intptr_t) stack->read_seq);
+    // the trace of a request is keyed by the seq following its own
+    uint16_t trace_seq = stack->protocol == MODBUS_PROTOCOL_TCP
+        ? (uint16_t)(header.seq + 1)
+        : stack->read_seq;
+    void *trace_ctx = (void *) ((intptr_t) stack + (intptr_t) trace_seq);
 
     switch (code.function) {
     case MODBUS_READ_COIL:
@@ -480,6 +486,11 @@ int modbus_stack_write(modbus_stack_t *stack, void *req, uint8_t slave_id,
     return ret;
 }
 
+uint16_t modbus_stack_read_seq(modbus_stack_t *stack)
+{
+    return stack->read_seq;
+}
+
 bool modbus_stack_is_rtu(modbus_stack_t *stack)
 {
     return stack->protocol == MODBUS_PROTOCOL_RTU;
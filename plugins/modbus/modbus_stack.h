@@ -58,5 +58,7 @@ int  modbus_stack_write(modbus_stack_t *stack, void *req, uint8_t slave_id,
                         uint16_t n_reg, uint8_t *bytes, uint8_t n_byte,
                         uint16_t *response_size, bool response);
 bool modbus_stack_is_rtu(modbus_stack_t *stack);
+// transaction id of the next read request
+uint16_t modbus_stack_read_seq(modbus_stack_t *stack);
 
 #endif
\ No newline at end of file
@@ -40,6 +40,7 @@ static int driver_connect(neu_plugin_t *plugin);
 
 static int driver_validate_tag(neu_plugin_t *plugin, neu_datatag_t *tag);
 static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group);
+static int driver_group_sync(neu_plugin_t *plugin, neu_plugin_group_t *group);
 static int driver_write(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
                         neu_value_u value);
 static int driver_write_tags(neu_plugin_t *plugin, void *req, UT_array *tags);
@@ -59,7 +60,7 @@ static const neu_plugin_intf_funs_t plugin_intf_funs = {
 
     .driver.validate_tag  = driver_validate_tag,
     .driver.group_timer   = driver_group_timer,
-    .driver.group_sync    = driver_group_timer,
+    .driver.group_sync    = driver_group_sync,
     .driver.write_tag     = driver_write,
     .driver.tag_validator = NULL,
     .driver.write_tags    = driver_write_tags,
@@ -116,6 +117,8 @@ static int driver_init(neu_plugin_t *plugin, bool load)
     plugin->stack    = modbus_stack_create((void *) plugin, MODBUS_PROTOCOL_TCP,
                                         modbus_send_msg, modbus_value_handle,
                                         modbus_write_resp);
+    plugin->health   = modbus_health_new();
+    modbus_cycles_init(plugin);
 
     plog_notice(plugin, "%s init success", plugin->common.name);
     return 0;
@@ -124,6 +127,8 @@ static int driver_init(neu_plugin_t *plugin, bool load)
 static int driver_uninit(neu_plugin_t *plugin)
 {
     plog_notice(plugin, "%s uninit start", plugin->common.name);
+    modbus_cycles_fini(plugin);
+    modbus_links_free(plugin);
     if (plugin->conn != NULL) {
         neu_conn_destory(plugin->conn);
     }
@@ -131,6 +136,8 @@ static int driver_uninit(neu_plugin_t *plugin)
     if (plugin->stack) {
         modbus_stack_destroy(plugin->stack);
     }
+    modbus_read_plan_fini(&plugin->plan);
+    modbus_health_free(plugin->health);
 
     // Repair: Release the corresponding IP memory according to the current
     // mode.
@@ -161,6 +168,7 @@ static int driver_uninit(neu_plugin_t *plugin)
 static int driver_start(neu_plugin_t *plugin)
 {
     neu_conn_start(plugin->conn);
+    modbus_links_start(plugin);
     plog_notice(plugin, "%s start success", plugin->common.name);
     return 0;
 }
@@ -168,6 +176,7 @@ static int driver_start(neu_plugin_t *plugin)
 static int driver_stop(neu_plugin_t *plugin)
 {
     neu_conn_stop(plugin->conn);
+    modbus_links_stop(plugin);
     plog_notice(plugin, "%s stop success", plugin->common.name);
     return 0;
 }
@@ -189,6 +198,10 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
                                        .t    = NEU_JSON_INT };
     neu_json_elem_t  check_header   = { .name = "check_header",
                                      .t    = NEU_JSON_INT };
+    neu_json_elem_t  max_inflight   = { .name = "max_inflight",
+                                     .t    = NEU_JSON_INT };
+
+    neu_json_elem_t links = { .name = "links", .t = NEU_JSON_INT };
 
     neu_json_elem_t degradation   = { .name = "device_degrade",
                                     .t    = NEU_JSON_INT };
@@ -197,6 +210,12 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
     neu_json_elem_t degrade_time  = { .name = "degrade_time",
                                      .t    = NEU_JSON_INT };
 
+    neu_json_elem_t degrade_max_time = { .name = "degrade_max_time",
+                                         .t    = NEU_JSON_INT };
+
+    neu_json_elem_t write_window = { .name = "write_window",
+                                     .t    = NEU_JSON_INT };
+
     neu_json_elem_t endianess    = { .name = "endianess", .t = NEU_JSON_INT };
     neu_json_elem_t address_base = { .name = "address_base",
                                      .t    = NEU_JSON_INT };
@@ -243,6 +262,21 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
         check_header.v.val_int = 0;
     }
 
+    ret = neu_parse_param((char *) config, &err_param, 1, &max_inflight);
+    if (ret != 0 || max_inflight.v.val_int < 1) {
+        free(err_param);
+        max_inflight.v.val_int = 1;
+    }
+
+    ret = neu_parse_param((char *) config, &err_param, 1, &links);
+    if (ret != 0 || links.v.val_int < 1) {
+        free(err_param);
+        links.v.val_int = 1;
+    }
+    if (links.v.val_int > MODBUS_MAX_LINKS) {
+        links.v.val_int = MODBUS_MAX_LINKS;
+    }
+
     ret = neu_parse_param((char *) config, &err_param, 3, &degradation,
                           &degrade_cycle, &degrade_time);
     if (ret != 0) {
@@ -252,6 +286,18 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
         degrade_time.v.val_int  = 600;
     }
 
+    ret = neu_parse_param((char *) config, &err_param, 1, &degrade_max_time);
+    if (ret != 0) {
+        free(err_param);
+        degrade_max_time.v.val_int = 3600;
+    }
+
+    ret = neu_parse_param((char *) config, &err_param, 1, &write_window);
+    if (ret != 0 || write_window.v.val_int < 0) {
+        free(err_param);
+        write_window.v.val_int = 0;
+    }
+
     ret = neu_parse_param((char *) config, &err_param, 1, &endianess);
     if (ret != 0) {
         free(err_param);
@@ -281,6 +327,8 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
     param.log              = plugin->common.log;
     param_backup.log       = plugin->common.log;
     plugin->interval       = interval.v.val_int;
+    plugin->timeout        = timeout.v.val_int;
+    plugin->max_inflight   = max_inflight.v.val_int;
     plugin->max_retries    = max_retries.v.val_int;
     plugin->retry_interval = retry_interval.v.val_int;
     plugin->check_header   = check_header.v.val_int;
@@ -291,6 +339,19 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
     plugin->endianess_64   = endianess_64.v.val_int;
     plugin->address_base   = address_base.v.val_int;
 
+    plugin->degrade_max_time = degrade_max_time.v.val_int;
+    modbus_health_config(plugin->health, plugin->degrade_cycle,
+                         plugin->degrade_time * 1000,
+                         plugin->degrade_max_time * 1000, MODBUS_DEGRADE_JITTER);
+    modbus_pace_init(&plugin->pace, plugin->interval, 1);
+    plugin->write_window = write_window.v.val_int;
+
+    if (modbus_read_plan_config(plugin, config) != 0) {
+        free(host.v.val_str);
+        free(backup_ip.v.val_str);
+        return -1;
+    }
+
     if (mode.v.val_int == 1) {
         param.type                 = NEU_CONN_TCP_SERVER;
         param.params.tcp_server.ip = strdup(
@@ -301,6 +362,7 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
         param.params.tcp_server.timeout      = timeout.v.val_int;
         param.params.tcp_server.max_link     = 1;
         backup                               = false;
+        links.v.val_int                      = 1;
 
         // Fix: Release previous memory when switching to Server mode. Note: Due
         // to union sharing memory, it is necessary to determine how to release
@@ -377,6 +439,7 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
             neu_conn_new(&param, (void *) plugin, modbus_conn_connected,
                          modbus_conn_disconnected);
     }
+    modbus_links_config(plugin, links.v.val_int, &param);
 
     if (host.v.val_str != NULL) {
         free(host.v.val_str);
@@ -444,6 +507,11 @@ static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group)
     return modbus_group_timer(plugin, group, 0xfa);
 }
 
+static int driver_group_sync(neu_plugin_t *plugin, neu_plugin_group_t *group)
+{
+    return modbus_group_sync(plugin, group, 0xfa);
+}
+
 static int driver_write(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
                         neu_value_u value)
 {
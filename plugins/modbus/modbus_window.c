@@ -0,0 +1,200 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdlib.h>
+#include <string.h>
+
+#include "modbus_window.h"
+
+struct modbus_window {
+    uint16_t      size;
+    uint16_t      n_inflight;
+    uint16_t      n_waiting;
+    modbus_txn_t *txns;
+};
+
+modbus_window_t *modbus_window_new(uint16_t size)
+{
+    modbus_window_t *window = calloc(1, sizeof(modbus_window_t));
+
+    window->size = size > 0 ? size : 1;
+    window->txns = calloc(window->size, sizeof(modbus_txn_t));
+
+    return window;
+}
+
+void modbus_window_free(modbus_window_t *window)
+{
+    if (window != NULL) {
+        free(window->txns);
+        free(window);
+    }
+}
+
+void modbus_window_reset(modbus_window_t *window)
+{
+    memset(window->txns, 0, window->size * sizeof(modbus_txn_t));
+    window->n_inflight = 0;
+    window->n_waiting  = 0;
+}
+
+uint16_t modbus_window_size(const modbus_window_t *window)
+{
+    return window->size;
+}
+
+uint16_t modbus_window_inflight(const modbus_window_t *window)
+{
+    return window->n_inflight;
+}
+
+uint16_t modbus_window_busy(const modbus_window_t *window)
+{
+    return window->n_inflight + window->n_waiting;
+}
+
+modbus_txn_t *modbus_window_get(modbus_window_t *window)
+{
+    for (uint16_t i = 0; i < window->size; i++) {
+        if (window->txns[i].state == MODBUS_TXN_FREE) {
+            return &window->txns[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void txn_release(modbus_window_t *window, modbus_txn_t *txn)
+{
+    switch (txn->state) {
+    case MODBUS_TXN_INFLIGHT:
+        window->n_inflight -= 1;
+        break;
+    case MODBUS_TXN_WAITING:
+        window->n_waiting -= 1;
+        break;
+    case MODBUS_TXN_FREE:
+        break;
+    }
+    txn->state = MODBUS_TXN_FREE;
+}
+
+void modbus_window_sent(modbus_window_t *window, modbus_txn_t *txn,
+                        uint32_t cmd, uint16_t seq, uint16_t response_size,
+                        int64_t now, int64_t timeout)
+{
+    if (txn->state == MODBUS_TXN_FREE) {
+        txn->retries = 0;
+    } else {
+        txn_release(window, txn);
+        txn->retries += 1;
+    }
+
+    txn->state         = MODBUS_TXN_INFLIGHT;
+    txn->cmd           = cmd;
+    txn->seq           = seq;
+    txn->response_size = response_size;
+    txn->send_ms       = now;
+    txn->due_ms        = now + timeout;
+    window->n_inflight += 1;
+}
+
+void modbus_window_retry(modbus_window_t *window, modbus_txn_t *txn,
+                         int64_t at)
+{
+    uint16_t retries = txn->retries;
+
+    txn_release(window, txn);
+    txn->state   = MODBUS_TXN_WAITING;
+    txn->retries = retries;
+    txn->due_ms  = at;
+    window->n_waiting += 1;
+}
+
+void modbus_window_done(modbus_window_t *window, modbus_txn_t *txn)
+{
+    txn_release(window, txn);
+}
+
+modbus_txn_t *modbus_window_match(modbus_window_t *window, uint16_t seq)
+{
+    for (uint16_t i = 0; i < window->size; i++) {
+        if (window->txns[i].state == MODBUS_TXN_INFLIGHT &&
+            window->txns[i].seq == seq) {
+            return &window->txns[i];
+        }
+    }
+
+    return NULL;
+}
+
+static modbus_txn_t *window_earliest(modbus_window_t *window,
+                                     modbus_txn_state_e state, int64_t now)
+{
+    modbus_txn_t *find = NULL;
+
+    for (uint16_t i = 0; i < window->size; i++) {
+        modbus_txn_t *txn = &window->txns[i];
+
+        if (txn->state == state && txn->due_ms <= now &&
+            (find == NULL || txn->due_ms < find->due_ms)) {
+            find = txn;
+        }
+    }
+
+    return find;
+}
+
+modbus_txn_t *modbus_window_expired(modbus_window_t *window, int64_t now)
+{
+    return window_earliest(window, MODBUS_TXN_INFLIGHT, now);
+}
+
+modbus_txn_t *modbus_window_due(modbus_window_t *window, int64_t now)
+{
+    return window_earliest(window, MODBUS_TXN_WAITING, now);
+}
+
+int64_t modbus_window_next(const modbus_window_t *window)
+{
+    int64_t next = -1;
+
+    for (uint16_t i = 0; i < window->size; i++) {
+        const modbus_txn_t *txn = &window->txns[i];
+
+        if (txn->state != MODBUS_TXN_FREE && (next < 0 || txn->due_ms < next)) {
+            next = txn->due_ms;
+        }
+    }
+
+    return next;
+}
+
+uint16_t modbus_window_response_size(const modbus_window_t *window)
+{
+    uint16_t size = 0;
+
+    for (uint16_t i = 0; i < window->size; i++) {
+        if (window->txns[i].state == MODBUS_TXN_INFLIGHT &&
+            window->txns[i].response_size > size) {
+            size = window->txns[i].response_size;
+        }
+    }
+
+    return size;
+}
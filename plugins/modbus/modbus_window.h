@@ -0,0 +1,94 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_PLUGIN_MODBUS_WINDOW_H_
+#define _NEU_PLUGIN_MODBUS_WINDOW_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/*
+ * Read transactions in flight on a modbus tcp connection.
+ *
+ * Up to `size` requests are sent before the first response is received,
+ * responses are matched to their request by the transaction id of the mbap
+ * header and may complete in any order. A transaction that is not answered
+ * before its deadline is either scheduled for a resend or given up.
+ */
+typedef enum modbus_txn_state {
+    MODBUS_TXN_FREE = 0,
+    MODBUS_TXN_INFLIGHT,
+    MODBUS_TXN_WAITING, // waiting to be resent
+} modbus_txn_state_e;
+
+typedef struct modbus_txn {
+    modbus_txn_state_e state;
+    uint32_t           cmd;     // index of the read command
+    uint16_t           seq;     // transaction id of the last send
+    uint16_t           retries; // resends so far
+    uint16_t           response_size;
+    int64_t            send_ms;
+    int64_t            due_ms; // deadline if in flight, resend time if waiting
+} modbus_txn_t;
+
+typedef struct modbus_window modbus_window_t;
+
+modbus_window_t *modbus_window_new(uint16_t size);
+void             modbus_window_free(modbus_window_t *window);
+void             modbus_window_reset(modbus_window_t *window);
+
+uint16_t modbus_window_size(const modbus_window_t *window);
+uint16_t modbus_window_inflight(const modbus_window_t *window);
+// transactions in flight or waiting to be resent
+uint16_t modbus_window_busy(const modbus_window_t *window);
+
+// a free slot, NULL if the window is full
+modbus_txn_t *modbus_window_get(modbus_window_t *window);
+
+/*
+ * Mark a transaction in flight, for a first send or a resend.
+ *
+ * @param timeout milliseconds the response is waited for.
+ */
+void modbus_window_sent(modbus_window_t *window, modbus_txn_t *txn,
+                        uint32_t cmd, uint16_t seq, uint16_t response_size,
+                        int64_t now, int64_t timeout);
+// schedule a resend of an expired transaction at `at`
+void modbus_window_retry(modbus_window_t *window, modbus_txn_t *txn,
+                         int64_t at);
+void modbus_window_done(modbus_window_t *window, modbus_txn_t *txn);
+
+// the transaction in flight with transaction id seq, NULL if there is none
+modbus_txn_t *modbus_window_match(modbus_window_t *window, uint16_t seq);
+// the oldest transaction in flight past its deadline, NULL if there is none
+modbus_txn_t *modbus_window_expired(modbus_window_t *window, int64_t now);
+// a waiting transaction due for a resend, NULL if there is none
+modbus_txn_t *modbus_window_due(modbus_window_t *window, int64_t now);
+// the earliest deadline or resend time, -1 if the window is idle
+int64_t modbus_window_next(const modbus_window_t *window);
+// the biggest response size in flight
+uint16_t modbus_window_response_size(const modbus_window_t *window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
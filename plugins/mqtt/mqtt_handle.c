@@ -97,6 +97,54 @@ static int tag_values_to_json(UT_array *tags, mqtt_static_vt_t *s_tags,
     return 0;
 }
 
+static int snapshot_to_json(const neu_group_snapshot_t *snap,
+                            mqtt_static_vt_t *s_tags, size_t n_s_tags,
+                            neu_json_read_resp_t *json, bool filter_error)
+{
+    int      index   = 0;
+    uint32_t n_valid = 0;
+    uint32_t n_tag   = neu_group_snapshot_size(snap);
+
+    for (uint32_t i = 0; i < n_tag; i++) {
+        if (!filter_error ||
+            neu_group_snapshot_type(snap, i) != NEU_TYPE_ERROR) {
+            n_valid += 1;
+        }
+    }
+
+    if (n_valid == 0) {
+        return 0;
+    }
+
+    json->n_tag = n_valid + n_s_tags;
+    json->tags  = (neu_json_read_resp_tag_t *) calloc(
+        json->n_tag, sizeof(neu_json_read_resp_tag_t));
+    if (NULL == json->tags) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < n_tag; i++) {
+        if (filter_error &&
+            neu_group_snapshot_type(snap, i) == NEU_TYPE_ERROR) {
+            continue;
+        }
+        neu_group_snapshot_to_json(snap, i, &json->tags[index]);
+        index += 1;
+    }
+
+    if (s_tags != NULL) {
+        for (size_t i = 0; i < n_s_tags; i++) {
+            neu_json_read_resp_tag_t *tag = &json->tags[index];
+            tag->name                     = s_tags[i].name;
+            tag->t                        = s_tags[i].jtype;
+            tag->value                    = s_tags[i].jvalue;
+            index += 1;
+        }
+    }
+
+    return 0;
+}
+
 char *generate_upload_json(neu_plugin_t *plugin, neu_reqresp_trans_data_t *data,
                            mqtt_upload_format_e format, mqtt_schema_vt_t *vts,
                            size_t n_vts, mqtt_static_vt_t *s_tags,
@@ -110,16 +158,16 @@ char *generate_upload_json(neu_plugin_t *plugin, neu_reqresp_trans_data_t *data,
 
     if (format == MQTT_UPLOAD_FORMAT_CUSTOM) {
         if (0 !=
-            tag_values_to_json(data->tags, NULL, 0, &json,
-                               !plugin->config.upload_err)) {
-            plog_error(plugin, "tag_values_to_json fail");
+            snapshot_to_json(data->snapshot, NULL, 0, &json,
+                             !plugin->config.upload_err)) {
+            plog_error(plugin, "snapshot_to_json fail");
             return NULL;
         }
     } else {
         if (0 !=
-            tag_values_to_json(data->tags, s_tags, n_s_tags, &json,
-                               !plugin->config.upload_err)) {
-            plog_error(plugin, "tag_values_to_json fail");
+            snapshot_to_json(data->snapshot, s_tags, n_s_tags, &json,
+                             !plugin->config.upload_err)) {
+            plog_error(plugin, "snapshot_to_json fail");
             return NULL;
         }
     }
@@ -1368,24 +1416,32 @@ int handle_trans_data(neu_plugin_t *            plugin,
         if (plugin->config.format == MQTT_UPLOAD_FORMAT_PROTOBUF) {
             Model__DataReport data_report = MODEL__DATA_REPORT__INIT;
 
+            const neu_group_snapshot_t *snap  = trans_data->snapshot;
+            uint32_t                    n_tag = neu_group_snapshot_size(snap);
+
             data_report.node      = trans_data->driver;
             data_report.group     = trans_data->group;
             data_report.timestamp = global_timestamp;
-            data_report.n_tags    = utarray_len(trans_data->tags) + n_satic_tag;
+            data_report.n_tags    = n_tag + n_satic_tag;
             data_report.tags =
                 calloc(data_report.n_tags, sizeof(Model__DataItem *));
 
             int index = 0;
-            utarray_foreach(trans_data->tags, neu_resp_tag_value_meta_t *,
-                            tag_value)
-            {
+            for (uint32_t k = 0; k < n_tag; k++) {
+                const neu_snapshot_value_u *v      = NULL;
+                neu_tag_meta_t *            metas  = NULL;
+                int                         n_meta = 0;
+
+                v     = neu_group_snapshot_value(snap, k);
+                metas = neu_group_snapshot_metas(snap, k, &n_meta);
+
                 Model__DataItem *tag = calloc(1, sizeof(Model__DataItem));
                 model__data_item__init(tag);
-                tag->name = tag_value->tag;
-                switch (tag_value->value.type) {
+                tag->name = (char *) neu_group_snapshot_tag(snap, k);
+                switch (neu_group_snapshot_type(snap, k)) {
                 case NEU_TYPE_ERROR:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_ERROR;
-                    tag->error     = tag_value->value.value.i32;
+                    tag->error     = v->i32;
                     break;
                 case NEU_TYPE_UINT8:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1393,7 +1449,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
-                    tag->value->int_value = tag_value->value.value.u8;
+                    tag->value->int_value = v->u8;
                     break;
                 case NEU_TYPE_INT8:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1401,7 +1457,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
-                    tag->value->int_value = tag_value->value.value.i8;
+                    tag->value->int_value = v->i8;
                     break;
                 case NEU_TYPE_INT16:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1409,7 +1465,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
-                    tag->value->int_value = tag_value->value.value.i16;
+                    tag->value->int_value = v->i16;
                     break;
                 case NEU_TYPE_WORD:
                 case NEU_TYPE_UINT16:
@@ -1418,7 +1474,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
-                    tag->value->int_value = tag_value->value.value.u16;
+                    tag->value->int_value = v->u16;
                     break;
                 case NEU_TYPE_INT32:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1426,7 +1482,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
-                    tag->value->int_value = tag_value->value.value.i32;
+                    tag->value->int_value = v->i32;
                     break;
                 case NEU_TYPE_DWORD:
                 case NEU_TYPE_UINT32:
@@ -1435,7 +1491,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
-                    tag->value->int_value = tag_value->value.value.u32;
+                    tag->value->int_value = v->u32;
                     break;
                 case NEU_TYPE_INT64:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1443,7 +1499,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
-                    tag->value->int_value = tag_value->value.value.i64;
+                    tag->value->int_value = v->i64;
                     break;
                 case NEU_TYPE_FLOAT:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1451,7 +1507,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_FLOAT_VALUE;
-                    tag->value->float_value = tag_value->value.value.f32;
+                    tag->value->float_value = v->f32;
                     break;
                 case NEU_TYPE_DOUBLE:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1459,7 +1515,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_FLOAT_VALUE;
-                    tag->value->float_value = tag_value->value.value.d64;
+                    tag->value->float_value = v->d64;
                     break;
                 case NEU_TYPE_BOOL:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1467,7 +1523,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_BOOL_VALUE;
-                    tag->value->bool_value = tag_value->value.value.boolean;
+                    tag->value->bool_value = v->boolean;
                     break;
                 case NEU_TYPE_STRING:
                     tag->item_case = MODEL__DATA_ITEM__ITEM_VALUE;
@@ -1475,22 +1531,22 @@ int handle_trans_data(neu_plugin_t *            plugin,
                     model__data_item_value__init(tag->value);
                     tag->value->value_case =
                         MODEL__DATA_ITEM_VALUE__VALUE_STRING_VALUE;
-                    tag->value->string_value = tag_value->value.value.str;
+                    tag->value->string_value = v->str;
                     break;
                 default:
                     break;
                 }
 
-                for (int i = 0; i < tag_value->n_meta; i++) {
-                    if (strlen(tag_value->metas[i].name) > 0) {
-                        if (strncmp(tag_value->metas[i].name, "q", 1) == 0) {
+                for (int i = 0; i < n_meta; i++) {
+                    if (strlen(metas[i].name) > 0) {
+                        if (strncmp(metas[i].name, "q", 1) == 0) {
                             tag->has_q = true;
-                            tag->q     = tag_value->metas[i].value.value.i32;
+                            tag->q     = metas[i].value.value.i32;
                         }
 
-                        if (strncmp(tag_value->metas[i].name, "t", 1) == 0) {
+                        if (strncmp(metas[i].name, "t", 1) == 0) {
                             tag->has_t = true;
-                            tag->t     = tag_value->metas[i].value.value.i64;
+                            tag->t     = metas[i].value.value.i64;
                         }
                     } else {
                         break;
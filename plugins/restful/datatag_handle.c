@@ -90,6 +90,10 @@ void handle_add_tags(nng_aio *aio)
                         cmd.tags[i].precision = req->tags[i].precision;
                         cmd.tags[i].decimal   = req->tags[i].decimal;
                         cmd.tags[i].bias      = req->tags[i].bias;
+                        cmd.tags[i].deadband =
+                            neu_json_tag_get_deadband(&req->tags[i]);
+                        cmd.tags[i].window =
+                            neu_json_tag_get_window(&req->tags[i]);
                         cmd.tags[i].address   = strdup(req->tags[i].address);
                         cmd.tags[i].name      = strdup(req->tags[i].name);
                         if (req->tags[i].description != NULL) {
@@ -228,6 +232,10 @@ void handle_add_gtags(nng_aio *aio)
                             req->groups[i].tags[j].decimal;
                         cmd.groups[i].tags[j].bias =
                             req->groups[i].tags[j].bias;
+                        cmd.groups[i].tags[j].deadband =
+                            neu_json_tag_get_deadband(&req->groups[i].tags[j]);
+                        cmd.groups[i].tags[j].window =
+                            neu_json_tag_get_window(&req->groups[i].tags[j]);
                         cmd.groups[i].tags[j].address =
                             strdup(req->groups[i].tags[j].address);
                         cmd.groups[i].tags[j].name =
@@ -405,6 +413,9 @@ void handle_update_tags(nng_aio *aio)
                 cmd.tags[i].precision = req->tags[i].precision;
                 cmd.tags[i].decimal   = req->tags[i].decimal;
                 cmd.tags[i].bias      = req->tags[i].bias;
+                cmd.tags[i].deadband =
+                    neu_json_tag_get_deadband(&req->tags[i]);
+                cmd.tags[i].window = neu_json_tag_get_window(&req->tags[i]);
                 cmd.tags[i].address   = strdup(req->tags[i].address);
                 cmd.tags[i].name      = strdup(req->tags[i].name);
                 if (req->tags[i].description != NULL) {
@@ -565,6 +576,8 @@ void handle_get_tags_resp(nng_aio *aio, neu_resp_get_tag_t *tags)
         tags_res.tags[index].bias        = tag->bias;
         tags_res.tags[index].t           = NEU_JSON_UNDEFINE;
         tags_res.tags[index].unit        = tag->unit;
+        neu_json_tag_set_deadband(&tags_res.tags[index], &tag->deadband);
+        neu_json_tag_set_window(&tags_res.tags[index], &tag->window);
     }
 
     neu_json_encode_by_fn(&tags_res, neu_json_encode_get_tags_resp, &result);
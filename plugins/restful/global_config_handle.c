@@ -1144,6 +1144,8 @@ static int get_tags_resp(context_t *ctx, neu_resp_get_tag_t *tags)
         tags_res.tags[index].decimal     = tag->decimal;
         tags_res.tags[index].bias        = tag->bias;
         tags_res.tags[index].t           = NEU_JSON_UNDEFINE;
+        neu_json_tag_set_deadband(&tags_res.tags[index], &tag->deadband);
+        neu_json_tag_set_window(&tags_res.tags[index], &tag->window);
     }
 
     // accumulate tag object in `tags` array
@@ -1224,6 +1226,8 @@ static int get_driver_tags_resp(context_t *ctx, neu_resp_get_tag_t *tags)
         gtag->tags[index].decimal     = tag->decimal;
         gtag->tags[index].bias        = tag->bias;
         gtag->tags[index].t           = NEU_JSON_UNDEFINE;
+        neu_json_tag_set_deadband(&gtag->tags[index], &tag->deadband);
+        neu_json_tag_set_window(&gtag->tags[index], &tag->window);
         tag->name                     = NULL; // moved
         tag->address                  = NULL; // moved
         tag->description              = NULL; // moved
@@ -1491,6 +1495,8 @@ static int add_tag(context_t *ctx, neu_json_add_tags_req_t *data)
         cmd.tags[i].precision = data->tags[i].precision;
         cmd.tags[i].decimal   = data->tags[i].decimal;
         cmd.tags[i].bias      = data->tags[i].bias;
+        cmd.tags[i].deadband  = neu_json_tag_get_deadband(&data->tags[i]);
+        cmd.tags[i].window    = neu_json_tag_get_window(&data->tags[i]);
         cmd.tags[i].address   = strdup(data->tags[i].address);
         cmd.tags[i].name      = strdup(data->tags[i].name);
         cmd.tags[i].description =
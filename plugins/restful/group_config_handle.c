@@ -39,7 +39,10 @@ void handle_add_group_config(nng_aio *aio)
                 CHECK_NODE_NAME_LENGTH_ERR;
             } else if (strlen(req->group) >= NEU_GROUP_NAME_LEN) {
                 CHECK_GROUP_NAME_LENGTH_ERR;
-            } else if (req->interval < NEU_GROUP_INTERVAL_LIMIT) {
+            } else if (req->interval < NEU_GROUP_INTERVAL_LIMIT ||
+                       req->aggregate < 0 || req->aggregate > UINT32_MAX ||
+                       (req->aggregate > 0 &&
+                        req->aggregate < req->interval)) {
                 CHECK_GROUP_INTERVAL_ERR;
             } else {
                 int                 ret    = 0;
@@ -50,8 +53,9 @@ void handle_add_group_config(nng_aio *aio)
                 header.otel_trace_type     = NEU_OTEL_TRACE_TYPE_REST_COMM;
                 strncpy(cmd.driver, req->node, NEU_NODE_NAME_LEN - 1);
                 strncpy(cmd.group, req->group, NEU_GROUP_NAME_LEN - 1);
-                cmd.interval = req->interval;
-                ret          = neu_plugin_op(plugin, header, &cmd);
+                cmd.interval  = req->interval;
+                cmd.aggregate = req->aggregate;
+                ret           = neu_plugin_op(plugin, header, &cmd);
                 if (ret != 0) {
                     NEU_JSON_RESPONSE_ERROR(NEU_ERR_IS_BUSY, {
                         neu_http_response(aio, NEU_ERR_IS_BUSY, result_error);
@@ -74,11 +78,14 @@ static inline int send_update_group(nng_aio *                           aio,
                (req->interval < NEU_GROUP_INTERVAL_LIMIT ||
                 req->interval > UINT32_MAX)) {
         return NEU_ERR_GROUP_PARAMETER_INVALID;
+    } else if (req->set_aggregate &&
+               (req->aggregate < 0 || req->aggregate > UINT32_MAX)) {
+        return NEU_ERR_GROUP_PARAMETER_INVALID;
     }
 
     // for backward compatibility,
-    // `new_name` or `interval` (inclusive) should be provided
-    if (!req->new_name && !req->set_interval) {
+    // `new_name`, `interval` or `aggregate` (inclusive) should be provided
+    if (!req->new_name && !req->set_interval && !req->set_aggregate) {
         return NEU_ERR_BODY_IS_WRONG;
     }
 
@@ -100,7 +107,9 @@ static inline int send_update_group(nng_aio *                           aio,
 
     strncpy(cmd.driver, req->node, NEU_NODE_NAME_LEN - 1);
     strncpy(cmd.group, req->group, NEU_GROUP_NAME_LEN - 1);
-    cmd.interval = req->set_interval ? req->interval : 0;
+    cmd.interval      = req->set_interval ? req->interval : 0;
+    cmd.set_aggregate = req->set_aggregate;
+    cmd.aggregate     = req->aggregate;
 
     neu_reqresp_head_t header = {
         .ctx             = aio,
@@ -208,6 +217,7 @@ void handle_get_group_resp(nng_aio *aio, neu_resp_get_group_t *groups)
         gconfig_res.group_configs[index].name      = group->name;
         gconfig_res.group_configs[index].interval  = group->interval;
         gconfig_res.group_configs[index].tag_count = group->tag_count;
+        gconfig_res.group_configs[index].aggregate = group->aggregate;
     }
 
     neu_json_encode_by_fn(&gconfig_res, neu_json_encode_get_group_config_resp,
@@ -165,6 +165,38 @@ static inline void gen_global_metrics(const neu_metrics_t *metrics,
             metrics->north_nodes, metrics->north_running_nodes,
             metrics->north_disconnected_nodes, metrics->south_nodes,
             metrics->south_running_nodes, metrics->south_disconnected_nodes);
+
+    fprintf(stream,
+            "# HELP mem_pool_in_use_objects Number of live pool objects\n"
+            "# TYPE mem_pool_in_use_objects gauge\n");
+    for (int i = 0; i < NEU_MEM_POOL_MAX; ++i) {
+        fprintf(stream, "mem_pool_in_use_objects{pool=\"%s\"} %" PRIu64 "\n",
+                neu_mem_pool_name(i), metrics->mem_pools[i].in_use);
+    }
+
+    fprintf(stream,
+            "# HELP mem_pool_allocs_total Total number of pool allocations\n"
+            "# TYPE mem_pool_allocs_total counter\n");
+    for (int i = 0; i < NEU_MEM_POOL_MAX; ++i) {
+        fprintf(stream, "mem_pool_allocs_total{pool=\"%s\"} %" PRIu64 "\n",
+                neu_mem_pool_name(i), metrics->mem_pools[i].allocs);
+    }
+
+    fprintf(stream,
+            "# HELP mem_pool_mallocs_total Pool allocations served by malloc\n"
+            "# TYPE mem_pool_mallocs_total counter\n");
+    for (int i = 0; i < NEU_MEM_POOL_MAX; ++i) {
+        fprintf(stream, "mem_pool_mallocs_total{pool=\"%s\"} %" PRIu64 "\n",
+                neu_mem_pool_name(i), metrics->mem_pools[i].mallocs);
+    }
+
+    fprintf(stream,
+            "# HELP mem_pool_cached_blocks Free blocks in the shared depot\n"
+            "# TYPE mem_pool_cached_blocks gauge\n");
+    for (int i = 0; i < NEU_MEM_POOL_MAX; ++i) {
+        fprintf(stream, "mem_pool_cached_blocks{pool=\"%s\"} %" PRIu64 "\n",
+                neu_mem_pool_name(i), metrics->mem_pools[i].cached);
+    }
 }
 
 static inline void gen_single_node_metrics(neu_node_metrics_t *node_metrics,
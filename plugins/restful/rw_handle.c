@@ -60,14 +60,16 @@ void handle_read(nng_aio *aio)
                 goto error;
             }
 
-            cmd.driver = req->node;
-            cmd.group  = req->group;
-            cmd.name   = req->name;
-            cmd.desc   = req->desc;
-            cmd.sync   = req->sync;
-            req->node  = NULL;
-            req->group = NULL;
-            ret        = neu_plugin_op(plugin, header, &cmd);
+            cmd.driver        = req->node;
+            cmd.group         = req->group;
+            cmd.name          = req->name;
+            cmd.desc          = req->desc;
+            cmd.sync          = req->sync;
+            cmd.history       = req->history;
+            cmd.history_query = req->history_query;
+            req->node         = NULL;
+            req->group        = NULL;
+            ret               = neu_plugin_op(plugin, header, &cmd);
             if (ret != 0) {
                 neu_req_read_group_fini(&cmd);
                 NEU_JSON_RESPONSE_ERROR(NEU_ERR_IS_BUSY, {
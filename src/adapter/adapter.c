@@ -38,18 +38,24 @@
 #include "adapter.h"
 #include "adapter_internal.h"
 #include "base/msg_internal.h"
+#include "core/route.h"
 #include "driver/driver_internal.h"
 #include "errcodes.h"
 #include "persist/persist.h"
 #include "plugin.h"
 #include "storage.h"
 
-void adapter_msg_q_exit(adapter_msg_q_t *q);
+#define ADAPTER_MSG_Q_SIZE 1024
+#define ADAPTER_MSG_Q_BATCH 32
+
+extern adapter_msg_q_policy_e g_msg_q_policy;
 
 static void *adapter_consumer(void *arg);
 static int   adapter_trans_data(enum neu_event_io_type type, int fd,
                                 void *usr_data);
 static int   adapter_loop(enum neu_event_io_type type, int fd, void *usr_data);
+static int   adapter_inbox(enum neu_event_io_type type, int fd, void *usr_data);
+static void  adapter_dispatch(neu_adapter_t *adapter, neu_msg_t *msg);
 static int   adapter_command(neu_adapter_t *adapter, neu_reqresp_head_t header,
                              void *data);
 static int adapter_response(neu_adapter_t *adapter, neu_reqresp_head_t *header,
@@ -125,14 +131,18 @@ static __thread int create_adapter_error = 0;
     REGISTER_METRIC(adapter, NEU_METRIC_TAG_READS_TOTAL, 0); \
     REGISTER_METRIC(adapter, NEU_METRIC_TAG_READ_ERRORS_TOTAL, 0);
 
-#define REGISTER_APP_METRICS(adapter)                              \
-    REGISTER_METRIC(adapter, NEU_METRIC_LINK_STATE,                \
-                    NEU_NODE_LINK_STATE_DISCONNECTED);             \
-    REGISTER_METRIC(adapter, NEU_METRIC_RUNNING_STATE,             \
-                    NEU_NODE_RUNNING_STATE_INIT);                  \
-    REGISTER_METRIC(adapter, NEU_METRIC_SEND_MSGS_TOTAL, 0);       \
-    REGISTER_METRIC(adapter, NEU_METRIC_SEND_MSG_ERRORS_TOTAL, 0); \
-    REGISTER_METRIC(adapter, NEU_METRIC_RECV_MSGS_TOTAL, 0);
+#define REGISTER_APP_METRICS(adapter)                                 \
+    REGISTER_METRIC(adapter, NEU_METRIC_LINK_STATE,                   \
+                    NEU_NODE_LINK_STATE_DISCONNECTED);                \
+    REGISTER_METRIC(adapter, NEU_METRIC_RUNNING_STATE,                \
+                    NEU_NODE_RUNNING_STATE_INIT);                     \
+    REGISTER_METRIC(adapter, NEU_METRIC_SEND_MSGS_TOTAL, 0);          \
+    REGISTER_METRIC(adapter, NEU_METRIC_SEND_MSG_ERRORS_TOTAL, 0);    \
+    REGISTER_METRIC(adapter, NEU_METRIC_RECV_MSGS_TOTAL, 0);          \
+    REGISTER_METRIC(adapter, NEU_METRIC_MSG_QUEUE_DEPTH, 0);          \
+    REGISTER_METRIC(adapter, NEU_METRIC_MSG_QUEUE_LATENCY_MS, 0);     \
+    REGISTER_METRIC(adapter, NEU_METRIC_MSG_QUEUE_MAX_LATENCY_MS, 0); \
+    REGISTER_METRIC(adapter, NEU_METRIC_MSG_QUEUE_DROPPED_TOTAL, 0);
 
 int neu_adapter_error()
 {
@@ -144,42 +154,143 @@ void neu_adapter_set_error(int error)
     create_adapter_error = error;
 }
 
+static void update_msg_q_metrics(neu_adapter_t *adapter)
+{
+    adapter_msg_q_stats_t stats = { 0 };
+
+    adapter_msg_q_stats(adapter->msg_q, &stats);
+    adapter_update_metric(adapter, NEU_METRIC_MSG_QUEUE_DEPTH, stats.depth,
+                          NULL);
+    adapter_update_metric(adapter, NEU_METRIC_MSG_QUEUE_LATENCY_MS,
+                          stats.latency_us / 1000, NULL);
+    adapter_update_metric(adapter, NEU_METRIC_MSG_QUEUE_MAX_LATENCY_MS,
+                          stats.max_latency_us / 1000, NULL);
+    if (stats.dropped > 0) {
+        adapter_update_metric(adapter, NEU_METRIC_MSG_QUEUE_DROPPED_TOTAL,
+                              stats.dropped, NULL);
+    }
+}
+
 static void *adapter_consumer(void *arg)
 {
     neu_adapter_t *adapter = (neu_adapter_t *) arg;
+    neu_msg_t *    msgs[ADAPTER_MSG_Q_BATCH];
 
     while (1) {
-        neu_msg_t *msg = NULL;
-        uint32_t   n   = adapter_msg_q_pop(adapter->msg_q, &msg);
-        if (msg == NULL) {
+        uint32_t n = adapter_msg_q_pop_batch(adapter->msg_q, msgs,
+                                             ADAPTER_MSG_Q_BATCH);
+        if (n == 0) {
             // safe quit
             break;
         }
-        neu_reqresp_head_t *header = neu_msg_get_header(msg);
 
-        nlog_debug("adapter(%s) recv msg from: %s %p, type: %s, %u",
-                   adapter->name, header->sender, header->ctx,
-                   neu_reqresp_type_string(header->type), n);
-        if (adapter->state == NEU_NODE_RUNNING_STATE_RUNNING) {
-            adapter->module->intf_funs->request(
-                adapter->plugin, (neu_reqresp_head_t *) header, &header[1]);
-        } else {
-            void *ctx = ((neu_reqresp_trans_data_t *) &header[1])->trace_ctx;
-            if (neu_otel_data_is_started() && ctx) {
-                neu_otel_trace_ctx trace = neu_otel_find_trace(ctx);
-                if (trace) {
-                    neu_otel_trace_reduce_expected_span_num(trace, 1);
+        for (uint32_t i = 0; i < n; i++) {
+            neu_reqresp_head_t *header = neu_msg_get_header(msgs[i]);
+
+            nlog_debug("adapter(%s) recv msg from: %s %p, type: %s, %u/%u",
+                       adapter->name, header->sender, header->ctx,
+                       neu_reqresp_type_string(header->type), i + 1, n);
+            if (adapter->state == NEU_NODE_RUNNING_STATE_RUNNING) {
+                adapter->module->intf_funs->request(
+                    adapter->plugin, (neu_reqresp_head_t *) header,
+                    &header[1]);
+            } else {
+                void *ctx =
+                    ((neu_reqresp_trans_data_t *) &header[1])->trace_ctx;
+                if (neu_otel_data_is_started() && ctx) {
+                    neu_otel_trace_ctx trace = neu_otel_find_trace(ctx);
+                    if (trace) {
+                        neu_otel_trace_reduce_expected_span_num(trace, 1);
+                    }
                 }
             }
+
+            neu_trans_data_free((neu_reqresp_trans_data_t *) &header[1]);
+            neu_msg_free(msgs[i]);
         }
 
-        neu_trans_data_free((neu_reqresp_trans_data_t *) &header[1]);
-        neu_msg_free(msg);
+        if (NULL != adapter->metrics) {
+            update_msg_q_metrics(adapter);
+        }
     }
 
     return NULL;
 }
 
+// data plane messages that other nodes may push to the inbox of a node
+static bool is_direct(neu_reqresp_type_e type)
+{
+    switch (type) {
+    case NEU_REQ_READ_GROUP:
+    case NEU_REQ_READ_GROUP_PAGINATE:
+    case NEU_REQ_WRITE_TAG:
+    case NEU_REQ_WRITE_TAGS:
+    case NEU_REQ_WRITE_GTAGS:
+    case NEU_RESP_READ_GROUP:
+    case NEU_RESP_READ_GROUP_PAGINATE:
+    case NEU_RESP_WRITE_TAGS:
+    case NEU_RESP_ERROR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*
+ * Send a data plane message straight to the inbox of the receiver, the
+ * manager only forwards these messages. Returns false if the message is left
+ * to the manager, for an unknown receiver or a full inbox.
+ */
+static bool send_direct(neu_adapter_t *adapter, neu_reqresp_head_t *header)
+{
+    if (!is_direct(header->type)) {
+        return false;
+    }
+
+    if (neu_route_send(header->receiver, (neu_msg_t *) header) != 0) {
+        return false;
+    }
+
+    nlog_debug("adapter: %s send %s to %s directly", adapter->name,
+               neu_reqresp_type_string(header->type), header->receiver);
+    return true;
+}
+
+static void inbox_msg_free(neu_msg_t *msg)
+{
+    neu_reqresp_head_t *header = neu_msg_get_header(msg);
+
+    switch (header->type) {
+    case NEU_REQ_READ_GROUP:
+        neu_req_read_group_fini((neu_req_read_group_t *) &header[1]);
+        break;
+    case NEU_REQ_READ_GROUP_PAGINATE:
+        neu_req_read_group_paginate_fini(
+            (neu_req_read_group_paginate_t *) &header[1]);
+        break;
+    case NEU_REQ_WRITE_TAG:
+        neu_req_write_tag_fini((neu_req_write_tag_t *) &header[1]);
+        break;
+    case NEU_REQ_WRITE_TAGS:
+        neu_req_write_tags_fini((neu_req_write_tags_t *) &header[1]);
+        break;
+    case NEU_REQ_WRITE_GTAGS:
+        neu_req_write_gtags_fini((neu_req_write_gtags_t *) &header[1]);
+        break;
+    case NEU_RESP_READ_GROUP:
+        neu_resp_read_free((neu_resp_read_group_t *) &header[1]);
+        break;
+    case NEU_RESP_READ_GROUP_PAGINATE:
+        neu_resp_read_paginate_free(
+            (neu_resp_read_group_paginate_t *) &header[1]);
+        break;
+    default:
+        break;
+    }
+
+    neu_msg_free(msg);
+}
+
 static inline zlog_category_t *get_log_category(const char *node)
 {
     char name[NEU_NODE_NAME_LEN] = { 0 };
@@ -280,7 +391,8 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
         neu_adapter_driver_init((neu_adapter_driver_t *) adapter);
         break;
     case NEU_NA_TYPE_APP: {
-        adapter->msg_q = adapter_msg_q_new(adapter->name, 1024);
+        adapter->msg_q = adapter_msg_q_new(adapter->name, ADAPTER_MSG_Q_SIZE,
+                                           g_msg_q_policy);
         pthread_create(&adapter->consumer_tid, NULL, adapter_consumer,
                        (void *) adapter);
         while (true) {
@@ -294,6 +406,7 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
                 break;
             }
         }
+        adapter_msg_q_bind(adapter->msg_q, adapter->trans_data_port);
 
         param.usr_data = (void *) adapter;
         param.cb       = adapter_trans_data;
@@ -343,6 +456,13 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
 
     adapter->control_io = neu_event_add_io(adapter->events, param);
 
+    adapter->inbox = adapter_msg_q_new(adapter->name, ADAPTER_MSG_Q_SIZE,
+                                       ADAPTER_MSG_Q_DROP_NEWEST);
+    adapter_msg_q_set_free(adapter->inbox, inbox_msg_free);
+    param.fd          = adapter_msg_q_fd(adapter->inbox);
+    param.cb          = adapter_inbox;
+    adapter->inbox_io = neu_event_add_io(adapter->events, param);
+
     adapter_storage_state(adapter->name, adapter->state);
 
     if (init_rv != 0) {
@@ -355,6 +475,7 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
             neu_event_del_io(adapter->events, adapter->trans_data_io);
         }
         neu_event_del_io(adapter->events, adapter->control_io);
+        neu_event_del_io(adapter->events, adapter->inbox_io);
 
         neu_adapter_destroy(adapter);
         return NULL;
@@ -782,6 +903,10 @@ static int adapter_command(neu_adapter_t *adapter, neu_reqresp_head_t header,
         break;
     }
 
+    if (send_direct(adapter, pheader)) {
+        return 0;
+    }
+
     ret = neu_send_msg(adapter->control_fd, msg);
     if (0 != ret) {
         nlog_error(
@@ -803,6 +928,10 @@ static int adapter_response(neu_adapter_t *adapter, neu_reqresp_head_t *header,
     neu_msg_exchange(header);
 
     neu_msg_gen(header, data);
+    if (send_direct(adapter, header)) {
+        return 0;
+    }
+
     neu_msg_t *msg = (neu_msg_t *) header;
     int        ret = neu_send_msg(adapter->control_fd, msg);
     if (0 != ret) {
@@ -818,6 +947,19 @@ static int adapter_response(neu_adapter_t *adapter, neu_reqresp_head_t *header,
 static int adapter_responseto(neu_adapter_t *     adapter,
                               neu_reqresp_head_t *header, void *data,
                               struct sockaddr_un dst)
+{
+    uint16_t port = 0;
+
+    if (sscanf(dst.sun_path + 1, "neuron-%" SCNu16, &port) != 1) {
+        port = 0;
+    }
+
+    return neu_adapter_trans_data_to(adapter, header, data, port, dst);
+}
+
+int neu_adapter_trans_data_to(neu_adapter_t *     adapter,
+                              neu_reqresp_head_t *header, void *data,
+                              uint16_t port, struct sockaddr_un dst)
 {
     assert(header->type == NEU_REQRESP_TRANS_DATA);
 
@@ -828,7 +970,15 @@ static int adapter_responseto(neu_adapter_t *     adapter,
     neu_reqresp_head_t *pheader = neu_msg_get_header(msg);
     snprintf(pheader->sender, sizeof(pheader->sender), "%s", adapter->name);
 
-    int ret = neu_send_msg_to(adapter->control_fd, &dst, msg);
+    // apps of this process take the message from their queue directly
+    int ret = 1;
+    if (port != 0) {
+        ret = adapter_msg_q_push_to(port, msg);
+    }
+    if (ret > 0) {
+        ret = neu_send_msg_to(adapter->control_fd, &dst, msg);
+    }
+
     if (0 != ret) {
         nlog_error("adapter: %s send responseto %s failed, ret: %d, errno: %d",
                    adapter->name, neu_reqresp_type_string(header->type), ret,
@@ -905,6 +1055,31 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
         return 0;
     }
 
+    adapter_dispatch(adapter, msg);
+    return 0;
+}
+
+static int adapter_inbox(enum neu_event_io_type type, int fd, void *usr_data)
+{
+    neu_adapter_t *adapter = (neu_adapter_t *) usr_data;
+    neu_msg_t *    msgs[ADAPTER_MSG_Q_BATCH];
+
+    if (type != NEU_EVENT_IO_READ) {
+        nlog_warn("adapter: %s inbox close, fd: %d", adapter->name, fd);
+        return 0;
+    }
+
+    uint32_t n =
+        adapter_msg_q_try_pop_batch(adapter->inbox, msgs, ADAPTER_MSG_Q_BATCH);
+    for (uint32_t i = 0; i < n; i++) {
+        adapter_dispatch(adapter, msgs[i]);
+    }
+
+    return 0;
+}
+
+static void adapter_dispatch(neu_adapter_t *adapter, neu_msg_t *msg)
+{
     neu_reqresp_head_t *header = neu_msg_get_header(msg);
 
     nlog_info("adapter(%s) recv msg from: %s %p, type: %s", adapter->name,
@@ -1481,15 +1656,21 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
     case NEU_REQ_ADD_GROUP: {
         neu_req_add_group_t *cmd   = (neu_req_add_group_t *) &header[1];
         neu_resp_error_t     error = { 0 };
-        nlog_notice("add group node:%s group:%s interval:%d", cmd->driver,
-                    cmd->group, cmd->interval);
-        if (cmd->interval < NEU_GROUP_INTERVAL_LIMIT) {
+        nlog_notice("add group node:%s group:%s interval:%d aggregate:%u",
+                    cmd->driver, cmd->group, cmd->interval, cmd->aggregate);
+        if (cmd->interval < NEU_GROUP_INTERVAL_LIMIT ||
+            (cmd->aggregate > 0 && cmd->aggregate < cmd->interval)) {
             error.error = NEU_ERR_GROUP_PARAMETER_INVALID;
         } else {
             if (adapter->module->type == NEU_NA_TYPE_DRIVER) {
                 error.error = neu_adapter_driver_add_group(
                     (neu_adapter_driver_t *) adapter, cmd->group, cmd->interval,
                     NULL);
+                if (error.error == NEU_ERR_SUCCESS && cmd->aggregate > 0) {
+                    neu_adapter_driver_set_group_aggregate(
+                        (neu_adapter_driver_t *) adapter, cmd->group,
+                        cmd->aggregate);
+                }
             } else {
                 error.error = NEU_ERR_GROUP_NOT_ALLOW;
             }
@@ -1497,7 +1678,7 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
 
         if (error.error == NEU_ERR_SUCCESS) {
             adapter_storage_add_group(adapter->name, cmd->group, cmd->interval,
-                                      NULL);
+                                      cmd->aggregate, NULL);
             if (header->monitor) {
                 notify_monitor(adapter, NEU_REQ_ADD_GROUP_EVENT, cmd);
             }
@@ -1517,13 +1698,20 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
             resp.error = neu_adapter_driver_update_group(
                 (neu_adapter_driver_t *) adapter, cmd->group, cmd->new_name,
                 cmd->interval);
+            if (resp.error == NEU_ERR_SUCCESS && cmd->set_aggregate) {
+                resp.error = neu_adapter_driver_set_group_aggregate(
+                    (neu_adapter_driver_t *) adapter, cmd->new_name,
+                    cmd->aggregate);
+            }
         } else {
             resp.error = NEU_ERR_GROUP_NOT_ALLOW;
         }
 
         if (resp.error == NEU_ERR_SUCCESS) {
-            adapter_storage_update_group(adapter->name, cmd->group,
-                                         cmd->new_name, cmd->interval);
+            adapter_storage_update_group(
+                adapter->name, cmd->group, cmd->new_name, cmd->interval,
+                neu_adapter_driver_group_aggregate(
+                    (neu_adapter_driver_t *) adapter, cmd->new_name));
             if (header->monitor) {
                 notify_monitor(adapter, NEU_REQ_UPDATE_GROUP_EVENT, cmd);
             }
@@ -1879,8 +2067,8 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
                 (neu_adapter_driver_t *) adapter, cmd->group, cmd->old_name,
                 cmd->new_name);
             if (resp.error == 0) {
-                rv = adapter_storage_rename_tag(cmd->driver, cmd->group,
-                                                cmd->old_name, cmd->new_name);
+                int rv = adapter_storage_rename_tag(
+                    cmd->driver, cmd->group, cmd->old_name, cmd->new_name);
                 if (rv != 0) {
                     // rollback in-memory rename on persistence failure
                     nlog_error("persist rename failed, rolling back "
@@ -2052,8 +2240,6 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
         assert(false);
         break;
     }
-
-    return 0;
 }
 
 int neu_adapter_validate_gtags(neu_adapter_t *adapter, neu_req_add_gtag_t *cmd,
@@ -2118,7 +2304,7 @@ int neu_adapter_add_gtags(neu_adapter_t *adapter, neu_req_add_gtag_t *cmd,
                                      cmd->groups[group_index].interval,
                                      cmd->groups[group_index].context);
         adapter_storage_add_group(adapter->name, cmd->groups[group_index].group,
-                                  cmd->groups[group_index].interval,
+                                  cmd->groups[group_index].interval, 0,
                                   cmd->groups[group_index].context);
         for (int tag_index = 0; tag_index < cmd->groups[group_index].n_tag;
              tag_index++) {
@@ -2178,6 +2364,7 @@ void neu_adapter_destroy(neu_adapter_t *adapter)
     // First set the message queue exit flag to let threads exit naturally
     if (adapter->msg_q != NULL) {
         adapter_msg_q_exit(adapter->msg_q);
+        adapter_msg_q_unbind(adapter->trans_data_port);
     }
 
     // Wait for the consumer thread to exit
@@ -2185,6 +2372,10 @@ void neu_adapter_destroy(neu_adapter_t *adapter)
         pthread_join(adapter->consumer_tid, NULL);
     }
 
+    if (adapter->inbox != NULL) {
+        adapter_msg_q_free(adapter->inbox);
+    }
+
     adapter->module->intf_funs->close(adapter->plugin);
 
     if (NULL != adapter->metrics) {
@@ -2227,6 +2418,9 @@ int neu_adapter_uninit(neu_adapter_t *adapter)
     adapter->module->intf_funs->uninit(adapter->plugin);
 
     neu_event_del_io(adapter->events, adapter->control_io);
+    // later direct messages fall back to the manager
+    adapter_msg_q_exit(adapter->inbox);
+    neu_event_del_io(adapter->events, adapter->inbox_io);
 
     if (adapter->module->type == NEU_NA_TYPE_DRIVER) {
         if (adapter->timer_connect != NULL) {
@@ -2452,6 +2646,10 @@ inline static void reply(neu_adapter_t *adapter, neu_reqresp_head_t *header,
                          void *data)
 {
     neu_msg_gen(header, data);
+    if (send_direct(adapter, header)) {
+        return;
+    }
+
     int ret = neu_send_msg(adapter->control_fd, (neu_msg_t *) header);
     if (0 != ret) {
         nlog_warn("%s reply %s to %s, error: %s(%d)", header->sender,
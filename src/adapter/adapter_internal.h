@@ -42,6 +42,7 @@ struct neu_adapter {
 
     neu_event_io_t *control_io;
     neu_event_io_t *trans_data_io;
+    neu_event_io_t *inbox_io;
 
     int control_fd;
     int trans_data_fd;
@@ -49,6 +50,9 @@ struct neu_adapter {
     adapter_msg_q_t *msg_q;
     pthread_t        consumer_tid;
 
+    // data plane requests and responses sent directly by other nodes
+    adapter_msg_q_t *inbox;
+
     uint16_t trans_data_port;
 
     neu_events_t *events;
@@ -73,6 +77,13 @@ int  neu_adapter_error();
 void neu_adapter_set_error(int error);
 
 uint16_t neu_adapter_trans_data_port(neu_adapter_t *adapter);
+/*
+ * Send trans data to the app listening on port at dst, it is pushed straight
+ * into the queue of the app if the app runs in this process.
+ */
+int neu_adapter_trans_data_to(neu_adapter_t *     adapter,
+                              neu_reqresp_head_t *header, void *data,
+                              uint16_t port, struct sockaddr_un dst);
 
 neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load);
 void neu_adapter_init(neu_adapter_t *adapter, neu_node_running_state_e state);
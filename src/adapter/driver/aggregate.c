@@ -0,0 +1,139 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "errcodes.h"
+
+#include "aggregate.h"
+
+void neu_driver_acc_reset(neu_driver_acc_t *acc)
+{
+    memset(acc, 0, sizeof(*acc));
+}
+
+void neu_driver_acc_add(neu_driver_acc_t *acc, double value)
+{
+    double delta = 0;
+
+    if (acc->count == 0) {
+        acc->first = value;
+        acc->min   = value;
+        acc->max   = value;
+    } else if (value < acc->min) {
+        acc->min = value;
+    } else if (value > acc->max) {
+        acc->max = value;
+    }
+
+    acc->count += 1;
+    acc->last = value;
+    acc->sum += value;
+
+    delta = value - acc->mean;
+    acc->mean += delta / acc->count;
+    acc->m2 += delta * (value - acc->mean);
+}
+
+bool neu_driver_acc_add_value(neu_driver_acc_t *acc, const neu_dvalue_t *value)
+{
+    double number = 0;
+
+    switch (value->type) {
+    case NEU_TYPE_ERROR:
+        acc->error = value->value.i32;
+        return false;
+    case NEU_TYPE_INT8:
+        number = value->value.i8;
+        break;
+    case NEU_TYPE_UINT8:
+    case NEU_TYPE_BIT:
+        number = value->value.u8;
+        break;
+    case NEU_TYPE_INT16:
+        number = value->value.i16;
+        break;
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_WORD:
+        number = value->value.u16;
+        break;
+    case NEU_TYPE_INT32:
+        number = value->value.i32;
+        break;
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_DWORD:
+        number = value->value.u32;
+        break;
+    case NEU_TYPE_INT64:
+        number = (double) value->value.i64;
+        break;
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_LWORD:
+        number = (double) value->value.u64;
+        break;
+    case NEU_TYPE_FLOAT:
+        number = value->value.f32;
+        break;
+    case NEU_TYPE_DOUBLE:
+        number = value->value.d64;
+        break;
+    case NEU_TYPE_BOOL:
+        number = value->value.boolean;
+        break;
+    default:
+        return false;
+    }
+
+    if (isnan(number)) {
+        acc->error = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
+        return false;
+    }
+
+    neu_driver_acc_add(acc, number);
+    return true;
+}
+
+double neu_driver_acc_stddev(const neu_driver_acc_t *acc)
+{
+    return acc->count > 0 ? sqrt(acc->m2 / acc->count) : 0;
+}
+
+static void acc_meta(neu_tag_meta_t *meta, const char *name, double value)
+{
+    snprintf(meta->name, sizeof(meta->name), "%s", name);
+    meta->value.type      = NEU_TYPE_DOUBLE;
+    meta->value.value.d64 = value;
+}
+
+int neu_driver_acc_metas(const neu_driver_acc_t *acc, neu_tag_meta_t *metas)
+{
+    acc_meta(&metas[0], "min", acc->min);
+    acc_meta(&metas[1], "max", acc->max);
+    acc_meta(&metas[2], "mean", acc->mean);
+    acc_meta(&metas[3], "sum", acc->sum);
+    snprintf(metas[4].name, sizeof(metas[4].name), "%s", "count");
+    metas[4].value.type      = NEU_TYPE_INT64;
+    metas[4].value.value.i64 = acc->count;
+    acc_meta(&metas[5], "first", acc->first);
+    acc_meta(&metas[6], "last", acc->last);
+    acc_meta(&metas[7], "stddev", neu_driver_acc_stddev(acc));
+
+    return NEU_DRIVER_ACC_N_META;
+}
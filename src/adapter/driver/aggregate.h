@@ -0,0 +1,72 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_DRIVER_AGGREGATE_H_
+#define _NEU_DRIVER_AGGREGATE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tag.h"
+#include "type.h"
+
+/*
+ * Running statistics of the numeric values of a tag over an aggregation
+ * window, see neu_req_add_group_t.
+ *
+ * Each accumulator is updated in constant time and space, the variance is
+ * kept with Welford's method so that it does not lose precision over long
+ * windows.
+ */
+typedef struct {
+    uint32_t count;
+    double   first;
+    double   last;
+    double   min;
+    double   max;
+    double   sum;
+    double   mean;
+    double   m2;    // sum of the squared distances to the mean
+    int32_t  error; // the last error read, 0 if there was none
+} neu_driver_acc_t;
+
+// number of metas neu_driver_acc_metas fills
+#define NEU_DRIVER_ACC_N_META 8
+
+void neu_driver_acc_reset(neu_driver_acc_t *acc);
+void neu_driver_acc_add(neu_driver_acc_t *acc, double value);
+/*
+ * Add a value read from the cache, errors are remembered and values that are
+ * not numbers are ignored.
+ *
+ * @return true if the value was accumulated.
+ */
+bool neu_driver_acc_add_value(neu_driver_acc_t *acc, const neu_dvalue_t *value);
+
+// population standard deviation of the values, 0 without values
+double neu_driver_acc_stddev(const neu_driver_acc_t *acc);
+
+/*
+ * The statistics as the metas of a report: min, max, mean, sum, count,
+ * first, last and stddev.
+ *
+ * @return the number of metas, metas must hold NEU_DRIVER_ACC_N_META.
+ */
+int neu_driver_acc_metas(const neu_driver_acc_t *acc, neu_tag_meta_t *metas);
+
+#endif
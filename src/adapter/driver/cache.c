@@ -20,6 +20,7 @@
 #include <assert.h>
 #include <math.h>
 #include <pthread.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <jansson.h>
@@ -33,14 +34,59 @@
 
 extern bool sub_filter_err;
 
+/*
+ * Every (group, tag) pair is resolved to a dense slot once, when the tag is
+ * added. Slots live in fixed size chunks that never move, so a slot stays
+ * addressable for the lifetime of the cache. The name index is guarded by a
+ * rwlock that is only taken for writing when tags are added, deleted or
+ * renamed; tag values are guarded by a small set of striped mutexes.
+ *
+ * Access by slot handle takes no index lock. A chunk pointer is set before
+ * n_slot is raised past its first slot, n_slot is stored with release and
+ * loaded with acquire, and chunks are only freed with the cache.
+ */
+#define CACHE_CHUNK_BITS 12
+#define CACHE_CHUNK_SIZE (1 << CACHE_CHUNK_BITS)
+#define CACHE_CHUNK_MAX 1024
+#define CACHE_STRIPE_NUM 64
+
+typedef struct {
+    char              key[NEU_GROUP_NAME_LEN];
+    void *            trace_ctx;
+    struct tag_index *tags;
+    // values of deadband filtered tags, updated atomically
+    uint64_t       n_forwarded;
+    uint64_t       n_suppressed;
+    UT_hash_handle hh;
+} group_index_t;
+
+// state of a deadband filtered tag
+typedef struct {
+    neu_tag_deadband_t  conf;
+    neu_tag_transform_t plan; // bands are in the units of reported values
+    group_index_t *     group;
+    bool                reported; // a value was reported since it was set
+    neu_type_e          type;     // of the last reported value
+    double              value;    // last reported value, if numeric
+    int64_t             reported_ts;
+} deadband_t;
+
+// the last numeric values of a tag as reported, a ring of `size` samples
 typedef struct {
-    char group[NEU_GROUP_NAME_LEN];
-    char tag[NEU_TAG_NAME_LEN];
-} tkey_t;
+    neu_tag_transform_t plan;
+    uint32_t            duration;
+    uint32_t            size;
+    uint32_t            head; // the oldest sample
+    uint32_t            n_sample;
+    neu_tag_sample_t    samples[];
+} window_t;
 
 struct elem {
     int64_t timestamp;
     bool    changed;
+    bool    used;
+    // bumped whenever the slot is released, invalidates stale slot handles
+    uint32_t gen;
 
     neu_dvalue_t value;
     neu_dvalue_t value_old;
@@ -48,820 +94,1350 @@ struct elem {
     neu_tag_meta_t *metas;
     int             n_meta;
 
-    tkey_t         key;
-    UT_hash_handle hh;
+    deadband_t *deadband;
+    window_t *  window;
 };
 
-typedef struct {
-    char           key[NEU_GROUP_NAME_LEN];
-    void *         trace_ctx;
+typedef struct tag_index {
+    char *         name;
+    uint32_t       slot;
     UT_hash_handle hh;
-} group_trace_t;
+} tag_index_t;
 
 struct neu_driver_cache {
-    pthread_mutex_t mtx;
-    group_trace_t * trace_table;
-    struct elem *   table;
-};
+    pthread_rwlock_t index_mtx;
+    group_index_t *  groups;
+
+    struct elem *chunks[CACHE_CHUNK_MAX];
+    uint32_t     n_slot;
+    uint32_t *   free_slots;
+    uint32_t     n_free;
+    uint32_t     free_size;
 
-// static void update_tag_error(neu_driver_cache_t *cache, const char *group,
-// const char *tag, int64_t timestamp, int error);
+    pthread_mutex_t stripes[CACHE_STRIPE_NUM];
+};
 
-inline static tkey_t to_key(const char *group, const char *tag)
+// whether a slot was allocated, its chunk can then be read without the index
+// lock
+static inline bool slot_published(neu_driver_cache_t *cache, uint32_t slot)
 {
-    tkey_t key = { 0 };
+    return slot < __atomic_load_n(&cache->n_slot, __ATOMIC_ACQUIRE);
+}
 
-    strncpy(key.group, group, sizeof(key.group) - 1);
-    strncpy(key.tag, tag, sizeof(key.tag) - 1);
+static inline struct elem *slot_elem(neu_driver_cache_t *cache, uint32_t slot)
+{
+    return &cache->chunks[slot >> CACHE_CHUNK_BITS]
+                         [slot & (CACHE_CHUNK_SIZE - 1)];
+}
 
-    return key;
+static inline pthread_mutex_t *slot_stripe(neu_driver_cache_t *cache,
+                                           uint32_t            slot)
+{
+    return &cache->stripes[slot % CACHE_STRIPE_NUM];
 }
 
-neu_driver_cache_t *neu_driver_cache_new()
+static inline neu_driver_cache_slot_t to_handle(uint32_t slot, uint32_t gen)
 {
-    neu_driver_cache_t *cache = calloc(1, sizeof(neu_driver_cache_t));
+    return ((int64_t)(gen & 0x7fffffff) << 32) | slot;
+}
 
-    pthread_mutex_init(&cache->mtx, NULL);
+static inline uint32_t handle_slot(neu_driver_cache_slot_t handle)
+{
+    return (uint32_t)(handle & 0xffffffff);
+}
 
-    return cache;
+static inline uint32_t handle_gen(neu_driver_cache_slot_t handle)
+{
+    return (uint32_t)(handle >> 32);
 }
 
-void neu_driver_cache_destroy(neu_driver_cache_t *cache)
+static group_index_t *find_group(neu_driver_cache_t *cache, const char *group)
 {
-    struct elem *elem = NULL;
-    struct elem *tmp  = NULL;
+    group_index_t *find = NULL;
 
-    pthread_mutex_lock(&cache->mtx);
-    HASH_ITER(hh, cache->table, elem, tmp)
-    {
-        HASH_DEL(cache->table, elem);
-        if (elem->value.type == NEU_TYPE_PTR) {
-            if (elem->value.value.ptr.ptr != NULL) {
-                free(elem->value.value.ptr.ptr);
-                elem->value.value.ptr.ptr = NULL;
-            }
-        } else if (elem->value.type == NEU_TYPE_CUSTOM) {
-            if (elem->value.value.json != NULL) {
-                json_decref(elem->value.value.json);
-                elem->value.value.json = NULL;
-            }
-        } else if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-            for (size_t i = 0; i < elem->value.value.strs.length; i++) {
-                free(elem->value.value.strs.strs[i]);
-                elem->value.value.strs.strs[i] = NULL;
-            }
-            free(elem->value.value.strs.strs);
-        } else if (NEU_TYPE_ARRAY_CHAR < elem->value.type &&
-                   elem->value.type < NEU_TYPE_ARRAY_STRING) {
-            free(elem->value.value.bools.bools);
-        }
+    HASH_FIND_STR(cache->groups, group, find);
+    return find;
+}
 
-        if (elem->metas != NULL) {
-            for (int i = 0; i < elem->n_meta; i++) {
-                neu_free_dvalue(&elem->metas[i].value);
-            }
-            free(elem->metas);
-        }
+// must be called with index_mtx held
+static int64_t find_slot(neu_driver_cache_t *cache, const char *group,
+                         const char *tag)
+{
+    group_index_t *g = find_group(cache, group);
+    tag_index_t *  t = NULL;
 
-        free(elem);
+    if (g == NULL) {
+        return -1;
     }
 
-    group_trace_t *elem1 = NULL;
-    group_trace_t *tmp1  = NULL;
-
-    HASH_ITER(hh, cache->trace_table, elem1, tmp1)
-    {
-        HASH_DEL(cache->trace_table, elem1);
-        free(elem1);
+    HASH_FIND_STR(g->tags, tag, t);
+    if (t == NULL) {
+        return -1;
     }
 
-    pthread_mutex_unlock(&cache->mtx);
-
-    pthread_mutex_destroy(&cache->mtx);
-
-    free(cache);
+    return t->slot;
 }
 
-// void neu_driver_cache_error(neu_driver_cache_t *cache, const char *group,
-// const char *tag, int64_t timestamp, int32_t error)
-//{
-// update_tag_error(cache, group, tag, timestamp, error);
-//}
-
-void neu_driver_cache_add(neu_driver_cache_t *cache, const char *group,
-                          const char *tag, neu_dvalue_t value)
+// must be called with index_mtx held for writing
+static int64_t alloc_slot(neu_driver_cache_t *cache)
 {
-    struct elem *elem = NULL;
-    tkey_t       key  = to_key(group, tag);
+    uint32_t slot = 0;
 
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
+    if (cache->n_free > 0) {
+        return cache->free_slots[--cache->n_free];
+    }
+
+    slot = cache->n_slot;
+    if ((slot >> CACHE_CHUNK_BITS) >= CACHE_CHUNK_MAX) {
+        return -1;
+    }
 
-    if (elem == NULL) {
-        elem = calloc(1, sizeof(struct elem));
+    if ((slot & (CACHE_CHUNK_SIZE - 1)) == 0) {
+        cache->chunks[slot >> CACHE_CHUNK_BITS] =
+            calloc(CACHE_CHUNK_SIZE, sizeof(struct elem));
+        if (cache->chunks[slot >> CACHE_CHUNK_BITS] == NULL) {
+            return -1;
+        }
+    }
 
-        snprintf(elem->key.group, sizeof(elem->key.group), "%s", group);
-        snprintf(elem->key.tag, sizeof(elem->key.tag), "%s", tag);
+    // publishes the chunk to the readers by slot handle
+    __atomic_store_n(&cache->n_slot, slot + 1, __ATOMIC_RELEASE);
+    return slot;
+}
 
-        HASH_ADD(hh, cache->table, key, sizeof(tkey_t), elem);
+// must be called with index_mtx held for writing
+static void release_slot(neu_driver_cache_t *cache, uint32_t slot)
+{
+    if (cache->n_free == cache->free_size) {
+        uint32_t  size = cache->free_size == 0 ? 64 : cache->free_size * 2;
+        uint32_t *free_slots =
+            realloc(cache->free_slots, size * sizeof(uint32_t));
+
+        if (free_slots == NULL) {
+            // the slot leaks until the cache is destroyed
+            return;
+        }
+        cache->free_slots = free_slots;
+        cache->free_size  = size;
     }
 
-    elem->timestamp = 0;
-    elem->changed   = false;
-    elem->value     = value;
+    cache->free_slots[cache->n_free++] = slot;
+}
 
-    pthread_mutex_unlock(&cache->mtx);
+static void elem_free_value(struct elem *elem)
+{
+    if (elem->value.type == NEU_TYPE_PTR) {
+        if (elem->value.value.ptr.ptr != NULL) {
+            free(elem->value.value.ptr.ptr);
+            elem->value.value.ptr.ptr = NULL;
+        }
+    } else if (elem->value.type == NEU_TYPE_CUSTOM) {
+        if (elem->value.value.json != NULL) {
+            json_decref(elem->value.value.json);
+            elem->value.value.json = NULL;
+        }
+    } else if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
+        for (size_t i = 0; i < elem->value.value.strs.length; i++) {
+            free(elem->value.value.strs.strs[i]);
+            elem->value.value.strs.strs[i] = NULL;
+        }
+        free(elem->value.value.strs.strs);
+    } else if (NEU_TYPE_ARRAY_CHAR < elem->value.type &&
+               elem->value.type < NEU_TYPE_ARRAY_STRING) {
+        free(elem->value.value.bools.bools);
+    }
+    if (elem->metas != NULL) {
+        for (int i = 0; i < elem->n_meta; i++) {
+            neu_free_dvalue(&elem->metas[i].value);
+        }
+        free(elem->metas);
+    }
+    elem->metas  = NULL;
+    elem->n_meta = 0;
 }
 
-void neu_driver_cache_update_trace(neu_driver_cache_t *cache, const char *group,
-                                   void *trace_ctx)
+static bool dvalue_number(const neu_dvalue_t *value, double *number)
 {
-    group_trace_t *elem                    = NULL;
-    char           key[NEU_GROUP_NAME_LEN] = { 0 };
+    switch (value->type) {
+    case NEU_TYPE_INT8:
+        *number = value->value.i8;
+        return true;
+    case NEU_TYPE_UINT8:
+    case NEU_TYPE_BIT:
+        *number = value->value.u8;
+        return true;
+    case NEU_TYPE_INT16:
+        *number = value->value.i16;
+        return true;
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_WORD:
+        *number = value->value.u16;
+        return true;
+    case NEU_TYPE_INT32:
+        *number = value->value.i32;
+        return true;
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_DWORD:
+        *number = value->value.u32;
+        return true;
+    case NEU_TYPE_INT64:
+        *number = (double) value->value.i64;
+        return true;
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_LWORD:
+        *number = (double) value->value.u64;
+        return true;
+    case NEU_TYPE_FLOAT:
+        *number = value->value.f32;
+        return true;
+    case NEU_TYPE_DOUBLE:
+        *number = value->value.d64;
+        return true;
+    case NEU_TYPE_BOOL:
+        *number = value->value.boolean;
+        return true;
+    default:
+        return false;
+    }
+}
 
-    snprintf(key, sizeof(key), "%s", group);
+/*
+ * Whether an update of a deadband filtered tag is reported.
+ *
+ * A numeric value is reported once it moved past every band configured from
+ * the last reported value, as transformed by the plan of the tag, other
+ * values whenever they changed. A change is
+ * held back until min_interval passed since the last report, and the value
+ * is reported again once max_interval passed without a report.
+ */
+static bool deadband_pass(deadband_t *db, const neu_dvalue_t *value,
+                          int64_t timestamp, bool changed, bool force)
+{
+    const neu_tag_deadband_t *conf     = &db->conf;
+    int64_t                   since    = timestamp - db->reported_ts;
+    neu_dvalue_t              reported = *value;
+    double                    number   = 0;
+    bool                      numeric  = dvalue_number(value, &number);
+    bool                      urgent   = false;
+    bool                      pass     = changed;
+
+    if (numeric) {
+        neu_tag_transform_apply(&db->plan, &reported);
+        numeric = dvalue_number(&reported, &number);
+    }
 
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->trace_table, &key, sizeof(key), elem);
+    // first values and type changes, e.g. recovering from an error, go out
+    urgent = force || !db->reported || value->type != db->type;
+    if (urgent) {
+        pass = true;
+    } else if (numeric) {
+        double delta = fabs(number - db->value);
 
-    if (elem == NULL) {
-        elem = calloc(1, sizeof(group_trace_t));
+        pass = delta > 0 && delta > conf->absolute &&
+            delta > fabs(db->value) * conf->percent / 100.0;
+    }
 
-        snprintf(elem->key, sizeof(elem->key), "%s", group);
-        elem->trace_ctx = trace_ctx;
+    if (pass && !urgent && conf->min_interval > 0 &&
+        since < conf->min_interval) {
+        pass = false;
+    }
+    if (!pass && conf->max_interval > 0 && since >= conf->max_interval) {
+        pass = true;
+    }
 
-        HASH_ADD(hh, cache->trace_table, key, sizeof(key), elem);
+    if (pass) {
+        db->reported    = true;
+        db->type        = value->type;
+        db->value       = numeric ? number : 0;
+        db->reported_ts = timestamp;
+        __atomic_fetch_add(&db->group->n_forwarded, 1, __ATOMIC_RELAXED);
+    } else if (changed) {
+        __atomic_fetch_add(&db->group->n_suppressed, 1, __ATOMIC_RELAXED);
     }
 
-    elem->trace_ctx = trace_ctx;
+    return pass;
+}
 
-    pthread_mutex_unlock(&cache->mtx);
+static void window_push(window_t *window, int64_t timestamp, double value)
+{
+    if (window->n_sample == window->size) {
+        window->head = (window->head + 1) % window->size;
+        window->n_sample -= 1;
+    }
+    window->samples[(window->head + window->n_sample) % window->size] =
+        (neu_tag_sample_t) { .timestamp = timestamp, .value = value };
+    window->n_sample += 1;
+
+    while (window->duration > 0 && window->n_sample > 0 &&
+           window->samples[window->head].timestamp <
+               timestamp - window->duration) {
+        window->head = (window->head + 1) % window->size;
+        window->n_sample -= 1;
+    }
 }
 
-void *neu_driver_cache_get_trace(neu_driver_cache_t *cache, const char *group)
+static inline const neu_tag_sample_t *window_at(const window_t *window,
+                                                uint32_t        i)
 {
-    group_trace_t *elem                    = NULL;
-    char           key[NEU_GROUP_NAME_LEN] = { 0 };
+    return &window->samples[(window->head + i) % window->size];
+}
 
-    void *trace = NULL;
+static inline bool sample_in(const neu_tag_sample_t *      sample,
+                             const neu_tag_history_query_t *query)
+{
+    return (query->from <= 0 || sample->timestamp >= query->from) &&
+        (query->to <= 0 || sample->timestamp <= query->to);
+}
 
-    snprintf(key, sizeof(key), "%s", group);
+static int window_query(const window_t *               window,
+                        const neu_tag_history_query_t *query,
+                        neu_tag_history_t *            history)
+{
+    uint32_t n_match = 0;
+    uint32_t skip    = 0;
+    double   sum     = 0;
 
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->trace_table, &key, sizeof(key), elem);
+    memset(history, 0, sizeof(*history));
 
-    if (elem != NULL) {
-        trace = elem->trace_ctx;
+    for (uint32_t i = 0; i < window->n_sample; i++) {
+        if (sample_in(window_at(window, i), query)) {
+            n_match += 1;
+        }
+    }
+    if (query->last > 0 && n_match > query->last) {
+        skip = n_match - query->last;
+    }
+    if (n_match - skip == 0) {
+        return 0;
     }
 
-    pthread_mutex_unlock(&cache->mtx);
+    if (!query->aggregate) {
+        history->samples = calloc(n_match - skip, sizeof(neu_tag_sample_t));
+        if (history->samples == NULL) {
+            return -1;
+        }
+    }
 
-    return trace;
+    for (uint32_t i = 0; i < window->n_sample; i++) {
+        const neu_tag_sample_t *sample = window_at(window, i);
+
+        if (!sample_in(sample, query)) {
+            continue;
+        }
+        if (skip > 0) {
+            skip -= 1;
+            continue;
+        }
+
+        if (history->count == 0 || sample->value < history->min) {
+            history->min = sample->value;
+        }
+        if (history->count == 0 || sample->value > history->max) {
+            history->max = sample->value;
+        }
+        sum += sample->value;
+        history->last = sample->value;
+        if (history->samples != NULL) {
+            history->samples[history->n_sample++] = *sample;
+        }
+        history->count += 1;
+    }
+    history->avg = sum / history->count;
+
+    return 0;
 }
 
-bool neu_driver_cache_update_change(neu_driver_cache_t *cache,
-                                    const char *group, const char *tag,
-                                    int64_t timestamp, neu_dvalue_t value,
-                                    neu_tag_meta_t *metas, int n_meta,
-                                    bool change)
+static bool elem_update(struct elem *elem, int64_t timestamp,
+                        neu_dvalue_t value, neu_tag_meta_t *metas, int n_meta,
+                        bool change)
 {
-    struct elem *elem        = NULL;
-    tkey_t       key         = to_key(group, tag);
-    bool         tag_changed = false;
+    bool tag_changed = false;
+    bool pending     = elem->changed;
 
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
-    if (elem != NULL) {
-        elem->timestamp = timestamp;
+    elem->timestamp = timestamp;
 
-        if (sub_filter_err && value.type == NEU_TYPE_ERROR) {
-            goto error_not_report;
-        }
+    if (sub_filter_err && value.type == NEU_TYPE_ERROR) {
+        goto error_not_report;
+    }
 
-        if ((!sub_filter_err && elem->value.type != value.type) ||
-            (sub_filter_err && elem->value.type != value.type &&
-             elem->value.type != NEU_TYPE_ERROR)) {
-            elem->changed = true;
-            tag_changed   = true;
-        } else if (sub_filter_err && elem->value.type != value.type &&
-                   elem->value.type == NEU_TYPE_ERROR) {
-            switch (value.type) {
-            case NEU_TYPE_INT8:
-            case NEU_TYPE_UINT8:
-            case NEU_TYPE_INT16:
-            case NEU_TYPE_UINT16:
-            case NEU_TYPE_INT32:
-            case NEU_TYPE_UINT32:
-            case NEU_TYPE_INT64:
-            case NEU_TYPE_UINT64:
-            case NEU_TYPE_BIT:
-            case NEU_TYPE_BOOL:
-            case NEU_TYPE_STRING:
-            case NEU_TYPE_TIME:
-            case NEU_TYPE_DATA_AND_TIME:
-            case NEU_TYPE_WORD:
-            case NEU_TYPE_DWORD:
-            case NEU_TYPE_LWORD:
-            case NEU_TYPE_ARRAY_CHAR:
-                if (memcmp(&elem->value_old.value, &value.value,
-                           sizeof(value.value)) != 0) {
+    if ((!sub_filter_err && elem->value.type != value.type) ||
+        (sub_filter_err && elem->value.type != value.type &&
+         elem->value.type != NEU_TYPE_ERROR)) {
+        elem->changed = true;
+        tag_changed   = true;
+    } else if (sub_filter_err && elem->value.type != value.type &&
+               elem->value.type == NEU_TYPE_ERROR) {
+        switch (value.type) {
+        case NEU_TYPE_INT8:
+        case NEU_TYPE_UINT8:
+        case NEU_TYPE_INT16:
+        case NEU_TYPE_UINT16:
+        case NEU_TYPE_INT32:
+        case NEU_TYPE_UINT32:
+        case NEU_TYPE_INT64:
+        case NEU_TYPE_UINT64:
+        case NEU_TYPE_BIT:
+        case NEU_TYPE_BOOL:
+        case NEU_TYPE_STRING:
+        case NEU_TYPE_TIME:
+        case NEU_TYPE_DATA_AND_TIME:
+        case NEU_TYPE_WORD:
+        case NEU_TYPE_DWORD:
+        case NEU_TYPE_LWORD:
+        case NEU_TYPE_ARRAY_CHAR:
+            if (memcmp(&elem->value_old.value, &value.value,
+                       sizeof(value.value)) != 0) {
+                elem->changed = true;
+                tag_changed   = true;
+            }
+            break;
+        case NEU_TYPE_BYTES:
+            if (elem->value_old.value.bytes.length !=
+                value.value.bytes.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.bytes.bytes,
+                           value.value.bytes.bytes,
+                           value.value.bytes.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
                 }
-                break;
-            case NEU_TYPE_BYTES:
-                if (elem->value_old.value.bytes.length !=
-                    value.value.bytes.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_BOOL:
+            if (elem->value_old.value.bools.length !=
+                value.value.bools.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.bools.bools,
+                           value.value.bools.bools,
+                           value.value.bools.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.bytes.bytes,
-                               value.value.bytes.bytes,
-                               value.value.bytes.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_BOOL:
-                if (elem->value_old.value.bools.length !=
-                    value.value.bools.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT8:
+            if (elem->value_old.value.i8s.length !=
+                value.value.i8s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.i8s.i8s,
+                           value.value.i8s.i8s,
+                           value.value.i8s.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.bools.bools,
-                               value.value.bools.bools,
-                               value.value.bools.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT8:
-                if (elem->value_old.value.i8s.length !=
-                    value.value.i8s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT8:
+            if (elem->value_old.value.u8s.length !=
+                value.value.u8s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.u8s.u8s,
+                           value.value.u8s.u8s,
+                           value.value.u8s.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i8s.i8s,
-                               value.value.i8s.i8s,
-                               value.value.i8s.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT8:
-                if (elem->value_old.value.u8s.length !=
-                    value.value.u8s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT16:
+            if (elem->value_old.value.i16s.length !=
+                value.value.i16s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.i16s.i16s,
+                           value.value.i16s.i16s,
+                           value.value.i16s.length * sizeof(int16_t)) !=
+                    0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u8s.u8s,
-                               value.value.u8s.u8s,
-                               value.value.u8s.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT16:
-                if (elem->value_old.value.i16s.length !=
-                    value.value.i16s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT16:
+            if (elem->value_old.value.u16s.length !=
+                value.value.u16s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.u16s.u16s,
+                           value.value.u16s.u16s,
+                           value.value.u16s.length * sizeof(uint16_t)) !=
+                    0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i16s.i16s,
-                               value.value.i16s.i16s,
-                               value.value.i16s.length * sizeof(int16_t)) !=
-                        0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT16:
-                if (elem->value_old.value.u16s.length !=
-                    value.value.u16s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT32:
+            if (elem->value_old.value.i32s.length !=
+                value.value.i32s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.i32s.i32s,
+                           value.value.i32s.i32s,
+                           value.value.i32s.length * sizeof(int32_t)) !=
+                    0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u16s.u16s,
-                               value.value.u16s.u16s,
-                               value.value.u16s.length * sizeof(uint16_t)) !=
-                        0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT32:
-                if (elem->value_old.value.i32s.length !=
-                    value.value.i32s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT32:
+            if (elem->value_old.value.u32s.length !=
+                value.value.u32s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.u32s.u32s,
+                           value.value.u32s.u32s,
+                           value.value.u32s.length * sizeof(uint32_t)) !=
+                    0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i32s.i32s,
-                               value.value.i32s.i32s,
-                               value.value.i32s.length * sizeof(int32_t)) !=
-                        0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT32:
-                if (elem->value_old.value.u32s.length !=
-                    value.value.u32s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT64:
+            if (elem->value_old.value.i64s.length !=
+                value.value.i64s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.i64s.i64s,
+                           value.value.i64s.i64s,
+                           value.value.i64s.length * sizeof(int64_t)) !=
+                    0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u32s.u32s,
-                               value.value.u32s.u32s,
-                               value.value.u32s.length * sizeof(uint32_t)) !=
-                        0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT64:
-                if (elem->value_old.value.i64s.length !=
-                    value.value.i64s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT64:
+            if (elem->value_old.value.u64s.length !=
+                value.value.u64s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.u64s.u64s,
+                           value.value.u64s.u64s,
+                           value.value.u64s.length * sizeof(uint64_t)) !=
+                    0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i64s.i64s,
-                               value.value.i64s.i64s,
-                               value.value.i64s.length * sizeof(int64_t)) !=
-                        0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT64:
-                if (elem->value_old.value.u64s.length !=
-                    value.value.u64s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_FLOAT:
+            if (elem->value_old.value.f32s.length !=
+                value.value.f32s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.f32s.f32s,
+                           value.value.f32s.f32s,
+                           value.value.f32s.length * sizeof(float)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u64s.u64s,
-                               value.value.u64s.u64s,
-                               value.value.u64s.length * sizeof(uint64_t)) !=
-                        0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_FLOAT:
-                if (elem->value_old.value.f32s.length !=
-                    value.value.f32s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_DOUBLE:
+            if (elem->value_old.value.f64s.length !=
+                value.value.f64s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.f64s.f64s,
+                           value.value.f64s.f64s,
+                           value.value.f64s.length * sizeof(double)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.f32s.f32s,
-                               value.value.f32s.f32s,
-                               value.value.f32s.length * sizeof(float)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_DOUBLE:
-                if (elem->value_old.value.f64s.length !=
-                    value.value.f64s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_STRING:
+            if (elem->value_old.value.strs.length !=
+                value.value.strs.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.strs.strs,
+                           value.value.strs.strs,
+                           value.value.strs.length * sizeof(char *)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.f64s.f64s,
-                               value.value.f64s.f64s,
-                               value.value.f64s.length * sizeof(double)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_STRING:
-                if (elem->value_old.value.strs.length !=
-                    value.value.strs.length) {
+            }
+            break;
+        case NEU_TYPE_CUSTOM: {
+            if (json_equal(elem->value_old.value.json, value.value.json) !=
+                1) {
+                elem->changed = true;
+                tag_changed   = true;
+            }
+            break;
+        }
+        case NEU_TYPE_PTR: {
+            if (elem->value_old.value.ptr.length !=
+                value.value.ptr.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value_old.value.ptr.ptr,
+                           value.value.ptr.ptr,
+                           value.value.ptr.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.strs.strs,
-                               value.value.strs.strs,
-                               value.value.strs.length * sizeof(char *)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_CUSTOM: {
-                if (json_equal(elem->value_old.value.json, value.value.json) !=
-                    1) {
+            }
+
+            break;
+        }
+        case NEU_TYPE_FLOAT:
+            if (elem->value_old.precision == 0) {
+                elem->changed =
+                    elem->value_old.value.f32 != value.value.f32;
+                tag_changed = elem->changed;
+            } else {
+                if (fabs(elem->value_old.value.f32 - value.value.f32) >
+                    pow(0.1, elem->value_old.precision)) {
                     elem->changed = true;
                     tag_changed   = true;
                 }
-                break;
             }
-            case NEU_TYPE_PTR: {
-                if (elem->value_old.value.ptr.length !=
-                    value.value.ptr.length) {
+            break;
+        case NEU_TYPE_DOUBLE:
+            if (elem->value_old.precision == 0) {
+                elem->changed =
+                    elem->value_old.value.d64 != value.value.d64;
+                tag_changed = elem->changed;
+            } else {
+                if (fabs(elem->value_old.value.d64 - value.value.d64) >
+                    pow(0.1, elem->value_old.precision)) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value_old.value.ptr.ptr,
-                               value.value.ptr.ptr,
-                               value.value.ptr.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-
-                break;
             }
-            case NEU_TYPE_FLOAT:
-                if (elem->value_old.precision == 0) {
-                    elem->changed =
-                        elem->value_old.value.f32 != value.value.f32;
-                    tag_changed = elem->changed;
-                } else {
-                    if (fabs(elem->value_old.value.f32 - value.value.f32) >
-                        pow(0.1, elem->value_old.precision)) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_DOUBLE:
-                if (elem->value_old.precision == 0) {
-                    elem->changed =
-                        elem->value_old.value.d64 != value.value.d64;
-                    tag_changed = elem->changed;
-                } else {
-                    if (fabs(elem->value_old.value.d64 - value.value.d64) >
-                        pow(0.1, elem->value_old.precision)) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
-                }
 
-                break;
-            case NEU_TYPE_ERROR:
-                break;
+            break;
+        case NEU_TYPE_ERROR:
+            break;
+        }
+    } else {
+        switch (value.type) {
+        case NEU_TYPE_INT8:
+        case NEU_TYPE_UINT8:
+        case NEU_TYPE_INT16:
+        case NEU_TYPE_UINT16:
+        case NEU_TYPE_INT32:
+        case NEU_TYPE_UINT32:
+        case NEU_TYPE_INT64:
+        case NEU_TYPE_UINT64:
+        case NEU_TYPE_BIT:
+        case NEU_TYPE_BOOL:
+        case NEU_TYPE_STRING:
+        case NEU_TYPE_TIME:
+        case NEU_TYPE_DATA_AND_TIME:
+        case NEU_TYPE_WORD:
+        case NEU_TYPE_DWORD:
+        case NEU_TYPE_LWORD:
+        case NEU_TYPE_ARRAY_CHAR:
+            if (memcmp(&elem->value.value, &value.value,
+                       sizeof(value.value)) != 0) {
+                elem->changed = true;
+                tag_changed   = true;
             }
-        } else {
-            switch (value.type) {
-            case NEU_TYPE_INT8:
-            case NEU_TYPE_UINT8:
-            case NEU_TYPE_INT16:
-            case NEU_TYPE_UINT16:
-            case NEU_TYPE_INT32:
-            case NEU_TYPE_UINT32:
-            case NEU_TYPE_INT64:
-            case NEU_TYPE_UINT64:
-            case NEU_TYPE_BIT:
-            case NEU_TYPE_BOOL:
-            case NEU_TYPE_STRING:
-            case NEU_TYPE_TIME:
-            case NEU_TYPE_DATA_AND_TIME:
-            case NEU_TYPE_WORD:
-            case NEU_TYPE_DWORD:
-            case NEU_TYPE_LWORD:
-            case NEU_TYPE_ARRAY_CHAR:
-                if (memcmp(&elem->value.value, &value.value,
-                           sizeof(value.value)) != 0) {
-                    elem->changed = true;
-                    tag_changed   = true;
-                }
-                break;
-            case NEU_TYPE_BYTES:
-                if (elem->value.value.bytes.length !=
-                    value.value.bytes.length) {
+            break;
+        case NEU_TYPE_BYTES:
+            if (elem->value.value.bytes.length !=
+                value.value.bytes.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.bytes.bytes,
+                           value.value.bytes.bytes,
+                           value.value.bytes.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.bytes.bytes,
-                               value.value.bytes.bytes,
-                               value.value.bytes.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_BOOL:
-                if (elem->value.value.bools.length !=
-                    value.value.bools.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_BOOL:
+            if (elem->value.value.bools.length !=
+                value.value.bools.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.bools.bools,
+                           value.value.bools.bools,
+                           value.value.bools.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.bools.bools,
-                               value.value.bools.bools,
-                               value.value.bools.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT8:
-                if (elem->value.value.i8s.length != value.value.i8s.length) {
-                    elem->changed = true;
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT8:
+            if (elem->value.value.i8s.length != value.value.i8s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.i8s.i8s, value.value.i8s.i8s,
+                           value.value.i8s.length) != 0) {
+                    elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.i8s.i8s, value.value.i8s.i8s,
-                               value.value.i8s.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT8:
-                if (elem->value.value.u8s.length != value.value.u8s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT8:
+            if (elem->value.value.u8s.length != value.value.u8s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.u8s.u8s, value.value.u8s.u8s,
+                           value.value.u8s.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.u8s.u8s, value.value.u8s.u8s,
-                               value.value.u8s.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT16:
-                if (elem->value.value.i16s.length != value.value.i16s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT16:
+            if (elem->value.value.i16s.length != value.value.i16s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(
+                        elem->value.value.i16s.i16s, value.value.i16s.i16s,
+                        value.value.i16s.length * sizeof(int16_t)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.i16s.i16s, value.value.i16s.i16s,
-                            value.value.i16s.length * sizeof(int16_t)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT16:
-                if (elem->value.value.u16s.length != value.value.u16s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT16:
+            if (elem->value.value.u16s.length != value.value.u16s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(
+                        elem->value.value.u16s.u16s, value.value.u16s.u16s,
+                        value.value.u16s.length * sizeof(uint16_t)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.u16s.u16s, value.value.u16s.u16s,
-                            value.value.u16s.length * sizeof(uint16_t)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT32:
-                if (elem->value.value.i32s.length != value.value.i32s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT32:
+            if (elem->value.value.i32s.length != value.value.i32s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(
+                        elem->value.value.i32s.i32s, value.value.i32s.i32s,
+                        value.value.i32s.length * sizeof(int32_t)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.i32s.i32s, value.value.i32s.i32s,
-                            value.value.i32s.length * sizeof(int32_t)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT32:
-                if (elem->value.value.u32s.length != value.value.u32s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT32:
+            if (elem->value.value.u32s.length != value.value.u32s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(
+                        elem->value.value.u32s.u32s, value.value.u32s.u32s,
+                        value.value.u32s.length * sizeof(uint32_t)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.u32s.u32s, value.value.u32s.u32s,
-                            value.value.u32s.length * sizeof(uint32_t)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_INT64:
-                if (elem->value.value.i64s.length != value.value.i64s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_INT64:
+            if (elem->value.value.i64s.length != value.value.i64s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(
+                        elem->value.value.i64s.i64s, value.value.i64s.i64s,
+                        value.value.i64s.length * sizeof(int64_t)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.i64s.i64s, value.value.i64s.i64s,
-                            value.value.i64s.length * sizeof(int64_t)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_UINT64:
-                if (elem->value.value.u64s.length != value.value.u64s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_UINT64:
+            if (elem->value.value.u64s.length != value.value.u64s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(
+                        elem->value.value.u64s.u64s, value.value.u64s.u64s,
+                        value.value.u64s.length * sizeof(uint64_t)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.u64s.u64s, value.value.u64s.u64s,
-                            value.value.u64s.length * sizeof(uint64_t)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_FLOAT:
-                if (elem->value.value.f32s.length != value.value.f32s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_FLOAT:
+            if (elem->value.value.f32s.length != value.value.f32s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.f32s.f32s,
+                           value.value.f32s.f32s,
+                           value.value.f32s.length * sizeof(float)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.f32s.f32s,
-                               value.value.f32s.f32s,
-                               value.value.f32s.length * sizeof(float)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_DOUBLE:
-                if (elem->value.value.f64s.length != value.value.f64s.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_DOUBLE:
+            if (elem->value.value.f64s.length != value.value.f64s.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.f64s.f64s,
+                           value.value.f64s.f64s,
+                           value.value.f64s.length * sizeof(double)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.f64s.f64s,
-                               value.value.f64s.f64s,
-                               value.value.f64s.length * sizeof(double)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_ARRAY_STRING:
-                if (elem->value.value.strs.length != value.value.strs.length) {
+            }
+            break;
+        case NEU_TYPE_ARRAY_STRING:
+            if (elem->value.value.strs.length != value.value.strs.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.strs.strs,
+                           value.value.strs.strs,
+                           value.value.strs.length * sizeof(char *)) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.strs.strs,
-                               value.value.strs.strs,
-                               value.value.strs.length * sizeof(char *)) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
-                break;
-            case NEU_TYPE_PTR: {
-                if (elem->value.value.ptr.length != value.value.ptr.length) {
+            }
+            break;
+        case NEU_TYPE_PTR: {
+            if (elem->value.value.ptr.length != value.value.ptr.length) {
+                elem->changed = true;
+                tag_changed   = true;
+            } else {
+                if (memcmp(elem->value.value.ptr.ptr, value.value.ptr.ptr,
+                           value.value.ptr.length) != 0) {
                     elem->changed = true;
                     tag_changed   = true;
-                } else {
-                    if (memcmp(elem->value.value.ptr.ptr, value.value.ptr.ptr,
-                               value.value.ptr.length) != 0) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
                 }
+            }
 
-                break;
+            break;
+        }
+        case NEU_TYPE_CUSTOM: {
+            if (json_equal(elem->value.value.json, value.value.json) != 1) {
+                elem->changed = true;
+                tag_changed   = true;
             }
-            case NEU_TYPE_CUSTOM: {
-                if (json_equal(elem->value.value.json, value.value.json) != 1) {
+            break;
+        }
+        case NEU_TYPE_FLOAT:
+            if (elem->value.precision == 0) {
+                elem->changed = elem->value.value.f32 != value.value.f32;
+                tag_changed   = elem->changed;
+            } else {
+                if (fabs(elem->value.value.f32 - value.value.f32) >
+                    pow(0.1, elem->value.precision)) {
                     elem->changed = true;
                     tag_changed   = true;
                 }
-                break;
             }
-            case NEU_TYPE_FLOAT:
-                if (elem->value.precision == 0) {
-                    elem->changed = elem->value.value.f32 != value.value.f32;
-                    tag_changed   = elem->changed;
-                } else {
-                    if (fabs(elem->value.value.f32 - value.value.f32) >
-                        pow(0.1, elem->value.precision)) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_DOUBLE:
-                if (elem->value.precision == 0) {
-                    elem->changed = elem->value.value.d64 != value.value.d64;
-                    tag_changed   = elem->changed;
-                } else {
-                    if (fabs(elem->value.value.d64 - value.value.d64) >
-                        pow(0.1, elem->value.precision)) {
-                        elem->changed = true;
-                        tag_changed   = true;
-                    }
+            break;
+        case NEU_TYPE_DOUBLE:
+            if (elem->value.precision == 0) {
+                elem->changed = elem->value.value.d64 != value.value.d64;
+                tag_changed   = elem->changed;
+            } else {
+                if (fabs(elem->value.value.d64 - value.value.d64) >
+                    pow(0.1, elem->value.precision)) {
+                    elem->changed = true;
+                    tag_changed   = true;
                 }
+            }
 
-                break;
-            case NEU_TYPE_ERROR:
-                elem->changed = true;
-                tag_changed   = true;
-                break;
+            break;
+        case NEU_TYPE_ERROR:
+            elem->changed = true;
+            tag_changed   = true;
+            break;
+        }
+    }
+
+    if (sub_filter_err && value.type != NEU_TYPE_ERROR) {
+        elem->value_old.type      = value.type;
+        elem->value_old.value     = value.value;
+        elem->value_old.precision = value.precision;
+    }
+
+error_not_report:
+
+    if (elem->window != NULL) {
+        neu_dvalue_t reported = value;
+        double       number   = 0;
+
+        if (dvalue_number(&reported, &number)) {
+            neu_tag_transform_apply(&elem->window->plan, &reported);
+            if (dvalue_number(&reported, &number)) {
+                window_push(elem->window, timestamp, number);
             }
         }
+    }
+
+    if (elem->deadband != NULL &&
+        !(sub_filter_err && value.type == NEU_TYPE_ERROR)) {
+        // a change not read out yet stays pending
+        tag_changed = deadband_pass(elem->deadband, &value, timestamp,
+                                    tag_changed, change);
+        elem->changed = pending || tag_changed;
+    }
+
+    if (change) {
+        elem->changed = true;
+    }
 
-        if (sub_filter_err && value.type != NEU_TYPE_ERROR) {
-            elem->value_old.type      = value.type;
-            elem->value_old.value     = value.value;
-            elem->value_old.precision = value.precision;
+    if (value.type == NEU_TYPE_PTR) {
+        elem->value.value.ptr.length = value.value.ptr.length;
+        elem->value.value.ptr.type   = value.value.ptr.type;
+        if (elem->value.value.ptr.ptr != NULL) {
+            free(elem->value.value.ptr.ptr);
+        }
+        elem->value.value.ptr.ptr = calloc(1, value.value.ptr.length);
+        memcpy(elem->value.value.ptr.ptr, value.value.ptr.ptr,
+               value.value.ptr.length);
+    } else if (value.type == NEU_TYPE_CUSTOM) {
+        if (elem->value.type == NEU_TYPE_CUSTOM) {
+            if (elem->value.value.json != NULL) {
+                json_decref(elem->value.value.json);
+                elem->value.value.json = NULL;
+            }
         }
 
-    error_not_report:
+        elem->value.value.json = value.value.json;
 
-        if (change) {
-            elem->changed = true;
+    } else if (value.type == NEU_TYPE_ARRAY_STRING) {
+        if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
+            for (size_t i = 0; i < elem->value.value.strs.length; i++) {
+                free(elem->value.value.strs.strs[i]);
+                elem->value.value.strs.strs[i] = NULL;
+            }
+            free(elem->value.value.strs.strs);
+        }
+        elem->value.value.strs.length = value.value.strs.length;
+        elem->value.value.strs.strs   = value.value.strs.strs;
+
+    } else if (NEU_TYPE_ARRAY_CHAR < value.type &&
+               value.type < NEU_TYPE_ARRAY_STRING) {
+        if (NEU_TYPE_ARRAY_CHAR < elem->value.type &&
+            elem->value.type < NEU_TYPE_ARRAY_STRING) {
+            free(elem->value.value.bools.bools);
+        }
+        elem->value.value.bools.length = value.value.bools.length;
+        elem->value.value.bools.bools  = value.value.bools.bools;
+    } else if (value.type == NEU_TYPE_ERROR) {
+        if (elem->value.type == NEU_TYPE_CUSTOM) {
+            if (elem->value.value.json != NULL) {
+                json_decref(elem->value.value.json);
+                elem->value.value.json = NULL;
+            }
         }
 
-        if (value.type == NEU_TYPE_PTR) {
-            elem->value.value.ptr.length = value.value.ptr.length;
-            elem->value.value.ptr.type   = value.value.ptr.type;
+        if (elem->value.type == NEU_TYPE_PTR) {
             if (elem->value.value.ptr.ptr != NULL) {
                 free(elem->value.value.ptr.ptr);
+                elem->value.value.ptr.ptr = NULL;
             }
-            elem->value.value.ptr.ptr = calloc(1, value.value.ptr.length);
-            memcpy(elem->value.value.ptr.ptr, value.value.ptr.ptr,
-                   value.value.ptr.length);
-        } else if (value.type == NEU_TYPE_CUSTOM) {
-            if (elem->value.type == NEU_TYPE_CUSTOM) {
-                if (elem->value.value.json != NULL) {
-                    json_decref(elem->value.value.json);
-                    elem->value.value.json = NULL;
-                }
+        }
+
+        if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
+            for (size_t i = 0; i < elem->value.value.strs.length; i++) {
+                free(elem->value.value.strs.strs[i]);
+                elem->value.value.strs.strs[i] = NULL;
             }
+            free(elem->value.value.strs.strs);
+        }
 
-            elem->value.value.json = value.value.json;
+        if (NEU_TYPE_ARRAY_CHAR < elem->value.type &&
+            elem->value.type < NEU_TYPE_ARRAY_STRING) {
+            free(elem->value.value.bools.bools);
+            elem->value.value.bools.bools = NULL;
+        }
 
-        } else if (value.type == NEU_TYPE_ARRAY_STRING) {
-            if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-                for (size_t i = 0; i < elem->value.value.strs.length; i++) {
-                    free(elem->value.value.strs.strs[i]);
-                    elem->value.value.strs.strs[i] = NULL;
-                }
-                free(elem->value.value.strs.strs);
-            }
-            elem->value.value.strs.length = value.value.strs.length;
-            elem->value.value.strs.strs   = value.value.strs.strs;
-
-        } else if (NEU_TYPE_ARRAY_CHAR < value.type &&
-                   value.type < NEU_TYPE_ARRAY_STRING) {
-            if (NEU_TYPE_ARRAY_CHAR < elem->value.type &&
-                elem->value.type < NEU_TYPE_ARRAY_STRING) {
-                free(elem->value.value.bools.bools);
-            }
-            elem->value.value.bools.length = value.value.bools.length;
-            elem->value.value.bools.bools  = value.value.bools.bools;
-        } else if (value.type == NEU_TYPE_ERROR) {
-            if (elem->value.type == NEU_TYPE_CUSTOM) {
-                if (elem->value.value.json != NULL) {
-                    json_decref(elem->value.value.json);
-                    elem->value.value.json = NULL;
-                }
-            }
+        elem->value.value = value.value;
+    } else {
+        elem->value.value = value.value;
+    }
+    elem->value.type = value.type;
 
-            if (elem->value.type == NEU_TYPE_PTR) {
-                if (elem->value.value.ptr.ptr != NULL) {
-                    free(elem->value.value.ptr.ptr);
-                    elem->value.value.ptr.ptr = NULL;
-                }
+    if (metas != NULL && n_meta != 0) {
+        if (elem->metas != NULL) {
+            free(elem->metas);
+        }
+        elem->metas = calloc(n_meta, sizeof(neu_tag_meta_t));
+        for (int i = 0; i < n_meta; i++) {
+            if (!neu_dvalue_is_array(&metas[i].value)) {
+                memcpy(&elem->metas[i], &metas[i], sizeof(neu_tag_meta_t));
+            } else {
+                neu_free_dvalue(&metas[i].value);
+                elem->metas[i].value.type = NEU_TYPE_INT8;
             }
+        }
 
-            if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-                for (size_t i = 0; i < elem->value.value.strs.length; i++) {
-                    free(elem->value.value.strs.strs[i]);
-                    elem->value.value.strs.strs[i] = NULL;
-                }
-                free(elem->value.value.strs.strs);
-            }
+        elem->n_meta = n_meta;
+    }
 
-            if (NEU_TYPE_ARRAY_CHAR < elem->value.type &&
-                elem->value.type < NEU_TYPE_ARRAY_STRING) {
-                free(elem->value.value.bools.bools);
-                elem->value.value.bools.bools = NULL;
-            }
+    return tag_changed;
+}
 
-            elem->value.value = value.value;
-        } else {
-            elem->value.value = value.value;
+static void elem_copy(struct elem *elem, neu_driver_cache_value_t *value,
+                      neu_tag_meta_t **metas, int *n_meta)
+{
+    value->timestamp       = elem->timestamp;
+    value->value.type      = elem->value.type;
+    value->value.precision = elem->value.precision;
+
+    // assert(n_meta <= NEU_TAG_META_SIZE);
+    if (elem->metas) {
+        *metas = calloc(elem->n_meta, sizeof(neu_tag_meta_t));
+        memcpy(*metas, elem->metas, sizeof(neu_tag_meta_t) * elem->n_meta);
+    } else {
+        *metas = NULL;
+    }
+    *n_meta = elem->n_meta;
+
+    switch (elem->value.type) {
+    case NEU_TYPE_INT8:
+    case NEU_TYPE_UINT8:
+    case NEU_TYPE_BIT:
+        value->value.value.u8 = elem->value.value.u8;
+        break;
+    case NEU_TYPE_INT16:
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_WORD:
+        value->value.value.u16 = elem->value.value.u16;
+        break;
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_DWORD:
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_ERROR:
+        value->value.value.u32 = elem->value.value.u32;
+        break;
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_LWORD:
+        value->value.value.u64 = elem->value.value.u64;
+        break;
+    case NEU_TYPE_BOOL:
+        value->value.value.boolean = elem->value.value.boolean;
+        break;
+    case NEU_TYPE_STRING:
+    case NEU_TYPE_TIME:
+    case NEU_TYPE_DATA_AND_TIME:
+    case NEU_TYPE_ARRAY_CHAR:
+        memcpy(value->value.value.str, elem->value.value.str,
+               sizeof(elem->value.value.str));
+        break;
+    case NEU_TYPE_BYTES:
+        value->value.value.bytes.length = elem->value.value.bytes.length;
+        memcpy(value->value.value.bytes.bytes,
+               elem->value.value.bytes.bytes,
+               elem->value.value.bytes.length);
+        break;
+    case NEU_TYPE_ARRAY_BOOL:
+        value->value.value.bools.length = elem->value.value.bools.length;
+        value->value.value.bools.bools =
+            calloc(elem->value.value.bools.length, sizeof(bool));
+        memcpy(value->value.value.bools.bools,
+               elem->value.value.bools.bools,
+               elem->value.value.bools.length);
+        break;
+    case NEU_TYPE_ARRAY_INT8:
+        value->value.value.i8s.length = elem->value.value.i8s.length;
+        value->value.value.i8s.i8s =
+            calloc(elem->value.value.i8s.length, sizeof(int8_t));
+        memcpy(value->value.value.i8s.i8s, elem->value.value.i8s.i8s,
+               elem->value.value.i8s.length);
+        break;
+    case NEU_TYPE_ARRAY_UINT8:
+        value->value.value.u8s.length = elem->value.value.u8s.length;
+        value->value.value.u8s.u8s =
+            calloc(elem->value.value.u8s.length, sizeof(uint8_t));
+        memcpy(value->value.value.u8s.u8s, elem->value.value.u8s.u8s,
+               elem->value.value.u8s.length);
+        break;
+    case NEU_TYPE_ARRAY_INT16:
+        value->value.value.i16s.length = elem->value.value.i16s.length;
+        value->value.value.i16s.i16s =
+            calloc(elem->value.value.i16s.length, sizeof(int16_t));
+        memcpy(value->value.value.i16s.i16s, elem->value.value.i16s.i16s,
+               elem->value.value.i16s.length * sizeof(int16_t));
+        break;
+    case NEU_TYPE_ARRAY_UINT16:
+        value->value.value.u16s.length = elem->value.value.u16s.length;
+        value->value.value.u16s.u16s =
+            calloc(elem->value.value.u16s.length, sizeof(uint16_t));
+        memcpy(value->value.value.u16s.u16s, elem->value.value.u16s.u16s,
+               elem->value.value.u16s.length * sizeof(uint16_t));
+        break;
+    case NEU_TYPE_ARRAY_INT32:
+        value->value.value.i32s.length = elem->value.value.i32s.length;
+        value->value.value.i32s.i32s =
+            calloc(elem->value.value.i32s.length, sizeof(int32_t));
+        memcpy(value->value.value.i32s.i32s, elem->value.value.i32s.i32s,
+               elem->value.value.i32s.length * sizeof(int32_t));
+        break;
+    case NEU_TYPE_ARRAY_UINT32:
+        value->value.value.u32s.length = elem->value.value.u32s.length;
+        value->value.value.u32s.u32s =
+            calloc(elem->value.value.u32s.length, sizeof(uint32_t));
+        memcpy(value->value.value.u32s.u32s, elem->value.value.u32s.u32s,
+               elem->value.value.u32s.length * sizeof(uint32_t));
+        break;
+    case NEU_TYPE_ARRAY_INT64:
+        value->value.value.i64s.length = elem->value.value.i64s.length;
+        value->value.value.i64s.i64s =
+            calloc(elem->value.value.i64s.length, sizeof(int64_t));
+        memcpy(value->value.value.i64s.i64s, elem->value.value.i64s.i64s,
+               elem->value.value.i64s.length * sizeof(int64_t));
+        break;
+    case NEU_TYPE_ARRAY_UINT64:
+        value->value.value.u64s.length = elem->value.value.u64s.length;
+        value->value.value.u64s.u64s =
+            calloc(elem->value.value.u64s.length, sizeof(uint64_t));
+        memcpy(value->value.value.u64s.u64s, elem->value.value.u64s.u64s,
+               elem->value.value.u64s.length * sizeof(uint64_t));
+        break;
+    case NEU_TYPE_ARRAY_FLOAT:
+        value->value.value.f32s.length = elem->value.value.f32s.length;
+        value->value.value.f32s.f32s =
+            calloc(elem->value.value.f32s.length, sizeof(float));
+        memcpy(value->value.value.f32s.f32s, elem->value.value.f32s.f32s,
+               elem->value.value.f32s.length * sizeof(float));
+        break;
+    case NEU_TYPE_ARRAY_DOUBLE:
+        value->value.value.f64s.length = elem->value.value.f64s.length;
+        value->value.value.f64s.f64s =
+            calloc(elem->value.value.f64s.length, sizeof(double));
+        memcpy(value->value.value.f64s.f64s, elem->value.value.f64s.f64s,
+               elem->value.value.f64s.length * sizeof(double));
+        break;
+    case NEU_TYPE_ARRAY_STRING:
+        value->value.value.strs.length = elem->value.value.strs.length;
+        value->value.value.strs.strs =
+            calloc(elem->value.value.strs.length, sizeof(char *));
+        for (size_t i = 0; i < elem->value.value.strs.length; i++) {
+            value->value.value.strs.strs[i] =
+                strdup(elem->value.value.strs.strs[i]);
         }
-        elem->value.type = value.type;
+        break;
+    case NEU_TYPE_PTR:
+        value->value.value.ptr.length = elem->value.value.ptr.length;
+        value->value.value.ptr.type   = elem->value.value.ptr.type;
+        value->value.value.ptr.ptr =
+            calloc(1, elem->value.value.ptr.length);
+        memcpy(value->value.value.ptr.ptr, elem->value.value.ptr.ptr,
+               elem->value.value.ptr.length);
+        break;
+    case NEU_TYPE_CUSTOM:
+        value->value.value.json = json_deep_copy(elem->value.value.json);
+        break;
+    }
+}
 
-        if (metas != NULL && n_meta != 0) {
-            if (elem->metas != NULL) {
-                free(elem->metas);
-            }
-            elem->metas = calloc(n_meta, sizeof(neu_tag_meta_t));
-            for (int i = 0; i < n_meta; i++) {
-                if (!neu_dvalue_is_array(&metas[i].value)) {
-                    memcpy(&elem->metas[i], &metas[i], sizeof(neu_tag_meta_t));
-                } else {
-                    neu_free_dvalue(&metas[i].value);
-                    elem->metas[i].value.type = NEU_TYPE_INT8;
-                }
-            }
+neu_driver_cache_t *neu_driver_cache_new()
+{
+    neu_driver_cache_t *cache = calloc(1, sizeof(neu_driver_cache_t));
 
-            elem->n_meta = n_meta;
+    pthread_rwlock_init(&cache->index_mtx, NULL);
+    for (int i = 0; i < CACHE_STRIPE_NUM; i++) {
+        pthread_mutex_init(&cache->stripes[i], NULL);
+    }
+
+    return cache;
+}
+
+void neu_driver_cache_destroy(neu_driver_cache_t *cache)
+{
+    group_index_t *g    = NULL;
+    group_index_t *gtmp = NULL;
+
+    pthread_rwlock_wrlock(&cache->index_mtx);
+    HASH_ITER(hh, cache->groups, g, gtmp)
+    {
+        tag_index_t *t    = NULL;
+        tag_index_t *ttmp = NULL;
+
+        HASH_ITER(hh, g->tags, t, ttmp)
+        {
+            HASH_DEL(g->tags, t);
+            free(t->name);
+            free(t);
+        }
+
+        HASH_DEL(cache->groups, g);
+        free(g);
+    }
+
+    for (uint32_t slot = 0; slot < cache->n_slot; slot++) {
+        struct elem *elem = slot_elem(cache, slot);
+
+        if (elem->used) {
+            elem_free_value(elem);
+            free(elem->deadband);
+            free(elem->window);
+        }
+    }
+
+    for (int i = 0; i < CACHE_CHUNK_MAX && cache->chunks[i] != NULL; i++) {
+        free(cache->chunks[i]);
+    }
+    free(cache->free_slots);
+    pthread_rwlock_unlock(&cache->index_mtx);
+
+    for (int i = 0; i < CACHE_STRIPE_NUM; i++) {
+        pthread_mutex_destroy(&cache->stripes[i]);
+    }
+    pthread_rwlock_destroy(&cache->index_mtx);
+
+    free(cache);
+}
+
+neu_driver_cache_slot_t neu_driver_cache_add(neu_driver_cache_t *cache,
+                                             const char *group, const char *tag,
+                                             neu_dvalue_t value)
+{
+    group_index_t *g    = NULL;
+    tag_index_t *  t    = NULL;
+    struct elem *  elem = NULL;
+    int64_t        slot = -1;
+    uint32_t       gen  = 0;
+
+    pthread_rwlock_wrlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    if (g == NULL) {
+        g = calloc(1, sizeof(group_index_t));
+        snprintf(g->key, sizeof(g->key), "%s", group);
+        HASH_ADD_STR(cache->groups, key, g);
+    }
+
+    HASH_FIND_STR(g->tags, tag, t);
+    if (t == NULL) {
+        slot = alloc_slot(cache);
+        if (slot < 0) {
+            pthread_rwlock_unlock(&cache->index_mtx);
+            return -1;
         }
+
+        t       = calloc(1, sizeof(tag_index_t));
+        t->name = strdup(tag);
+        t->slot = (uint32_t) slot;
+        HASH_ADD_KEYPTR(hh, g->tags, t->name, strlen(t->name), t);
+    }
+
+    elem = slot_elem(cache, t->slot);
+
+    pthread_mutex_lock(slot_stripe(cache, t->slot));
+    elem->used      = true;
+    elem->timestamp = 0;
+    elem->changed   = false;
+    elem->value     = value;
+    gen             = elem->gen;
+    pthread_mutex_unlock(slot_stripe(cache, t->slot));
+
+    slot = t->slot;
+    pthread_rwlock_unlock(&cache->index_mtx);
+
+    return to_handle((uint32_t) slot, gen);
+}
+
+neu_driver_cache_slot_t neu_driver_cache_slot(neu_driver_cache_t *cache,
+                                              const char *        group,
+                                              const char *        tag)
+{
+    int64_t  slot = -1;
+    uint32_t gen  = 0;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    slot = find_slot(cache, group, tag);
+    if (slot >= 0) {
+        pthread_mutex_lock(slot_stripe(cache, (uint32_t) slot));
+        gen = slot_elem(cache, (uint32_t) slot)->gen;
+        pthread_mutex_unlock(slot_stripe(cache, (uint32_t) slot));
+    }
+    pthread_rwlock_unlock(&cache->index_mtx);
+
+    return slot < 0 ? -1 : to_handle((uint32_t) slot, gen);
+}
+
+void neu_driver_cache_update_trace(neu_driver_cache_t *cache, const char *group,
+                                   void *trace_ctx)
+{
+    group_index_t *g = NULL;
+
+    pthread_rwlock_wrlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    if (g == NULL) {
+        g = calloc(1, sizeof(group_index_t));
+        snprintf(g->key, sizeof(g->key), "%s", group);
+        HASH_ADD_STR(cache->groups, key, g);
+    }
+
+    g->trace_ctx = trace_ctx;
+    pthread_rwlock_unlock(&cache->index_mtx);
+}
+
+void *neu_driver_cache_get_trace(neu_driver_cache_t *cache, const char *group)
+{
+    group_index_t *g     = NULL;
+    void *         trace = NULL;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    if (g != NULL) {
+        trace = g->trace_ctx;
+    }
+    pthread_rwlock_unlock(&cache->index_mtx);
+
+    return trace;
+}
+
+bool neu_driver_cache_update_change(neu_driver_cache_t *cache,
+                                    const char *group, const char *tag,
+                                    int64_t timestamp, neu_dvalue_t value,
+                                    neu_tag_meta_t *metas, int n_meta,
+                                    bool change)
+{
+    bool    tag_changed = false;
+    int64_t slot        = -1;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    slot = find_slot(cache, group, tag);
+    if (slot >= 0) {
+        pthread_mutex_lock(slot_stripe(cache, (uint32_t) slot));
+        tag_changed = elem_update(slot_elem(cache, (uint32_t) slot),
+                                  timestamp, value, metas, n_meta, change);
+        pthread_mutex_unlock(slot_stripe(cache, (uint32_t) slot));
     }
+    pthread_rwlock_unlock(&cache->index_mtx);
 
-    pthread_mutex_unlock(&cache->mtx);
     return tag_changed;
 }
 
@@ -874,175 +1450,75 @@ void neu_driver_cache_update(neu_driver_cache_t *cache, const char *group,
                                    n_meta, false);
 }
 
-int neu_driver_cache_meta_get(neu_driver_cache_t *cache, const char *group,
-                              const char *tag, neu_driver_cache_value_t *value,
-                              neu_tag_meta_t **metas, int *n_meta)
+int neu_driver_cache_update_many(neu_driver_cache_t *cache, const char *group,
+                                 int64_t                 timestamp,
+                                 const neu_tag_update_t *items, int n)
 {
-    struct elem *elem = NULL;
-    int          ret  = -1;
-    tkey_t       key  = to_key(group, tag);
-
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
-
-    if (elem != NULL) {
-        value->timestamp       = elem->timestamp;
-        value->value.type      = elem->value.type;
-        value->value.precision = elem->value.precision;
-
-        // assert(n_meta <= NEU_TAG_META_SIZE);
-        if (elem->metas) {
-            *metas = calloc(elem->n_meta, sizeof(neu_tag_meta_t));
-            memcpy(*metas, elem->metas, sizeof(neu_tag_meta_t) * elem->n_meta);
-        } else {
-            *metas = NULL;
-        }
-        *n_meta = elem->n_meta;
+    group_index_t *g         = NULL;
+    int            n_updated = 0;
 
-        switch (elem->value.type) {
-        case NEU_TYPE_INT8:
-        case NEU_TYPE_UINT8:
-        case NEU_TYPE_BIT:
-            value->value.value.u8 = elem->value.value.u8;
-            break;
-        case NEU_TYPE_INT16:
-        case NEU_TYPE_UINT16:
-        case NEU_TYPE_WORD:
-            value->value.value.u16 = elem->value.value.u16;
-            break;
-        case NEU_TYPE_INT32:
-        case NEU_TYPE_UINT32:
-        case NEU_TYPE_DWORD:
-        case NEU_TYPE_FLOAT:
-        case NEU_TYPE_ERROR:
-            value->value.value.u32 = elem->value.value.u32;
-            break;
-        case NEU_TYPE_INT64:
-        case NEU_TYPE_UINT64:
-        case NEU_TYPE_DOUBLE:
-        case NEU_TYPE_LWORD:
-            value->value.value.u64 = elem->value.value.u64;
-            break;
-        case NEU_TYPE_BOOL:
-            value->value.value.boolean = elem->value.value.boolean;
-            break;
-        case NEU_TYPE_STRING:
-        case NEU_TYPE_TIME:
-        case NEU_TYPE_DATA_AND_TIME:
-        case NEU_TYPE_ARRAY_CHAR:
-            memcpy(value->value.value.str, elem->value.value.str,
-                   sizeof(elem->value.value.str));
-            break;
-        case NEU_TYPE_BYTES:
-            value->value.value.bytes.length = elem->value.value.bytes.length;
-            memcpy(value->value.value.bytes.bytes,
-                   elem->value.value.bytes.bytes,
-                   elem->value.value.bytes.length);
-            break;
-        case NEU_TYPE_ARRAY_BOOL:
-            value->value.value.bools.length = elem->value.value.bools.length;
-            value->value.value.bools.bools =
-                calloc(elem->value.value.bools.length, sizeof(bool));
-            memcpy(value->value.value.bools.bools,
-                   elem->value.value.bools.bools,
-                   elem->value.value.bools.length);
-            break;
-        case NEU_TYPE_ARRAY_INT8:
-            value->value.value.i8s.length = elem->value.value.i8s.length;
-            value->value.value.i8s.i8s =
-                calloc(elem->value.value.i8s.length, sizeof(int8_t));
-            memcpy(value->value.value.i8s.i8s, elem->value.value.i8s.i8s,
-                   elem->value.value.i8s.length);
-            break;
-        case NEU_TYPE_ARRAY_UINT8:
-            value->value.value.u8s.length = elem->value.value.u8s.length;
-            value->value.value.u8s.u8s =
-                calloc(elem->value.value.u8s.length, sizeof(uint8_t));
-            memcpy(value->value.value.u8s.u8s, elem->value.value.u8s.u8s,
-                   elem->value.value.u8s.length);
-            break;
-        case NEU_TYPE_ARRAY_INT16:
-            value->value.value.i16s.length = elem->value.value.i16s.length;
-            value->value.value.i16s.i16s =
-                calloc(elem->value.value.i16s.length, sizeof(int16_t));
-            memcpy(value->value.value.i16s.i16s, elem->value.value.i16s.i16s,
-                   elem->value.value.i16s.length * sizeof(int16_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT16:
-            value->value.value.u16s.length = elem->value.value.u16s.length;
-            value->value.value.u16s.u16s =
-                calloc(elem->value.value.u16s.length, sizeof(uint16_t));
-            memcpy(value->value.value.u16s.u16s, elem->value.value.u16s.u16s,
-                   elem->value.value.u16s.length * sizeof(uint16_t));
-            break;
-        case NEU_TYPE_ARRAY_INT32:
-            value->value.value.i32s.length = elem->value.value.i32s.length;
-            value->value.value.i32s.i32s =
-                calloc(elem->value.value.i32s.length, sizeof(int32_t));
-            memcpy(value->value.value.i32s.i32s, elem->value.value.i32s.i32s,
-                   elem->value.value.i32s.length * sizeof(int32_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT32:
-            value->value.value.u32s.length = elem->value.value.u32s.length;
-            value->value.value.u32s.u32s =
-                calloc(elem->value.value.u32s.length, sizeof(uint32_t));
-            memcpy(value->value.value.u32s.u32s, elem->value.value.u32s.u32s,
-                   elem->value.value.u32s.length * sizeof(uint32_t));
-            break;
-        case NEU_TYPE_ARRAY_INT64:
-            value->value.value.i64s.length = elem->value.value.i64s.length;
-            value->value.value.i64s.i64s =
-                calloc(elem->value.value.i64s.length, sizeof(int64_t));
-            memcpy(value->value.value.i64s.i64s, elem->value.value.i64s.i64s,
-                   elem->value.value.i64s.length * sizeof(int64_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT64:
-            value->value.value.u64s.length = elem->value.value.u64s.length;
-            value->value.value.u64s.u64s =
-                calloc(elem->value.value.u64s.length, sizeof(uint64_t));
-            memcpy(value->value.value.u64s.u64s, elem->value.value.u64s.u64s,
-                   elem->value.value.u64s.length * sizeof(uint64_t));
-            break;
-        case NEU_TYPE_ARRAY_FLOAT:
-            value->value.value.f32s.length = elem->value.value.f32s.length;
-            value->value.value.f32s.f32s =
-                calloc(elem->value.value.f32s.length, sizeof(float));
-            memcpy(value->value.value.f32s.f32s, elem->value.value.f32s.f32s,
-                   elem->value.value.f32s.length * sizeof(float));
-            break;
-        case NEU_TYPE_ARRAY_DOUBLE:
-            value->value.value.f64s.length = elem->value.value.f64s.length;
-            value->value.value.f64s.f64s =
-                calloc(elem->value.value.f64s.length, sizeof(double));
-            memcpy(value->value.value.f64s.f64s, elem->value.value.f64s.f64s,
-                   elem->value.value.f64s.length * sizeof(double));
-            break;
-        case NEU_TYPE_ARRAY_STRING:
-            value->value.value.strs.length = elem->value.value.strs.length;
-            value->value.value.strs.strs =
-                calloc(elem->value.value.strs.length, sizeof(char *));
-            for (size_t i = 0; i < elem->value.value.strs.length; i++) {
-                value->value.value.strs.strs[i] =
-                    strdup(elem->value.value.strs.strs[i]);
-            }
-            break;
-        case NEU_TYPE_PTR:
-            value->value.value.ptr.length = elem->value.value.ptr.length;
-            value->value.value.ptr.type   = elem->value.value.ptr.type;
-            value->value.value.ptr.ptr =
-                calloc(1, elem->value.value.ptr.length);
-            memcpy(value->value.value.ptr.ptr, elem->value.value.ptr.ptr,
-                   elem->value.value.ptr.length);
-            break;
-        case NEU_TYPE_CUSTOM:
-            value->value.value.json = json_deep_copy(elem->value.value.json);
-            break;
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    for (int i = 0; g != NULL && i < n; i++) {
+        tag_index_t *t = NULL;
+
+        HASH_FIND_STR(g->tags, items[i].tag, t);
+        if (t == NULL) {
+            continue;
         }
 
-        ret = 0;
+        pthread_mutex_lock(slot_stripe(cache, t->slot));
+        elem_update(slot_elem(cache, t->slot), timestamp, items[i].value,
+                    items[i].metas, items[i].n_meta, false);
+        pthread_mutex_unlock(slot_stripe(cache, t->slot));
+        n_updated += 1;
+    }
+    pthread_rwlock_unlock(&cache->index_mtx);
+
+    return n_updated;
+}
+
+bool neu_driver_cache_update_slot(neu_driver_cache_t *    cache,
+                                  neu_driver_cache_slot_t slot,
+                                  int64_t timestamp, neu_dvalue_t value,
+                                  neu_tag_meta_t *metas, int n_meta,
+                                  bool change)
+{
+    bool         tag_changed = false;
+    uint32_t     index       = handle_slot(slot);
+    struct elem *elem        = NULL;
+
+    if (slot < 0 || !slot_published(cache, index)) {
+        return false;
+    }
+
+    elem = slot_elem(cache, index);
+    pthread_mutex_lock(slot_stripe(cache, index));
+    if (elem->used && elem->gen == handle_gen(slot)) {
+        tag_changed =
+            elem_update(elem, timestamp, value, metas, n_meta, change);
     }
+    pthread_mutex_unlock(slot_stripe(cache, index));
 
-    pthread_mutex_unlock(&cache->mtx);
+    return tag_changed;
+}
+
+int neu_driver_cache_meta_get(neu_driver_cache_t *cache, const char *group,
+                              const char *tag, neu_driver_cache_value_t *value,
+                              neu_tag_meta_t **metas, int *n_meta)
+{
+    int     ret  = -1;
+    int64_t slot = -1;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    slot = find_slot(cache, group, tag);
+    if (slot >= 0) {
+        pthread_mutex_lock(slot_stripe(cache, (uint32_t) slot));
+        elem_copy(slot_elem(cache, (uint32_t) slot), value, metas, n_meta);
+        pthread_mutex_unlock(slot_stripe(cache, (uint32_t) slot));
+        ret = 0;
+    }
+    pthread_rwlock_unlock(&cache->index_mtx);
 
     return ret;
 }
@@ -1052,174 +1528,57 @@ int neu_driver_cache_meta_get_changed(neu_driver_cache_t *cache,
                                       neu_driver_cache_value_t *value,
                                       neu_tag_meta_t **metas, int *n_meta)
 {
-    struct elem *elem = NULL;
-    int          ret  = -1;
-    tkey_t       key  = to_key(group, tag);
-
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
-
-    if (elem != NULL && elem->changed) {
-        value->timestamp       = elem->timestamp;
-        value->value.type      = elem->value.type;
-        value->value.precision = elem->value.precision;
-
-        // assert(n_meta <= NEU_TAG_META_SIZE);
-        if (elem->metas) {
-            *metas = calloc(elem->n_meta, sizeof(neu_tag_meta_t));
-            memcpy(*metas, elem->metas, sizeof(neu_tag_meta_t) * elem->n_meta);
-        } else {
-            *metas = NULL;
-        }
-        *n_meta = elem->n_meta;
-
-        switch (elem->value.type) {
-        case NEU_TYPE_INT8:
-        case NEU_TYPE_UINT8:
-        case NEU_TYPE_BIT:
-            value->value.value.u8 = elem->value.value.u8;
-            break;
-        case NEU_TYPE_INT16:
-        case NEU_TYPE_UINT16:
-        case NEU_TYPE_WORD:
-            value->value.value.u16 = elem->value.value.u16;
-            break;
-        case NEU_TYPE_INT32:
-        case NEU_TYPE_UINT32:
-        case NEU_TYPE_FLOAT:
-        case NEU_TYPE_ERROR:
-        case NEU_TYPE_DWORD:
-            value->value.value.u32 = elem->value.value.u32;
-            break;
-        case NEU_TYPE_INT64:
-        case NEU_TYPE_UINT64:
-        case NEU_TYPE_DOUBLE:
-        case NEU_TYPE_LWORD:
-            value->value.value.u64 = elem->value.value.u64;
-            break;
-        case NEU_TYPE_BOOL:
-            value->value.value.boolean = elem->value.value.boolean;
-            break;
-        case NEU_TYPE_STRING:
-        case NEU_TYPE_TIME:
-        case NEU_TYPE_DATA_AND_TIME:
-        case NEU_TYPE_ARRAY_CHAR:
-            memcpy(value->value.value.str, elem->value.value.str,
-                   sizeof(elem->value.value.str));
-            break;
-        case NEU_TYPE_BYTES:
-            value->value.value.bytes.length = elem->value.value.bytes.length;
-            memcpy(value->value.value.bytes.bytes,
-                   elem->value.value.bytes.bytes,
-                   elem->value.value.bytes.length);
-            break;
-        case NEU_TYPE_ARRAY_BOOL:
-            value->value.value.bools.length = elem->value.value.bools.length;
-            value->value.value.bools.bools =
-                calloc(elem->value.value.bools.length, sizeof(bool));
-            memcpy(value->value.value.bools.bools,
-                   elem->value.value.bools.bools,
-                   elem->value.value.bools.length);
-            break;
-        case NEU_TYPE_ARRAY_INT8:
-            value->value.value.i8s.length = elem->value.value.i8s.length;
-            value->value.value.i8s.i8s =
-                calloc(elem->value.value.i8s.length, sizeof(int8_t));
-            memcpy(value->value.value.i8s.i8s, elem->value.value.i8s.i8s,
-                   elem->value.value.i8s.length);
-            break;
-        case NEU_TYPE_ARRAY_UINT8:
-            value->value.value.u8s.length = elem->value.value.u8s.length;
-            value->value.value.u8s.u8s =
-                calloc(elem->value.value.u8s.length, sizeof(uint8_t));
-            memcpy(value->value.value.u8s.u8s, elem->value.value.u8s.u8s,
-                   elem->value.value.u8s.length);
-            break;
-        case NEU_TYPE_ARRAY_INT16:
-            value->value.value.i16s.length = elem->value.value.i16s.length;
-            value->value.value.i16s.i16s =
-                calloc(elem->value.value.i16s.length, sizeof(int16_t));
-            memcpy(value->value.value.i16s.i16s, elem->value.value.i16s.i16s,
-                   elem->value.value.i16s.length * sizeof(int16_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT16:
-            value->value.value.u16s.length = elem->value.value.u16s.length;
-            value->value.value.u16s.u16s =
-                calloc(elem->value.value.u16s.length, sizeof(uint16_t));
-            memcpy(value->value.value.u16s.u16s, elem->value.value.u16s.u16s,
-                   elem->value.value.u16s.length * sizeof(uint16_t));
-            break;
-        case NEU_TYPE_ARRAY_INT32:
-            value->value.value.i32s.length = elem->value.value.i32s.length;
-            value->value.value.i32s.i32s =
-                calloc(elem->value.value.i32s.length, sizeof(int32_t));
-            memcpy(value->value.value.i32s.i32s, elem->value.value.i32s.i32s,
-                   elem->value.value.i32s.length * sizeof(int32_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT32:
-            value->value.value.u32s.length = elem->value.value.u32s.length;
-            value->value.value.u32s.u32s =
-                calloc(elem->value.value.u32s.length, sizeof(uint32_t));
-            memcpy(value->value.value.u32s.u32s, elem->value.value.u32s.u32s,
-                   elem->value.value.u32s.length * sizeof(uint32_t));
-            break;
-        case NEU_TYPE_ARRAY_INT64:
-            value->value.value.i64s.length = elem->value.value.i64s.length;
-            value->value.value.i64s.i64s =
-                calloc(elem->value.value.i64s.length, sizeof(int64_t));
-            memcpy(value->value.value.i64s.i64s, elem->value.value.i64s.i64s,
-                   elem->value.value.i64s.length * sizeof(int64_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT64:
-            value->value.value.u64s.length = elem->value.value.u64s.length;
-            value->value.value.u64s.u64s =
-                calloc(elem->value.value.u64s.length, sizeof(uint64_t));
-            memcpy(value->value.value.u64s.u64s, elem->value.value.u64s.u64s,
-                   elem->value.value.u64s.length * sizeof(uint64_t));
-            break;
-        case NEU_TYPE_ARRAY_FLOAT:
-            value->value.value.f32s.length = elem->value.value.f32s.length;
-            value->value.value.f32s.f32s =
-                calloc(elem->value.value.f32s.length, sizeof(float));
-            memcpy(value->value.value.f32s.f32s, elem->value.value.f32s.f32s,
-                   elem->value.value.f32s.length * sizeof(float));
-            break;
-        case NEU_TYPE_ARRAY_DOUBLE:
-            value->value.value.f64s.length = elem->value.value.f64s.length;
-            value->value.value.f64s.f64s =
-                calloc(elem->value.value.f64s.length, sizeof(double));
-            memcpy(value->value.value.f64s.f64s, elem->value.value.f64s.f64s,
-                   elem->value.value.f64s.length * sizeof(double));
-            break;
-        case NEU_TYPE_ARRAY_STRING:
-            value->value.value.strs.length = elem->value.value.strs.length;
-            value->value.value.strs.strs =
-                calloc(elem->value.value.strs.length, sizeof(char *));
-            for (size_t i = 0; i < elem->value.value.strs.length; i++) {
-                value->value.value.strs.strs[i] =
-                    strdup(elem->value.value.strs.strs[i]);
+    int     ret  = -1;
+    int64_t slot = -1;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    slot = find_slot(cache, group, tag);
+    if (slot >= 0) {
+        struct elem *elem = slot_elem(cache, (uint32_t) slot);
+
+        pthread_mutex_lock(slot_stripe(cache, (uint32_t) slot));
+        if (elem->changed) {
+            elem_copy(elem, value, metas, n_meta);
+            if (elem->value.type != NEU_TYPE_ERROR) {
+                elem->changed = false;
             }
-            break;
-        case NEU_TYPE_PTR:
-            value->value.value.ptr.length = elem->value.value.ptr.length;
-            value->value.value.ptr.type   = elem->value.value.ptr.type;
-            value->value.value.ptr.ptr =
-                calloc(1, elem->value.value.ptr.length);
-            memcpy(value->value.value.ptr.ptr, elem->value.value.ptr.ptr,
-                   elem->value.value.ptr.length);
-            break;
-        case NEU_TYPE_CUSTOM:
-            value->value.value.json = json_deep_copy(elem->value.value.json);
-            break;
+            ret = 0;
         }
+        pthread_mutex_unlock(slot_stripe(cache, (uint32_t) slot));
+    }
+    pthread_rwlock_unlock(&cache->index_mtx);
 
-        if (elem->value.type != NEU_TYPE_ERROR) {
-            elem->changed = false;
-        }
-        ret = 0;
+    return ret;
+}
+
+int neu_driver_cache_meta_get_slot(neu_driver_cache_t *      cache,
+                                   neu_driver_cache_slot_t   slot,
+                                   neu_driver_cache_value_t *value,
+                                   neu_tag_meta_t **metas, int *n_meta,
+                                   bool changed)
+{
+    int          ret   = -1;
+    uint32_t     index = handle_slot(slot);
+    struct elem *elem  = NULL;
+
+    if (slot < 0 || !slot_published(cache, index)) {
+        return -1;
     }
 
-    pthread_mutex_unlock(&cache->mtx);
+    elem = slot_elem(cache, index);
+    pthread_mutex_lock(slot_stripe(cache, index));
+    if (elem->used && elem->gen == handle_gen(slot)) {
+        if (!changed || elem->changed) {
+            elem_copy(elem, value, metas, n_meta);
+            if (changed && elem->value.type != NEU_TYPE_ERROR) {
+                elem->changed = false;
+            }
+            ret = 0;
+        } else {
+            ret = 1;
+        }
+    }
+    pthread_mutex_unlock(slot_stripe(cache, index));
 
     return ret;
 }
@@ -1227,60 +1586,197 @@ int neu_driver_cache_meta_get_changed(neu_driver_cache_t *cache,
 void neu_driver_cache_del(neu_driver_cache_t *cache, const char *group,
                           const char *tag)
 {
-    struct elem *elem = NULL;
-    tkey_t       key  = to_key(group, tag);
+    group_index_t *g = NULL;
+    tag_index_t *  t = NULL;
 
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
+    pthread_rwlock_wrlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    if (g != NULL) {
+        HASH_FIND_STR(g->tags, tag, t);
+    }
 
-    if (elem != NULL) {
-        HASH_DEL(cache->table, elem);
-        if (elem->value.type == NEU_TYPE_PTR) {
-            if (elem->value.value.ptr.ptr != NULL) {
-                free(elem->value.value.ptr.ptr);
-                elem->value.value.ptr.ptr = NULL;
-            }
-        } else if (elem->value.type == NEU_TYPE_CUSTOM) {
-            if (elem->value.value.json != NULL) {
-                json_decref(elem->value.value.json);
-                elem->value.value.json = NULL;
+    if (t != NULL) {
+        struct elem *elem = slot_elem(cache, t->slot);
+
+        HASH_DEL(g->tags, t);
+
+        pthread_mutex_lock(slot_stripe(cache, t->slot));
+        elem_free_value(elem);
+        free(elem->deadband);
+        free(elem->window);
+        elem->deadband = NULL;
+        elem->window   = NULL;
+        memset(&elem->value, 0, sizeof(elem->value));
+        memset(&elem->value_old, 0, sizeof(elem->value_old));
+        elem->timestamp = 0;
+        elem->changed   = false;
+        elem->used      = false;
+        elem->gen += 1;
+        pthread_mutex_unlock(slot_stripe(cache, t->slot));
+
+        release_slot(cache, t->slot);
+        free(t->name);
+        free(t);
+    }
+
+    pthread_rwlock_unlock(&cache->index_mtx);
+}
+
+int neu_driver_cache_set_deadband(neu_driver_cache_t *       cache,
+                                  const char *               group,
+                                  const char *               tag,
+                                  const neu_tag_deadband_t * deadband,
+                                  const neu_tag_transform_t *plan)
+{
+    group_index_t *g   = NULL;
+    tag_index_t *  t   = NULL;
+    int            ret = -1;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    if (g != NULL) {
+        HASH_FIND_STR(g->tags, tag, t);
+    }
+
+    if (t != NULL) {
+        struct elem *elem = slot_elem(cache, t->slot);
+
+        pthread_mutex_lock(slot_stripe(cache, t->slot));
+        if (deadband == NULL || !neu_tag_deadband_is_set(deadband)) {
+            free(elem->deadband);
+            elem->deadband = NULL;
+        } else {
+            if (elem->deadband == NULL) {
+                elem->deadband = calloc(1, sizeof(deadband_t));
             }
-        } else if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-            for (size_t i = 0; i < elem->value.value.strs.length; i++) {
-                free(elem->value.value.strs.strs[i]);
-                elem->value.value.strs.strs[i] = NULL;
+            // the next value is reported whatever it is
+            memset(elem->deadband, 0, sizeof(deadband_t));
+            elem->deadband->conf  = *deadband;
+            elem->deadband->group = g;
+            if (plan != NULL) {
+                elem->deadband->plan = *plan;
             }
-            free(elem->value.value.strs.strs);
-        } else if (NEU_TYPE_ARRAY_CHAR < elem->value.type &&
-                   elem->value.type < NEU_TYPE_ARRAY_STRING) {
-            free(elem->value.value.bools.bools);
         }
-        if (elem->metas != NULL) {
-            for (int i = 0; i < elem->n_meta; i++) {
-                neu_free_dvalue(&elem->metas[i].value);
-            }
-            free(elem->metas);
+        pthread_mutex_unlock(slot_stripe(cache, t->slot));
+        ret = 0;
+    }
+
+    pthread_rwlock_unlock(&cache->index_mtx);
+    return ret;
+}
+
+int neu_driver_cache_set_window(neu_driver_cache_t *       cache,
+                                const char *               group,
+                                const char *               tag,
+                                const neu_tag_window_t *   window,
+                                const neu_tag_transform_t *plan)
+{
+    int64_t   slot  = -1;
+    window_t *ring  = NULL;
+    uint32_t  depth = 0;
+
+    if (window != NULL && window->depth > 0) {
+        depth = window->depth < NEU_TAG_WINDOW_DEPTH_MAX
+            ? window->depth
+            : NEU_TAG_WINDOW_DEPTH_MAX;
+        ring = calloc(1, sizeof(window_t) + depth * sizeof(neu_tag_sample_t));
+        if (ring == NULL) {
+            return -1;
+        }
+        ring->duration = window->duration;
+        ring->size     = depth;
+        if (plan != NULL) {
+            ring->plan = *plan;
+        }
+    }
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    slot = find_slot(cache, group, tag);
+    if (slot >= 0) {
+        struct elem *elem = slot_elem(cache, (uint32_t) slot);
+
+        pthread_mutex_lock(slot_stripe(cache, (uint32_t) slot));
+        // samples are kept across group changes that leave the window alone
+        if (ring == NULL || elem->window == NULL ||
+            elem->window->size != ring->size ||
+            elem->window->duration != ring->duration) {
+            free(elem->window);
+            elem->window = ring;
+            ring         = NULL;
+        } else {
+            elem->window->plan = ring->plan;
+        }
+        pthread_mutex_unlock(slot_stripe(cache, (uint32_t) slot));
+    }
+    pthread_rwlock_unlock(&cache->index_mtx);
+
+    free(ring);
+    return slot >= 0 ? 0 : -1;
+}
+
+int neu_driver_cache_history(neu_driver_cache_t *cache, const char *group,
+                             const char *                   tag,
+                             const neu_tag_history_query_t *query,
+                             neu_tag_history_t *            history)
+{
+    int64_t slot = -1;
+    int     ret  = -1;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    slot = find_slot(cache, group, tag);
+    if (slot >= 0) {
+        struct elem *elem = slot_elem(cache, (uint32_t) slot);
+
+        pthread_mutex_lock(slot_stripe(cache, (uint32_t) slot));
+        if (elem->window != NULL) {
+            ret = window_query(elem->window, query, history);
         }
-        free(elem);
+        pthread_mutex_unlock(slot_stripe(cache, (uint32_t) slot));
     }
+    pthread_rwlock_unlock(&cache->index_mtx);
 
-    pthread_mutex_unlock(&cache->mtx);
+    return ret;
+}
+
+void neu_driver_cache_take_filtered(neu_driver_cache_t *cache,
+                                    const char *group, uint64_t *forwarded,
+                                    uint64_t *suppressed)
+{
+    group_index_t *g = NULL;
+
+    *forwarded  = 0;
+    *suppressed = 0;
+
+    pthread_rwlock_rdlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    if (g != NULL) {
+        *forwarded =
+            __atomic_exchange_n(&g->n_forwarded, 0, __ATOMIC_RELAXED);
+        *suppressed =
+            __atomic_exchange_n(&g->n_suppressed, 0, __ATOMIC_RELAXED);
+    }
+    pthread_rwlock_unlock(&cache->index_mtx);
 }
 
 void neu_driver_cache_rename(neu_driver_cache_t *cache, const char *group,
                              const char *old_tag, const char *new_tag)
 {
-    struct elem *elem = NULL;
-    tkey_t       key  = to_key(group, old_tag);
+    group_index_t *g = NULL;
+    tag_index_t *  t = NULL;
 
-    pthread_mutex_lock(&cache->mtx);
-    HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
+    pthread_rwlock_wrlock(&cache->index_mtx);
+    g = find_group(cache, group);
+    if (g != NULL) {
+        HASH_FIND_STR(g->tags, old_tag, t);
+    }
 
-    if (elem != NULL) {
-        HASH_DEL(cache->table, elem);
-        elem->key = to_key(group, new_tag);
-        HASH_ADD(hh, cache->table, key, sizeof(tkey_t), elem);
+    // the slot is kept, so handles resolved before the rename stay valid
+    if (t != NULL) {
+        HASH_DEL(g->tags, t);
+        free(t->name);
+        t->name = strdup(new_tag);
+        HASH_ADD_KEYPTR(hh, g->tags, t->name, strlen(t->name), t);
     }
 
-    pthread_mutex_unlock(&cache->mtx);
+    pthread_rwlock_unlock(&cache->index_mtx);
 }
@@ -22,15 +22,29 @@
 
 #include <stdint.h>
 
+#include "tag.h"
+#include "transform.h"
 #include "type.h"
 
 typedef struct neu_driver_cache neu_driver_cache_t;
 
+/*
+ * Dense slot a (group, tag) pair is resolved to when the tag is added, -1 if
+ * the tag is not in the cache. A slot handle becomes stale once the tag is
+ * deleted; slot based accessors detect that and fail instead of touching
+ * another tag. Renaming a tag keeps its slot.
+ */
+typedef int64_t neu_driver_cache_slot_t;
+
 neu_driver_cache_t *neu_driver_cache_new();
 void                neu_driver_cache_destroy(neu_driver_cache_t *cache);
 
-void neu_driver_cache_add(neu_driver_cache_t *cache, const char *group,
-                          const char *tag, neu_dvalue_t value);
+neu_driver_cache_slot_t neu_driver_cache_add(neu_driver_cache_t *cache,
+                                             const char *group, const char *tag,
+                                             neu_dvalue_t value);
+neu_driver_cache_slot_t neu_driver_cache_slot(neu_driver_cache_t *cache,
+                                              const char *        group,
+                                              const char *        tag);
 void neu_driver_cache_update(neu_driver_cache_t *cache, const char *group,
                              const char *tag, int64_t timestamp,
                              neu_dvalue_t value, neu_tag_meta_t *metas,
@@ -40,12 +54,71 @@ bool neu_driver_cache_update_change(neu_driver_cache_t *cache,
                                     int64_t timestamp, neu_dvalue_t value,
                                     neu_tag_meta_t *metas, int n_meta,
                                     bool change);
+/*
+ * Update tags of a group under one lookup of the group and one hold of the
+ * index.
+ *
+ * @return the number of tags found and updated.
+ */
+int  neu_driver_cache_update_many(neu_driver_cache_t *cache, const char *group,
+                                  int64_t                 timestamp,
+                                  const neu_tag_update_t *items, int n);
+bool neu_driver_cache_update_slot(neu_driver_cache_t *    cache,
+                                  neu_driver_cache_slot_t slot,
+                                  int64_t timestamp, neu_dvalue_t value,
+                                  neu_tag_meta_t *metas, int n_meta,
+                                  bool change);
 
 void neu_driver_cache_del(neu_driver_cache_t *cache, const char *group,
                           const char *tag);
 void neu_driver_cache_rename(neu_driver_cache_t *cache, const char *group,
                              const char *old_tag, const char *new_tag);
 
+/*
+ * Filter the reported changes of a tag by a deadband, see neu_tag_deadband_t.
+ * Setting a deadband resets the filter, NULL or an unset deadband removes it.
+ * Values are compared as reported, after plan, which may be NULL for the
+ * values as cached.
+ *
+ * @return 0 on success, -1 if the tag is not in the cache.
+ */
+int neu_driver_cache_set_deadband(neu_driver_cache_t *       cache,
+                                  const char *               group,
+                                  const char *               tag,
+                                  const neu_tag_deadband_t * deadband,
+                                  const neu_tag_transform_t *plan);
+/*
+ * Take the number of reported and of held back changes of the deadband
+ * filtered tags of a group since the last call.
+ */
+void neu_driver_cache_take_filtered(neu_driver_cache_t *cache,
+                                    const char *group, uint64_t *forwarded,
+                                    uint64_t *suppressed);
+
+/*
+ * Keep the last numeric values of a tag, see neu_tag_window_t. Values are
+ * kept as reported, after plan, which may be NULL for the values as cached.
+ * Samples are kept if the window does not change, NULL or a depth of 0
+ * removes it.
+ *
+ * @return 0 on success, -1 if the tag is not in the cache.
+ */
+int neu_driver_cache_set_window(neu_driver_cache_t *       cache,
+                                const char *               group,
+                                const char *               tag,
+                                const neu_tag_window_t *   window,
+                                const neu_tag_transform_t *plan);
+/*
+ * Query the window of a tag, the samples of history are allocated unless only
+ * the aggregates are asked for and are freed by the caller.
+ *
+ * @return 0 on success, -1 if the tag has no window.
+ */
+int neu_driver_cache_history(neu_driver_cache_t *cache, const char *group,
+                             const char *                   tag,
+                             const neu_tag_history_query_t *query,
+                             neu_tag_history_t *            history);
+
 void neu_driver_cache_update_trace(neu_driver_cache_t *cache, const char *group,
                                    void *trace_ctx);
 
@@ -63,5 +136,12 @@ int neu_driver_cache_meta_get_changed(neu_driver_cache_t *cache,
                                       const char *group, const char *tag,
                                       neu_driver_cache_value_t *value,
                                       neu_tag_meta_t **metas, int *n_meta);
+// return 0 on success, 1 if `changed` is set and the tag is not changed,
+// -1 if the slot is stale
+int neu_driver_cache_meta_get_slot(neu_driver_cache_t *      cache,
+                                   neu_driver_cache_slot_t   slot,
+                                   neu_driver_cache_value_t *value,
+                                   neu_tag_meta_t **metas, int *n_meta,
+                                   bool changed);
 
 #endif
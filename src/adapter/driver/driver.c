@@ -21,11 +21,16 @@
 #include <math.h>
 #include <netinet/in.h>
 #include <pthread.h>
+#include <stddef.h>
 #include <stdlib.h>
 
 #define EPSILON 1e-9
 
+// reports of a tick fire follow its reads by this many milliseconds
+#define TICK_REPORT_OFFSET_MS 20
+
 #include "event/event.h"
+#include "event/sched.h"
 #include "utils/http.h"
 #include "utils/log.h"
 #include "utils/time.h"
@@ -34,11 +39,15 @@
 #include "adapter.h"
 #include "adapter/adapter_internal.h"
 #include "adapter/storage.h"
+#include "aggregate.h"
 #include "base/group.h"
 #include "cache.h"
 #include "driver_internal.h"
 #include "errcodes.h"
+#include "sync.h"
 #include "tag.h"
+#include "tick.h"
+#include "transform.h"
 
 #include "core/node_manager.h"
 #include "otel/otel_manager.h"
@@ -53,6 +62,7 @@ typedef struct to_be_write_tag {
 
 typedef struct {
     char               app[NEU_NODE_NAME_LEN];
+    uint16_t           port; // trans data port of the app
     struct sockaddr_un addr;
 } sub_app_t;
 
@@ -64,38 +74,101 @@ typedef struct group {
     UT_array *      wt_tags;
     pthread_mutex_t wt_mtx;
 
-    neu_event_timer_t *report;
-    neu_event_timer_t *read;
+    // read and report timers are shared with the groups of the tick
+    neu_driver_tick_t *tick;
+    // deadline accounting, owned by the read pass
+    int64_t            last_read_ms;
     neu_event_timer_t *write;
 
+    // used instead of the timer above when running on the shared scheduler
+    neu_sched_task_t *write_task;
+
+    // device reads of the group and the sync reads waiting for them, sync
+    // reads start their own from the write timer or task of the group
+    neu_driver_sync_t *sync;
+
     UT_array *      apps; // sub_app_t array
     pthread_mutex_t apps_mtx;
 
+    // readable tags, their interned names and cache slots, rebuilt on group
+    // change
+    UT_array *               report_tags;
+    neu_tag_names_t *        report_names;
+    neu_driver_cache_slot_t *report_slots;
+    neu_tag_transform_t *    report_plans;
+    int64_t                  report_ts;
+    // interned driver and group names of the reports
+    char *report_driver;
+    char *report_group;
+
+    // milliseconds per aggregated report, 0 reports the values as read
+    uint32_t          aggregate;
+    int64_t           aggregate_start;
+    neu_driver_acc_t *report_accs; // one per report tag
+
     neu_plugin_group_t    grp;
     neu_adapter_driver_t *driver;
 
     UT_hash_handle hh;
 } group_t;
 
+// timers of a tick, usr_data of the tick
+typedef struct {
+    neu_adapter_driver_t *driver;
+    neu_driver_tick_t *   tick;
+
+    // held by a pass over the members, and while they change
+    pthread_mutex_t read_mtx;
+    pthread_mutex_t report_mtx;
+    uint64_t        n_read;
+    uint64_t        n_report;
+    int64_t         read_epoch;
+    int64_t         report_epoch;
+
+    neu_event_timer_t *read;
+    neu_event_timer_t *report;
+    neu_sched_task_t * read_task;
+    neu_sched_task_t * report_task;
+} tick_timer_t;
+
+extern neu_sched_t *g_sched;
+extern uint32_t     g_group_phases;
+
+extern neu_driver_deadline_e g_group_deadline;
+
 struct neu_adapter_driver {
     neu_adapter_t adapter;
 
     neu_driver_cache_t *cache;
     neu_events_t *      driver_events;
 
+    // shared scheduler, driver_events is not created when set
+    neu_sched_t *       sched;
+    neu_sched_strand_t *strand;
+    neu_sched_strand_t *report_strand;
+
+    // group timers coalesced by interval
+    neu_driver_ticks_t *ticks;
+
     size_t        tag_cnt;
     struct group *groups;
 };
 
 static void report_to_app(neu_adapter_driver_t *driver, group_t *group,
-                          struct sockaddr_un dst);
+                          const sub_app_t *app);
 static int  report_callback(void *usr_data);
-static int  read_callback(void *usr_data);
+static void read_callback(group_t *group, neu_driver_tick_member_t *member);
 static int  write_callback(void *usr_data);
+static void group_read_end(group_t *group);
+static void group_read_flush(group_t *group);
+static void sync_read_group(group_t *group, neu_reqresp_head_t *req);
 static void read_group(int64_t timestamp, int64_t timeout,
                        neu_tag_cache_type_e cache_type,
                        neu_driver_cache_t *cache, const char *group,
                        UT_array *tags, UT_array *tag_values);
+static void read_history(neu_driver_cache_t *cache, const char *group,
+                         const neu_tag_history_query_t *query,
+                         UT_array *                     tag_values);
 static void read_group_paginate(int64_t timestamp, int64_t timeout,
                                 neu_tag_cache_type_e cache_type,
                                 neu_driver_cache_t *cache, const char *group,
@@ -103,7 +176,15 @@ static void read_group_paginate(int64_t timestamp, int64_t timeout,
 static void read_report_group(int64_t timestamp, int64_t timeout,
                               neu_tag_cache_type_e cache_type,
                               neu_driver_cache_t *cache, const char *group,
-                              UT_array *tags, UT_array *tag_values);
+                              UT_array *tags, neu_driver_cache_slot_t *slots,
+                              const neu_tag_transform_t *plans,
+                              neu_group_snapshot_t *snapshot);
+static void read_aggregate_group(group_t *group, int64_t timestamp,
+                                 int64_t              timeout,
+                                 neu_tag_cache_type_e cache_type,
+                                 neu_group_snapshot_t *snapshot);
+static void report_tags_change(void *arg, int64_t timestamp, UT_array *tags,
+                               uint32_t interval);
 static void update_with_trace(neu_adapter_t *adapter, const char *group,
                               const char *tag, neu_dvalue_t value,
                               neu_tag_meta_t *metas, int n_meta,
@@ -119,6 +200,8 @@ static void update_im_f_m(neu_adapter_t *adapter, const char *group,
 static void update_with_meta(neu_adapter_t *adapter, const char *group,
                              const char *tag, neu_dvalue_t value,
                              neu_tag_meta_t *metas, int n_meta);
+static void update_many(neu_adapter_t *adapter, const char *group,
+                        const neu_tag_update_t *items, int n);
 static void write_response(neu_adapter_t *adapter, void *r, neu_error error);
 static void write_responses(neu_adapter_t *adapter, void *r,
                             neu_driver_write_responses_t *response,
@@ -137,43 +220,6 @@ static inline void start_group_timer(neu_adapter_driver_t *driver,
                                      group_t *             grp);
 static inline void stop_group_timer(neu_adapter_driver_t *driver, group_t *grp);
 
-static void format_tag_value(neu_dvalue_t *value)
-{
-    double scale = pow(10, 5);
-
-    int negative = 1;
-
-    if (value->value.d64 < 0) {
-        value->value.d64 *= -1;
-        negative = -1;
-    }
-
-    int64_t integer_part = (int64_t) value->value.d64;
-    double  decimal_part = value->value.d64 - integer_part;
-    decimal_part *= scale;
-    decimal_part = round(decimal_part);
-    char str[6]  = { 0 };
-    snprintf(str, sizeof(str), "%05" PRId64 "", (int64_t) decimal_part);
-    int i = 0, flag = 0;
-    for (; i < 4; i++) {
-        if (str[i] == '0' && str[i + 1] == '0') {
-            flag = 1;
-            break;
-        } else if (str[i] == '9' && str[i + 1] == '9') {
-            flag = 2;
-            break;
-        }
-    }
-    if (flag != 0 && i != 0) {
-        decimal_part     = round(decimal_part / pow(10, 5 - i));
-        value->value.d64 = (double) integer_part + decimal_part / pow(10, i);
-    } else {
-        value->value.d64 = (double) integer_part + decimal_part / scale;
-    }
-
-    value->value.d64 *= negative;
-}
-
 static void write_responses(neu_adapter_t *adapter, void *r,
                             neu_driver_write_responses_t *response,
                             int                           n_response)
@@ -430,6 +476,46 @@ static void update_with_meta(neu_adapter_t *adapter, const char *group,
         global_timestamp, n_meta);
 }
 
+static void update_many(neu_adapter_t *adapter, const char *group,
+                        const neu_tag_update_t *items, int n)
+{
+    neu_adapter_driver_t *         driver = (neu_adapter_driver_t *) adapter;
+    neu_adapter_update_metric_cb_t update_metric =
+        driver->adapter.cb_funs.update_metric;
+    uint64_t n_error    = 0;
+    int32_t  last_error = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (items[i].value.type == NEU_TYPE_ERROR) {
+            n_error += 1;
+            last_error = items[i].value.value.i32;
+        }
+    }
+
+    neu_driver_cache_update_many(driver->cache, group, global_timestamp, items,
+                                 n);
+    update_metric(&driver->adapter, NEU_METRIC_TAG_READS_TOTAL, n, NULL);
+    if (n_error > 0) {
+        update_metric(&driver->adapter, NEU_METRIC_TAG_READ_ERRORS_TOTAL,
+                      n_error, NULL);
+        update_metric(&driver->adapter, NEU_METRIC_GROUP_LAST_ERROR_CODE,
+                      last_error, group);
+        update_metric(&driver->adapter, NEU_METRIC_GROUP_LAST_ERROR_TS,
+                      global_timestamp, group);
+    }
+    nlog_debug("update driver: %s, group: %s, %d tags, %" PRIu64
+               " errors, timestamp: %" PRId64,
+               driver->adapter.name, group, n, n_error, global_timestamp);
+}
+
+static void group_read_end_cb(neu_adapter_t *adapter, neu_plugin_group_t *grp)
+{
+    group_t *group = (group_t *) ((char *) grp - offsetof(group_t, grp));
+
+    (void) adapter;
+    group_read_end(group);
+}
+
 static void update_with_trace(neu_adapter_t *adapter, const char *group,
                               const char *tag, neu_dvalue_t value,
                               neu_tag_meta_t *metas, int n_meta,
@@ -501,46 +587,47 @@ static void update_im_f_m(neu_adapter_t *adapter, const char *group,
     neu_reqresp_head_t header = {
         .type = NEU_REQRESP_TRANS_DATA,
     };
-    neu_reqresp_trans_data_t *data =
-        calloc(1, sizeof(neu_reqresp_trans_data_t));
+    neu_reqresp_trans_data_t data = { 0 };
 
-    data->driver = strdup(driver->adapter.name);
-    data->group  = strdup(group);
-    utarray_new(data->tags, neu_resp_tag_value_meta_icd());
+    neu_tag_names_t *names = neu_tag_names_new(tags);
+
+    data.driver   = neu_str_intern(driver->adapter.name);
+    data.group    = neu_str_intern(group);
+    data.snapshot = neu_group_snapshot_new(names);
+    neu_tag_names_unref(names);
 
     read_report_group(global_timestamp, 0,
                       neu_adapter_get_tag_cache_type(&driver->adapter),
-                      driver->cache, group, tags, data->tags);
+                      driver->cache, group, tags, NULL, NULL, data.snapshot);
+    neu_group_snapshot_seal(data.snapshot);
 
-    if (utarray_len(data->tags) > 0) {
+    if (neu_group_snapshot_size(data.snapshot) > 0) {
 
-        data->ctx        = calloc(1, sizeof(neu_reqresp_trans_data_ctx_t));
-        data->ctx->index = utarray_len(find->apps);
-        pthread_mutex_init(&data->ctx->mtx, NULL);
+        data.ctx = neu_trans_data_ctx_new(utarray_len(find->apps));
 
         if (utarray_len(find->apps) > 0) {
             pthread_mutex_lock(&find->apps_mtx);
 
             utarray_foreach(find->apps, sub_app_t *, app)
             {
-                if (driver->adapter.cb_funs.responseto(
-                        &driver->adapter, &header, data, app->addr) != 0) {
-                    neu_trans_data_free(data);
+                if (neu_adapter_trans_data_to(&driver->adapter, &header,
+                                              &data, app->port,
+                                              app->addr) != 0) {
+                    neu_trans_data_free(&data);
                 }
             }
 
             pthread_mutex_unlock(&find->apps_mtx);
         } else {
-            neu_trans_data_free(data);
+            neu_trans_data_free(&data);
         }
     } else {
-        utarray_free(data->tags);
-        free(data->group);
-        free(data->driver);
+        neu_group_snapshot_free(data.snapshot);
+        neu_str_release(data.group);
+        neu_str_release(data.driver);
     }
 
     utarray_free(tags);
-    free(data);
 }
 
 static void update_im(neu_adapter_t *adapter, const char *group,
@@ -596,46 +683,47 @@ static void update_im(neu_adapter_t *adapter, const char *group,
     neu_reqresp_head_t header = {
         .type = NEU_REQRESP_TRANS_DATA,
     };
-    neu_reqresp_trans_data_t *data =
-        calloc(1, sizeof(neu_reqresp_trans_data_t));
+    neu_reqresp_trans_data_t data = { 0 };
+
+    neu_tag_names_t *names = neu_tag_names_new(tags);
 
-    data->driver = strdup(driver->adapter.name);
-    data->group  = strdup(group);
-    utarray_new(data->tags, neu_resp_tag_value_meta_icd());
+    data.driver   = neu_str_intern(driver->adapter.name);
+    data.group    = neu_str_intern(group);
+    data.snapshot = neu_group_snapshot_new(names);
+    neu_tag_names_unref(names);
 
     read_report_group(global_timestamp, 0,
                       neu_adapter_get_tag_cache_type(&driver->adapter),
-                      driver->cache, group, tags, data->tags);
+                      driver->cache, group, tags, NULL, NULL, data.snapshot);
+    neu_group_snapshot_seal(data.snapshot);
 
-    if (utarray_len(data->tags) > 0) {
+    if (neu_group_snapshot_size(data.snapshot) > 0) {
 
-        data->ctx        = calloc(1, sizeof(neu_reqresp_trans_data_ctx_t));
-        data->ctx->index = utarray_len(find->apps);
-        pthread_mutex_init(&data->ctx->mtx, NULL);
+        data.ctx = neu_trans_data_ctx_new(utarray_len(find->apps));
 
         if (utarray_len(find->apps) > 0) {
             pthread_mutex_lock(&find->apps_mtx);
 
             utarray_foreach(find->apps, sub_app_t *, app)
             {
-                if (driver->adapter.cb_funs.responseto(
-                        &driver->adapter, &header, data, app->addr) != 0) {
-                    neu_trans_data_free(data);
+                if (neu_adapter_trans_data_to(&driver->adapter, &header,
+                                              &data, app->port,
+                                              app->addr) != 0) {
+                    neu_trans_data_free(&data);
                 }
             }
 
             pthread_mutex_unlock(&find->apps_mtx);
         } else {
-            neu_trans_data_free(data);
+            neu_trans_data_free(&data);
         }
     } else {
-        utarray_free(data->tags);
-        free(data->group);
-        free(data->driver);
+        neu_group_snapshot_free(data.snapshot);
+        neu_str_release(data.group);
+        neu_str_release(data.driver);
     }
 
     utarray_free(tags);
-    free(data);
 }
 
 static void update(neu_adapter_t *adapter, const char *group, const char *tag,
@@ -674,8 +762,18 @@ neu_adapter_driver_t *neu_adapter_driver_create()
 {
     neu_adapter_driver_t *driver = calloc(1, sizeof(neu_adapter_driver_t));
 
-    driver->cache                                     = neu_driver_cache_new();
-    driver->driver_events                             = neu_event_new("driver");
+    driver->cache = neu_driver_cache_new();
+    driver->ticks = neu_driver_ticks_new(g_group_phases);
+    if (g_sched != NULL) {
+        // plugin work of a node is serialized on one strand, reports only
+        // read the cache and use their own
+        driver->sched         = g_sched;
+        driver->strand        = neu_sched_strand_new(g_sched);
+        driver->report_strand = neu_sched_strand_new(g_sched);
+    } else {
+        driver->driver_events = neu_event_new("driver");
+    }
+
     driver->adapter.cb_funs.driver.update             = update;
     driver->adapter.cb_funs.driver.write_response     = write_response;
     driver->adapter.cb_funs.driver.write_responses    = write_responses;
@@ -687,16 +785,26 @@ neu_adapter_driver_t *neu_adapter_driver_create()
     driver->adapter.cb_funs.driver.update_im_f_m       = update_im_f_m;
     driver->adapter.cb_funs.driver.update_with_trace   = update_with_trace;
     driver->adapter.cb_funs.driver.update_with_meta    = update_with_meta;
+    driver->adapter.cb_funs.driver.update_many         = update_many;
+    driver->adapter.cb_funs.driver.group_read_end      = group_read_end_cb;
     driver->adapter.cb_funs.driver.scan_tags_response  = scan_tags_response;
     driver->adapter.cb_funs.driver.test_read_tag_response =
         test_read_tag_response;
+    driver->adapter.cb_funs.driver.register_group_metric =
+        neu_adapter_register_group_metric;
 
     return driver;
 }
 
 void neu_adapter_driver_destroy(neu_adapter_driver_t *driver)
 {
-    neu_event_close(driver->driver_events);
+    if (driver->sched != NULL) {
+        neu_sched_strand_free(driver->sched, driver->strand);
+        neu_sched_strand_free(driver->sched, driver->report_strand);
+    } else {
+        neu_event_close(driver->driver_events);
+    }
+    neu_driver_ticks_free(driver->ticks);
     neu_driver_cache_destroy(driver->cache);
 }
 
@@ -717,6 +825,7 @@ int neu_adapter_driver_uninit(neu_adapter_driver_t *driver)
 
         neu_adapter_driver_try_del_tag(driver, neu_group_tag_size(el->group));
         stop_group_timer(driver, el);
+        group_read_flush(el);
         if (el->grp.group_free != NULL) {
             el->grp.group_free(&el->grp);
         }
@@ -734,6 +843,16 @@ int neu_adapter_driver_uninit(neu_adapter_driver_t *driver)
 
         utarray_free(el->wt_tags);
         utarray_free(el->apps);
+        neu_driver_sync_free(el->sync);
+        if (el->report_tags != NULL) {
+            utarray_free(el->report_tags);
+        }
+        neu_tag_names_unref(el->report_names);
+        free(el->report_slots);
+        free(el->report_plans);
+        free(el->report_accs);
+        neu_str_release(el->report_driver);
+        neu_str_release(el->report_group);
         neu_group_destroy(el->group);
         free(el);
     }
@@ -766,49 +885,204 @@ int neu_adapter_driver_try_connect(void *param)
         driver->adapter.plugin);
 }
 
+// fires of a tick to handle, the next one or all elapsed since epoch
+static uint64_t tick_fires(tick_timer_t *timer, uint64_t done, int64_t epoch)
+{
+    uint64_t to = done + 1;
+
+    // anchored to the start of the tick, fires missed by an overrun are
+    // skipped instead of shifting the following ones
+    if (g_group_deadline != NEU_DRIVER_DEADLINE_DRIFT) {
+        uint32_t period  = neu_driver_tick_period(timer->tick);
+        int64_t  elapsed = neu_time_ms() - epoch + period / 2;
+
+        if (elapsed > 0 && (uint64_t) elapsed / period > to) {
+            to = (uint64_t) elapsed / period;
+        }
+    }
+
+    return to;
+}
+
+static int tick_read_callback(void *usr_data)
+{
+    tick_timer_t *timer = (tick_timer_t *) usr_data;
+
+    // the due groups of the tick are read back to back
+    pthread_mutex_lock(&timer->read_mtx);
+    uint64_t from = timer->n_read;
+    uint64_t to   = tick_fires(timer, from, timer->read_epoch);
+    for (int i = 0; i < neu_driver_tick_size(timer->tick); i++) {
+        neu_driver_tick_member_t *m = neu_driver_tick_member(timer->tick, i);
+        if (neu_driver_tick_due_between(timer->tick, m, from, to) > 0) {
+            read_callback(m->data, m);
+        }
+    }
+    timer->n_read = to;
+    pthread_mutex_unlock(&timer->read_mtx);
+
+    return 0;
+}
+
+static int tick_report_callback(void *usr_data)
+{
+    tick_timer_t *timer = (tick_timer_t *) usr_data;
+
+    pthread_mutex_lock(&timer->report_mtx);
+    uint64_t from = timer->n_report;
+    uint64_t to   = tick_fires(timer, from, timer->report_epoch);
+    for (int i = 0; i < neu_driver_tick_size(timer->tick); i++) {
+        neu_driver_tick_member_t *m = neu_driver_tick_member(timer->tick, i);
+        if (neu_driver_tick_due_between(timer->tick, m, from, to) > 0) {
+            report_callback(m->data);
+        }
+    }
+    timer->n_report = to;
+    pthread_mutex_unlock(&timer->report_mtx);
+
+    return 0;
+}
+
+static tick_timer_t *tick_timer_start(neu_adapter_driver_t *driver,
+                                      neu_driver_tick_t *   tick)
+{
+    tick_timer_t *timer  = calloc(1, sizeof(tick_timer_t));
+    uint32_t      period = neu_driver_tick_period(tick);
+
+    timer->driver = driver;
+    timer->tick   = tick;
+    pthread_mutex_init(&timer->read_mtx, NULL);
+    pthread_mutex_init(&timer->report_mtx, NULL);
+    neu_driver_tick_set_data(tick, timer);
+
+    neu_event_timer_param_t param = {
+        .second      = period / 1000,
+        .millisecond = period % 1000,
+        .usr_data    = (void *) timer,
+        .type        = NEU_EVENT_TIMER_NOBLOCK,
+    };
+
+    param.type        = driver->adapter.module->timer_type;
+    param.cb          = tick_read_callback;
+    timer->read_epoch = neu_time_ms();
+    if (driver->sched != NULL) {
+        timer->read_task =
+            neu_sched_add_timer(driver->sched, driver->strand, param);
+    } else {
+        timer->read = neu_event_add_timer(driver->driver_events, param);
+    }
+
+    // anchored after the read epoch rather than sleeping for the offset
+    param.type          = NEU_EVENT_TIMER_NOBLOCK;
+    param.cb            = tick_report_callback;
+    timer->report_epoch = timer->read_epoch + TICK_REPORT_OFFSET_MS;
+    param.delay         = timer->report_epoch + period - neu_time_ms();
+    if (param.delay <= 0) {
+        param.delay = 1;
+    }
+    if (driver->sched != NULL) {
+        timer->report_task =
+            neu_sched_add_timer(driver->sched, driver->report_strand, param);
+    } else {
+        timer->report = neu_adapter_add_timer((neu_adapter_t *) driver, param);
+    }
+
+    nlog_notice("%s add group tick, base: %" PRIu32 ", phases: %" PRIu32,
+                driver->adapter.name, neu_driver_tick_base(tick),
+                neu_driver_tick_phases(tick));
+    return timer;
+}
+
+// waits for running callbacks, called without the locks of the tick
+static void tick_timer_stop(neu_adapter_driver_t *driver, tick_timer_t *timer)
+{
+    if (timer->report) {
+        neu_adapter_del_timer((neu_adapter_t *) driver, timer->report);
+    }
+    if (timer->read) {
+        neu_event_del_timer(driver->driver_events, timer->read);
+    }
+    if (timer->report_task) {
+        neu_sched_del_task(driver->sched, timer->report_task);
+    }
+    if (timer->read_task) {
+        neu_sched_del_task(driver->sched, timer->read_task);
+    }
+
+    nlog_notice("%s del group tick, base: %" PRIu32, driver->adapter.name,
+                neu_driver_tick_base(timer->tick));
+    pthread_mutex_destroy(&timer->read_mtx);
+    pthread_mutex_destroy(&timer->report_mtx);
+    free(timer);
+}
+
 static inline void start_group_timer(neu_adapter_driver_t *driver, group_t *grp)
 {
-    uint32_t interval = neu_group_get_interval(grp->group);
+    uint32_t           interval = neu_group_get_interval(grp->group);
+    neu_driver_tick_t *tick = neu_driver_ticks_find(driver->ticks, interval);
+
+    if (tick == NULL) {
+        tick = neu_driver_ticks_add(driver->ticks, interval);
+        tick_timer_start(driver, tick);
+    }
+
+    tick_timer_t *timer = (tick_timer_t *) neu_driver_tick_get_data(tick);
+    pthread_mutex_lock(&timer->read_mtx);
+    pthread_mutex_lock(&timer->report_mtx);
+    neu_driver_tick_join(tick, grp, interval, neu_group_tag_size(grp->group));
+    pthread_mutex_unlock(&timer->report_mtx);
+    pthread_mutex_unlock(&timer->read_mtx);
+    grp->tick         = tick;
+    grp->last_read_ms = 0;
+    neu_adapter_update_group_metric(&driver->adapter, grp->name,
+                                    NEU_METRIC_GROUP_EFFECTIVE_INTERVAL_MS,
+                                    interval);
 
     neu_event_timer_param_t param = {
-        .second      = interval / 1000,
-        .millisecond = interval % 1000,
+        .second      = 0,
+        .millisecond = 3,
         .usr_data    = (void *) grp,
+        .cb          = write_callback,
         .type        = NEU_EVENT_TIMER_NOBLOCK,
     };
 
-    param.type = driver->adapter.module->timer_type;
-    param.cb   = read_callback;
-    grp->read  = neu_event_add_timer(driver->driver_events, param);
+    if (driver->sched != NULL) {
+        // writes are posted when they are stored instead of being polled
+        grp->write_task = neu_sched_add_task(driver->sched, driver->strand,
+                                             write_callback, (void *) grp);
+        neu_sched_post(grp->write_task);
+        return;
+    }
 
-    struct timespec t1 = {
-        .tv_sec  = 0,
-        .tv_nsec = 1000 * 1000 * 20,
-    };
-    struct timespec t2 = { 0 };
-    nanosleep(&t1, &t2);
+    grp->write = neu_event_add_timer(driver->driver_events, param);
+}
 
-    param.type  = NEU_EVENT_TIMER_NOBLOCK;
-    param.cb    = report_callback;
-    grp->report = neu_adapter_add_timer((neu_adapter_t *) driver, param);
+static int group_interval_cmp(const void *a, const void *b)
+{
+    uint32_t ia = neu_group_get_interval((*(group_t **) a)->group);
+    uint32_t ib = neu_group_get_interval((*(group_t **) b)->group);
 
-    param.second      = 0;
-    param.millisecond = 3;
-    param.cb          = write_callback;
-    grp->write        = neu_event_add_timer(driver->driver_events, param);
+    return ia < ib ? -1 : (ia > ib ? 1 : 0);
 }
 
 void neu_adapter_driver_start_group_timer(neu_adapter_driver_t *driver)
 {
-    group_t *el = NULL, *tmp = NULL;
+    group_t * el      = NULL, *tmp = NULL;
+    int       n_group = 0;
+    group_t **groups =
+        calloc(HASH_COUNT(driver->groups) + 1, sizeof(group_t *));
 
-    HASH_ITER(hh, driver->groups, el, tmp)
-    {
-        start_group_timer(driver, el);
+    HASH_ITER(hh, driver->groups, el, tmp) { groups[n_group++] = el; }
+
+    // shorter intervals first, so that their harmonics join the same ticks
+    qsort(groups, n_group, sizeof(group_t *), group_interval_cmp);
+    for (int i = 0; i < n_group; i++) {
+        start_group_timer(driver, groups[i]);
         neu_adapter_update_group_metric(
-            &driver->adapter, neu_group_get_name(el->group),
-            NEU_METRIC_GROUP_TAGS_TOTAL, neu_group_tag_size(el->group));
+            &driver->adapter, neu_group_get_name(groups[i]->group),
+            NEU_METRIC_GROUP_TAGS_TOTAL, neu_group_tag_size(groups[i]->group));
     }
+    free(groups);
 
     driver->adapter.cb_funs.update_metric(
         &driver->adapter, NEU_METRIC_TAGS_TOTAL, driver->tag_cnt, NULL);
@@ -816,40 +1090,50 @@ void neu_adapter_driver_start_group_timer(neu_adapter_driver_t *driver)
 
 static inline void stop_group_timer(neu_adapter_driver_t *driver, group_t *grp)
 {
-    if (grp->report) {
-        neu_adapter_del_timer((neu_adapter_t *) driver, grp->report);
-        grp->report = NULL;
-    }
-    if (grp->read) {
-        neu_event_del_timer(driver->driver_events, grp->read);
-        grp->read = NULL;
+    if (grp->tick) {
+        tick_timer_t *timer =
+            (tick_timer_t *) neu_driver_tick_get_data(grp->tick);
+        int n = 0;
+
+        // waits for a running pass over the group
+        pthread_mutex_lock(&timer->read_mtx);
+        pthread_mutex_lock(&timer->report_mtx);
+        n = neu_driver_tick_leave(grp->tick, grp);
+        pthread_mutex_unlock(&timer->report_mtx);
+        pthread_mutex_unlock(&timer->read_mtx);
+
+        if (n == 0) {
+            tick_timer_stop(driver, timer);
+            neu_driver_ticks_del(driver->ticks, grp->tick);
+        }
+        grp->tick = NULL;
     }
     if (grp->write) {
         neu_event_del_timer(driver->driver_events, grp->write);
         grp->write = NULL;
     }
+    if (grp->write_task) {
+        neu_sched_del_task(driver->sched, grp->write_task);
+        grp->write_task = NULL;
+    }
 }
 
 void neu_adapter_driver_stop_group_timer(neu_adapter_driver_t *driver)
 {
     group_t *el = NULL, *tmp = NULL;
 
-    HASH_ITER(hh, driver->groups, el, tmp) { stop_group_timer(driver, el); }
+    HASH_ITER(hh, driver->groups, el, tmp)
+    {
+        stop_group_timer(driver, el);
+        // nothing serves the waiting sync reads anymore
+        group_read_flush(el);
+    }
 }
 
-void neu_adapter_driver_read_group(neu_adapter_driver_t *driver,
-                                   neu_reqresp_head_t *  req)
+static void reply_read_group(neu_adapter_driver_t *driver, group_t *g,
+                             neu_reqresp_head_t *req)
 {
-    neu_req_read_group_t *cmd = (neu_req_read_group_t *) &req[1];
-    group_t *             g   = find_group(driver, cmd->group);
-    if (g == NULL) {
-        neu_resp_error_t error = { .error = NEU_ERR_GROUP_NOT_EXIST };
-        req->type              = NEU_RESP_ERROR;
-        neu_req_read_group_fini(cmd);
-        driver->adapter.cb_funs.response(&driver->adapter, req, &error);
-        return;
-    }
-
+    neu_req_read_group_t *cmd   = (neu_req_read_group_t *) &req[1];
     neu_resp_read_group_t resp  = { 0 };
     neu_group_t *         group = g->group;
     UT_array *tags = neu_group_query_read_tag(group, cmd->name, cmd->desc,
@@ -867,33 +1151,20 @@ void neu_adapter_driver_read_group(neu_adapter_driver_t *driver,
 
             utarray_push_back(resp.tags, &tag_value);
         }
-    } else if (cmd->sync) {
-        if (NULL == driver->adapter.module->intf_funs->driver.group_sync) {
-            // plugin does not support sync read
-            utarray_foreach(tags, neu_datatag_t *, tag)
-            {
-                neu_resp_tag_value_meta_t tag_value = { 0 };
-                snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
-                tag_value.value.type = NEU_TYPE_ERROR;
-                tag_value.value.value.i32 =
-                    NEU_ERR_PLUGIN_NOT_SUPPORT_READ_SYNC;
+    } else if (cmd->sync &&
+               NULL == driver->adapter.module->intf_funs->driver.group_sync) {
+        // plugin does not support sync read
+        utarray_foreach(tags, neu_datatag_t *, tag)
+        {
+            neu_resp_tag_value_meta_t tag_value = { 0 };
+            snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
+            tag_value.value.type      = NEU_TYPE_ERROR;
+            tag_value.value.value.i32 = NEU_ERR_PLUGIN_NOT_SUPPORT_READ_SYNC;
 
-                utarray_push_back(resp.tags, &tag_value);
-            }
-        } else {
-            // sync read to update cache
-            stop_group_timer(driver, g);
-            driver->adapter.module->intf_funs->driver.group_sync(
-                driver->adapter.plugin, &g->grp);
-            // fetch updated data from cache
-            read_group(global_timestamp,
-                       neu_group_get_interval(group) *
-                           NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
-                       neu_adapter_get_tag_cache_type(&driver->adapter),
-                       driver->cache, cmd->group, tags, resp.tags);
-            start_group_timer(driver, g);
+            utarray_push_back(resp.tags, &tag_value);
         }
     } else {
+        // sync reads get here once the device read they waited for is done
         read_group(global_timestamp,
                    neu_group_get_interval(group) *
                        NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
@@ -901,6 +1172,11 @@ void neu_adapter_driver_read_group(neu_adapter_driver_t *driver,
                    driver->cache, cmd->group, tags, resp.tags);
     }
 
+    if (cmd->history) {
+        read_history(driver->cache, cmd->group, &cmd->history_query,
+                     resp.tags);
+    }
+
     resp.driver = cmd->driver;
     resp.group  = cmd->group;
     cmd->driver = NULL; // ownership moved
@@ -913,20 +1189,33 @@ void neu_adapter_driver_read_group(neu_adapter_driver_t *driver,
     driver->adapter.cb_funs.response(&driver->adapter, req, &resp);
 }
 
-void neu_adapter_driver_read_group_paginate(neu_adapter_driver_t *driver,
-                                            neu_reqresp_head_t *  req)
+void neu_adapter_driver_read_group(neu_adapter_driver_t *driver,
+                                   neu_reqresp_head_t *  req)
 {
-    neu_req_read_group_paginate_t *cmd =
-        (neu_req_read_group_paginate_t *) &req[1];
-    group_t *g = find_group(driver, cmd->group);
+    neu_req_read_group_t *cmd = (neu_req_read_group_t *) &req[1];
+    group_t *             g   = find_group(driver, cmd->group);
     if (g == NULL) {
         neu_resp_error_t error = { .error = NEU_ERR_GROUP_NOT_EXIST };
         req->type              = NEU_RESP_ERROR;
-        neu_req_read_group_paginate_fini(cmd);
+        neu_req_read_group_fini(cmd);
         driver->adapter.cb_funs.response(&driver->adapter, req, &error);
         return;
     }
 
+    if (cmd->sync && driver->adapter.state == NEU_NODE_RUNNING_STATE_RUNNING &&
+        NULL != driver->adapter.module->intf_funs->driver.group_sync) {
+        sync_read_group(g, req);
+        return;
+    }
+
+    reply_read_group(driver, g, req);
+}
+
+static void reply_read_group_paginate(neu_adapter_driver_t *driver,
+                                      group_t *g, neu_reqresp_head_t *req)
+{
+    neu_req_read_group_paginate_t *cmd =
+        (neu_req_read_group_paginate_t *) &req[1];
     neu_resp_read_group_paginate_t resp  = { 0 };
     neu_group_t *                  group = g->group;
     UT_array *                     tags;
@@ -964,46 +1253,32 @@ void neu_adapter_driver_read_group_paginate(neu_adapter_driver_t *driver,
 
             utarray_push_back(resp.tags, &tag_value);
         }
-    } else if (cmd->sync) {
-        if (NULL == driver->adapter.module->intf_funs->driver.group_sync) {
-            // plugin does not support sync read
-            utarray_foreach(tags, neu_datatag_t *, tag)
-            {
-                neu_resp_tag_value_meta_paginate_t tag_value = { 0 };
-                snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
-                tag_value.value.type = NEU_TYPE_ERROR;
-                tag_value.value.value.i32 =
-                    NEU_ERR_PLUGIN_NOT_SUPPORT_READ_SYNC;
-
-                tag_value.datatag.name        = strdup(tag->name);
-                tag_value.datatag.address     = strdup(tag->address);
-                tag_value.datatag.attribute   = tag->attribute;
-                tag_value.datatag.type        = tag->type;
-                tag_value.datatag.precision   = tag->precision;
-                tag_value.datatag.decimal     = tag->decimal;
-                tag_value.datatag.bias        = tag->bias;
-                tag_value.datatag.description = strdup(tag->description);
-                tag_value.datatag.option      = tag->option;
-                tag_value.datatag.unit        = strdup(tag->unit);
-                memcpy(tag_value.datatag.meta, tag->meta, NEU_TAG_META_LENGTH);
-
-                utarray_push_back(resp.tags, &tag_value);
-            }
-        } else {
-            // sync read to update cache
-            stop_group_timer(driver, g);
-            driver->adapter.module->intf_funs->driver.group_sync(
-                driver->adapter.plugin, &g->grp);
-            // fetch updated data from cache
-            read_group_paginate(
-                global_timestamp,
-                neu_group_get_interval(group) *
-                    NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
-                neu_adapter_get_tag_cache_type(&driver->adapter), driver->cache,
-                cmd->group, tags, resp.tags);
-            start_group_timer(driver, g);
+    } else if (cmd->sync &&
+               NULL == driver->adapter.module->intf_funs->driver.group_sync) {
+        // plugin does not support sync read
+        utarray_foreach(tags, neu_datatag_t *, tag)
+        {
+            neu_resp_tag_value_meta_paginate_t tag_value = { 0 };
+            snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
+            tag_value.value.type      = NEU_TYPE_ERROR;
+            tag_value.value.value.i32 = NEU_ERR_PLUGIN_NOT_SUPPORT_READ_SYNC;
+
+            tag_value.datatag.name        = strdup(tag->name);
+            tag_value.datatag.address     = strdup(tag->address);
+            tag_value.datatag.attribute   = tag->attribute;
+            tag_value.datatag.type        = tag->type;
+            tag_value.datatag.precision   = tag->precision;
+            tag_value.datatag.decimal     = tag->decimal;
+            tag_value.datatag.bias        = tag->bias;
+            tag_value.datatag.description = strdup(tag->description);
+            tag_value.datatag.option      = tag->option;
+            tag_value.datatag.unit        = strdup(tag->unit);
+            memcpy(tag_value.datatag.meta, tag->meta, NEU_TAG_META_LENGTH);
+
+            utarray_push_back(resp.tags, &tag_value);
         }
     } else {
+        // sync reads get here once the device read they waited for is done
         read_group_paginate(global_timestamp,
                             neu_group_get_interval(group) *
                                 NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
@@ -1026,6 +1301,39 @@ void neu_adapter_driver_read_group_paginate(neu_adapter_driver_t *driver,
     driver->adapter.cb_funs.response(&driver->adapter, req, &resp);
 }
 
+void neu_adapter_driver_read_group_paginate(neu_adapter_driver_t *driver,
+                                            neu_reqresp_head_t *  req)
+{
+    neu_req_read_group_paginate_t *cmd =
+        (neu_req_read_group_paginate_t *) &req[1];
+    group_t *g = find_group(driver, cmd->group);
+    if (g == NULL) {
+        neu_resp_error_t error = { .error = NEU_ERR_GROUP_NOT_EXIST };
+        req->type              = NEU_RESP_ERROR;
+        neu_req_read_group_paginate_fini(cmd);
+        driver->adapter.cb_funs.response(&driver->adapter, req, &error);
+        return;
+    }
+
+    if (cmd->sync && driver->adapter.state == NEU_NODE_RUNNING_STATE_RUNNING &&
+        NULL != driver->adapter.module->intf_funs->driver.group_sync) {
+        sync_read_group(g, req);
+        return;
+    }
+
+    reply_read_group_paginate(driver, g, req);
+}
+
+static void reply_read(neu_adapter_driver_t *driver, group_t *group,
+                       neu_reqresp_head_t *req)
+{
+    if (req->type == NEU_REQ_READ_GROUP_PAGINATE) {
+        reply_read_group_paginate(driver, group, req);
+    } else {
+        reply_read_group(driver, group, req);
+    }
+}
+
 static void fix_value(neu_datatag_t *tag, neu_type_e value_type,
                       neu_dvalue_t *value)
 {
@@ -1915,6 +2223,8 @@ int neu_adapter_driver_add_group(neu_adapter_driver_t *driver, const char *name,
         find->grp.interval   = interval;
         find->grp.context    = context;
         find->grp.tags       = neu_group_get_tag(find->group);
+        find->sync           = neu_driver_sync_new();
+        find->report_ts      = -1; // build report tags on the first cycle
 
         if (NEU_NODE_RUNNING_STATE_RUNNING == driver->adapter.state) {
             start_group_timer(driver, find);
@@ -1931,6 +2241,26 @@ int neu_adapter_driver_add_group(neu_adapter_driver_t *driver, const char *name,
                               NEU_METRIC_GROUP_LAST_ERROR_CODE, 0);
         REGISTER_GROUP_METRIC(&driver->adapter, find->name,
                               NEU_METRIC_GROUP_LAST_ERROR_TS, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_LATE_CYCLES_TOTAL, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_SKIPPED_CYCLES_TOTAL, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_EFFECTIVE_INTERVAL_MS, interval);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_JITTER_LE_5MS, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_JITTER_LE_20MS, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_JITTER_LE_100MS, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_JITTER_LE_500MS, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_JITTER_GT_500MS, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_FORWARDED_VALUES_TOTAL, 0);
+        REGISTER_GROUP_METRIC(&driver->adapter, find->name,
+                              NEU_METRIC_GROUP_SUPPRESSED_VALUES_TOTAL, 0);
 
         HASH_ADD_STR(driver->groups, name, find);
         ret = NEU_ERR_SUCCESS;
@@ -2013,6 +2343,47 @@ int neu_adapter_driver_update_group(neu_adapter_driver_t *driver,
     return ret;
 }
 
+int neu_adapter_driver_set_group_aggregate(neu_adapter_driver_t *driver,
+                                           const char *name, uint32_t aggregate)
+{
+    group_t *find = NULL;
+
+    HASH_FIND_STR(driver->groups, name, find);
+    if (NULL == find) {
+        return NEU_ERR_GROUP_NOT_EXIST;
+    }
+
+    if (aggregate > 0 && aggregate < neu_group_get_interval(find->group)) {
+        return NEU_ERR_GROUP_PARAMETER_INVALID;
+    }
+
+    if (find->aggregate == aggregate) {
+        return 0;
+    }
+
+    if (NEU_NODE_RUNNING_STATE_RUNNING == driver->adapter.state) {
+        stop_group_timer(driver, find);
+    }
+
+    find->aggregate = aggregate;
+    find->report_ts = -1; // restart the accumulators with the report tags
+
+    if (NEU_NODE_RUNNING_STATE_RUNNING == driver->adapter.state) {
+        start_group_timer(driver, find);
+    }
+
+    return 0;
+}
+
+uint32_t neu_adapter_driver_group_aggregate(neu_adapter_driver_t *driver,
+                                            const char *          name)
+{
+    group_t *find = NULL;
+
+    HASH_FIND_STR(driver->groups, name, find);
+    return find != NULL ? find->aggregate : 0;
+}
+
 int neu_adapter_driver_del_group(neu_adapter_driver_t *driver, const char *name)
 {
     group_t *find = NULL;
@@ -2027,6 +2398,7 @@ int neu_adapter_driver_del_group(neu_adapter_driver_t *driver, const char *name)
         if (NEU_NODE_RUNNING_STATE_RUNNING == driver->adapter.state) {
             stop_group_timer(driver, find);
         }
+        group_read_flush(find);
 
         if (find->grp.group_free != NULL) {
             find->grp.group_free(&find->grp);
@@ -2062,6 +2434,16 @@ int neu_adapter_driver_del_group(neu_adapter_driver_t *driver, const char *name)
         utarray_free(find->grp.tags);
         utarray_free(find->wt_tags);
         utarray_free(find->apps);
+        neu_driver_sync_free(find->sync);
+        if (find->report_tags != NULL) {
+            utarray_free(find->report_tags);
+        }
+        neu_tag_names_unref(find->report_names);
+        free(find->report_slots);
+        free(find->report_plans);
+        free(find->report_accs);
+        neu_str_release(find->report_driver);
+        neu_str_release(find->report_group);
         neu_group_destroy(find->group);
         pthread_mutex_destroy(&find->wt_mtx);
         pthread_mutex_destroy(&find->apps_mtx);
@@ -2135,6 +2517,7 @@ UT_array *neu_adapter_driver_get_group(neu_adapter_driver_t *driver,
             neu_resp_group_info_t info = { 0 };
 
             info.interval  = neu_group_get_interval(el->group);
+            info.aggregate = el->aggregate;
             info.tag_count = neu_group_tag_size(el->group);
             strncpy(info.name, el->name, sizeof(info.name));
 
@@ -2259,7 +2642,8 @@ int neu_adapter_driver_add_tag(neu_adapter_driver_t *driver, const char *group,
     HASH_FIND_STR(driver->groups, group, find);
     if (find == NULL) {
         neu_adapter_driver_add_group(driver, group, interval, NULL);
-        adapter_storage_add_group(driver->adapter.name, group, interval, NULL);
+        adapter_storage_add_group(driver->adapter.name, group, interval, 0,
+                                  NULL);
     }
     HASH_FIND_STR(driver->groups, group, find);
     assert(find != NULL);
@@ -2462,7 +2846,7 @@ UT_array *neu_adapter_driver_get_ptag(neu_adapter_driver_t *driver,
 }
 
 static void report_to_app(neu_adapter_driver_t *driver, group_t *group,
-                          struct sockaddr_un dst)
+                          const sub_app_t *app)
 {
     neu_reqresp_head_t header = {
         .type = NEU_REQRESP_TRANS_DATA,
@@ -2471,42 +2855,61 @@ static void report_to_app(neu_adapter_driver_t *driver, group_t *group,
     UT_array *tags =
         neu_adapter_driver_get_read_tag(group->driver, group->name);
 
-    neu_reqresp_trans_data_t *data =
-        calloc(1, sizeof(neu_reqresp_trans_data_t));
+    neu_reqresp_trans_data_t data   = { 0 };
+    neu_tag_names_t *        names  = neu_tag_names_new(tags);
+    UT_array *               values = NULL;
+    uint32_t                 id     = 0;
 
-    data->driver = strdup(group->driver->adapter.name);
-    data->group  = strdup(group->name);
-    utarray_new(data->tags, neu_resp_tag_value_meta_icd());
+    data.driver   = neu_str_intern(group->driver->adapter.name);
+    data.group    = neu_str_intern(group->name);
+    data.snapshot = neu_group_snapshot_new(names);
+    neu_tag_names_unref(names);
+    utarray_new(values, neu_resp_tag_value_meta_icd());
 
     read_group(global_timestamp,
                neu_group_get_interval(group->group) *
                    NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
                neu_adapter_get_tag_cache_type(&driver->adapter), driver->cache,
-               group->name, tags, data->tags);
+               group->name, tags, values);
 
-    nlog_info("report group: %s, all tags: %d, report tags: %d", group->name,
-              utarray_len(tags), utarray_len(data->tags));
-    if (utarray_len(data->tags) > 0) {
-        pthread_mutex_lock(&group->apps_mtx);
+    // read_group yields exactly one value per tag, in tag order
+    utarray_foreach(values, neu_resp_tag_value_meta_t *, tag_value)
+    {
+        neu_group_snapshot_push(data.snapshot, id++, &tag_value->value,
+                                tag_value->metas, tag_value->n_meta);
+    }
+    utarray_free(values);
+    neu_group_snapshot_seal(data.snapshot);
 
-        data->ctx        = calloc(1, sizeof(neu_reqresp_trans_data_ctx_t));
-        data->ctx->index = 1;
+    nlog_info("report group: %s, all tags: %d, report tags: %u", group->name,
+              utarray_len(tags), neu_group_snapshot_size(data.snapshot));
+    if (neu_group_snapshot_size(data.snapshot) > 0) {
+        pthread_mutex_lock(&group->apps_mtx);
 
-        pthread_mutex_init(&data->ctx->mtx, NULL);
+        data.ctx = neu_trans_data_ctx_new(1);
 
-        if (driver->adapter.cb_funs.responseto(&driver->adapter, &header, data,
-                                               dst) != 0) {
-            neu_trans_data_free(data);
+        if (neu_adapter_trans_data_to(&driver->adapter, &header, &data,
+                                      app->port, app->addr) != 0) {
+            neu_trans_data_free(&data);
         }
 
         pthread_mutex_unlock(&group->apps_mtx);
     } else {
-        utarray_free(data->tags);
-        free(data->group);
-        free(data->driver);
+        neu_group_snapshot_free(data.snapshot);
+        neu_str_release(data.group);
+        neu_str_release(data.driver);
     }
     utarray_free(tags);
-    free(data);
+}
+
+// reference of an interned name, interned again after a rename
+static char *intern_cached(char **cached, const char *name)
+{
+    if (*cached == NULL || strcmp(*cached, name) != 0) {
+        neu_str_release(*cached);
+        *cached = neu_str_intern(name);
+    }
+    return neu_str_ref(*cached);
 }
 
 static int report_callback(void *usr_data)
@@ -2521,16 +2924,17 @@ static int report_callback(void *usr_data)
         .type = NEU_REQRESP_TRANS_DATA,
     };
 
-    UT_array *tags =
-        neu_adapter_driver_get_read_tag(group->driver, group->name);
+    if (neu_group_is_change(group->group, group->report_ts)) {
+        neu_group_change_test(group->group, group->report_ts, (void *) group,
+                              report_tags_change);
+    }
 
-    neu_reqresp_trans_data_t *data =
-        calloc(1, sizeof(neu_reqresp_trans_data_t));
+    neu_reqresp_trans_data_t data = { 0 };
 
-    data->driver = strdup(group->driver->adapter.name);
-    data->group  = strdup(group->name);
-    utarray_new(data->tags, neu_resp_tag_value_meta_icd());
-    utarray_reserve(data->tags, utarray_len(tags));
+    data.driver =
+        intern_cached(&group->report_driver, group->driver->adapter.name);
+    data.group    = intern_cached(&group->report_group, group->name);
+    data.snapshot = neu_group_snapshot_new(group->report_names);
 
     void *trace_ctx =
         neu_driver_cache_get_trace(group->driver->cache, group->name);
@@ -2540,7 +2944,7 @@ static int report_callback(void *usr_data)
     if (neu_otel_data_is_started() && trace_ctx) {
         trans_trace = neu_otel_find_trace2(trace_ctx);
         if (trans_trace) {
-            data->trace_ctx      = trace_ctx;
+            data.trace_ctx       = trace_ctx;
             char new_span_id[36] = { 0 };
             neu_otel_new_span_id(new_span_id);
             trans_scope =
@@ -2551,17 +2955,27 @@ static int report_callback(void *usr_data)
         }
     }
 
-    read_report_group(global_timestamp,
-                      neu_group_get_interval(group->group) *
-                          NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
-                      neu_adapter_get_tag_cache_type(&group->driver->adapter),
-                      group->driver->cache, group->name, tags, data->tags);
+    if (group->aggregate > 0) {
+        read_aggregate_group(
+            group, global_timestamp,
+            neu_group_get_interval(group->group) *
+                NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
+            neu_adapter_get_tag_cache_type(&group->driver->adapter),
+            data.snapshot);
+    } else {
+        read_report_group(
+            global_timestamp,
+            neu_group_get_interval(group->group) *
+                NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
+            neu_adapter_get_tag_cache_type(&group->driver->adapter),
+            group->driver->cache, group->name, group->report_tags,
+            group->report_slots, group->report_plans, data.snapshot);
+    }
+    neu_group_snapshot_seal(data.snapshot);
 
-    if (utarray_len(data->tags) > 0) {
+    if (neu_group_snapshot_size(data.snapshot) > 0) {
         pthread_mutex_lock(&group->apps_mtx);
-        data->ctx        = calloc(1, sizeof(neu_reqresp_trans_data_ctx_t));
-        data->ctx->index = utarray_len(group->apps);
-        pthread_mutex_init(&data->ctx->mtx, NULL);
+        data.ctx = neu_trans_data_ctx_new(utarray_len(group->apps));
 
         if (utarray_len(group->apps) > 0) {
             int app_num = 0;
@@ -2572,10 +2986,10 @@ static int report_callback(void *usr_data)
 
             utarray_foreach(group->apps, sub_app_t *, app)
             {
-                if (group->driver->adapter.cb_funs.responseto(
-                        &group->driver->adapter, &header, data, app->addr) !=
-                    0) {
-                    neu_trans_data_free(data);
+                if (neu_adapter_trans_data_to(&group->driver->adapter,
+                                              &header, &data, app->port,
+                                              app->addr) != 0) {
+                    neu_trans_data_free(&data);
                     if (trans_trace) {
                         neu_otel_scope_add_span_attr_int(trans_scope, app->app,
                                                          0);
@@ -2598,7 +3012,7 @@ static int report_callback(void *usr_data)
             }
 
         } else {
-            neu_trans_data_free(data);
+            neu_trans_data_free(&data);
 
             if (trans_trace) {
                 neu_otel_scope_add_span_attr_int(trans_scope, "no sub app", 1);
@@ -2609,26 +3023,68 @@ static int report_callback(void *usr_data)
 
         pthread_mutex_unlock(&group->apps_mtx);
     } else {
-        utarray_free(data->tags);
-        free(data->group);
-        free(data->driver);
+        neu_group_snapshot_free(data.snapshot);
+        neu_str_release(data.group);
+        neu_str_release(data.driver);
         if (trans_trace) {
             neu_otel_scope_add_span_attr_int(trans_scope, "no tags", 1);
             neu_otel_scope_set_span_end_time(trans_scope, neu_time_ns());
             neu_otel_trace_set_final(trans_trace);
         }
     }
-    utarray_free(tags);
-    free(data);
     return 0;
 }
 
+static void report_tags_change(void *arg, int64_t timestamp, UT_array *tags,
+                               uint32_t interval)
+{
+    group_t * group    = (group_t *) arg;
+    UT_array *readable = NULL;
+    int       i        = 0;
+    (void) interval;
+
+    utarray_new(readable, neu_tag_get_icd());
+    utarray_foreach(tags, neu_datatag_t *, tag)
+    {
+        if (neu_tag_attribute_test(tag, NEU_ATTRIBUTE_READ) ||
+            neu_tag_attribute_test(tag, NEU_ATTRIBUTE_SUBSCRIBE)) {
+            utarray_push_back(readable, tag);
+        }
+    }
+    utarray_free(tags);
+
+    if (group->report_tags != NULL) {
+        utarray_free(group->report_tags);
+    }
+    neu_tag_names_unref(group->report_names);
+    free(group->report_slots);
+    free(group->report_plans);
+    free(group->report_accs);
+
+    group->report_tags  = readable;
+    group->report_names = neu_tag_names_new(readable);
+    group->report_slots =
+        calloc(utarray_len(readable) + 1, sizeof(neu_driver_cache_slot_t));
+    group->report_plans =
+        calloc(utarray_len(readable) + 1, sizeof(neu_tag_transform_t));
+    group->report_accs =
+        calloc(utarray_len(readable) + 1, sizeof(neu_driver_acc_t));
+    group->report_ts       = timestamp;
+    group->aggregate_start = 0; // the window restarts with the tags
+
+    utarray_foreach(readable, neu_datatag_t *, tag)
+    {
+        neu_tag_transform_compile(&group->report_plans[i], tag);
+        group->report_slots[i++] = neu_driver_cache_slot(
+            group->driver->cache, group->name, tag->name);
+    }
+}
+
 static void group_change(void *arg, int64_t timestamp, UT_array *tags,
                          uint32_t interval)
 {
     group_t *group   = (group_t *) arg;
     group->timestamp = timestamp;
-    (void) interval;
 
     if (group->grp.group_free != NULL)
         group->grp.group_free(&group->grp);
@@ -2640,7 +3096,8 @@ static void group_change(void *arg, int64_t timestamp, UT_array *tags,
 
     utarray_foreach(tags, neu_datatag_t *, tag)
     {
-        neu_dvalue_t value = { 0 };
+        neu_dvalue_t        value = { 0 };
+        neu_tag_transform_t plan  = { 0 };
 
         value.precision = tag->precision;
         value.type      = NEU_TYPE_ERROR;
@@ -2648,6 +3105,24 @@ static void group_change(void *arg, int64_t timestamp, UT_array *tags,
 
         neu_driver_cache_add(group->driver->cache, group->name, tag->name,
                              value);
+        // deadbands and windows see the values as reported
+        neu_tag_transform_compile(&plan, tag);
+        if (neu_tag_attribute_test(tag, NEU_ATTRIBUTE_SUBSCRIBE) &&
+            neu_tag_deadband_is_set(&tag->deadband)) {
+            neu_driver_cache_set_deadband(group->driver->cache, group->name,
+                                          tag->name, &tag->deadband, &plan);
+        }
+        if (neu_tag_window_is_set(&tag->window)) {
+            neu_tag_window_t window = tag->window;
+
+            // a window of duration only holds a sample per read of the group
+            if (window.depth == 0) {
+                window.depth =
+                    window.duration / (interval > 0 ? interval : 1) + 1;
+            }
+            neu_driver_cache_set_window(group->driver->cache, group->name,
+                                        tag->name, &window, &plan);
+        }
     }
 
     neu_plugin_group_t grp = {
@@ -2672,10 +3147,86 @@ static void group_change(void *arg, int64_t timestamp, UT_array *tags,
                 timestamp);
 }
 
+static void group_read_done(group_t *group, bool flush)
+{
+    UT_array *pending = neu_driver_sync_end(group->sync, flush);
+
+    if (pending != NULL) {
+        nlog_debug("%s-%s answer %u sync reads", group->driver->adapter.name,
+                   group->name, utarray_len(pending));
+        utarray_foreach(pending, neu_reqresp_head_t **, req)
+        {
+            reply_read(group->driver, group, *req);
+        }
+        utarray_free(pending);
+    }
+}
+
+// end the device read in flight and answer the sync reads waiting for it
+static void group_read_end(group_t *group)
+{
+    group_read_done(group, false);
+}
+
+// answer the waiting sync reads from the cache when nothing will serve them
+static void group_read_flush(group_t *group)
+{
+    group_read_done(group, true);
+}
+
+// run the write timer or task of the group now for the waiting sync reads
+static void group_sync_post(group_t *group)
+{
+    if (group->write_task != NULL) {
+        neu_sched_post(group->write_task);
+    } else if (group->write != NULL) {
+        neu_event_post_timer(group->driver->driver_events, group->write);
+    }
+}
+
+// a read the plugin did not start, the waiting sync reads start their own
+static void group_read_cancel(group_t *group)
+{
+    neu_driver_sync_cancel(group->sync);
+    group_sync_post(group);
+}
+
+/*
+ * Sync reads share the device read in flight, periodic or sync, and only
+ * start one of their own when there is none. The group timers are left
+ * untouched.
+ */
+static void sync_read_group(group_t *group, neu_reqresp_head_t *req)
+{
+    neu_driver_sync_push(group->sync, req);
+    group_sync_post(group);
+}
+
+static void sync_callback(group_t *group)
+{
+    neu_adapter_driver_t *driver = group->driver;
+
+    if (!neu_driver_sync_waiting(group->sync) ||
+        !neu_driver_sync_begin(group->sync, true, NULL)) {
+        return;
+    }
+
+    // a plugin still busy with a read the driver did not start is not
+    // waited for, the requests get what it read so far
+    if (driver->adapter.state != NEU_NODE_RUNNING_STATE_RUNNING ||
+        driver->adapter.module->intf_funs->driver.group_sync(
+            driver->adapter.plugin, &group->grp) !=
+            NEU_PLUGIN_GROUP_READ_PENDING) {
+        group_read_end(group);
+    }
+}
+
 static int write_callback(void *usr_data)
 {
     group_t *                group = (group_t *) usr_data;
     neu_node_running_state_e state = group->driver->adapter.state;
+
+    sync_callback(group);
     if (state != NEU_NODE_RUNNING_STATE_RUNNING) {
         return 0;
     }
@@ -2787,12 +3338,126 @@ static int write_callback(void *usr_data)
     return 0;
 }
 
-static int read_callback(void *usr_data)
+static const char *jitter_metric(int64_t jitter)
+{
+    if (jitter <= 5) {
+        return NEU_METRIC_GROUP_JITTER_LE_5MS;
+    } else if (jitter <= 20) {
+        return NEU_METRIC_GROUP_JITTER_LE_20MS;
+    } else if (jitter <= 100) {
+        return NEU_METRIC_GROUP_JITTER_LE_100MS;
+    } else if (jitter <= 500) {
+        return NEU_METRIC_GROUP_JITTER_LE_500MS;
+    } else {
+        return NEU_METRIC_GROUP_JITTER_GT_500MS;
+    }
+}
+
+// back off a group that keeps overrunning, restore it once it keeps up
+static void group_pace(group_t *group, neu_driver_tick_member_t *member,
+                       int64_t spend, bool skipped)
+{
+    uint64_t interval = 0;
+
+    if (g_group_deadline != NEU_DRIVER_DEADLINE_BACKOFF ||
+        !neu_driver_tick_pace(group->tick, member, spend, skipped)) {
+        return;
+    }
+
+    interval            = neu_driver_tick_interval(group->tick, member);
+    group->last_read_ms = 0;
+    nlog_warn("%s-%s interval %" PRIu32 " backoff to %" PRIu64,
+              group->driver->adapter.name, group->name, member->interval,
+              interval);
+    neu_adapter_update_group_metric(&group->driver->adapter, group->name,
+                                    NEU_METRIC_GROUP_EFFECTIVE_INTERVAL_MS,
+                                    interval);
+}
+
+// the budget of a read cycle is the effective interval of the group, from
+// its start to the end reported by the plugin
+static void group_deadline(group_t *group, neu_driver_tick_member_t *member,
+                           int64_t start, int64_t spend)
+{
+    neu_adapter_t *adapter  = &group->driver->adapter;
+    int64_t        interval = neu_driver_tick_interval(group->tick, member);
+    int64_t        skipped  = 0;
+    bool           late     = spend > interval;
+
+    if (group->last_read_ms > 0) {
+        int64_t gap    = start - group->last_read_ms;
+        int64_t jitter = gap > interval ? gap - interval : interval - gap;
+        int64_t n      = (gap + interval / 2) / interval;
+
+        skipped = n > 1 ? n - 1 : 0;
+        neu_adapter_update_group_metric(adapter, group->name,
+                                        jitter_metric(jitter), 1);
+        if (skipped > 0) {
+            neu_adapter_update_group_metric(
+                adapter, group->name, NEU_METRIC_GROUP_SKIPPED_CYCLES_TOTAL,
+                skipped);
+        }
+    }
+    group->last_read_ms = start;
+
+    if (late) {
+        neu_adapter_update_group_metric(
+            adapter, group->name, NEU_METRIC_GROUP_LATE_CYCLES_TOTAL, 1);
+    }
+
+    group_pace(group, member, spend, skipped > 0);
+}
+
+// a due read that could not start as the last one is still running
+static void group_overrun(group_t *group, neu_driver_tick_member_t *member)
+{
+    neu_adapter_update_group_metric(&group->driver->adapter, group->name,
+                                    NEU_METRIC_GROUP_LATE_CYCLES_TOTAL, 1);
+    group_pace(group, member, 0, true);
+}
+
+// the last periodic read that ended, if it was not accounted yet
+static void group_read_account(group_t *                 group,
+                               neu_driver_tick_member_t *member)
+{
+    int64_t start = 0;
+    int64_t spend = 0;
+
+    if (!neu_driver_sync_take_done(group->sync, &start, &spend)) {
+        return;
+    }
+
+    nlog_debug("%s-%s timer: %" PRId64, group->driver->adapter.name,
+               group->name, spend);
+    neu_adapter_update_group_metric(&group->driver->adapter, group->name,
+                                    NEU_METRIC_GROUP_LAST_TIMER_MS, spend);
+    group_deadline(group, member, start, spend);
+}
+
+static void group_filtered(group_t *group)
+{
+    uint64_t forwarded  = 0;
+    uint64_t suppressed = 0;
+
+    neu_driver_cache_take_filtered(group->driver->cache, group->name,
+                                   &forwarded, &suppressed);
+    if (forwarded > 0) {
+        neu_adapter_update_group_metric(
+            &group->driver->adapter, group->name,
+            NEU_METRIC_GROUP_FORWARDED_VALUES_TOTAL, forwarded);
+    }
+    if (suppressed > 0) {
+        neu_adapter_update_group_metric(
+            &group->driver->adapter, group->name,
+            NEU_METRIC_GROUP_SUPPRESSED_VALUES_TOTAL, suppressed);
+    }
+}
+
+static void read_callback(group_t *group, neu_driver_tick_member_t *member)
 {
-    group_t *                group = (group_t *) usr_data;
     neu_node_running_state_e state = group->driver->adapter.state;
     if (state != NEU_NODE_RUNNING_STATE_RUNNING) {
-        return 0;
+        return;
     }
 
     if (neu_group_is_change(group->group, group->timestamp)) {
@@ -2801,141 +3466,111 @@ static int read_callback(void *usr_data)
     }
 
     if (group->grp.tags != NULL && utarray_len(group->grp.tags) > 0) {
-        int64_t spend = global_timestamp;
+        bool overrun = false;
+        int  ret     = 0;
 
-        group->driver->adapter.module->intf_funs->driver.group_timer(
+        group_read_account(group, member);
+        if (!neu_driver_sync_begin(group->sync, false, &overrun)) {
+            // the last read of the group is still running, a sync read is
+            // not held against the schedule
+            if (overrun) {
+                group_overrun(group, member);
+            }
+            return;
+        }
+        ret = group->driver->adapter.module->intf_funs->driver.group_timer(
             group->driver->adapter.plugin, &group->grp);
+        if (ret == NEU_PLUGIN_GROUP_READ_BUSY) {
+            group_read_cancel(group);
+            group_overrun(group, member);
+        } else if (ret != NEU_PLUGIN_GROUP_READ_PENDING) {
+            group_read_end(group);
+        }
+
+        // a read that ended before the call returned
+        group_read_account(group, member);
+        group_filtered(group);
+    }
+}
+
+static int read_report_cache(neu_driver_cache_t *cache, const char *group,
+                             neu_datatag_t *tag, neu_driver_cache_slot_t *slot,
+                             bool changed, neu_driver_cache_value_t *value,
+                             neu_tag_meta_t **metas, int *n_meta)
+{
+    int ret = -1;
 
-        spend = global_timestamp - spend;
-        nlog_debug("%s-%s timer: %" PRId64, group->driver->adapter.name,
-                   group->name, spend);
+    if (slot == NULL) {
+        if (changed) {
+            return neu_driver_cache_meta_get_changed(cache, group, tag->name,
+                                                     value, metas, n_meta);
+        } else {
+            return neu_driver_cache_meta_get(cache, group, tag->name, value,
+                                             metas, n_meta);
+        }
+    }
 
-        neu_adapter_update_group_metric(&group->driver->adapter, group->name,
-                                        NEU_METRIC_GROUP_LAST_TIMER_MS, spend);
+    ret = neu_driver_cache_meta_get_slot(cache, *slot, value, metas, n_meta,
+                                         changed);
+    if (ret < 0) {
+        // the tag was not cached yet or was re-added, resolve it again
+        *slot = neu_driver_cache_slot(cache, group, tag->name);
+        ret   = neu_driver_cache_meta_get_slot(cache, *slot, value, metas,
+                                             n_meta, changed);
     }
 
-    return 0;
+    return ret == 0 ? 0 : -1;
 }
 
 static void read_report_group(int64_t timestamp, int64_t timeout,
                               neu_tag_cache_type_e cache_type,
                               neu_driver_cache_t *cache, const char *group,
-                              UT_array *tags, UT_array *tag_values)
-{
-    utarray_foreach(tags, neu_datatag_t *, tag)
-    {
-        neu_driver_cache_value_t  value     = { 0 };
-        neu_resp_tag_value_meta_t tag_value = { 0 };
-
-        if (neu_tag_attribute_test(tag, NEU_ATTRIBUTE_SUBSCRIBE)) {
-            if (neu_driver_cache_meta_get_changed(cache, group, tag->name,
-                                                  &value, &tag_value.metas,
-                                                  &tag_value.n_meta) != 0) {
+                              UT_array *tags, neu_driver_cache_slot_t *slots,
+                              const neu_tag_transform_t *plans,
+                              neu_group_snapshot_t *snapshot)
+{
+    uint32_t id = 0;
+
+    for (neu_datatag_t *tag = (neu_datatag_t *) utarray_front(tags);
+         tag != NULL; tag = (neu_datatag_t *) utarray_next(tags, tag), id++) {
+        neu_driver_cache_value_t   value     = { 0 };
+        neu_dvalue_t               tag_value = { 0 };
+        neu_tag_meta_t *           metas     = NULL;
+        int                        n_meta    = 0;
+        neu_tag_transform_t        compiled  = { 0 };
+        const neu_tag_transform_t *plan      = &compiled;
+
+        if (read_report_cache(
+                cache, group, tag, slots == NULL ? NULL : &slots[id],
+                neu_tag_attribute_test(tag, NEU_ATTRIBUTE_SUBSCRIBE), &value,
+                &metas, &n_meta) != 0) {
+            if (neu_tag_attribute_test(tag, NEU_ATTRIBUTE_SUBSCRIBE)) {
                 nlog_debug("tag: %s not changed", tag->name);
                 continue;
-            }
-        } else {
-            if (neu_driver_cache_meta_get(cache, group, tag->name, &value,
-                                          &tag_value.metas,
-                                          &tag_value.n_meta) != 0) {
-                snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
-                tag_value.value.type      = NEU_TYPE_ERROR;
-                tag_value.value.value.i32 = NEU_ERR_PLUGIN_TAG_NOT_READY;
-
-                utarray_push_back(tag_values, &tag_value);
+            } else {
+                tag_value.type      = NEU_TYPE_ERROR;
+                tag_value.value.i32 = NEU_ERR_PLUGIN_TAG_NOT_READY;
+
+                neu_group_snapshot_push(snapshot, id, &tag_value, metas,
+                                        n_meta);
                 continue;
             }
         }
-        snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
-        tag_value.datatag = *tag;
-
-        tag_value.datatag.bias = tag->bias;
-
         if (value.value.type == NEU_TYPE_ERROR) {
-            tag_value.value = value.value;
+            tag_value = value.value;
 
-            utarray_push_back(tag_values, &tag_value);
+            neu_group_snapshot_push(snapshot, id, &tag_value, metas, n_meta);
             continue;
         }
 
         if ((tag->type == NEU_TYPE_FLOAT && isnan(value.value.value.f32)) ||
             (tag->type == NEU_TYPE_DOUBLE && isnan(value.value.value.d64))) {
-            tag_value.value.type      = NEU_TYPE_ERROR;
-            tag_value.value.value.i32 = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
-            utarray_push_back(tag_values, &tag_value);
+            tag_value.type      = NEU_TYPE_ERROR;
+            tag_value.value.i32 = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
+            neu_group_snapshot_push(snapshot, id, &tag_value, metas, n_meta);
             continue;
         }
 
-        switch (tag->type) {
-        case NEU_TYPE_UINT16:
-        case NEU_TYPE_INT16:
-            switch (tag->option.value16.endian) {
-            case NEU_DATATAG_ENDIAN_B16:
-                value.value.value.u16 = htons(value.value.value.u16);
-                break;
-            case NEU_DATATAG_ENDIAN_L16:
-            default:
-                break;
-            }
-            break;
-        case NEU_TYPE_FLOAT:
-        case NEU_TYPE_UINT32:
-        case NEU_TYPE_INT32:
-            switch (tag->option.value32.endian) {
-            case NEU_DATATAG_ENDIAN_LB32: {
-                uint16_t *v1 = (uint16_t *) value.value.value.bytes.bytes;
-                uint16_t *v2 = (uint16_t *) (value.value.value.bytes.bytes + 2);
-
-                neu_htons_p(v1);
-                neu_htons_p(v2);
-                break;
-            }
-            case NEU_DATATAG_ENDIAN_BB32:
-                value.value.value.u32 = htonl(value.value.value.u32);
-                break;
-            case NEU_DATATAG_ENDIAN_BL32:
-                value.value.value.u32 = htonl(value.value.value.u32);
-                uint16_t *v1 = (uint16_t *) value.value.value.bytes.bytes;
-                uint16_t *v2 = (uint16_t *) (value.value.value.bytes.bytes + 2);
-
-                neu_htons_p(v1);
-                neu_htons_p(v2);
-                break;
-            case NEU_DATATAG_ENDIAN_LL32:
-            default:
-                break;
-            }
-            break;
-        case NEU_TYPE_DOUBLE:
-        case NEU_TYPE_INT64:
-        case NEU_TYPE_UINT64:
-            switch (tag->option.value64.endian) {
-            case NEU_DATATAG_ENDIAN_B64:
-            case NEU_DATATAG_ENDIAN_BB64:
-                value.value.value.u64 = neu_htonll(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_LB64:
-                value.value.value.u64 = neu_htonlb(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_BL64:
-                value.value.value.u64 = neu_htonbl(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_WS64:
-                value.value.value.u64 = neu_htonws(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_WR64:
-                value.value.value.u64 = neu_htonwr(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_L64:
-            case NEU_DATATAG_ENDIAN_LL64:
-            default:
-                break;
-            }
-            break;
-        default:
-            break;
-        }
-
         if (cache_type != NEU_TAG_CACHE_TYPE_NEVER &&
             (timestamp - value.timestamp) > timeout && timeout > 0) {
             if (value.value.type == NEU_TYPE_PTR) {
@@ -2943,77 +3578,114 @@ static void read_report_group(int64_t timestamp, int64_t timeout,
             } else {
                 neu_free_dvalue(&value.value);
             }
-            tag_value.value.type      = NEU_TYPE_ERROR;
-            tag_value.value.value.i32 = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
+            tag_value.type      = NEU_TYPE_ERROR;
+            tag_value.value.i32 = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
         } else {
             if (value.value.type == NEU_TYPE_PTR) {
-                tag_value.value.type             = NEU_TYPE_PTR;
-                tag_value.value.value.ptr.length = value.value.value.ptr.length;
-                tag_value.value.value.ptr.type   = value.value.value.ptr.type;
-                tag_value.value.value.ptr.ptr    = value.value.value.ptr.ptr;
+                tag_value.type             = NEU_TYPE_PTR;
+                tag_value.value.ptr.length = value.value.value.ptr.length;
+                tag_value.value.ptr.type   = value.value.value.ptr.type;
+                tag_value.value.ptr.ptr    = value.value.value.ptr.ptr;
             } else {
-                tag_value.value = value.value;
+                tag_value = value.value;
             }
 
-            if (tag->decimal != 0 || tag->bias != 0) {
-                double decimal = tag->decimal != 0 ? tag->decimal : 1;
-                double bias    = tag->bias;
-
-                tag_value.value.type = NEU_TYPE_DOUBLE;
-                switch (tag->type) {
-                case NEU_TYPE_INT8:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i8 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT8:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u8 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT16:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i16 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT16:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u16 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT32:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i32 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT32:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u32 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT64:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i64 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT64:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u64 * decimal + bias;
-                    break;
-                case NEU_TYPE_FLOAT:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.f32 * decimal + bias;
-                    break;
-                case NEU_TYPE_DOUBLE:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.d64 * decimal + bias;
-                    break;
-                default:
-                    tag_value.value.type = tag->type;
-                    break;
-                }
-            }
-            if (tag->precision == 0 && tag->bias == 0 &&
-                tag->type == NEU_TYPE_DOUBLE) {
-                format_tag_value(&tag_value.value);
+            if (plans != NULL) {
+                plan = &plans[id];
+            } else {
+                neu_tag_transform_compile(&compiled, tag);
             }
+            neu_tag_transform_apply(plan, &tag_value);
         }
 
-        utarray_push_back(tag_values, &tag_value);
+        neu_group_snapshot_push(snapshot, id, &tag_value, metas, n_meta);
+    }
+}
+
+/*
+ * Accumulate the values of the tags of an aggregating group, once per window
+ * report their statistics instead, the mean as the value and all of them as
+ * metas. Tags without numeric values are left out of the reports.
+ */
+static void read_aggregate_group(group_t *group, int64_t timestamp,
+                                 int64_t              timeout,
+                                 neu_tag_cache_type_e cache_type,
+                                 neu_group_snapshot_t *snapshot)
+{
+    uint32_t interval = neu_group_get_interval(group->group);
+    uint32_t id       = 0;
+
+    if (group->aggregate_start == 0) {
+        group->aggregate_start = timestamp;
+    }
+
+    for (neu_datatag_t *tag = (neu_datatag_t *) utarray_front(
+             group->report_tags);
+         tag != NULL;
+         tag = (neu_datatag_t *) utarray_next(group->report_tags, tag), id++) {
+        neu_driver_acc_t *       acc    = &group->report_accs[id];
+        neu_driver_cache_value_t value  = { 0 };
+        neu_tag_meta_t *         metas  = NULL;
+        int                      n_meta = 0;
+
+        if (read_report_cache(group->driver->cache, group->name, tag,
+                              &group->report_slots[id], false, &value, &metas,
+                              &n_meta) != 0) {
+            acc->error = NEU_ERR_PLUGIN_TAG_NOT_READY;
+            continue;
+        }
+
+        if (value.value.type == NEU_TYPE_ERROR) {
+            acc->error = value.value.value.i32;
+        } else if (cache_type != NEU_TAG_CACHE_TYPE_NEVER &&
+                   (timestamp - value.timestamp) > timeout && timeout > 0) {
+            acc->error = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
+        } else {
+            neu_tag_transform_apply(&group->report_plans[id], &value.value);
+            neu_driver_acc_add_value(acc, &value.value);
+        }
+
+        if (value.value.type == NEU_TYPE_PTR) {
+            free(value.value.value.ptr.ptr);
+        } else {
+            neu_free_dvalue(&value.value);
+        }
+        for (int i = 0; i < n_meta; i++) {
+            neu_free_dvalue(&metas[i].value);
+        }
+        free(metas);
+    }
+
+    // a sample taken half an interval early still closes the window
+    if (timestamp - group->aggregate_start + interval / 2 < group->aggregate) {
+        return;
     }
+
+    id = 0;
+    utarray_foreach(group->report_tags, neu_datatag_t *, tag)
+    {
+        neu_driver_acc_t *acc   = &group->report_accs[id];
+        neu_dvalue_t      value = { 0 };
+
+        if (acc->count > 0) {
+            neu_tag_meta_t *metas =
+                calloc(NEU_DRIVER_ACC_N_META, sizeof(neu_tag_meta_t));
+
+            value.type      = NEU_TYPE_DOUBLE;
+            value.precision = tag->precision;
+            value.value.d64 = acc->mean;
+            neu_group_snapshot_push(snapshot, id, &value, metas,
+                                    neu_driver_acc_metas(acc, metas));
+        } else if (acc->error != 0) {
+            value.type      = NEU_TYPE_ERROR;
+            value.value.i32 = acc->error;
+            neu_group_snapshot_push(snapshot, id, &value, NULL, 0);
+        }
+
+        neu_driver_acc_reset(acc);
+        id += 1;
+    }
+    group->aggregate_start = timestamp;
 }
 
 static void read_group(int64_t timestamp, int64_t timeout,
@@ -3025,6 +3697,7 @@ static void read_group(int64_t timestamp, int64_t timeout,
     {
         neu_resp_tag_value_meta_t tag_value = { 0 };
         neu_driver_cache_value_t  value     = { 0 };
+        neu_tag_transform_t       plan      = { 0 };
 
         snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
         tag_value.datatag = *tag;
@@ -3047,76 +3720,6 @@ static void read_group(int64_t timestamp, int64_t timeout,
             continue;
         }
 
-        switch (tag->type) {
-        case NEU_TYPE_UINT16:
-        case NEU_TYPE_INT16:
-            switch (tag->option.value16.endian) {
-            case NEU_DATATAG_ENDIAN_B16:
-                value.value.value.u16 = htons(value.value.value.u16);
-                break;
-            case NEU_DATATAG_ENDIAN_L16:
-            default:
-                break;
-            }
-            break;
-        case NEU_TYPE_FLOAT:
-        case NEU_TYPE_UINT32:
-        case NEU_TYPE_INT32:
-            switch (tag->option.value32.endian) {
-            case NEU_DATATAG_ENDIAN_LB32: {
-                uint16_t *v1 = (uint16_t *) value.value.value.bytes.bytes;
-                uint16_t *v2 = (uint16_t *) (value.value.value.bytes.bytes + 2);
-
-                neu_htons_p(v1);
-                neu_htons_p(v2);
-                break;
-            }
-            case NEU_DATATAG_ENDIAN_BB32:
-                value.value.value.u32 = htonl(value.value.value.u32);
-                break;
-            case NEU_DATATAG_ENDIAN_BL32:
-                value.value.value.u32 = htonl(value.value.value.u32);
-                uint16_t *v1 = (uint16_t *) value.value.value.bytes.bytes;
-                uint16_t *v2 = (uint16_t *) (value.value.value.bytes.bytes + 2);
-
-                neu_htons_p(v1);
-                neu_htons_p(v2);
-                break;
-            case NEU_DATATAG_ENDIAN_LL32:
-            default:
-                break;
-            }
-            break;
-        case NEU_TYPE_DOUBLE:
-        case NEU_TYPE_INT64:
-        case NEU_TYPE_UINT64:
-            switch (tag->option.value64.endian) {
-            case NEU_DATATAG_ENDIAN_B64:
-            case NEU_DATATAG_ENDIAN_BB64:
-                value.value.value.u64 = neu_htonll(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_LB64:
-                value.value.value.u64 = neu_htonlb(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_BL64:
-                value.value.value.u64 = neu_htonbl(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_WS64:
-                value.value.value.u64 = neu_htonws(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_WR64:
-                value.value.value.u64 = neu_htonwr(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_L64:
-            case NEU_DATATAG_ENDIAN_LL64:
-            default:
-                break;
-            }
-            break;
-        default:
-            break;
-        }
-
         if (cache_type != NEU_TAG_CACHE_TYPE_NEVER &&
             (timestamp - value.timestamp) > timeout) {
             if (value.value.type == NEU_TYPE_PTR) {
@@ -3135,66 +3738,29 @@ static void read_group(int64_t timestamp, int64_t timeout,
             } else {
                 tag_value.value = value.value;
             }
-            if (tag->decimal != 0 || tag->bias != 0) {
-                tag_value.value.type = NEU_TYPE_DOUBLE;
-                double decimal       = tag->decimal != 0 ? tag->decimal : 1;
-                double bias          = tag->bias;
-                switch (tag->type) {
-                case NEU_TYPE_INT8:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i8 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT8:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u8 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT16:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i16 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT16:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u16 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT32:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i32 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT32:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u32 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT64:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i64 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT64:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u64 * decimal + bias;
-                    break;
-                case NEU_TYPE_FLOAT:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.f32 * decimal + bias;
-                    break;
-                case NEU_TYPE_DOUBLE:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.d64 * decimal + bias;
-                    break;
-                default:
-                    tag_value.value.type = tag->type;
-                    break;
-                }
-            }
-
-            if (tag->precision == 0 && tag->bias == 0 &&
-                tag->type == NEU_TYPE_DOUBLE) {
-                format_tag_value(&tag_value.value);
-            }
+            neu_tag_transform_compile(&plan, tag);
+            neu_tag_transform_apply(&plan, &tag_value.value);
         }
         utarray_push_back(tag_values, &tag_value);
     }
 }
 
+static void read_history(neu_driver_cache_t *cache, const char *group,
+                         const neu_tag_history_query_t *query,
+                         UT_array *                     tag_values)
+{
+    utarray_foreach(tag_values, neu_resp_tag_value_meta_t *, tag_value)
+    {
+        neu_tag_history_t history = { 0 };
+
+        if (neu_driver_cache_history(cache, group, tag_value->tag, query,
+                                     &history) == 0) {
+            tag_value->history  = calloc(1, sizeof(neu_tag_history_t));
+            *tag_value->history = history;
+        }
+    }
+}
+
 static void read_group_paginate(int64_t timestamp, int64_t timeout,
                                 neu_tag_cache_type_e cache_type,
                                 neu_driver_cache_t *cache, const char *group,
@@ -3204,6 +3770,7 @@ static void read_group_paginate(int64_t timestamp, int64_t timeout,
     {
         neu_resp_tag_value_meta_paginate_t tag_value = { 0 };
         neu_driver_cache_value_t           value     = { 0 };
+        neu_tag_transform_t                plan      = { 0 };
 
         snprintf(tag_value.tag, sizeof(tag_value.tag), "%s", tag->name);
 
@@ -3242,76 +3809,6 @@ static void read_group_paginate(int64_t timestamp, int64_t timeout,
             continue;
         }
 
-        switch (tag->type) {
-        case NEU_TYPE_UINT16:
-        case NEU_TYPE_INT16:
-            switch (tag->option.value16.endian) {
-            case NEU_DATATAG_ENDIAN_B16:
-                value.value.value.u16 = htons(value.value.value.u16);
-                break;
-            case NEU_DATATAG_ENDIAN_L16:
-            default:
-                break;
-            }
-            break;
-        case NEU_TYPE_FLOAT:
-        case NEU_TYPE_UINT32:
-        case NEU_TYPE_INT32:
-            switch (tag->option.value32.endian) {
-            case NEU_DATATAG_ENDIAN_LB32: {
-                uint16_t *v1 = (uint16_t *) value.value.value.bytes.bytes;
-                uint16_t *v2 = (uint16_t *) (value.value.value.bytes.bytes + 2);
-
-                neu_htons_p(v1);
-                neu_htons_p(v2);
-                break;
-            }
-            case NEU_DATATAG_ENDIAN_BB32:
-                value.value.value.u32 = htonl(value.value.value.u32);
-                break;
-            case NEU_DATATAG_ENDIAN_BL32:
-                value.value.value.u32 = htonl(value.value.value.u32);
-                uint16_t *v1 = (uint16_t *) value.value.value.bytes.bytes;
-                uint16_t *v2 = (uint16_t *) (value.value.value.bytes.bytes + 2);
-
-                neu_htons_p(v1);
-                neu_htons_p(v2);
-                break;
-            case NEU_DATATAG_ENDIAN_LL32:
-            default:
-                break;
-            }
-            break;
-        case NEU_TYPE_DOUBLE:
-        case NEU_TYPE_INT64:
-        case NEU_TYPE_UINT64:
-            switch (tag->option.value64.endian) {
-            case NEU_DATATAG_ENDIAN_B64:
-            case NEU_DATATAG_ENDIAN_BB64:
-                value.value.value.u64 = neu_htonll(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_LB64:
-                value.value.value.u64 = neu_htonlb(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_BL64:
-                value.value.value.u64 = neu_htonbl(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_WS64:
-                value.value.value.u64 = neu_htonws(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_WR64:
-                value.value.value.u64 = neu_htonwr(value.value.value.u64);
-                break;
-            case NEU_DATATAG_ENDIAN_L64:
-            case NEU_DATATAG_ENDIAN_LL64:
-            default:
-                break;
-            }
-            break;
-        default:
-            break;
-        }
-
         if (cache_type != NEU_TAG_CACHE_TYPE_NEVER &&
             (timestamp - value.timestamp) > timeout) {
             if (value.value.type == NEU_TYPE_PTR) {
@@ -3330,61 +3827,8 @@ static void read_group_paginate(int64_t timestamp, int64_t timeout,
             } else {
                 tag_value.value = value.value;
             }
-            if (tag->decimal != 0 || tag->bias != 0) {
-                tag_value.value.type = NEU_TYPE_DOUBLE;
-                double decimal       = tag->decimal != 0 ? tag->decimal : 1;
-                double bias          = tag->bias;
-                switch (tag->type) {
-                case NEU_TYPE_INT8:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i8 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT8:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u8 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT16:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i16 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT16:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u16 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT32:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i32 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT32:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u32 * decimal + bias;
-                    break;
-                case NEU_TYPE_INT64:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.i64 * decimal + bias;
-                    break;
-                case NEU_TYPE_UINT64:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.u64 * decimal + bias;
-                    break;
-                case NEU_TYPE_FLOAT:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.f32 * decimal + bias;
-                    break;
-                case NEU_TYPE_DOUBLE:
-                    tag_value.value.value.d64 =
-                        (double) tag_value.value.value.d64 * decimal + bias;
-                    break;
-                default:
-                    tag_value.value.type = tag->type;
-                    break;
-                }
-            }
-
-            if (tag->precision == 0 && tag->bias == 0 &&
-                tag->type == NEU_TYPE_DOUBLE) {
-                format_tag_value(&tag_value.value);
-            }
+            neu_tag_transform_compile(&plan, tag);
+            neu_tag_transform_apply(&plan, &tag_value.value);
         }
         utarray_push_back(tag_values, &tag_value);
     }
@@ -3395,6 +3839,10 @@ static void store_write_tag(group_t *group, to_be_write_tag_t *tag)
     pthread_mutex_lock(&group->wt_mtx);
     utarray_push_back(group->wt_tags, tag);
     pthread_mutex_unlock(&group->wt_mtx);
+
+    if (group->write_task != NULL) {
+        neu_sched_post(group->write_task);
+    }
 }
 
 void neu_adapter_driver_subscribe(neu_adapter_driver_t *driver,
@@ -3422,6 +3870,7 @@ void neu_adapter_driver_subscribe(neu_adapter_driver_t *driver,
     }
 
     snprintf(sub_app.app, sizeof(sub_app.app), "%s", req->app);
+    sub_app.port            = req->port;
     sub_app.addr.sun_family = AF_UNIX;
     snprintf(sub_app.addr.sun_path, sizeof(sub_app.addr.sun_path),
              "%cneuron-%" PRIu16, '\0', req->port);
@@ -3429,7 +3878,7 @@ void neu_adapter_driver_subscribe(neu_adapter_driver_t *driver,
     utarray_push_back(find->apps, &sub_app);
     pthread_mutex_unlock(&find->apps_mtx);
 
-    report_to_app(driver, find, sub_app.addr);
+    report_to_app(driver, find, &sub_app);
 }
 
 void neu_adapter_driver_unsubscribe(neu_adapter_driver_t * driver,
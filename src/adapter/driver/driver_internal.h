@@ -52,6 +52,16 @@ int neu_adapter_driver_add_group(neu_adapter_driver_t *driver, const char *name,
 int neu_adapter_driver_update_group(neu_adapter_driver_t *driver,
                                     const char *name, const char *new_name,
                                     uint32_t interval);
+/*
+ * Report the statistics of the values of a group once per aggregate
+ * milliseconds instead of the values, 0 goes back to the values.
+ */
+int      neu_adapter_driver_set_group_aggregate(neu_adapter_driver_t *driver,
+                                                const char *          name,
+                                                uint32_t aggregate);
+uint32_t neu_adapter_driver_group_aggregate(neu_adapter_driver_t *driver,
+                                            const char *          name);
+
 int neu_adapter_driver_del_group(neu_adapter_driver_t *driver,
                                  const char *          name);
 int neu_adapter_driver_group_exist(neu_adapter_driver_t *driver,
@@ -0,0 +1,139 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "utils/time.h"
+
+#include "sync.h"
+
+struct neu_driver_sync {
+    pthread_mutex_t mtx;
+    UT_array *      reqs;    // void *
+    bool            reading; // a device read is in flight
+    bool            by_sync; // the read in flight was started by sync reads
+    int64_t         start;
+    // the last periodic read that ended, taken by the next read pass as
+    // plugins may end their reads on a thread of their own
+    int64_t done_start;
+    int64_t done_spend; // -1 once taken
+};
+
+neu_driver_sync_t *neu_driver_sync_new()
+{
+    neu_driver_sync_t *sync = calloc(1, sizeof(neu_driver_sync_t));
+
+    pthread_mutex_init(&sync->mtx, NULL);
+    utarray_new(sync->reqs, &ut_ptr_icd);
+    sync->done_spend = -1;
+
+    return sync;
+}
+
+void neu_driver_sync_free(neu_driver_sync_t *sync)
+{
+    utarray_free(sync->reqs);
+    pthread_mutex_destroy(&sync->mtx);
+    free(sync);
+}
+
+void neu_driver_sync_push(neu_driver_sync_t *sync, void *req)
+{
+    pthread_mutex_lock(&sync->mtx);
+    utarray_push_back(sync->reqs, &req);
+    pthread_mutex_unlock(&sync->mtx);
+}
+
+bool neu_driver_sync_waiting(neu_driver_sync_t *sync)
+{
+    bool waiting = false;
+
+    pthread_mutex_lock(&sync->mtx);
+    waiting = utarray_len(sync->reqs) > 0;
+    pthread_mutex_unlock(&sync->mtx);
+
+    return waiting;
+}
+
+bool neu_driver_sync_begin(neu_driver_sync_t *sync, bool by_sync,
+                           bool *overrun)
+{
+    bool begin = false;
+
+    pthread_mutex_lock(&sync->mtx);
+    if (!sync->reading) {
+        sync->reading = true;
+        sync->by_sync = by_sync;
+        sync->start   = neu_time_ms();
+        begin         = true;
+    } else if (overrun != NULL) {
+        *overrun = !sync->by_sync;
+    }
+    pthread_mutex_unlock(&sync->mtx);
+
+    return begin;
+}
+
+UT_array *neu_driver_sync_end(neu_driver_sync_t *sync, bool flush)
+{
+    UT_array *reqs = NULL;
+
+    pthread_mutex_lock(&sync->mtx);
+    if (!sync->reading && !flush) {
+        // requests queued since the flush wait for a read of their own
+        pthread_mutex_unlock(&sync->mtx);
+        return NULL;
+    }
+    if (sync->reading && !sync->by_sync) {
+        sync->done_start = sync->start;
+        sync->done_spend = neu_time_ms() - sync->start;
+    }
+    sync->reading = false;
+    if (utarray_len(sync->reqs) > 0) {
+        reqs = sync->reqs;
+        utarray_new(sync->reqs, &ut_ptr_icd);
+    }
+    pthread_mutex_unlock(&sync->mtx);
+
+    return reqs;
+}
+
+void neu_driver_sync_cancel(neu_driver_sync_t *sync)
+{
+    pthread_mutex_lock(&sync->mtx);
+    sync->reading = false;
+    pthread_mutex_unlock(&sync->mtx);
+}
+
+bool neu_driver_sync_take_done(neu_driver_sync_t *sync, int64_t *start,
+                               int64_t *spend)
+{
+    bool done = false;
+
+    pthread_mutex_lock(&sync->mtx);
+    if (sync->done_spend >= 0) {
+        *start           = sync->done_start;
+        *spend           = sync->done_spend;
+        sync->done_spend = -1;
+        done             = true;
+    }
+    pthread_mutex_unlock(&sync->mtx);
+
+    return done;
+}
@@ -0,0 +1,78 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef _NEU_DRIVER_SYNC_H_
+#define _NEU_DRIVER_SYNC_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "utils/utarray.h"
+
+/*
+ * Device reads of a group and the sync reads waiting for them.
+ *
+ * Sync reads share the device read in flight, periodic or sync, and only
+ * start one of their own when there is none. Whoever starts a read begins it
+ * here first, so that at most one read of the group is in flight, and the
+ * end of the read hands back every sync read queued before it.
+ *
+ * Thread safe, reads may end on a thread of the plugin.
+ */
+typedef struct neu_driver_sync neu_driver_sync_t;
+
+neu_driver_sync_t *neu_driver_sync_new();
+// the sync reads still queued are dropped, flush them before
+void neu_driver_sync_free(neu_driver_sync_t *sync);
+
+// queue a sync read, the caller then makes sure a read gets started
+void neu_driver_sync_push(neu_driver_sync_t *sync, void *req);
+// whether sync reads wait for a read of their own
+bool neu_driver_sync_waiting(neu_driver_sync_t *sync);
+
+/*
+ * Mark a device read in flight, by_sync if sync reads start it.
+ *
+ * @return false if one already is, overrun is then set if that one is a
+ * periodic read.
+ */
+bool neu_driver_sync_begin(neu_driver_sync_t *sync, bool by_sync,
+                           bool *overrun);
+/*
+ * End the device read in flight, or with flush answer the queue even if
+ * none is, as nothing will serve it anymore. The end of a read dropped by
+ * a flush is ignored.
+ *
+ * @return the sync reads the read answers, NULL if none, freed by the
+ * caller.
+ */
+UT_array *neu_driver_sync_end(neu_driver_sync_t *sync, bool flush);
+// a read that was begun but not started, the queue waits for the next one
+void neu_driver_sync_cancel(neu_driver_sync_t *sync);
+
+/*
+ * Take the start and the milliseconds spent of the last periodic read that
+ * ended, once.
+ *
+ * @return false if it was taken already.
+ */
+bool neu_driver_sync_take_done(neu_driver_sync_t *sync, int64_t *start,
+                               int64_t *spend);
+
+#endif
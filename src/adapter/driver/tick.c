@@ -0,0 +1,280 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/utarray.h"
+#include "utils/utextend.h"
+#include "utils/utlist.h"
+
+#include "tick.h"
+
+// a phase is never shorter than this
+#define MIN_PHASE_MS 10
+
+struct neu_driver_tick {
+    uint32_t  base;
+    uint32_t  n_phase;
+    double *  load; // weight per base interval of each phase
+    UT_array *members;
+    void *    data;
+
+    struct neu_driver_tick *prev;
+    struct neu_driver_tick *next;
+};
+
+struct neu_driver_ticks {
+    uint32_t           n_phase;
+    neu_driver_tick_t *ticks;
+};
+
+static const char *deadline_names[] = {
+    [NEU_DRIVER_DEADLINE_DRIFT]   = "drift",
+    [NEU_DRIVER_DEADLINE_SKIP]    = "skip",
+    [NEU_DRIVER_DEADLINE_BACKOFF] = "backoff",
+};
+
+static const UT_icd member_icd = { sizeof(neu_driver_tick_member_t), NULL,
+                                   NULL, NULL };
+
+static uint32_t tick_phases(uint32_t base, uint32_t n_phase)
+{
+    uint32_t n = n_phase > 0 ? n_phase : 1;
+
+    while (n > 1 && (base % n != 0 || base / n < MIN_PHASE_MS)) {
+        n -= 1;
+    }
+
+    return n;
+}
+
+int neu_driver_deadline_parse(const char *str)
+{
+    for (size_t i = 0; i < sizeof(deadline_names) / sizeof(deadline_names[0]);
+         i++) {
+        if (strcmp(str, deadline_names[i]) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+const char *neu_driver_deadline_str(neu_driver_deadline_e deadline)
+{
+    if (deadline > NEU_DRIVER_DEADLINE_BACKOFF) {
+        return "unknown";
+    }
+    return deadline_names[deadline];
+}
+
+static void tick_free(neu_driver_tick_t *tick)
+{
+    utarray_free(tick->members);
+    free(tick->load);
+    free(tick);
+}
+
+neu_driver_ticks_t *neu_driver_ticks_new(uint32_t n_phase)
+{
+    neu_driver_ticks_t *ticks = calloc(1, sizeof(neu_driver_ticks_t));
+
+    ticks->n_phase = n_phase > 0 ? n_phase : 1;
+    return ticks;
+}
+
+void neu_driver_ticks_free(neu_driver_ticks_t *ticks)
+{
+    neu_driver_tick_t *el = NULL, *tmp = NULL;
+
+    DL_FOREACH_SAFE(ticks->ticks, el, tmp)
+    {
+        DL_DELETE(ticks->ticks, el);
+        tick_free(el);
+    }
+    free(ticks);
+}
+
+neu_driver_tick_t *neu_driver_ticks_find(neu_driver_ticks_t *ticks,
+                                         uint32_t            interval)
+{
+    neu_driver_tick_t *find = NULL;
+    neu_driver_tick_t *el   = NULL;
+
+    if (interval == 0) {
+        return NULL;
+    }
+
+    DL_FOREACH(ticks->ticks, el)
+    {
+        if (interval % el->base == 0 &&
+            (find == NULL || el->base > find->base)) {
+            find = el;
+        }
+    }
+
+    return find;
+}
+
+neu_driver_tick_t *neu_driver_ticks_add(neu_driver_ticks_t *ticks,
+                                        uint32_t            interval)
+{
+    neu_driver_tick_t *tick = calloc(1, sizeof(neu_driver_tick_t));
+
+    tick->base    = interval > 0 ? interval : 1;
+    tick->n_phase = tick_phases(tick->base, ticks->n_phase);
+    tick->load    = calloc(tick->n_phase, sizeof(double));
+    utarray_new(tick->members, &member_icd);
+
+    DL_APPEND(ticks->ticks, tick);
+    return tick;
+}
+
+void neu_driver_ticks_del(neu_driver_ticks_t *ticks, neu_driver_tick_t *tick)
+{
+    DL_DELETE(ticks->ticks, tick);
+    tick_free(tick);
+}
+
+int neu_driver_ticks_size(const neu_driver_ticks_t *ticks)
+{
+    neu_driver_tick_t *el    = NULL;
+    int                count = 0;
+
+    DL_COUNT(ticks->ticks, el, count);
+    return count;
+}
+
+int neu_driver_tick_join(neu_driver_tick_t *tick, void *data,
+                         uint32_t interval, uint32_t weight)
+{
+    neu_driver_tick_member_t member = {
+        .data     = data,
+        .interval = interval,
+        .every    = interval / tick->base,
+        .weight   = weight,
+    };
+
+    if (interval == 0 || interval % tick->base != 0) {
+        return -1;
+    }
+
+    // bind the member to the phase carrying the least weight
+    for (uint32_t i = 1; i < tick->n_phase; i++) {
+        if (tick->load[i] < tick->load[member.phase]) {
+            member.phase = i;
+        }
+    }
+    tick->load[member.phase] += (double) weight / member.every;
+
+    utarray_push_back(tick->members, &member);
+    return 0;
+}
+
+int neu_driver_tick_leave(neu_driver_tick_t *tick, void *data)
+{
+    unsigned int index = 0;
+
+    utarray_foreach(tick->members, neu_driver_tick_member_t *, member)
+    {
+        if (member->data == data) {
+            tick->load[member->phase] -=
+                (double) member->weight / member->every;
+            utarray_erase(tick->members, index, 1);
+            break;
+        }
+        index += 1;
+    }
+
+    return utarray_len(tick->members);
+}
+
+bool neu_driver_tick_pace(const neu_driver_tick_t * tick,
+                          neu_driver_tick_member_t *member, int64_t spend,
+                          bool skipped)
+{
+    int64_t  interval = (int64_t) neu_driver_tick_interval(tick, member);
+    uint32_t backoff  = member->backoff;
+
+    // restore only with headroom in the interval one step down, so that it
+    // does not flap
+    int64_t restored = backoff > 0 ? interval / 2 : interval;
+
+    if (skipped || spend > interval) {
+        member->ok_streak = 0;
+        if (++member->late_streak >= NEU_DRIVER_TICK_BACKOFF_CYCLES &&
+            backoff < NEU_DRIVER_TICK_BACKOFF_MAX) {
+            backoff += 1;
+        }
+    } else if (spend * 4 <= restored * 3) {
+        member->late_streak = 0;
+        if (++member->ok_streak >= NEU_DRIVER_TICK_RESTORE_CYCLES &&
+            backoff > 0) {
+            backoff -= 1;
+        }
+    } else {
+        member->late_streak = 0;
+        member->ok_streak   = 0;
+    }
+
+    if (backoff == member->backoff) {
+        return false;
+    }
+
+    __atomic_store_n(&member->backoff, backoff, __ATOMIC_RELAXED);
+    member->late_streak = 0;
+    member->ok_streak   = 0;
+    return true;
+}
+
+uint32_t neu_driver_tick_period(const neu_driver_tick_t *tick)
+{
+    return tick->base / tick->n_phase;
+}
+
+uint32_t neu_driver_tick_base(const neu_driver_tick_t *tick)
+{
+    return tick->base;
+}
+
+uint32_t neu_driver_tick_phases(const neu_driver_tick_t *tick)
+{
+    return tick->n_phase;
+}
+
+int neu_driver_tick_size(const neu_driver_tick_t *tick)
+{
+    return utarray_len(tick->members);
+}
+
+neu_driver_tick_member_t *neu_driver_tick_member(neu_driver_tick_t *tick,
+                                                 int                index)
+{
+    return (neu_driver_tick_member_t *) utarray_eltptr(tick->members,
+                                                       (unsigned int) index);
+}
+
+void neu_driver_tick_set_data(neu_driver_tick_t *tick, void *data)
+{
+    tick->data = data;
+}
+
+void *neu_driver_tick_get_data(const neu_driver_tick_t *tick)
+{
+    return tick->data;
+}
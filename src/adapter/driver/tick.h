@@ -0,0 +1,174 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef _NEU_DRIVER_TICK_H_
+#define _NEU_DRIVER_TICK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Plans the group timers of a driver.
+ *
+ * Groups whose interval is a multiple of the base interval of a tick share
+ * that tick, a group is due every interval / base fires of the base interval.
+ * The base interval is split into phases, the tick fires once per phase and
+ * each group is bound to the least loaded phase, so that load is spread
+ * across the period instead of bursting at its start.
+ *
+ * Not thread safe, callers serialize the planner and the passes over the
+ * members of a tick.
+ */
+typedef struct neu_driver_ticks neu_driver_ticks_t;
+typedef struct neu_driver_tick  neu_driver_tick_t;
+
+typedef struct {
+    void *   data;
+    uint32_t interval;
+    uint32_t every;       // due once every `every` base intervals
+    uint32_t phase;       // phase of the base interval the member is due in
+    uint32_t weight;      // load of the member, used to pick its phase
+    uint32_t backoff;     // the interval is stretched by 2^backoff
+    uint32_t late_streak; // late cycles in a row
+    uint32_t ok_streak;   // cycles in a row that fit one back-off step less
+} neu_driver_tick_member_t;
+
+// back-off after this many late cycles in a row
+#define NEU_DRIVER_TICK_BACKOFF_CYCLES 3
+// restore one back-off step after this many cycles in budget in a row
+#define NEU_DRIVER_TICK_RESTORE_CYCLES 10
+// the interval is stretched by at most 2^NEU_DRIVER_TICK_BACKOFF_MAX
+#define NEU_DRIVER_TICK_BACKOFF_MAX 3
+
+/*
+ * What a tick does with fires missed while a pass overran its period.
+ */
+typedef enum {
+    // the following fires are shifted, the schedule drifts
+    NEU_DRIVER_DEADLINE_DRIFT = 0,
+    // fires stay anchored to the start of the tick, missed ones are skipped
+    NEU_DRIVER_DEADLINE_SKIP,
+    // as skip, and the interval of a group that keeps overrunning is doubled
+    // until it keeps up, then restored step by step
+    NEU_DRIVER_DEADLINE_BACKOFF,
+} neu_driver_deadline_e;
+
+int         neu_driver_deadline_parse(const char *str);
+const char *neu_driver_deadline_str(neu_driver_deadline_e deadline);
+
+/*
+ * n_phase is the number of phases per base interval, 1 fires all members of
+ * a tick together.
+ */
+neu_driver_ticks_t *neu_driver_ticks_new(uint32_t n_phase);
+void                neu_driver_ticks_free(neu_driver_ticks_t *ticks);
+
+/*
+ * Find the tick a member of interval should join, the tick with the biggest
+ * base interval that divides interval, NULL if there is none.
+ */
+neu_driver_tick_t *neu_driver_ticks_find(neu_driver_ticks_t *ticks,
+                                         uint32_t            interval);
+// add a tick of base interval
+neu_driver_tick_t *neu_driver_ticks_add(neu_driver_ticks_t *ticks,
+                                        uint32_t            interval);
+// remove and free a tick, its timers must be stopped before
+void neu_driver_ticks_del(neu_driver_ticks_t *ticks, neu_driver_tick_t *tick);
+int  neu_driver_ticks_size(const neu_driver_ticks_t *ticks);
+
+/*
+ * Add a member to a tick, interval must be a multiple of the base interval.
+ */
+int neu_driver_tick_join(neu_driver_tick_t *tick, void *data,
+                         uint32_t interval, uint32_t weight);
+/*
+ * Remove a member from a tick.
+ *
+ * @return the number of remaining members.
+ */
+int neu_driver_tick_leave(neu_driver_tick_t *tick, void *data);
+
+// milliseconds between two fires of the tick
+uint32_t neu_driver_tick_period(const neu_driver_tick_t *tick);
+uint32_t neu_driver_tick_base(const neu_driver_tick_t *tick);
+uint32_t neu_driver_tick_phases(const neu_driver_tick_t *tick);
+
+int                       neu_driver_tick_size(const neu_driver_tick_t *tick);
+neu_driver_tick_member_t *neu_driver_tick_member(neu_driver_tick_t *tick,
+                                                 int                index);
+
+void  neu_driver_tick_set_data(neu_driver_tick_t *tick, void *data);
+void *neu_driver_tick_get_data(const neu_driver_tick_t *tick);
+
+/*
+ * Number of fires of a tick in [from, to) a member is due on, fires are
+ * counted from 0.
+ */
+static inline uint64_t
+neu_driver_tick_due_between(const neu_driver_tick_t *       tick,
+                            const neu_driver_tick_member_t *member,
+                            uint64_t from, uint64_t to)
+{
+    uint32_t backoff = __atomic_load_n(&member->backoff, __ATOMIC_RELAXED);
+    uint64_t cycle   = (uint64_t) member->every * neu_driver_tick_phases(tick);
+    uint64_t skew    = 0;
+
+    // due fires in [0, x) are (x + skew) / cycle
+    cycle <<= backoff;
+    skew = cycle - 1 - member->phase;
+
+    return (to + skew) / cycle - (from + skew) / cycle;
+}
+
+/*
+ * Milliseconds between two fires of a tick a member is due on, its interval
+ * stretched by its back-off.
+ */
+static inline uint64_t
+neu_driver_tick_interval(const neu_driver_tick_t *       tick,
+                         const neu_driver_tick_member_t *member)
+{
+    uint32_t backoff = __atomic_load_n(&member->backoff, __ATOMIC_RELAXED);
+    uint64_t cycle   = (uint64_t) member->every * neu_driver_tick_phases(tick);
+
+    return (cycle << backoff) * neu_driver_tick_period(tick);
+}
+
+/*
+ * Account a read cycle of a member that took spend milliseconds for its
+ * back-off. The cycle is late if it overran the effective interval of the
+ * member or if due fires were skipped.
+ *
+ * @return true if the back-off of the member changed.
+ */
+bool neu_driver_tick_pace(const neu_driver_tick_t * tick,
+                          neu_driver_tick_member_t *member, int64_t spend,
+                          bool skipped);
+
+/*
+ * Whether a member is due on the fire number `count` of its tick.
+ */
+static inline bool neu_driver_tick_due(const neu_driver_tick_t *       tick,
+                                       const neu_driver_tick_member_t *member,
+                                       uint64_t                        count)
+{
+    return neu_driver_tick_due_between(tick, member, count, count + 1) > 0;
+}
+
+#endif
@@ -0,0 +1,235 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <math.h>
+#include <netinet/in.h>
+#include <string.h>
+
+#include "transform.h"
+
+static const double pow10_table[] = { 1, 10, 100, 1000, 10000, 100000 };
+
+static void swap_b16(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->u16 = htons(value->u16);
+}
+
+static void swap_lb32(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    neu_htons_p((uint16_t *) value->bytes.bytes);
+    neu_htons_p((uint16_t *) (value->bytes.bytes + 2));
+}
+
+static void swap_bb32(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->u32 = htonl(value->u32);
+}
+
+static void swap_bl32(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    swap_bb32(plan, value);
+    swap_lb32(plan, value);
+}
+
+static void swap_b64(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->u64 = neu_htonll(value->u64);
+}
+
+static void swap_lb64(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->u64 = neu_htonlb(value->u64);
+}
+
+static void swap_bl64(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->u64 = neu_htonbl(value->u64);
+}
+
+static void swap_ws64(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->u64 = neu_htonws(value->u64);
+}
+
+static void swap_wr64(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->u64 = neu_htonwr(value->u64);
+}
+
+// value * decimal + bias as a double
+#define SCALE_STEP(name, member)                                          \
+    static void scale_##name(const neu_tag_transform_t *plan,             \
+                             neu_value_u *              value)            \
+    {                                                                     \
+        value->d64 = (double) value->member * plan->decimal + plan->bias; \
+    }
+
+SCALE_STEP(i8, i8)
+SCALE_STEP(u8, u8)
+SCALE_STEP(i16, i16)
+SCALE_STEP(u16, u16)
+SCALE_STEP(i32, i32)
+SCALE_STEP(u32, u32)
+SCALE_STEP(i64, i64)
+SCALE_STEP(u64, u64)
+SCALE_STEP(f32, f32)
+SCALE_STEP(d64, d64)
+
+static void round_d64(const neu_tag_transform_t *plan, neu_value_u *value)
+{
+    (void) plan;
+    value->d64 = neu_tag_transform_round(value->d64);
+}
+
+double neu_tag_transform_round(double value)
+{
+    double   sign    = value < 0 ? -1 : 1;
+    double   abs     = value * sign;
+    int64_t  integer = (int64_t) abs;
+    uint32_t decimal = (uint32_t) round((abs - (double) integer) * 1e5);
+    uint32_t digits[5];
+    int      i = 0;
+
+    // the 5 decimals, a carry into the integer part leaves them all 0
+    for (uint32_t d = decimal, k = 5; k > 0; d /= 10, k--) {
+        digits[k - 1] = d % 10;
+    }
+
+    for (i = 0; i < 4; i++) {
+        if ((digits[i] == 0 && digits[i + 1] == 0) ||
+            (digits[i] == 9 && digits[i + 1] == 9)) {
+            break;
+        }
+    }
+
+    if (i > 0 && i < 4) {
+        return sign *
+            ((double) integer +
+             round(decimal / pow10_table[5 - i]) / pow10_table[i]);
+    }
+    return sign * ((double) integer + decimal / pow10_table[5]);
+}
+
+static neu_tag_transform_step_fn swap_step(const neu_datatag_t *tag)
+{
+    switch (tag->type) {
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_INT16:
+        return tag->option.value16.endian == NEU_DATATAG_ENDIAN_B16 ? swap_b16
+                                                                    : NULL;
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_INT32:
+        switch (tag->option.value32.endian) {
+        case NEU_DATATAG_ENDIAN_LB32:
+            return swap_lb32;
+        case NEU_DATATAG_ENDIAN_BB32:
+            return swap_bb32;
+        case NEU_DATATAG_ENDIAN_BL32:
+            return swap_bl32;
+        default:
+            return NULL;
+        }
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+        switch (tag->option.value64.endian) {
+        case NEU_DATATAG_ENDIAN_B64:
+        case NEU_DATATAG_ENDIAN_BB64:
+            return swap_b64;
+        case NEU_DATATAG_ENDIAN_LB64:
+            return swap_lb64;
+        case NEU_DATATAG_ENDIAN_BL64:
+            return swap_bl64;
+        case NEU_DATATAG_ENDIAN_WS64:
+            return swap_ws64;
+        case NEU_DATATAG_ENDIAN_WR64:
+            return swap_wr64;
+        default:
+            return NULL;
+        }
+    default:
+        return NULL;
+    }
+}
+
+static neu_tag_transform_step_fn scale_step(neu_type_e type)
+{
+    switch (type) {
+    case NEU_TYPE_INT8:
+        return scale_i8;
+    case NEU_TYPE_UINT8:
+        return scale_u8;
+    case NEU_TYPE_INT16:
+        return scale_i16;
+    case NEU_TYPE_UINT16:
+        return scale_u16;
+    case NEU_TYPE_INT32:
+        return scale_i32;
+    case NEU_TYPE_UINT32:
+        return scale_u32;
+    case NEU_TYPE_INT64:
+        return scale_i64;
+    case NEU_TYPE_UINT64:
+        return scale_u64;
+    case NEU_TYPE_FLOAT:
+        return scale_f32;
+    case NEU_TYPE_DOUBLE:
+        return scale_d64;
+    default:
+        return NULL;
+    }
+}
+
+void neu_tag_transform_compile(neu_tag_transform_t *plan,
+                               const neu_datatag_t *tag)
+{
+    neu_tag_transform_step_fn step = swap_step(tag);
+
+    memset(plan, 0, sizeof(*plan));
+
+    if (step != NULL) {
+        plan->steps[plan->n_step++] = step;
+    }
+
+    if (tag->decimal != 0 || tag->bias != 0) {
+        plan->decimal = tag->decimal != 0 ? tag->decimal : 1;
+        plan->bias    = tag->bias;
+
+        step = scale_step(tag->type);
+        if (step != NULL) {
+            plan->steps[plan->n_step++] = step;
+            plan->type                  = NEU_TYPE_DOUBLE;
+        } else {
+            plan->type = tag->type;
+        }
+    }
+
+    if (tag->precision == 0 && tag->bias == 0 &&
+        tag->type == NEU_TYPE_DOUBLE) {
+        plan->steps[plan->n_step++] = round_d64;
+    }
+}
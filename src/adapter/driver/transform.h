@@ -0,0 +1,73 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef _NEU_DRIVER_TRANSFORM_H_
+#define _NEU_DRIVER_TRANSFORM_H_
+
+#include <stdint.h>
+
+#include "tag.h"
+#include "type.h"
+
+/*
+ * Transforms applied to the cached value of a tag before it is read out or
+ * reported: the byte swap of the tag endian option, the tag decimal and bias,
+ * and the rounding of double noise.
+ *
+ * They are compiled from the tag once, when the tag or its group changes,
+ * into a sequence of steps run for every value without looking at the tag
+ * again.
+ */
+typedef struct neu_tag_transform neu_tag_transform_t;
+
+typedef void (*neu_tag_transform_step_fn)(const neu_tag_transform_t *plan,
+                                          neu_value_u *              value);
+
+#define NEU_TAG_TRANSFORM_MAX_STEP 3
+
+struct neu_tag_transform {
+    uint8_t                   n_step;
+    neu_tag_transform_step_fn steps[NEU_TAG_TRANSFORM_MAX_STEP];
+    // type of the transformed value, 0 keeps the type of the cached value
+    neu_type_e type;
+    double     decimal;
+    double     bias;
+};
+
+void neu_tag_transform_compile(neu_tag_transform_t *plan,
+                               const neu_datatag_t *tag);
+
+static inline void neu_tag_transform_apply(const neu_tag_transform_t *plan,
+                                           neu_dvalue_t *             value)
+{
+    for (uint8_t i = 0; i < plan->n_step; i++) {
+        plan->steps[i](plan, &value->value);
+    }
+    if (plan->type != 0) {
+        value->type = plan->type;
+    }
+}
+
+/*
+ * Round a double to at most 5 decimals, dropping the trailing digits once two
+ * consecutive decimals are 0 or 9, e.g. 1.2999999 is 1.3.
+ */
+double neu_tag_transform_round(double value);
+
+#endif
@@ -16,114 +16,494 @@
  * along with this program; if not, write to the Free Software Foundation,
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
+#include <errno.h>
+#include <poll.h>
 #include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "utils/log.h"
-#include "utils/utextend.h"
+#include "utils/uthash.h"
 
 #include "msg_q.h"
 
-struct item {
-    neu_msg_t *  msg;
-    struct item *prev, *next;
+#define CACHE_LINE_SIZE 64
+
+/*
+ * Bounded ring of Dmitry Vyukov: every cell carries a sequence number that
+ * tells whether the cell is free for the enqueue position or holds the value
+ * of the dequeue position. Producers claim positions with a CAS on head and
+ * the consumer with a CAS on tail, the CAS on tail also lets a producer evict
+ * the oldest message under ADAPTER_MSG_Q_DROP_OLDEST.
+ */
+struct cell {
+    uint64_t   seq;
+    neu_msg_t *msg;
+    int64_t    ts;
 };
 
 struct adapter_msg_q {
-    struct item *list;
-    uint32_t     max;
-    uint32_t     current;
-    char *       name;
+    char *                 name;
+    adapter_msg_q_policy_e policy;
+    uint32_t               size;
+    uint64_t               mask;
+    struct cell *          cells;
+    int                    efd;
+    adapter_msg_q_free_fn  free_fn;
+
+    char     pad0[CACHE_LINE_SIZE];
+    uint64_t head;
+    char     pad1[CACHE_LINE_SIZE];
+    uint64_t tail;
+    char     pad2[CACHE_LINE_SIZE];
+
+    uint32_t sleeping;
+    uint32_t exit_flag;
+    uint64_t dropped;
+    uint64_t latency_us;
+    uint64_t max_latency_us;
 
+    // producers waiting for room under ADAPTER_MSG_Q_BLOCK
     pthread_mutex_t mtx;
     pthread_cond_t  cond;
-    volatile bool   exit_flag;
+    uint32_t        n_blocked;
+
+    // the owner and the pushes by port in progress
+    uint32_t refs;
+};
+
+struct inbox {
+    uint16_t         port;
+    adapter_msg_q_t *q;
+    UT_hash_handle   hh;
+};
+
+// queues of apps by trans data port
+static pthread_rwlock_t inbox_mtx = PTHREAD_RWLOCK_INITIALIZER;
+static struct inbox *   inboxes   = NULL;
+
+static const char *policy_names[] = {
+    [ADAPTER_MSG_Q_DROP_NEWEST] = "drop_newest",
+    [ADAPTER_MSG_Q_DROP_OLDEST] = "drop_oldest",
+    [ADAPTER_MSG_Q_BLOCK]       = "block",
 };
 
-void adapter_msg_q_exit(adapter_msg_q_t *q);
+int adapter_msg_q_policy_parse(const char *str)
+{
+    for (size_t i = 0; i < sizeof(policy_names) / sizeof(policy_names[0]);
+         i++) {
+        if (strcmp(str, policy_names[i]) == 0) {
+            return (int) i;
+        }
+    }
+    return -1;
+}
+
+const char *adapter_msg_q_policy_str(adapter_msg_q_policy_e policy)
+{
+    if (policy > ADAPTER_MSG_Q_BLOCK) {
+        return "unknown";
+    }
+    return policy_names[policy];
+}
+
+static inline int64_t now_us()
+{
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline uint32_t round_up_pow2(uint32_t n)
+{
+    uint32_t size = 2;
+    while (size < n && size < (1u << 31)) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static void trans_data_free(neu_msg_t *msg)
+{
+    neu_reqresp_head_t *header = neu_msg_get_header(msg);
+    neu_trans_data_free((neu_reqresp_trans_data_t *) &header[1]);
+    neu_msg_free(msg);
+}
 
-adapter_msg_q_t *adapter_msg_q_new(const char *name, uint32_t size)
+static inline uint32_t depth(adapter_msg_q_t *q)
+{
+    uint64_t tail = __atomic_load_n(&q->tail, __ATOMIC_SEQ_CST);
+    uint64_t head = __atomic_load_n(&q->head, __ATOMIC_SEQ_CST);
+    return head > tail ? (uint32_t)(head - tail) : 0;
+}
+
+static int try_push(adapter_msg_q_t *q, neu_msg_t *msg, int64_t ts)
+{
+    struct cell *cell = NULL;
+    uint64_t     pos  = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+
+    while (true) {
+        cell         = &q->cells[pos & q->mask];
+        uint64_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        int64_t  dif = (int64_t) seq - (int64_t) pos;
+
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->head, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return -1;
+        } else {
+            pos = __atomic_load_n(&q->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->msg = msg;
+    cell->ts  = ts;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+static neu_msg_t *try_pop(adapter_msg_q_t *q, int64_t *ts)
+{
+    struct cell *cell = NULL;
+    uint64_t     pos  = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+
+    while (true) {
+        cell         = &q->cells[pos & q->mask];
+        uint64_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        int64_t  dif = (int64_t) seq - (int64_t)(pos + 1);
+
+        if (dif == 0) {
+            if (__atomic_compare_exchange_n(&q->tail, &pos, pos + 1, true,
+                                            __ATOMIC_SEQ_CST,
+                                            __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (dif < 0) {
+            return NULL;
+        } else {
+            pos = __atomic_load_n(&q->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    neu_msg_t *msg = cell->msg;
+    *ts            = cell->ts;
+    __atomic_store_n(&cell->seq, pos + q->mask + 1, __ATOMIC_RELEASE);
+    return msg;
+}
+
+static void wake_consumer(adapter_msg_q_t *q)
+{
+    uint64_t one = 1;
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_exchange_n(&q->sleeping, 0, __ATOMIC_SEQ_CST)) {
+        ssize_t size = write(q->efd, &one, sizeof(one));
+        (void) size;
+    }
+}
+
+static void wake_producers(adapter_msg_q_t *q)
+{
+    if (__atomic_load_n(&q->n_blocked, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&q->mtx);
+        pthread_cond_broadcast(&q->cond);
+        pthread_mutex_unlock(&q->mtx);
+    }
+}
+
+adapter_msg_q_t *adapter_msg_q_new(const char *name, uint32_t size,
+                                   adapter_msg_q_policy_e policy)
 {
     struct adapter_msg_q *q = calloc(1, sizeof(struct adapter_msg_q));
 
+    q->name    = strdup(name);
+    q->policy  = policy;
+    q->size    = round_up_pow2(size);
+    q->mask    = q->size - 1;
+    q->cells   = calloc(q->size, sizeof(struct cell));
+    q->efd     = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    q->free_fn = trans_data_free;
+    q->refs    = 1;
+    // the consumer is idle until the first pop
+    q->sleeping = 1;
+    for (uint32_t i = 0; i < q->size; i++) {
+        q->cells[i].seq = i;
+    }
+
     pthread_mutex_init(&q->mtx, NULL);
     pthread_cond_init(&q->cond, NULL);
-    q->max     = size;
-    q->name    = strdup(name);
-    q->current = 0;
 
     return q;
 }
 
-void adapter_msg_q_free(adapter_msg_q_t *q)
+static void msg_q_release(adapter_msg_q_t *q)
 {
-    adapter_msg_q_exit(q);
-    struct item *tmp = NULL, *elt = NULL;
-    nlog_warn("app: %s, drop %u msg", q->name, q->current);
+    neu_msg_t *msg = NULL;
+    int64_t    ts  = 0;
+
+    if (__atomic_sub_fetch(&q->refs, 1, __ATOMIC_ACQ_REL) > 0) {
+        return;
+    }
+
+    nlog_warn("app: %s, drop %u msg", q->name, depth(q));
+    while ((msg = try_pop(q, &ts)) != NULL) {
+        q->free_fn(msg);
+    }
+
     pthread_mutex_destroy(&q->mtx);
     pthread_cond_destroy(&q->cond);
-    DL_FOREACH_SAFE(q->list, elt, tmp)
-    {
-        DL_DELETE(q->list, elt);
-        neu_reqresp_head_t *header = neu_msg_get_header(elt->msg);
-        neu_trans_data_free((neu_reqresp_trans_data_t *) &header[1]);
-        neu_msg_free(elt->msg);
-        free(elt);
-    }
+    close(q->efd);
+    free(q->cells);
     free(q->name);
     free(q);
 }
 
+void adapter_msg_q_free(adapter_msg_q_t *q)
+{
+    // a push by port still in progress releases the queue once it returns
+    adapter_msg_q_exit(q);
+    msg_q_release(q);
+}
+
 void adapter_msg_q_exit(adapter_msg_q_t *q)
 {
+    uint64_t one = 1;
+
+    __atomic_store_n(&q->exit_flag, 1, __ATOMIC_SEQ_CST);
+    ssize_t size = write(q->efd, &one, sizeof(one));
+    (void) size;
+
     pthread_mutex_lock(&q->mtx);
-    q->exit_flag = true;
     pthread_cond_broadcast(&q->cond);
     pthread_mutex_unlock(&q->mtx);
 }
 
 int adapter_msg_q_push(adapter_msg_q_t *q, neu_msg_t *msg)
 {
-    int ret = -1;
-    pthread_mutex_lock(&q->mtx);
-    if (q->current < q->max) {
-        q->current += 1;
-        struct item *elt = calloc(1, sizeof(struct item));
-        elt->msg         = msg;
-        DL_APPEND(q->list, elt);
-        ret = 0;
+    int64_t ts = now_us();
+
+    if (__atomic_load_n(&q->exit_flag, __ATOMIC_SEQ_CST)) {
+        return -1;
+    }
+
+    while (try_push(q, msg, ts) != 0) {
+        switch (q->policy) {
+        case ADAPTER_MSG_Q_DROP_OLDEST: {
+            int64_t    old_ts = 0;
+            neu_msg_t *old    = try_pop(q, &old_ts);
+            if (old != NULL) {
+                q->free_fn(old);
+                __atomic_add_fetch(&q->dropped, 1, __ATOMIC_RELAXED);
+            }
+            break;
+        }
+        case ADAPTER_MSG_Q_BLOCK:
+            pthread_mutex_lock(&q->mtx);
+            __atomic_add_fetch(&q->n_blocked, 1, __ATOMIC_SEQ_CST);
+            while (depth(q) >= q->size &&
+                   !__atomic_load_n(&q->exit_flag, __ATOMIC_SEQ_CST)) {
+                pthread_cond_wait(&q->cond, &q->mtx);
+            }
+            __atomic_sub_fetch(&q->n_blocked, 1, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&q->mtx);
+
+            if (__atomic_load_n(&q->exit_flag, __ATOMIC_SEQ_CST)) {
+                return -1;
+            }
+            break;
+        case ADAPTER_MSG_Q_DROP_NEWEST:
+        default:
+            __atomic_add_fetch(&q->dropped, 1, __ATOMIC_RELAXED);
+            nlog_warn("app: %s, msg q is full, %u(%u)", q->name, depth(q),
+                      q->size);
+            return -1;
+        }
+    }
+
+    wake_consumer(q);
+    return 0;
+}
+
+static uint32_t pop_n(adapter_msg_q_t *q, neu_msg_t **msgs, uint32_t n)
+{
+    uint32_t i  = 0;
+    int64_t  ts = 0;
+
+    for (; i < n; i++) {
+        int64_t msg_ts = 0;
+        msgs[i]        = try_pop(q, &msg_ts);
+        if (msgs[i] == NULL) {
+            break;
+        }
+        if (i == 0) {
+            ts = msg_ts;
+        }
     }
-    pthread_mutex_unlock(&q->mtx);
 
-    if (ret == -1) {
-        nlog_warn("app: %s, msg q is full, %u(%u)", q->name, q->current,
-                  q->max);
+    if (i > 0) {
+        // the first message of the batch waited the longest
+        uint64_t latency = (uint64_t)(now_us() - ts);
+        __atomic_store_n(&q->latency_us, latency, __ATOMIC_RELAXED);
+        if (latency > __atomic_load_n(&q->max_latency_us, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&q->max_latency_us, latency, __ATOMIC_RELAXED);
+        }
+        wake_producers(q);
+    }
+
+    return i;
+}
+
+// announce that the consumer goes idle, false if it has to pop again
+static bool go_idle(adapter_msg_q_t *q)
+{
+    __atomic_store_n(&q->sleeping, 1, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (depth(q) > 0 || __atomic_load_n(&q->exit_flag, __ATOMIC_SEQ_CST)) {
+        return !__atomic_exchange_n(&q->sleeping, 0, __ATOMIC_SEQ_CST);
+    }
+    return true;
+}
+
+uint32_t adapter_msg_q_pop_batch(adapter_msg_q_t *q, neu_msg_t **msgs,
+                                 uint32_t n)
+{
+    uint64_t cnt = 0;
+
+    while (!__atomic_load_n(&q->exit_flag, __ATOMIC_SEQ_CST)) {
+        uint32_t i = pop_n(q, msgs, n);
+        if (i > 0) {
+            return i;
+        }
+
+        if (!go_idle(q)) {
+            continue;
+        }
+
+        struct pollfd pfd = { .fd = q->efd, .events = POLLIN };
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) {
+            nlog_error("app: %s, msg q wait error: %s", q->name,
+                       strerror(errno));
+            break;
+        }
+        if (read(q->efd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN &&
+            errno != EINTR) {
+            nlog_error("app: %s, msg q wait error: %s", q->name,
+                       strerror(errno));
+            break;
+        }
+    }
+
+    return 0;
+}
+
+uint32_t adapter_msg_q_try_pop_batch(adapter_msg_q_t *q, neu_msg_t **msgs,
+                                     uint32_t n)
+{
+    uint64_t cnt = 0;
+    uint64_t one = 1;
+
+    if (read(q->efd, &cnt, sizeof(cnt)) < 0 && errno != EAGAIN &&
+        errno != EINTR) {
+        nlog_error("adapter: %s, msg q read error: %s", q->name,
+                   strerror(errno));
+    }
+
+    if (__atomic_load_n(&q->exit_flag, __ATOMIC_SEQ_CST)) {
+        return 0;
+    }
+
+    __atomic_store_n(&q->sleeping, 0, __ATOMIC_SEQ_CST);
+    uint32_t i = pop_n(q, msgs, n);
+
+    // a full batch or a racing push keeps the fd readable for the next round
+    if (i == n || !go_idle(q)) {
+        ssize_t size = write(q->efd, &one, sizeof(one));
+        (void) size;
+    }
+
+    return i;
+}
+
+void adapter_msg_q_set_free(adapter_msg_q_t *q, adapter_msg_q_free_fn fn)
+{
+    q->free_fn = fn;
+}
+
+int adapter_msg_q_fd(adapter_msg_q_t *q)
+{
+    return q->efd;
+}
+
+void adapter_msg_q_stats(adapter_msg_q_t *q, adapter_msg_q_stats_t *stats)
+{
+    stats->depth      = depth(q);
+    stats->dropped    = __atomic_exchange_n(&q->dropped, 0, __ATOMIC_RELAXED);
+    stats->latency_us = __atomic_load_n(&q->latency_us, __ATOMIC_RELAXED);
+    stats->max_latency_us =
+        __atomic_exchange_n(&q->max_latency_us, 0, __ATOMIC_RELAXED);
+}
+
+int adapter_msg_q_bind(adapter_msg_q_t *q, uint16_t port)
+{
+    struct inbox *inbox = NULL;
+    int           ret   = 0;
+
+    pthread_rwlock_wrlock(&inbox_mtx);
+    HASH_FIND(hh, inboxes, &port, sizeof(port), inbox);
+    if (inbox == NULL) {
+        inbox       = calloc(1, sizeof(struct inbox));
+        inbox->port = port;
+        inbox->q    = q;
+        HASH_ADD(hh, inboxes, port, sizeof(port), inbox);
     } else {
-        pthread_cond_signal(&q->cond);
+        ret = -1;
     }
+    pthread_rwlock_unlock(&inbox_mtx);
 
     return ret;
 }
 
-uint32_t adapter_msg_q_pop(adapter_msg_q_t *q, neu_msg_t **p_data)
+void adapter_msg_q_unbind(uint16_t port)
 {
-    uint32_t ret = 0;
-    pthread_mutex_lock(&q->mtx);
-    while (q->current == 0 && !q->exit_flag) {
-        pthread_cond_wait(&q->cond, &q->mtx);
+    struct inbox *inbox = NULL;
+
+    // the pushes in progress hold a reference to the queue
+    pthread_rwlock_wrlock(&inbox_mtx);
+    HASH_FIND(hh, inboxes, &port, sizeof(port), inbox);
+    if (inbox != NULL) {
+        HASH_DEL(inboxes, inbox);
+        free(inbox);
     }
-    if (q->exit_flag) {
-        pthread_mutex_unlock(&q->mtx);
-        *p_data = NULL;
-        return 0;
+    pthread_rwlock_unlock(&inbox_mtx);
+}
+
+int adapter_msg_q_push_to(uint16_t port, neu_msg_t *msg)
+{
+    struct inbox *   inbox = NULL;
+    adapter_msg_q_t *q     = NULL;
+    int              ret   = 1;
+
+    pthread_rwlock_rdlock(&inbox_mtx);
+    HASH_FIND(hh, inboxes, &port, sizeof(port), inbox);
+    if (inbox != NULL) {
+        q = inbox->q;
+        __atomic_add_fetch(&q->refs, 1, __ATOMIC_RELAXED);
     }
-    struct item *elt = DL_LAST(q->list);
-    if (elt != NULL) {
-        DL_DELETE(q->list, elt);
-        *p_data = elt->msg;
-        free(elt);
-        q->current -= 1;
-        ret = q->current;
+    pthread_rwlock_unlock(&inbox_mtx);
+
+    // the push may wait for room, binding and unbinding the ports of the
+    // other apps must not wait for it
+    if (q != NULL) {
+        ret = adapter_msg_q_push(q, msg);
+        msg_q_release(q);
     }
-    pthread_mutex_unlock(&q->mtx);
+
     return ret;
 }
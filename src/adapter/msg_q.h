@@ -25,12 +25,96 @@
 #include "base/msg_internal.h"
 #include "msg.h"
 
+/**
+ * Bounded FIFO of trans data messages in front of an app.
+ *
+ * The queue is a preallocated lock-free ring, any thread may push and a single
+ * consumer pops. The consumer sleeps on an eventfd that producers only signal
+ * when it is idle.
+ */
 typedef struct adapter_msg_q adapter_msg_q_t;
 
-adapter_msg_q_t *adapter_msg_q_new(const char *name, uint32_t size);
+// releases a message left in the queue, the trans data free by default
+typedef void (*adapter_msg_q_free_fn)(neu_msg_t *msg);
+
+typedef enum {
+    // reject the pushed message when the queue is full
+    ADAPTER_MSG_Q_DROP_NEWEST = 0,
+    // release the oldest queued message to make room
+    ADAPTER_MSG_Q_DROP_OLDEST = 1,
+    // wait until the consumer makes room
+    ADAPTER_MSG_Q_BLOCK = 2,
+} adapter_msg_q_policy_e;
+
+typedef struct {
+    uint32_t depth;
+    uint64_t dropped;        // dropped messages since the last call
+    uint64_t latency_us;     // queueing latency of the last popped message
+    uint64_t max_latency_us; // max queueing latency since the last call
+} adapter_msg_q_stats_t;
+
+int         adapter_msg_q_policy_parse(const char *str);
+const char *adapter_msg_q_policy_str(adapter_msg_q_policy_e policy);
+
+/**
+ * @brief Create a queue.
+ *
+ * @param[in] size capacity, rounded up to a power of two.
+ */
+adapter_msg_q_t *adapter_msg_q_new(const char *name, uint32_t size,
+                                   adapter_msg_q_policy_e policy);
 void             adapter_msg_q_free(adapter_msg_q_t *q);
 
-int      adapter_msg_q_push(adapter_msg_q_t *q, neu_msg_t *msg);
-uint32_t adapter_msg_q_pop(adapter_msg_q_t *q, neu_msg_t **p_data);
+void adapter_msg_q_set_free(adapter_msg_q_t *q, adapter_msg_q_free_fn fn);
+
+/**
+ * @brief Wake up the consumer and blocked producers, later pops return 0.
+ */
+void adapter_msg_q_exit(adapter_msg_q_t *q);
+
+/**
+ * @brief Push a message, the queue owns the message on success.
+ *
+ * @return 0 on success, -1 if the message is rejected.
+ */
+int adapter_msg_q_push(adapter_msg_q_t *q, neu_msg_t *msg);
+
+/**
+ * @brief Pop up to n messages in FIFO order, waits while the queue is empty.
+ *
+ * @return the number of popped messages, 0 when the queue is exited.
+ */
+uint32_t adapter_msg_q_pop_batch(adapter_msg_q_t *q, neu_msg_t **msgs,
+                                 uint32_t n);
+
+/**
+ * @brief Pop up to n messages without waiting, for a consumer that runs on an
+ * event loop and watches adapter_msg_q_fd.
+ *
+ * The fd stays readable while messages are left in the queue.
+ *
+ * @return the number of popped messages.
+ */
+uint32_t adapter_msg_q_try_pop_batch(adapter_msg_q_t *q, neu_msg_t **msgs,
+                                     uint32_t n);
+int      adapter_msg_q_fd(adapter_msg_q_t *q);
+
+void adapter_msg_q_stats(adapter_msg_q_t *q, adapter_msg_q_stats_t *stats);
+
+/**
+ * In-process delivery of trans data: an app binds its queue to its trans data
+ * port and drivers push straight into the queue of the port instead of
+ * sending the message pointer over the abstract socket of the port.
+ */
+int  adapter_msg_q_bind(adapter_msg_q_t *q, uint16_t port);
+void adapter_msg_q_unbind(uint16_t port);
+
+/**
+ * @brief Push a message to the queue bound to a port.
+ *
+ * @return 0 on success, -1 if the message is rejected, 1 if no queue is bound
+ * to the port.
+ */
+int adapter_msg_q_push_to(uint16_t port, neu_msg_t *msg);
 
 #endif
\ No newline at end of file
@@ -35,11 +35,13 @@ void adapter_storage_setting(const char *node, const char *setting)
 }
 
 void adapter_storage_add_group(const char *node, const char *group,
-                               uint32_t interval, void *context)
+                               uint32_t interval, uint32_t aggregate,
+                               void *context)
 {
     neu_persist_group_info_t info = {
-        .name     = (char *) group,
-        .interval = interval,
+        .name      = (char *) group,
+        .interval  = interval,
+        .aggregate = aggregate,
     };
     if (context != NULL) {
         char *ctx = neu_cid_info_to_string((cid_dataset_info_t *) context);
@@ -51,11 +53,13 @@ void adapter_storage_add_group(const char *node, const char *group,
 }
 
 void adapter_storage_update_group(const char *node, const char *group,
-                                  const char *new_name, uint32_t interval)
+                                  const char *new_name, uint32_t interval,
+                                  uint32_t aggregate)
 {
     neu_persist_group_info_t info = {
-        .name     = (char *) new_name,
-        .interval = interval,
+        .name      = (char *) new_name,
+        .interval  = interval,
+        .aggregate = aggregate,
     };
 
     int rv = neu_persister_update_group(node, group, &info);
@@ -169,6 +173,10 @@ int adapter_load_group_and_tag(neu_adapter_driver_t *driver)
             cid_dataset_info_t *info = neu_cid_info_from_string(p->context);
             neu_adapter_driver_add_group(driver, p->name, p->interval, info);
         }
+        if (p->aggregate > 0) {
+            neu_adapter_driver_set_group_aggregate(driver, p->name,
+                                                   p->aggregate);
+        }
 
         rv = neu_persister_load_tags(adapter->name, p->name, &tags);
         if (0 != rv) {
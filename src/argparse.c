@@ -31,6 +31,8 @@
 
 #include <zlog.h>
 
+#include "adapter/driver/tick.h"
+#include "adapter/msg_q.h"
 #include "argparse.h"
 #include "define.h"
 #include "persist/persist.h"
@@ -88,6 +90,21 @@ const char *usage_text =
 "    --syslog_host <HOST> syslog server host to which neuron will send logs\n"
 "    --syslog_port <PORT> syslog server port (default 541 if not provided)\n"
 "    --sub_filter_error The subscribe attribute only detects the last read value and does not report any error tags\n"
+"    --scheduler <N>      run driver groups on N shared workers instead of one\n"
+"                         thread per node, 0 for the number of cores\n"
+"    --msg_q_policy <POLICY>\n"
+"                         app message queue overflow policy:\n"
+"                           - drop_newest, reject new messages (default)\n"
+"                           - drop_oldest, drop the oldest queued message\n"
+"                           - block,       wait for the app to make room\n"
+"    --group_phases <N>   spread the groups of a driver sharing an interval\n"
+"                         over N phases of the interval (default 1)\n"
+"    --group_deadline <POLICY>\n"
+"                         what group timers do when a read cycle overruns:\n"
+"                           - drift,   shift the following cycles (default)\n"
+"                           - skip,    skip the missed cycles\n"
+"                           - backoff, skip, and stretch the interval of\n"
+"                                      groups that keep overrunning\n"
 "\n";
 // clang-format on
 
@@ -313,6 +330,52 @@ static inline int load_env(neu_cli_args_t *args, char **log_level_out,
             }
         }
 
+        char *scheduler = getenv(NEU_ENV_SCHEDULER);
+        if (scheduler != NULL) {
+            char *end = NULL;
+            long  n   = strtol(scheduler, &end, 10);
+            if ('\0' == *scheduler || '\0' != *end || n < -1 || n > 1024) {
+                printf("neuron %s setting invalid!\n", NEU_ENV_SCHEDULER);
+                ret = -1;
+                break;
+            }
+            args->scheduler = (int) n;
+        }
+
+        char *group_phases = getenv(NEU_ENV_GROUP_PHASES);
+        if (group_phases != NULL) {
+            char *end = NULL;
+            long  n   = strtol(group_phases, &end, 10);
+            if ('\0' == *group_phases || '\0' != *end || n < 1 || n > 64) {
+                printf("neuron %s setting invalid!\n", NEU_ENV_GROUP_PHASES);
+                ret = -1;
+                break;
+            }
+            args->group_phases = (uint32_t) n;
+        }
+
+        char *group_deadline = getenv(NEU_ENV_GROUP_DEADLINE);
+        if (group_deadline != NULL) {
+            int deadline = neu_driver_deadline_parse(group_deadline);
+            if (deadline < 0) {
+                printf("neuron %s setting invalid!\n", NEU_ENV_GROUP_DEADLINE);
+                ret = -1;
+                break;
+            }
+            args->group_deadline = deadline;
+        }
+
+        char *msg_q_policy = getenv(NEU_ENV_MSG_Q_POLICY);
+        if (msg_q_policy != NULL) {
+            int policy = adapter_msg_q_policy_parse(msg_q_policy);
+            if (policy < 0) {
+                printf("neuron %s setting invalid!\n", NEU_ENV_MSG_Q_POLICY);
+                ret = -1;
+                break;
+            }
+            args->msg_q_policy = policy;
+        }
+
         char *log_level = getenv(NEU_ENV_LOG_LEVEL);
         if (log_level != NULL) {
             if (*log_level_out != NULL) {
@@ -569,10 +632,18 @@ void neu_cli_args_init(neu_cli_args_t *args, int argc, char *argv[])
         { "syslog_port", required_argument, NULL, 'P' },
         { "sub_filter_error", no_argument, NULL, 'f' },
         { "node", required_argument, NULL, 'n' },
+        { "scheduler", required_argument, NULL, 'w' },
+        { "msg_q_policy", required_argument, NULL, 'q' },
+        { "group_phases", required_argument, NULL, 'g' },
+        { "group_deadline", required_argument, NULL, 'D' },
         { NULL, 0, NULL, 0 },
     };
 
     memset(args, 0, sizeof(*args));
+    args->scheduler    = -1;
+    args->msg_q_policy = ADAPTER_MSG_Q_DROP_NEWEST;
+    args->group_phases   = 1;
+    args->group_deadline = NEU_DRIVER_DEADLINE_DRIFT;
 
     int c            = 0;
     int option_index = 0;
@@ -669,6 +740,53 @@ void neu_cli_args_init(neu_cli_args_t *args, int argc, char *argv[])
             free(args->node_name);
             args->node_name = strdup(optarg);
             break;
+        case 'w': {
+            char *end = NULL;
+            long  n   = strtol(optarg, &end, 10);
+            if ('\0' == *optarg || '\0' != *end || n < 0 || n > 1024) {
+                fprintf(stderr, "%s: option '--scheduler' invalid : `%s`\n",
+                        argv[0], optarg);
+                ret = 1;
+                goto quit;
+            }
+            args->scheduler = (int) n;
+            break;
+        }
+        case 'q': {
+            int policy = adapter_msg_q_policy_parse(optarg);
+            if (policy < 0) {
+                fprintf(stderr, "%s: option '--msg_q_policy' invalid : `%s`\n",
+                        argv[0], optarg);
+                ret = 1;
+                goto quit;
+            }
+            args->msg_q_policy = policy;
+            break;
+        }
+        case 'g': {
+            char *end = NULL;
+            long  n   = strtol(optarg, &end, 10);
+            if ('\0' == *optarg || '\0' != *end || n < 1 || n > 64) {
+                fprintf(stderr, "%s: option '--group_phases' invalid : `%s`\n",
+                        argv[0], optarg);
+                ret = 1;
+                goto quit;
+            }
+            args->group_phases = (uint32_t) n;
+            break;
+        }
+        case 'D': {
+            int deadline = neu_driver_deadline_parse(optarg);
+            if (deadline < 0) {
+                fprintf(stderr,
+                        "%s: option '--group_deadline' invalid : `%s`\n",
+                        argv[0], optarg);
+                ret = 1;
+                goto quit;
+            }
+            args->group_deadline = deadline;
+            break;
+        }
         case '?':
         default:
             usage();
@@ -36,6 +36,10 @@
 #define NEU_ENV_SYSLOG_HOST "NEURON_SYSLOG_HOST"
 #define NEU_ENV_SYSLOG_PORT "NEURON_SYSLOG_PORT"
 #define NEU_ENV_SUB_FILTER_ERROR "NEURON_SUB_FILTER_ERROR"
+#define NEU_ENV_SCHEDULER "NEURON_SCHEDULER"
+#define NEU_ENV_MSG_Q_POLICY "NEURON_MSG_Q_POLICY"
+#define NEU_ENV_GROUP_PHASES "NEURON_GROUP_PHASES"
+#define NEU_ENV_GROUP_DEADLINE "NEURON_GROUP_DEADLINE"
 
 #define NEURON_CONFIG_FNAME "./config/neuron.json"
 
@@ -68,6 +72,10 @@ typedef struct {
     char *   syslog_host;
     uint16_t syslog_port;
     bool     sub_filter_err;
+    int      scheduler;      // shared scheduler workers, -1 if disabled
+    int      msg_q_policy;   // app message queue overflow policy
+    uint32_t group_phases;   // phases of a group timer tick
+    int      group_deadline; // policy for group cycles missing deadlines
 } neu_cli_args_t;
 
 /** Parse command line arguments.
@@ -431,6 +431,10 @@ void neu_metrics_visist(neu_metrics_cb_t cb, void *data)
         }
     }
 
+    for (int i = 0; i < NEU_MEM_POOL_MAX; ++i) {
+        neu_mem_pool_stats(i, &g_metrics_.mem_pools[i]);
+    }
+
     cb(&g_metrics_, data);
     pthread_rwlock_unlock(&g_metrics_mtx_);
 }
@@ -29,6 +29,7 @@ extern "C" {
 #include <sys/un.h>
 
 #include "msg.h"
+#include "utils/mem_pool.h"
 
 #define NEU_REQRESP_TYPE_MAP(XX)                                               \
     XX(NEU_RESP_ERROR, neu_resp_error_t)                                       \
@@ -243,7 +244,8 @@ static inline neu_msg_t *neu_msg_new(neu_reqresp_type_e t, void *ctx,
     }
 
     size_t     total = sizeof(neu_msg_t) + body_size;
-    neu_msg_t *msg   = calloc(1, total);
+    neu_msg_t *msg   = (neu_msg_t *) neu_mem_pool_alloc(NEU_MEM_POOL_MSG,
+                                                        total);
     if (msg) {
         msg->head.type = t;
         msg->head.len  = total;
@@ -257,7 +259,8 @@ static inline neu_msg_t *neu_msg_new(neu_reqresp_type_e t, void *ctx,
 
 static inline neu_msg_t *neu_msg_copy(const neu_msg_t *other)
 {
-    neu_msg_t *msg = calloc(1, other->head.len);
+    neu_msg_t *msg =
+        (neu_msg_t *) neu_mem_pool_alloc(NEU_MEM_POOL_MSG, other->head.len);
     if (msg) {
         memcpy(msg, other, other->head.len);
     }
@@ -267,7 +270,7 @@ static inline neu_msg_t *neu_msg_copy(const neu_msg_t *other)
 static inline void neu_msg_free(neu_msg_t *msg)
 {
     if (msg) {
-        free(msg);
+        neu_mem_pool_free(msg);
     }
 }
 
@@ -0,0 +1,530 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2023 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#include <assert.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "msg.h"
+
+struct neu_tag_names {
+    pthread_mutex_t mtx;
+    uint32_t        ref;
+    uint32_t        n_tag;
+    const char **   names;
+    double *        biases;
+    char *          blob;
+};
+
+struct neu_group_snapshot {
+    neu_tag_names_t *names;
+
+    uint32_t              n_tag;
+    uint32_t              capacity;
+    uint32_t *            ids;
+    uint8_t *             types;
+    uint8_t *             precisions;
+    neu_snapshot_value_u *values;
+
+    // allocated only when at least one tag carries metas
+    neu_tag_meta_t **metas;
+    int *            n_metas;
+
+    char * arena;
+    size_t arena_len;
+    size_t arena_size;
+};
+
+neu_tag_names_t *neu_tag_names_new(UT_array *tags)
+{
+    neu_tag_names_t *names = (neu_tag_names_t *) calloc(1, sizeof(*names));
+    size_t           size  = 0;
+    size_t           off   = 0;
+    uint32_t         id    = 0;
+
+    pthread_mutex_init(&names->mtx, NULL);
+    names->ref   = 1;
+    names->n_tag = utarray_len(tags);
+
+    utarray_foreach(tags, neu_datatag_t *, tag)
+    {
+        size += strlen(tag->name) + 1;
+    }
+
+    names->names =
+        (const char **) calloc(names->n_tag + 1, sizeof(const char *));
+    names->biases = (double *) calloc(names->n_tag + 1, sizeof(double));
+    names->blob   = (char *) calloc(size + 1, 1);
+
+    utarray_foreach(tags, neu_datatag_t *, tag)
+    {
+        size_t len = strlen(tag->name);
+
+        memcpy(names->blob + off, tag->name, len);
+        names->names[id]  = names->blob + off;
+        names->biases[id] = tag->bias;
+        off += len + 1;
+        id += 1;
+    }
+
+    return names;
+}
+
+neu_tag_names_t *neu_tag_names_ref(neu_tag_names_t *names)
+{
+    pthread_mutex_lock(&names->mtx);
+    names->ref += 1;
+    pthread_mutex_unlock(&names->mtx);
+    return names;
+}
+
+void neu_tag_names_unref(neu_tag_names_t *names)
+{
+    uint32_t ref = 0;
+
+    if (names == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&names->mtx);
+    names->ref -= 1;
+    ref = names->ref;
+    pthread_mutex_unlock(&names->mtx);
+
+    if (ref == 0) {
+        pthread_mutex_destroy(&names->mtx);
+        free(names->names);
+        free(names->biases);
+        free(names->blob);
+        free(names);
+    }
+}
+
+uint32_t neu_tag_names_size(const neu_tag_names_t *names)
+{
+    return names->n_tag;
+}
+
+const char *neu_tag_names_name(const neu_tag_names_t *names, uint32_t id)
+{
+    return names->names[id];
+}
+
+double neu_tag_names_bias(const neu_tag_names_t *names, uint32_t id)
+{
+    return names->biases[id];
+}
+
+static bool snapshot_type_in_arena(neu_type_e type)
+{
+    return type == NEU_TYPE_STRING || type == NEU_TYPE_TIME ||
+        type == NEU_TYPE_DATA_AND_TIME || type == NEU_TYPE_ARRAY_CHAR ||
+        type == NEU_TYPE_BYTES;
+}
+
+neu_group_snapshot_t *neu_group_snapshot_new(neu_tag_names_t *names)
+{
+    neu_group_snapshot_t *snap =
+        (neu_group_snapshot_t *) calloc(1, sizeof(neu_group_snapshot_t));
+
+    snap->names    = neu_tag_names_ref(names);
+    snap->capacity = names->n_tag;
+    snap->ids      = (uint32_t *) calloc(snap->capacity + 1, sizeof(uint32_t));
+    snap->types    = (uint8_t *) calloc(snap->capacity + 1, sizeof(uint8_t));
+    snap->precisions =
+        (uint8_t *) calloc(snap->capacity + 1, sizeof(uint8_t));
+    snap->values = (neu_snapshot_value_u *) calloc(
+        snap->capacity + 1, sizeof(neu_snapshot_value_u));
+
+    return snap;
+}
+
+static size_t snapshot_arena_put(neu_group_snapshot_t *snap, const void *data,
+                                 size_t len)
+{
+    size_t off = snap->arena_len;
+
+    if (snap->arena_len + len + 1 > snap->arena_size) {
+        size_t size = snap->arena_size == 0 ? 256 : snap->arena_size * 2;
+        while (size < snap->arena_len + len + 1) {
+            size *= 2;
+        }
+        snap->arena      = (char *) realloc(snap->arena, size);
+        snap->arena_size = size;
+    }
+
+    memcpy(snap->arena + off, data, len);
+    snap->arena[off + len] = '\0';
+    snap->arena_len += len + 1;
+
+    return off;
+}
+
+void neu_group_snapshot_push(neu_group_snapshot_t *snap, uint32_t id,
+                             neu_dvalue_t *value, neu_tag_meta_t *metas,
+                             int n_meta)
+{
+    uint32_t              i = snap->n_tag;
+    neu_snapshot_value_u *v = &snap->values[i];
+
+    assert(i < snap->capacity && id < snap->names->n_tag);
+
+    snap->ids[i]        = id;
+    snap->types[i]      = (uint8_t) value->type;
+    snap->precisions[i] = value->precision;
+
+    switch (value->type) {
+    case NEU_TYPE_INT8:
+    case NEU_TYPE_UINT8:
+    case NEU_TYPE_BIT:
+        v->u8 = value->value.u8;
+        break;
+    case NEU_TYPE_INT16:
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_WORD:
+        v->u16 = value->value.u16;
+        break;
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_DWORD:
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_ERROR:
+        v->u32 = value->value.u32;
+        break;
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_LWORD:
+        v->u64 = value->value.u64;
+        break;
+    case NEU_TYPE_BOOL:
+        v->boolean = value->value.boolean;
+        break;
+    case NEU_TYPE_STRING:
+    case NEU_TYPE_TIME:
+    case NEU_TYPE_DATA_AND_TIME:
+    case NEU_TYPE_ARRAY_CHAR:
+        // arena offset, resolved by neu_group_snapshot_seal
+        v->u64 = snapshot_arena_put(
+            snap, value->value.str,
+            strnlen(value->value.str, sizeof(value->value.str)));
+        break;
+    case NEU_TYPE_BYTES:
+        v->u64 = snapshot_arena_put(
+            snap, value->value.bytes.bytes, value->value.bytes.length);
+        v->bytes.length = value->value.bytes.length;
+        break;
+    case NEU_TYPE_PTR:
+        v->ptr = value->value.ptr;
+        break;
+    case NEU_TYPE_CUSTOM:
+        v->json = value->value.json;
+        break;
+    default:
+        // arrays share the {pointer, length} layout
+        v->strs = value->value.strs;
+        break;
+    }
+
+    if (metas != NULL) {
+        if (snap->metas == NULL) {
+            snap->metas = (neu_tag_meta_t **) calloc(snap->capacity + 1,
+                                                     sizeof(neu_tag_meta_t *));
+            snap->n_metas = (int *) calloc(snap->capacity + 1, sizeof(int));
+        }
+        snap->metas[i]   = metas;
+        snap->n_metas[i] = n_meta;
+    }
+
+    snap->n_tag += 1;
+}
+
+void neu_group_snapshot_seal(neu_group_snapshot_t *snap)
+{
+    for (uint32_t i = 0; i < snap->n_tag; i++) {
+        if (snapshot_type_in_arena((neu_type_e) snap->types[i])) {
+            if (snap->types[i] == NEU_TYPE_BYTES) {
+                snap->values[i].bytes.u8s =
+                    (uint8_t *) snap->arena + (size_t) snap->values[i].u64;
+            } else {
+                snap->values[i].str =
+                    snap->arena + (size_t) snap->values[i].u64;
+            }
+        }
+    }
+}
+
+void neu_group_snapshot_free(neu_group_snapshot_t *snap)
+{
+    for (uint32_t i = 0; i < snap->n_tag; i++) {
+        neu_snapshot_value_u *v    = &snap->values[i];
+        neu_type_e            type = (neu_type_e) snap->types[i];
+
+        if (type == NEU_TYPE_PTR) {
+            free(v->ptr.ptr);
+        } else if (type == NEU_TYPE_ARRAY_STRING) {
+            for (size_t k = 0; k < v->strs.length; ++k) {
+                free(v->strs.strs[k]);
+            }
+            free(v->strs.strs);
+        } else if (NEU_TYPE_ARRAY_CHAR < type &&
+                   type < NEU_TYPE_ARRAY_STRING) {
+            free(v->bools.bools);
+        } else if (NEU_TYPE_CUSTOM == type) {
+            json_decref(v->json);
+        }
+
+        if (snap->metas != NULL && snap->metas[i] != NULL) {
+            for (int k = 0; k < snap->n_metas[i]; k++) {
+                neu_free_dvalue(&snap->metas[i][k].value);
+            }
+            free(snap->metas[i]);
+        }
+    }
+
+    neu_tag_names_unref(snap->names);
+    free(snap->ids);
+    free(snap->types);
+    free(snap->precisions);
+    free(snap->values);
+    free(snap->metas);
+    free(snap->n_metas);
+    free(snap->arena);
+    free(snap);
+}
+
+uint32_t neu_group_snapshot_size(const neu_group_snapshot_t *snap)
+{
+    return snap->n_tag;
+}
+
+const char *neu_group_snapshot_tag(const neu_group_snapshot_t *snap,
+                                   uint32_t                    i)
+{
+    return snap->names->names[snap->ids[i]];
+}
+
+double neu_group_snapshot_bias(const neu_group_snapshot_t *snap, uint32_t i)
+{
+    return snap->names->biases[snap->ids[i]];
+}
+
+neu_type_e neu_group_snapshot_type(const neu_group_snapshot_t *snap,
+                                   uint32_t                    i)
+{
+    return (neu_type_e) snap->types[i];
+}
+
+uint8_t neu_group_snapshot_precision(const neu_group_snapshot_t *snap,
+                                     uint32_t                    i)
+{
+    return snap->precisions[i];
+}
+
+const neu_snapshot_value_u *
+neu_group_snapshot_value(const neu_group_snapshot_t *snap, uint32_t i)
+{
+    return &snap->values[i];
+}
+
+neu_tag_meta_t *
+neu_group_snapshot_metas(const neu_group_snapshot_t *snap, uint32_t i,
+                         int *n_meta)
+{
+    if (snap->metas == NULL || snap->metas[i] == NULL) {
+        *n_meta = 0;
+        return NULL;
+    }
+
+    *n_meta = snap->n_metas[i];
+    return snap->metas[i];
+}
+
+void neu_group_snapshot_to_json(const neu_group_snapshot_t *snap, uint32_t i,
+                                neu_json_read_resp_tag_t *  tag_json)
+{
+    const neu_snapshot_value_u *v      = &snap->values[i];
+    neu_tag_meta_t *            metas  = NULL;
+    int                         n_meta = 0;
+
+    tag_json->name  = (char *) neu_group_snapshot_tag(snap, i);
+    tag_json->error = 0;
+
+    metas            = neu_group_snapshot_metas(snap, i, &n_meta);
+    tag_json->n_meta = n_meta;
+    if (tag_json->n_meta > 0) {
+        tag_json->metas = (neu_json_tag_meta_t *) calloc(
+            tag_json->n_meta, sizeof(neu_json_tag_meta_t));
+    }
+    neu_json_metas_to_json(metas, n_meta, tag_json);
+
+    tag_json->datatag.bias = neu_group_snapshot_bias(snap, i);
+
+    switch (neu_group_snapshot_type(snap, i)) {
+    case NEU_TYPE_ERROR:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->i32;
+        tag_json->error         = v->i32;
+        break;
+    case NEU_TYPE_UINT8:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->u8;
+        break;
+    case NEU_TYPE_INT8:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->i8;
+        break;
+    case NEU_TYPE_INT16:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->i16;
+        break;
+    case NEU_TYPE_INT32:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->i32;
+        break;
+    case NEU_TYPE_INT64:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->i64;
+        break;
+    case NEU_TYPE_WORD:
+    case NEU_TYPE_UINT16:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->u16;
+        break;
+    case NEU_TYPE_DWORD:
+    case NEU_TYPE_UINT32:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->u32;
+        break;
+    case NEU_TYPE_LWORD:
+    case NEU_TYPE_UINT64:
+        tag_json->t             = NEU_JSON_INT;
+        tag_json->value.val_int = v->u64;
+        break;
+    case NEU_TYPE_FLOAT:
+        tag_json->t               = NEU_JSON_FLOAT;
+        tag_json->value.val_float = v->f32;
+        if (isnan(v->f32)) {
+            tag_json->error = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
+        } else {
+            tag_json->precision = neu_group_snapshot_precision(snap, i);
+        }
+        break;
+    case NEU_TYPE_DOUBLE:
+        tag_json->t                = NEU_JSON_DOUBLE;
+        tag_json->value.val_double = v->d64;
+        if (isnan(v->d64)) {
+            tag_json->error = NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED;
+        } else {
+            tag_json->precision = neu_group_snapshot_precision(snap, i);
+        }
+        break;
+    case NEU_TYPE_BOOL:
+        tag_json->t              = NEU_JSON_BOOL;
+        tag_json->value.val_bool = v->boolean;
+        break;
+    case NEU_TYPE_BIT:
+        tag_json->t             = NEU_JSON_BIT;
+        tag_json->value.val_bit = v->u8;
+        break;
+    case NEU_TYPE_STRING:
+    case NEU_TYPE_TIME:
+    case NEU_TYPE_DATA_AND_TIME:
+    case NEU_TYPE_ARRAY_CHAR:
+        tag_json->t             = NEU_JSON_STR;
+        tag_json->value.val_str = v->str;
+        break;
+    case NEU_TYPE_PTR:
+        tag_json->t             = NEU_JSON_STR;
+        tag_json->value.val_str = (char *) v->ptr.ptr;
+        break;
+    case NEU_TYPE_BYTES:
+        tag_json->t                            = NEU_JSON_ARRAY_UINT8;
+        tag_json->value.val_array_uint8.length = v->bytes.length;
+        tag_json->value.val_array_uint8.u8s    = v->bytes.u8s;
+        break;
+    case NEU_TYPE_ARRAY_BOOL:
+        tag_json->t                           = NEU_JSON_ARRAY_BOOL;
+        tag_json->value.val_array_bool.length = v->bools.length;
+        tag_json->value.val_array_bool.bools  = v->bools.bools;
+        break;
+    case NEU_TYPE_ARRAY_INT8:
+        tag_json->t                           = NEU_JSON_ARRAY_INT8;
+        tag_json->value.val_array_int8.length = v->i8s.length;
+        tag_json->value.val_array_int8.i8s    = v->i8s.i8s;
+        break;
+    case NEU_TYPE_ARRAY_UINT8:
+        tag_json->t                            = NEU_JSON_ARRAY_UINT8;
+        tag_json->value.val_array_uint8.length = v->u8s.length;
+        tag_json->value.val_array_uint8.u8s    = v->u8s.u8s;
+        break;
+    case NEU_TYPE_ARRAY_INT16:
+        tag_json->t                            = NEU_JSON_ARRAY_INT16;
+        tag_json->value.val_array_int16.length = v->i16s.length;
+        tag_json->value.val_array_int16.i16s   = v->i16s.i16s;
+        break;
+    case NEU_TYPE_ARRAY_UINT16:
+        tag_json->t                             = NEU_JSON_ARRAY_UINT16;
+        tag_json->value.val_array_uint16.length = v->u16s.length;
+        tag_json->value.val_array_uint16.u16s   = v->u16s.u16s;
+        break;
+    case NEU_TYPE_ARRAY_INT32:
+        tag_json->t                            = NEU_JSON_ARRAY_INT32;
+        tag_json->value.val_array_int32.length = v->i32s.length;
+        tag_json->value.val_array_int32.i32s   = v->i32s.i32s;
+        break;
+    case NEU_TYPE_ARRAY_UINT32:
+        tag_json->t                             = NEU_JSON_ARRAY_UINT32;
+        tag_json->value.val_array_uint32.length = v->u32s.length;
+        tag_json->value.val_array_uint32.u32s   = v->u32s.u32s;
+        break;
+    case NEU_TYPE_ARRAY_INT64:
+        tag_json->t                            = NEU_JSON_ARRAY_INT64;
+        tag_json->value.val_array_int64.length = v->i64s.length;
+        tag_json->value.val_array_int64.i64s   = v->i64s.i64s;
+        break;
+    case NEU_TYPE_ARRAY_UINT64:
+        tag_json->t                             = NEU_JSON_ARRAY_UINT64;
+        tag_json->value.val_array_uint64.length = v->u64s.length;
+        tag_json->value.val_array_uint64.u64s   = v->u64s.u64s;
+        break;
+    case NEU_TYPE_ARRAY_FLOAT:
+        tag_json->t                            = NEU_JSON_ARRAY_FLOAT;
+        tag_json->value.val_array_float.length = v->f32s.length;
+        tag_json->value.val_array_float.f32s   = v->f32s.f32s;
+        break;
+    case NEU_TYPE_ARRAY_DOUBLE:
+        tag_json->t                             = NEU_JSON_ARRAY_DOUBLE;
+        tag_json->value.val_array_double.length = v->f64s.length;
+        tag_json->value.val_array_double.f64s   = v->f64s.f64s;
+        break;
+    case NEU_TYPE_ARRAY_STRING:
+        tag_json->t                          = NEU_JSON_ARRAY_STR;
+        tag_json->value.val_array_str.length = v->strs.length;
+        tag_json->value.val_array_str.p_strs = v->strs.strs;
+        break;
+    case NEU_TYPE_CUSTOM:
+        tag_json->t                = NEU_JSON_OBJECT;
+        tag_json->value.val_object = json_deep_copy(v->json);
+        break;
+    default:
+        break;
+    }
+}
@@ -48,6 +48,8 @@ static void tag_array_copy(void *_dst, const void *_src)
 
     memcpy(dst->format, src->format, sizeof(src->format));
     dst->n_format = src->n_format;
+    dst->deadband = src->deadband;
+    dst->window   = src->window;
     memcpy(dst->meta, src->meta, sizeof(src->meta));
 }
 
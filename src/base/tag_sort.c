@@ -17,34 +17,36 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
 #include <stdlib.h>
+#include <string.h>
 
 #include "tag_sort.h"
 
-static neu_tag_sort_elem_t *array_to_list(UT_array *tags);
-static void                 tag_sort(neu_tag_sort_result_t *result, void *tag,
-                                     neu_tag_sort_fn fn, UT_icd icd);
+static neu_tag_sort_elem_t *array_to_elems(UT_array *tags);
+static void elems_sort(neu_tag_sort_elem_t *elems, unsigned int n,
+                       neu_tag_sort_cmp cmp);
+static void tag_sort(neu_tag_sort_result_t *result, uint32_t *cap, void *tag,
+                     neu_tag_sort_fn fn, UT_icd *icd);
 
 neu_tag_sort_result_t *neu_tag_sort(UT_array *tags, neu_tag_sort_fn sort,
                                     neu_tag_sort_cmp cmp)
 {
     neu_tag_sort_result_t *result = calloc(1, sizeof(neu_tag_sort_result_t));
-    neu_tag_sort_elem_t *  elt = NULL, *tmp = NULL;
-    neu_tag_sort_elem_t *  head = array_to_list(tags);
-
-    DL_SORT(head, cmp);
-    DL_FOREACH_SAFE(head, elt, tmp)
-    {
-        tag_sort(result, elt->tag, sort, tags->icd);
-        DL_DELETE(head, elt);
-        free(elt);
+    neu_tag_sort_elem_t *  elems  = array_to_elems(tags);
+    unsigned int           n      = utarray_len(tags);
+    uint32_t               cap    = 0;
+
+    elems_sort(elems, n, cmp);
+    for (unsigned int i = 0; i < n; i++) {
+        tag_sort(result, &cap, elems[i].tag, sort, &tags->icd);
     }
 
+    free(elems);
     return result;
 }
 
 void neu_tag_sort_free(neu_tag_sort_result_t *result)
 {
-    for (uint16_t i = 0; i < result->n_sort; i++) {
+    for (uint32_t i = 0; i < result->n_sort; i++) {
         utarray_free(result->sorts[i].tags);
     }
 
@@ -52,46 +54,99 @@ void neu_tag_sort_free(neu_tag_sort_result_t *result)
     free(result);
 }
 
-static neu_tag_sort_elem_t *array_to_list(UT_array *tags)
+static neu_tag_sort_elem_t *array_to_elems(UT_array *tags)
 {
-    neu_tag_sort_elem_t *head = NULL, *tmp = NULL;
+    neu_tag_sort_elem_t *elems =
+        calloc(utarray_len(tags) + 1, sizeof(neu_tag_sort_elem_t));
+    unsigned int i = 0;
 
     for (void **tag = utarray_front(tags); tag != NULL;
          tag        = utarray_next(tags, tag)) {
-        tmp      = calloc(1, sizeof(neu_tag_sort_elem_t));
-        tmp->tag = *tag;
-        DL_APPEND(head, tmp);
+        elems[i++].tag = *tag;
+    }
+
+    return elems;
+}
+
+/*
+ * Stable bottom-up merge sort, tags equal by cmp keep their order in the
+ * array, as with DL_SORT before.
+ */
+static void elems_sort(neu_tag_sort_elem_t *elems, unsigned int n,
+                       neu_tag_sort_cmp cmp)
+{
+    neu_tag_sort_elem_t *src = elems;
+    neu_tag_sort_elem_t *dst = NULL;
+    unsigned int         i   = 1;
+
+    // groups are mostly rebuilt from tags already in order
+    while (i < n && cmp(&elems[i - 1], &elems[i]) <= 0) {
+        i++;
+    }
+    if (i >= n) {
+        return;
+    }
+
+    dst = calloc(n, sizeof(neu_tag_sort_elem_t));
+    for (unsigned int width = 1; width < n; width *= 2) {
+        for (unsigned int lo = 0; lo < n; lo += 2 * width) {
+            unsigned int mid = lo + width < n ? lo + width : n;
+            unsigned int hi  = lo + 2 * width < n ? lo + 2 * width : n;
+            unsigned int l = lo, r = mid, k = lo;
+
+            while (l < mid && r < hi) {
+                if (cmp(&src[l], &src[r]) <= 0) {
+                    dst[k++] = src[l++];
+                } else {
+                    dst[k++] = src[r++];
+                }
+            }
+            while (l < mid) {
+                dst[k++] = src[l++];
+            }
+            while (r < hi) {
+                dst[k++] = src[r++];
+            }
+        }
+
+        neu_tag_sort_elem_t *tmp = src;
+        src                      = dst;
+        dst                      = tmp;
     }
 
-    return head;
+    if (src != elems) {
+        memcpy(elems, src, n * sizeof(neu_tag_sort_elem_t));
+        dst = src;
+    }
+    free(dst);
 }
 
-static void tag_sort(neu_tag_sort_result_t *result, void *tag,
-                     neu_tag_sort_fn fn, UT_icd icd)
+static void tag_sort(neu_tag_sort_result_t *result, uint32_t *cap, void *tag,
+                     neu_tag_sort_fn fn, UT_icd *icd)
 {
-    bool sorted = false;
-
-    for (uint16_t i = 0; i < result->n_sort; i++) {
-        if (fn(&result->sorts[i],
-               *(void **) utarray_back(result->sorts[i].tags), tag)) {
-            utarray_push_back(result->sorts[i].tags, &tag);
-            result->sorts[i].info.size += 1;
-            sorted = true;
-            break;
+    neu_tag_sort_t *sort = NULL;
+
+    // tags come in order, only the current batch may take the tag
+    if (result->n_sort > 0) {
+        sort = &result->sorts[result->n_sort - 1];
+        if (fn(sort, *(void **) utarray_back(sort->tags), tag)) {
+            utarray_push_back(sort->tags, &tag);
+            sort->info.size += 1;
+            return;
         }
     }
 
-    if (!sorted) {
-        result->n_sort += 1;
-        result->sorts =
-            realloc(result->sorts, sizeof(neu_tag_sort_t) * result->n_sort);
-
-        memset(&result->sorts[result->n_sort - 1], 0, sizeof(neu_tag_sort_t));
-        utarray_new(result->sorts[result->n_sort - 1].tags, &icd);
-        utarray_push_back(result->sorts[result->n_sort - 1].tags, &tag);
-        result->sorts[result->n_sort - 1].info.size = 1;
-        fn(&result->sorts[result->n_sort - 1],
-           *(void **) utarray_back(result->sorts[result->n_sort - 1].tags),
-           tag);
+    if (result->n_sort == *cap) {
+        *cap          = *cap > 0 ? *cap * 2 : 8;
+        result->sorts = realloc(result->sorts, sizeof(neu_tag_sort_t) * *cap);
     }
-}
\ No newline at end of file
+
+    sort = &result->sorts[result->n_sort];
+    result->n_sort += 1;
+
+    memset(sort, 0, sizeof(neu_tag_sort_t));
+    utarray_new(sort->tags, icd);
+    utarray_push_back(sort->tags, &tag);
+    sort->info.size = 1;
+    fn(sort, *(void **) utarray_back(sort->tags), tag);
+}
@@ -1696,9 +1696,9 @@ static int manager_loop(enum neu_event_io_type type, int fd, void *usr_data)
                 manager_storage_add_node(manager, driver->node, driver->tags);
                 adapter_storage_setting(driver->node, driver->setting);
                 for (uint16_t j = 0; j < driver->n_group; j++) {
-                    adapter_storage_add_group(driver->node,
-                                              driver->groups[j].group,
-                                              driver->groups[j].interval, NULL);
+                    adapter_storage_add_group(
+                        driver->node, driver->groups[j].group,
+                        driver->groups[j].interval, 0, NULL);
                     adapter_storage_add_tags(
                         driver->node, driver->groups[j].group,
                         driver->groups[j].tags, driver->groups[j].n_tag);
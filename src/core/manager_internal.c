@@ -108,9 +108,10 @@ int neu_manager_del_node(neu_manager_t *manager, const char *node_name)
         return NEU_ERR_NODE_NOT_EXIST;
     }
 
+    // unpublish the inbox of the node before it is released
+    neu_node_manager_del(manager->node_manager, node_name);
     neu_adapter_destroy(adapter);
     neu_subscribe_manager_remove(manager->subscribe_manager, node_name, NULL);
-    neu_node_manager_del(manager->node_manager, node_name);
     return NEU_ERR_SUCCESS;
 }
 
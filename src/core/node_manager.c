@@ -24,6 +24,7 @@
 
 #include "adapter/adapter_internal.h"
 #include "node_manager.h"
+#include "route.h"
 
 typedef struct node_entity {
     char *name;
@@ -45,6 +46,22 @@ struct neu_node_manager {
     UT_array *     monitors;
 };
 
+// publish the inboxes of the nodes for the direct data plane
+static void route_publish(neu_node_manager_t *mgr)
+{
+    neu_route_table_t *table = neu_route_table_new();
+    node_entity_t *    el = NULL, *tmp = NULL;
+
+    HASH_ITER(hh, mgr->nodes, el, tmp)
+    {
+        if (el->adapter->inbox != NULL) {
+            neu_route_table_add(table, el->name, el->adapter->inbox);
+        }
+    }
+
+    neu_route_publish(table);
+}
+
 int neu_node_manager_update_tags(neu_node_manager_t *mgr, const char *name,
                                  const char *tags)
 {
@@ -78,6 +95,7 @@ void neu_node_manager_destroy(neu_node_manager_t *mgr)
 {
     node_entity_t *el = NULL, *tmp = NULL;
 
+    neu_route_publish(NULL);
     HASH_ITER(hh, mgr->nodes, el, tmp)
     {
         HASH_DEL(mgr->nodes, el);
@@ -107,6 +125,7 @@ int neu_node_manager_add(neu_node_manager_t *mgr, neu_adapter_t *adapter,
         utarray_push_back(mgr->monitors, &node);
     }
 
+    route_publish(mgr);
     return 0;
 }
 
@@ -121,6 +140,7 @@ int neu_node_manager_add_static(neu_node_manager_t *mgr, neu_adapter_t *adapter)
 
     HASH_ADD_STR(mgr->nodes, name, node);
 
+    route_publish(mgr);
     return 0;
 }
 
@@ -136,6 +156,7 @@ int neu_node_manager_add_single(neu_node_manager_t *mgr, neu_adapter_t *adapter,
 
     HASH_ADD_STR(mgr->nodes, name, node);
 
+    route_publish(mgr);
     return 0;
 }
 
@@ -159,6 +180,7 @@ int neu_node_manager_update_name(neu_node_manager_t *mgr, const char *node_name,
     node->name = new_name;
     HASH_ADD_STR(mgr->nodes, name, node);
 
+    route_publish(mgr);
     return 0;
 }
 
@@ -192,6 +214,8 @@ void neu_node_manager_del(neu_node_manager_t *mgr, const char *name)
             free(node->tags);
         }
         free(node);
+
+        route_publish(mgr);
     }
 }
 
@@ -0,0 +1,148 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/uthash.h"
+
+#include "route.h"
+
+struct route {
+    char *           node;
+    adapter_msg_q_t *inbox;
+    UT_hash_handle   hh;
+};
+
+struct neu_route_table {
+    struct route *routes;
+    uint32_t      ref;
+};
+
+static pthread_mutex_t    route_mtx  = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t     route_cond = PTHREAD_COND_INITIALIZER;
+static neu_route_table_t *current    = NULL;
+// published tables that are still referenced
+static uint32_t n_table = 0;
+
+neu_route_table_t *neu_route_table_new()
+{
+    return calloc(1, sizeof(neu_route_table_t));
+}
+
+void neu_route_table_free(neu_route_table_t *table)
+{
+    struct route *el = NULL, *tmp = NULL;
+
+    HASH_ITER(hh, table->routes, el, tmp)
+    {
+        HASH_DEL(table->routes, el);
+        free(el->node);
+        free(el);
+    }
+    free(table);
+}
+
+int neu_route_table_add(neu_route_table_t *table, const char *node,
+                        adapter_msg_q_t *inbox)
+{
+    struct route *route = NULL;
+
+    HASH_FIND_STR(table->routes, node, route);
+    if (route != NULL) {
+        return -1;
+    }
+
+    route        = calloc(1, sizeof(struct route));
+    route->node  = strdup(node);
+    route->inbox = inbox;
+    HASH_ADD_KEYPTR(hh, table->routes, route->node, strlen(route->node),
+                    route);
+    return 0;
+}
+
+// drop a reference, the caller holds route_mtx
+static neu_route_table_t *unref(neu_route_table_t *table)
+{
+    table->ref -= 1;
+    if (table->ref > 0) {
+        return NULL;
+    }
+
+    n_table -= 1;
+    pthread_cond_broadcast(&route_cond);
+    return table;
+}
+
+void neu_route_publish(neu_route_table_t *table)
+{
+    neu_route_table_t *old = NULL;
+
+    pthread_mutex_lock(&route_mtx);
+    if (current != NULL) {
+        old = unref(current);
+    }
+    current = table;
+    if (table != NULL) {
+        table->ref = 1;
+        n_table += 1;
+    }
+
+    // grace period, senders still pushing to replaced tables
+    while (n_table > (current != NULL ? 1u : 0u)) {
+        pthread_cond_wait(&route_cond, &route_mtx);
+    }
+    pthread_mutex_unlock(&route_mtx);
+
+    if (old != NULL) {
+        neu_route_table_free(old);
+    }
+}
+
+int neu_route_send(const char *node, neu_msg_t *msg)
+{
+    neu_route_table_t *table = NULL;
+    struct route *     route = NULL;
+    int                ret   = 1;
+
+    pthread_mutex_lock(&route_mtx);
+    table = current;
+    if (table != NULL) {
+        table->ref += 1;
+    }
+    pthread_mutex_unlock(&route_mtx);
+
+    if (table == NULL) {
+        return ret;
+    }
+
+    HASH_FIND_STR(table->routes, node, route);
+    if (route != NULL) {
+        ret = adapter_msg_q_push(route->inbox, msg);
+    }
+
+    pthread_mutex_lock(&route_mtx);
+    table = unref(table);
+    pthread_mutex_unlock(&route_mtx);
+
+    if (table != NULL) {
+        neu_route_table_free(table);
+    }
+    return ret;
+}
@@ -0,0 +1,56 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef _NEU_ROUTE_H_
+#define _NEU_ROUTE_H_
+
+#include "adapter/msg_q.h"
+
+/**
+ * Routing table of the data plane, node name to the inbox of the node.
+ *
+ * The manager builds a new table on every node change and publishes it, a
+ * published table is never modified. Senders take a reference on the current
+ * table for the time of a push, so they never wait for the manager, and
+ * publishing returns only after the replaced tables are released, so an inbox
+ * can be freed once its node is out of the table.
+ */
+typedef struct neu_route_table neu_route_table_t;
+
+neu_route_table_t *neu_route_table_new();
+void               neu_route_table_free(neu_route_table_t *table);
+int neu_route_table_add(neu_route_table_t *table, const char *node,
+                        adapter_msg_q_t *inbox);
+
+/**
+ * @brief Replace the current table, NULL clears it.
+ *
+ * The table is owned by the routing afterwards. Only one thread publishes.
+ */
+void neu_route_publish(neu_route_table_t *table);
+
+/**
+ * @brief Push a message to the inbox of a node.
+ *
+ * @return 0 on success, the inbox owns the message, -1 if the inbox rejects
+ * the message, 1 if there is no route to the node.
+ */
+int neu_route_send(const char *node, neu_msg_t *msg);
+
+#endif
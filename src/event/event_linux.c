@@ -24,97 +24,400 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "event/event.h"
 #include "utils/log.h"
+#include "utils/utlist.h"
 
 #ifdef NEU_PLATFORM_LINUX
 #include <sys/epoll.h>
 #include <sys/timerfd.h>
 
+/*
+ * All timers of a loop share one timerfd. Timers are kept in a hierarchical
+ * timer wheel with a 1ms tick: level 0 holds timers due within the next 64
+ * ticks, every further level covers 64 times the span of the one below and
+ * is cascaded down when the lower level wraps. The timerfd is armed to the
+ * earliest tick that has work, either an expiration or a cascade.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVEL 4
+#define WHEEL_SPAN ((int64_t) 1 << (WHEEL_BITS * WHEEL_LEVEL))
+
+#define EVENT_BATCH 64
+#define EVENT_CHUNK_SIZE 256
+#define EVENT_TIMER_KEY UINT64_MAX
+
 struct neu_event_timer {
-    int                    fd;
-    struct event_data *    event_data;
-    struct itimerspec      value;
-    neu_event_timer_type_e type;
-    pthread_mutex_t        mtx;
-    bool                   stop;
+    int64_t                  expire;
+    int64_t                  interval;
+    neu_event_timer_type_e   type;
+    neu_event_timer_callback cb;
+    void *                   usr_data;
+
+    bool stop;
+    // deleted from within its own callback, freed by the loop
+    bool detached;
+    // posted while its callback was running, fires again right after
+    bool posted;
+
+    struct neu_event_timer **bucket;
+    struct neu_event_timer * prev;
+    struct neu_event_timer * next;
 };
 
 struct neu_event_io {
-    int                fd;
-    struct event_data *event_data;
-};
-struct event_data {
-    enum {
-        TIMER = 0,
-        IO    = 1,
-    } type;
-    union {
-        neu_event_io_callback    io;
-        neu_event_timer_callback timer;
-    } callback;
-    union {
-        neu_event_io_t    io;
-        neu_event_timer_t timer;
-    } ctx;
-
-    void *usr_data;
-    int   fd;
-    int   index;
-    bool  use;
+    int                   fd;
+    int                   index;
+    uint32_t              gen;
+    bool                  use;
+    neu_event_io_callback cb;
+    void *                usr_data;
+    int                   next_free;
 };
 
-#define EVENT_SIZE 1400
-
 struct neu_events {
     int       epoll_fd;
+    int       timer_fd;
     pthread_t thread;
     bool      stop;
 
     zlog_category_t *log;
 
-    pthread_mutex_t   mtx;
-    int               n_event;
-    struct event_data event_datas[EVENT_SIZE];
+    // io slots live in chunks that never move once allocated
+    pthread_mutex_t      mtx;
+    struct neu_event_io **chunks;
+    int                  n_chunk;
+    int                  free_io;
+
+    pthread_mutex_t         timer_mtx;
+    pthread_cond_t          timer_cond;
+    struct timespec         base;
+    int64_t                 tick;
+    int64_t                 armed;
+    struct neu_event_timer *wheel[WHEEL_LEVEL][WHEEL_SIZE];
+    struct neu_event_timer *expired;
+    struct neu_event_timer *idle;
+    struct neu_event_timer *running;
 };
 
-static int get_free_event(neu_events_t *events)
+static inline uint64_t io_key(struct neu_event_io *io)
+{
+    return ((uint64_t) io->gen << 32) | (uint32_t) io->index;
+}
+
+static inline struct neu_event_io *io_slot(neu_events_t *events, int index)
 {
-    int ret = -1;
+    return &events->chunks[index / EVENT_CHUNK_SIZE][index % EVENT_CHUNK_SIZE];
+}
+
+static struct neu_event_io *get_free_io(neu_events_t *events)
+{
+    struct neu_event_io *io = NULL;
+
     pthread_mutex_lock(&events->mtx);
-    for (int i = 0; i < EVENT_SIZE; i++) {
-        if (events->event_datas[i].use == false) {
-            events->event_datas[i].use   = true;
-            events->event_datas[i].index = i;
-            ret                          = i;
-            break;
+    if (events->free_io < 0) {
+        struct neu_event_io **chunks = realloc(
+            events->chunks, (events->n_chunk + 1) * sizeof(*events->chunks));
+        struct neu_event_io *chunk =
+            calloc(EVENT_CHUNK_SIZE, sizeof(struct neu_event_io));
+
+        if (chunks == NULL || chunk == NULL) {
+            if (chunks != NULL) {
+                events->chunks = chunks;
+            }
+            free(chunk);
+            pthread_mutex_unlock(&events->mtx);
+            return NULL;
+        }
+
+        events->chunks                  = chunks;
+        events->chunks[events->n_chunk] = chunk;
+        for (int i = EVENT_CHUNK_SIZE - 1; i >= 0; i--) {
+            chunk[i].index     = events->n_chunk * EVENT_CHUNK_SIZE + i;
+            chunk[i].next_free = events->free_io;
+            events->free_io    = chunk[i].index;
         }
+        events->n_chunk += 1;
     }
 
+    io              = io_slot(events, events->free_io);
+    events->free_io = io->next_free;
+    io->use         = true;
+    pthread_mutex_unlock(&events->mtx);
+
+    return io;
+}
+
+static void free_io(neu_events_t *events, struct neu_event_io *io)
+{
+    pthread_mutex_lock(&events->mtx);
+    io->gen += 1;
+
+    io->use         = false;
+    io->next_free   = events->free_io;
+    events->free_io = io->index;
     pthread_mutex_unlock(&events->mtx);
-    return ret;
 }
 
-static void free_event(neu_events_t *events, int index)
+static int64_t now_tick(neu_events_t *events)
+{
+    struct timespec now = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((int64_t)(now.tv_sec - events->base.tv_sec) * 1000000000 +
+            (now.tv_nsec - events->base.tv_nsec)) /
+        1000000;
+}
+
+static void timer_unlink(struct neu_event_timer *timer)
+{
+    if (timer->bucket != NULL) {
+        DL_DELETE(*timer->bucket, timer);
+        timer->bucket = NULL;
+    }
+}
+
+static void timer_link(struct neu_event_timer **bucket,
+                       struct neu_event_timer * timer)
+{
+    DL_APPEND(*bucket, timer);
+    timer->bucket = bucket;
+}
+
+// must be called with timer_mtx held
+static void wheel_insert(neu_events_t *events, struct neu_event_timer *timer)
+{
+    int64_t expire = timer->expire;
+    int64_t delta  = expire - events->tick;
+    int     level  = 0;
+
+    if (delta < 0) {
+        expire = events->tick;
+        delta  = 0;
+    } else if (delta >= WHEEL_SPAN) {
+        expire = events->tick + WHEEL_SPAN - 1;
+        delta  = WHEEL_SPAN - 1;
+    }
+
+    while (level < WHEEL_LEVEL - 1 &&
+           delta >= ((int64_t) 1 << (WHEEL_BITS * (level + 1)))) {
+        level += 1;
+    }
+
+    timer_link(
+        &events->wheel[level][(expire >> (WHEEL_BITS * level)) & WHEEL_MASK],
+        timer);
+}
+
+// must be called with timer_mtx held
+static int cascade(neu_events_t *events, int level)
+{
+    int index = (int) ((events->tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+    struct neu_event_timer *list  = events->wheel[level][index];
+    struct neu_event_timer *timer = NULL;
+    struct neu_event_timer *tmp   = NULL;
+
+    events->wheel[level][index] = NULL;
+    DL_FOREACH_SAFE(list, timer, tmp)
+    {
+        DL_DELETE(list, timer);
+        timer->bucket = NULL;
+        wheel_insert(events, timer);
+    }
+
+    return index;
+}
+
+// earliest tick with an expiration or a cascade, -1 if the wheel is empty
+static int64_t wheel_next(neu_events_t *events)
+{
+    int64_t next = -1;
+
+    for (int i = 0; i < WHEEL_SIZE; i++) {
+        if (events->wheel[0][(events->tick + i) & WHEEL_MASK] != NULL) {
+            return events->tick + i;
+        }
+    }
+
+    for (int level = 1; level < WHEEL_LEVEL; level++) {
+        int64_t base = events->tick >> (WHEEL_BITS * level);
+
+        for (int i = 1; i <= WHEEL_SIZE; i++) {
+            if (events->wheel[level][(base + i) & WHEEL_MASK] != NULL) {
+                int64_t at = (base + i) << (WHEEL_BITS * level);
+
+                if (next < 0 || at < next) {
+                    next = at;
+                }
+                break;
+            }
+        }
+    }
+
+    return next;
+}
+
+// an empty wheel has nothing to cascade, skip the ticks it slept through
+static void wheel_catch_up(neu_events_t *events, int64_t now)
+{
+    if (events->tick < now && wheel_next(events) < 0) {
+        events->tick = now;
+    }
+}
+
+// move every timer due at or before `now` to the expired list
+static void wheel_advance(neu_events_t *events, int64_t now)
+{
+    wheel_catch_up(events, now);
+    while (events->tick <= now) {
+        int                     index = (int) (events->tick & WHEEL_MASK);
+        struct neu_event_timer *timer = NULL;
+        struct neu_event_timer *tmp   = NULL;
+
+        if (index == 0) {
+            for (int level = 1; level < WHEEL_LEVEL; level++) {
+                if (cascade(events, level) != 0) {
+                    break;
+                }
+            }
+        }
+
+        DL_FOREACH_SAFE(events->wheel[0][index], timer, tmp)
+        {
+            timer_unlink(timer);
+            timer_link(&events->expired, timer);
+        }
+
+        events->tick += 1;
+    }
+}
+
+static void timer_fd_arm(neu_events_t *events, int64_t tick)
+{
+    struct itimerspec value = { 0 };
+
+    if (tick >= 0) {
+        int64_t sec  = events->base.tv_sec + tick / 1000;
+        int64_t nsec = events->base.tv_nsec + (tick % 1000) * 1000000;
+
+        value.it_value.tv_sec  = sec + nsec / 1000000000;
+        value.it_value.tv_nsec = nsec % 1000000000;
+    }
+
+    events->armed = tick;
+    timerfd_settime(events->timer_fd, TFD_TIMER_ABSTIME, &value, NULL);
+}
+
+// must be called with timer_mtx held
+static void timer_schedule(neu_events_t *events, struct neu_event_timer *timer,
+                           int64_t now)
+{
+    if (timer->interval <= 0) {
+        timer_link(&events->idle, timer);
+        return;
+    }
+
+    if (timer->type == NEU_EVENT_TIMER_BLOCK) {
+        timer->expire = now + timer->interval;
+    } else {
+        // skip the periods missed while the callback was running
+        timer->expire += timer->interval;
+        if (timer->expire <= now) {
+            timer->expire +=
+                ((now - timer->expire) / timer->interval + 1) * timer->interval;
+        }
+    }
+
+    wheel_insert(events, timer);
+}
+
+static void timer_run(neu_events_t *events)
 {
+    struct neu_event_timer *timer = NULL;
+
+    pthread_mutex_lock(&events->timer_mtx);
+    wheel_advance(events, now_tick(events));
+
+    while ((timer = events->expired) != NULL && !events->stop) {
+        timer_unlink(timer);
+        events->running = timer;
+        pthread_mutex_unlock(&events->timer_mtx);
+
+        timer->cb(timer->usr_data);
+
+        pthread_mutex_lock(&events->timer_mtx);
+        events->running = NULL;
+        if (!timer->stop && timer->posted) {
+            timer->posted = false;
+            timer->expire = now_tick(events);
+            wheel_insert(events, timer);
+        } else if (!timer->stop) {
+            timer_schedule(events, timer, now_tick(events));
+        } else if (timer->detached) {
+            free(timer);
+        }
+        pthread_cond_broadcast(&events->timer_cond);
+    }
+
+    if (!events->stop) {
+        timer_fd_arm(events, wheel_next(events));
+    }
+    pthread_mutex_unlock(&events->timer_mtx);
+}
+
+static void io_run(neu_events_t *events, struct epoll_event *event)
+{
+    int                   index    = (int) (event->data.u64 & 0xffffffff);
+    uint32_t              gen      = (uint32_t)(event->data.u64 >> 32);
+    neu_event_io_callback cb       = NULL;
+    void *                usr_data = NULL;
+    int                   fd       = -1;
+
     pthread_mutex_lock(&events->mtx);
-    events->event_datas[index].use   = false;
-    events->event_datas[index].index = 0;
+    if (index < events->n_chunk * EVENT_CHUNK_SIZE) {
+        struct neu_event_io *io = io_slot(events, index);
+
+        // skip events of an io deleted earlier in the same batch
+        if (io->use && io->gen == gen) {
+            cb       = io->cb;
+            usr_data = io->usr_data;
+            fd       = io->fd;
+        }
+    }
     pthread_mutex_unlock(&events->mtx);
+
+    if (cb == NULL) {
+        return;
+    }
+
+    if ((event->events & EPOLLHUP) == EPOLLHUP) {
+        cb(NEU_EVENT_IO_HUP, fd, usr_data);
+        return;
+    }
+
+    if ((event->events & EPOLLRDHUP) == EPOLLRDHUP) {
+        cb(NEU_EVENT_IO_CLOSED, fd, usr_data);
+        return;
+    }
+
+    if ((event->events & EPOLLIN) == EPOLLIN) {
+        cb(NEU_EVENT_IO_READ, fd, usr_data);
+    }
 }
 
 static void *event_loop(void *arg)
 {
-    neu_events_t *events   = (neu_events_t *) arg;
-    int           epoll_fd = events->epoll_fd;
+    neu_events_t *     events   = (neu_events_t *) arg;
+    int                epoll_fd = events->epoll_fd;
+    struct epoll_event batch[EVENT_BATCH];
 
     while (!events->stop) {
-        struct epoll_event event = { 0 };
-        struct event_data *data  = NULL;
-
-        int ret = epoll_wait(epoll_fd, &event, 1, 1000);
+        int ret = epoll_wait(epoll_fd, batch, EVENT_BATCH, 1000);
         if (ret == 0) {
             continue;
         }
@@ -129,50 +432,17 @@ static void *event_loop(void *arg)
             break;
         }
 
-        data = (struct event_data *) event.data.ptr;
-
-        switch (data->type) {
-        case TIMER:
-            pthread_mutex_lock(&data->ctx.timer.mtx);
-            if ((event.events & EPOLLIN) == EPOLLIN) {
+        for (int i = 0; i < ret && !events->stop; i++) {
+            if (batch[i].data.u64 == EVENT_TIMER_KEY) {
                 uint64_t t;
 
-                ssize_t size = read(data->fd, &t, sizeof(t));
+                ssize_t size = read(events->timer_fd, &t, sizeof(t));
                 (void) size;
 
-                if (!data->ctx.timer.stop) {
-                    if (data->ctx.timer.type == NEU_EVENT_TIMER_BLOCK) {
-                        epoll_ctl(epoll_fd, EPOLL_CTL_DEL, data->fd, NULL);
-                        ret = data->callback.timer(data->usr_data);
-                        timerfd_settime(data->fd, 0, &data->ctx.timer.value,
-                                        NULL);
-                        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, data->fd, &event);
-                    } else {
-                        ret = data->callback.timer(data->usr_data);
-                    }
-                }
+                timer_run(events);
+            } else {
+                io_run(events, &batch[i]);
             }
-
-            pthread_mutex_unlock(&data->ctx.timer.mtx);
-            break;
-        case IO:
-            if ((event.events & EPOLLHUP) == EPOLLHUP) {
-                data->callback.io(NEU_EVENT_IO_HUP, data->fd, data->usr_data);
-                break;
-            }
-
-            if ((event.events & EPOLLRDHUP) == EPOLLRDHUP) {
-                data->callback.io(NEU_EVENT_IO_CLOSED, data->fd,
-                                  data->usr_data);
-                break;
-            }
-
-            if ((event.events & EPOLLIN) == EPOLLIN) {
-                data->callback.io(NEU_EVENT_IO_READ, data->fd, data->usr_data);
-                break;
-            }
-
-            break;
         }
     }
 
@@ -181,29 +451,79 @@ static void *event_loop(void *arg)
 
 neu_events_t *neu_event_new(const char *name)
 {
-    neu_events_t *events = calloc(1, sizeof(struct neu_events));
+    neu_events_t *     events = calloc(1, sizeof(struct neu_events));
+    struct epoll_event event  = {
+        .events   = EPOLLIN,
+        .data.u64 = EVENT_TIMER_KEY,
+    };
 
     events->log      = zlog_get_category(name);
     events->epoll_fd = epoll_create(1);
+    events->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK);
 
-    zlog_notice(events->log, "create epoll: %d(%d)", events->epoll_fd, errno);
+    zlog_notice(events->log, "create epoll: %d, timer: %d(%d)",
+                events->epoll_fd, events->timer_fd, errno);
     assert(events->epoll_fd > 0);
+    assert(events->timer_fd > 0);
+
+    epoll_ctl(events->epoll_fd, EPOLL_CTL_ADD, events->timer_fd, &event);
 
     events->stop    = false;
-    events->n_event = 0;
+    events->free_io = -1;
+    events->armed   = -1;
+    clock_gettime(CLOCK_MONOTONIC, &events->base);
     pthread_mutex_init(&events->mtx, NULL);
+    pthread_mutex_init(&events->timer_mtx, NULL);
+    pthread_cond_init(&events->timer_cond, NULL);
 
     pthread_create(&events->thread, NULL, event_loop, events);
 
     return events;
 };
 
+static void free_timers(struct neu_event_timer **bucket)
+{
+    struct neu_event_timer *timer = NULL;
+    struct neu_event_timer *tmp   = NULL;
+
+    DL_FOREACH_SAFE(*bucket, timer, tmp)
+    {
+        DL_DELETE(*bucket, timer);
+        free(timer);
+    }
+}
+
 int neu_event_close(neu_events_t *events)
 {
+    struct itimerspec wakeup = {
+        .it_value.tv_nsec = 1,
+    };
+
+    // wake the loop up through the timerfd so it sees the stop flag
+    pthread_mutex_lock(&events->timer_mtx);
     events->stop = true;
-    close(events->epoll_fd);
+    timerfd_settime(events->timer_fd, 0, &wakeup, NULL);
+    pthread_mutex_unlock(&events->timer_mtx);
 
     pthread_join(events->thread, NULL);
+    close(events->timer_fd);
+    close(events->epoll_fd);
+
+    for (int level = 0; level < WHEEL_LEVEL; level++) {
+        for (int i = 0; i < WHEEL_SIZE; i++) {
+            free_timers(&events->wheel[level][i]);
+        }
+    }
+    free_timers(&events->expired);
+    free_timers(&events->idle);
+
+    for (int i = 0; i < events->n_chunk; i++) {
+        free(events->chunks[i]);
+    }
+    free(events->chunks);
+
+    pthread_cond_destroy(&events->timer_cond);
+    pthread_mutex_destroy(&events->timer_mtx);
     pthread_mutex_destroy(&events->mtx);
 
     free(events);
@@ -213,102 +533,122 @@ int neu_event_close(neu_events_t *events)
 neu_event_timer_t *neu_event_add_timer(neu_events_t *          events,
                                        neu_event_timer_param_t timer)
 {
-    int               ret      = 0;
-    int               timer_fd = timerfd_create(CLOCK_MONOTONIC, 0);
-    struct itimerspec value    = {
-        .it_value.tv_sec     = timer.second,
-        .it_value.tv_nsec    = timer.millisecond * 1000 * 1000,
-        .it_interval.tv_sec  = timer.second,
-        .it_interval.tv_nsec = timer.millisecond * 1000 * 1000,
-    };
-    int index = get_free_event(events);
-    if (index < 0) {
-        zlog_fatal(events->log, "no free event: %d", events->epoll_fd);
-    }
-    assert(index >= 0);
-
-    neu_event_timer_t *timer_ctx = &events->event_datas[index].ctx.timer;
-    timer_ctx->event_data        = &events->event_datas[index];
-
-    struct epoll_event event = {
-        .events   = EPOLLIN,
-        .data.ptr = timer_ctx->event_data,
-    };
+    struct neu_event_timer *timer_ctx = calloc(1, sizeof(neu_event_timer_t));
 
-    timerfd_settime(timer_fd, 0, &value, NULL);
-
-    timer_ctx->event_data->type           = TIMER;
-    timer_ctx->event_data->fd             = timer_fd;
-    timer_ctx->event_data->usr_data       = timer.usr_data;
-    timer_ctx->event_data->callback.timer = timer.cb;
-    timer_ctx->event_data->ctx.timer = events->event_datas[index].ctx.timer;
-    timer_ctx->event_data->index     = index;
-
-    timer_ctx->value = value;
-    timer_ctx->fd    = timer_fd;
-    timer_ctx->type  = timer.type;
-    timer_ctx->stop  = false;
-    pthread_mutex_init(&timer_ctx->mtx, NULL);
+    if (timer_ctx == NULL) {
+        zlog_fatal(events->log, "no free timer: %d", events->epoll_fd);
+        return NULL;
+    }
 
-    ret = epoll_ctl(events->epoll_fd, EPOLL_CTL_ADD, timer_fd, &event);
+    timer_ctx->interval = timer.second * 1000 + timer.millisecond;
+    timer_ctx->type     = timer.type;
+    timer_ctx->cb       = timer.cb;
+    timer_ctx->usr_data = timer.usr_data;
+    timer_ctx->stop     = false;
+
+    pthread_mutex_lock(&events->timer_mtx);
+    if (timer_ctx->interval > 0) {
+        int64_t now = now_tick(events);
+
+        // timers are placed relative to the tick, which an idle loop leaves
+        // behind
+        wheel_catch_up(events, now);
+        timer_ctx->expire =
+            now + (timer.delay > 0 ? timer.delay : timer_ctx->interval);
+        wheel_insert(events, timer_ctx);
+
+        if (!events->stop &&
+            (events->armed < 0 || timer_ctx->expire < events->armed)) {
+            timer_fd_arm(events, timer_ctx->expire);
+        }
+    } else {
+        timer_link(&events->idle, timer_ctx);
+    }
+    pthread_mutex_unlock(&events->timer_mtx);
 
     zlog_notice(events->log,
                 "add timer, second: %" PRId64 ", millisecond: %" PRId64
-                ", timer: %d in epoll %d, "
-                "ret: %d, index: %d",
-                timer.second, timer.millisecond, timer_fd, events->epoll_fd,
-                ret, index);
+                ", type: %d in epoll %d",
+                timer.second, timer.millisecond, timer.type, events->epoll_fd);
 
     return timer_ctx;
 }
 
 int neu_event_del_timer(neu_events_t *events, neu_event_timer_t *timer)
 {
-    zlog_notice(events->log, "del timer: %d from epoll: %d, index: %d",
-                timer->fd, events->epoll_fd, timer->event_data->index);
+    zlog_notice(events->log, "del timer: %p from epoll: %d", (void *) timer,
+                events->epoll_fd);
 
+    pthread_mutex_lock(&events->timer_mtx);
     timer->stop = true;
-    epoll_ctl(events->epoll_fd, EPOLL_CTL_DEL, timer->fd, NULL);
+    timer_unlink(timer);
+
+    if (events->running == timer) {
+        if (pthread_equal(pthread_self(), events->thread)) {
+            timer->detached = true;
+            pthread_mutex_unlock(&events->timer_mtx);
+            return 0;
+        }
+
+        // wait for the running callback before releasing the timer
+        while (events->running == timer) {
+            pthread_cond_wait(&events->timer_cond, &events->timer_mtx);
+        }
+    }
+    pthread_mutex_unlock(&events->timer_mtx);
 
-    pthread_mutex_lock(&timer->mtx);
-    close(timer->fd);
-    pthread_mutex_unlock(&timer->mtx);
+    free(timer);
+    return 0;
+}
+
+int neu_event_post_timer(neu_events_t *events, neu_event_timer_t *timer)
+{
+    pthread_mutex_lock(&events->timer_mtx);
+    if (timer->stop || timer->interval <= 0 ||
+        timer->bucket == &events->expired) {
+        // deleted, idle or already due
+    } else if (events->running == timer) {
+        timer->posted = true;
+    } else {
+        int64_t now = now_tick(events);
+
+        timer_unlink(timer);
+        wheel_catch_up(events, now);
+        timer->expire = now;
+        wheel_insert(events, timer);
+
+        if (!events->stop && (events->armed < 0 || now < events->armed)) {
+            timer_fd_arm(events, now);
+        }
+    }
+    pthread_mutex_unlock(&events->timer_mtx);
 
-    pthread_mutex_destroy(&timer->mtx);
-    free_event(events, timer->event_data->index);
     return 0;
 }
 
 neu_event_io_t *neu_event_add_io(neu_events_t *events, neu_event_io_param_t io)
 {
-    int ret   = 0;
-    int index = get_free_event(events);
-
-    zlog_notice(events->log, "add io, fd: %d, epoll: %d, index: %d", io.fd,
-                events->epoll_fd, index);
-    assert(index >= 0);
-
-    neu_event_io_t *io_ctx   = &events->event_datas[index].ctx.io;
-    io_ctx->event_data       = &events->event_datas[index];
-    struct epoll_event event = {
-        .events   = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP,
-        .data.ptr = io_ctx->event_data,
-    };
+    int                ret    = 0;
+    neu_event_io_t *   io_ctx = get_free_io(events);
+    struct epoll_event event  = { 0 };
+
+    if (io_ctx == NULL) {
+        zlog_fatal(events->log, "no free event: %d", events->epoll_fd);
+    }
+    assert(io_ctx != NULL);
 
-    io_ctx->event_data->type        = IO;
-    io_ctx->event_data->fd          = io.fd;
-    io_ctx->event_data->usr_data    = io.usr_data;
-    io_ctx->event_data->callback.io = io.cb;
-    io_ctx->event_data->ctx.io      = events->event_datas[index].ctx.io;
-    io_ctx->event_data->index       = index;
+    io_ctx->fd       = io.fd;
+    io_ctx->cb       = io.cb;
+    io_ctx->usr_data = io.usr_data;
 
-    io_ctx->fd = io.fd;
+    event.events   = EPOLLIN | EPOLLERR | EPOLLHUP | EPOLLRDHUP;
+    event.data.u64 = io_key(io_ctx);
 
     ret = epoll_ctl(events->epoll_fd, EPOLL_CTL_ADD, io.fd, &event);
 
     zlog_notice(events->log,
                 "add io, fd: %d, epoll: %d, ret: %d(%d), index: %d", io.fd,
-                events->epoll_fd, ret, errno, index);
+                events->epoll_fd, ret, errno, io_ctx->index);
     assert(ret == 0);
 
     return io_ctx;
@@ -321,12 +661,12 @@ int neu_event_del_io(neu_events_t *events, neu_event_io_t *io)
     }
 
     zlog_notice(events->log, "del io: %d from epoll: %d, index: %d", io->fd,
-                events->epoll_fd, io->event_data->index);
+                events->epoll_fd, io->index);
 
     epoll_ctl(events->epoll_fd, EPOLL_CTL_DEL, io->fd, NULL);
-    free_event(events, io->event_data->index);
+    free_io(events, io);
 
     return 0;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -144,6 +144,14 @@ int neu_event_del_timer(neu_events_t *events, neu_event_timer_t *timer)
     return 0;
 }
 
+int neu_event_post_timer(neu_events_t *events, neu_event_timer_t *timer)
+{
+    (void) events;
+    (void) timer;
+    // kqueue timers can not be brought forward, the timer keeps its period
+    return -1;
+}
+
 neu_event_io_t *neu_event_add_io(neu_events_t *events, neu_event_io_param_t io)
 {
     (void) events;
@@ -0,0 +1,376 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "event/event.h"
+#include "event/sched.h"
+#include "utils/log.h"
+#include "utils/utlist.h"
+
+struct neu_sched_task {
+    neu_sched_t *            sched;
+    neu_sched_strand_t *     strand;
+    neu_event_timer_t *      timer;
+    neu_event_timer_callback cb;
+    void *                   usr_data;
+
+    bool      queued;
+    bool      running;
+    bool      deleted;
+    bool      detached;
+    pthread_t runner;
+
+    struct neu_sched_task *prev;
+    struct neu_sched_task *next;
+};
+
+struct neu_sched_strand {
+    pthread_mutex_t   mtx;
+    pthread_cond_t    cond;
+    neu_sched_task_t *tasks;
+    // queued on a worker or being run
+    bool scheduled;
+    int  home;
+
+    struct neu_sched_strand *prev;
+    struct neu_sched_strand *next;
+};
+
+struct sched_worker {
+    neu_sched_t *       sched;
+    int                 id;
+    pthread_t           thread;
+    pthread_mutex_t     mtx;
+    neu_sched_strand_t *deque;
+};
+
+struct neu_sched {
+    zlog_category_t *log;
+    neu_events_t *   events;
+
+    int                  n_worker;
+    struct sched_worker *workers;
+
+    pthread_mutex_t mtx;
+    pthread_cond_t  cond;
+    int             pending;
+    int             next_home;
+    bool            stop;
+};
+
+static void submit(neu_sched_t *sched, neu_sched_strand_t *strand, int worker)
+{
+    struct sched_worker *w = &sched->workers[worker];
+
+    pthread_mutex_lock(&w->mtx);
+    DL_APPEND(w->deque, strand);
+    pthread_mutex_unlock(&w->mtx);
+
+    pthread_mutex_lock(&sched->mtx);
+    sched->pending += 1;
+    pthread_cond_signal(&sched->cond);
+    pthread_mutex_unlock(&sched->mtx);
+}
+
+static neu_sched_strand_t *take(struct sched_worker *w)
+{
+    neu_sched_t *       sched  = w->sched;
+    neu_sched_strand_t *strand = NULL;
+
+    pthread_mutex_lock(&w->mtx);
+    if (w->deque != NULL) {
+        strand = w->deque;
+        DL_DELETE(w->deque, strand);
+    }
+    pthread_mutex_unlock(&w->mtx);
+
+    // the owner takes the oldest strand from the head, steal the newest one
+    // from the tail of another worker
+    for (int i = 1; strand == NULL && i < sched->n_worker; i++) {
+        struct sched_worker *victim =
+            &sched->workers[(w->id + i) % sched->n_worker];
+
+        pthread_mutex_lock(&victim->mtx);
+        if (victim->deque != NULL) {
+            strand = victim->deque->prev;
+            DL_DELETE(victim->deque, strand);
+        }
+        pthread_mutex_unlock(&victim->mtx);
+    }
+
+    if (strand != NULL) {
+        pthread_mutex_lock(&sched->mtx);
+        sched->pending -= 1;
+        pthread_mutex_unlock(&sched->mtx);
+    }
+
+    return strand;
+}
+
+// run one task of the strand, then requeue the strand if it has more work
+static void run_strand(struct sched_worker *w, neu_sched_strand_t *strand)
+{
+    neu_sched_task_t *task = NULL;
+
+    pthread_mutex_lock(&strand->mtx);
+    task = strand->tasks;
+    if (task != NULL) {
+        DL_DELETE(strand->tasks, task);
+        task->queued  = false;
+        task->running = true;
+        task->runner  = pthread_self();
+        pthread_mutex_unlock(&strand->mtx);
+
+        task->cb(task->usr_data);
+
+        pthread_mutex_lock(&strand->mtx);
+        task->running = false;
+        if (task->detached) {
+            free(task);
+        }
+        pthread_cond_broadcast(&strand->cond);
+    }
+
+    if (strand->tasks != NULL) {
+        pthread_mutex_unlock(&strand->mtx);
+        submit(w->sched, strand, w->id);
+        return;
+    }
+
+    strand->scheduled = false;
+    pthread_cond_broadcast(&strand->cond);
+    pthread_mutex_unlock(&strand->mtx);
+}
+
+static void *worker_loop(void *arg)
+{
+    struct sched_worker *w     = (struct sched_worker *) arg;
+    neu_sched_t *        sched = w->sched;
+
+    while (true) {
+        neu_sched_strand_t *strand = take(w);
+
+        if (strand != NULL) {
+            run_strand(w, strand);
+            continue;
+        }
+
+        pthread_mutex_lock(&sched->mtx);
+        while (sched->pending == 0 && !sched->stop) {
+            pthread_cond_wait(&sched->cond, &sched->mtx);
+        }
+        if (sched->stop && sched->pending == 0) {
+            pthread_mutex_unlock(&sched->mtx);
+            break;
+        }
+        pthread_mutex_unlock(&sched->mtx);
+    }
+
+    return NULL;
+}
+
+static void post(neu_sched_task_t *task, bool skip_running)
+{
+    neu_sched_strand_t *strand = task->strand;
+    bool                wake   = false;
+
+    pthread_mutex_lock(&strand->mtx);
+    if (!task->deleted && !task->queued &&
+        !(skip_running && task->running)) {
+        DL_APPEND(strand->tasks, task);
+        task->queued = true;
+        if (!strand->scheduled) {
+            strand->scheduled = true;
+            wake              = true;
+        }
+    }
+    pthread_mutex_unlock(&strand->mtx);
+
+    if (wake) {
+        submit(task->sched, strand, strand->home);
+    }
+}
+
+// timer callback, runs on the timer loop and only queues the task
+static int task_fire(void *usr_data)
+{
+    post((neu_sched_task_t *) usr_data, true);
+    return 0;
+}
+
+neu_sched_t *neu_sched_new(const char *name, int n_worker)
+{
+    neu_sched_t *sched = calloc(1, sizeof(neu_sched_t));
+
+    if (n_worker <= 0) {
+        n_worker = (int) sysconf(_SC_NPROCESSORS_ONLN);
+        if (n_worker <= 0) {
+            n_worker = 1;
+        }
+    }
+
+    sched->log      = zlog_get_category(name);
+    sched->events   = neu_event_new(name);
+    sched->n_worker = n_worker;
+    sched->workers  = calloc(n_worker, sizeof(struct sched_worker));
+    pthread_mutex_init(&sched->mtx, NULL);
+    pthread_cond_init(&sched->cond, NULL);
+
+    for (int i = 0; i < n_worker; i++) {
+        sched->workers[i].sched = sched;
+        sched->workers[i].id    = i;
+        pthread_mutex_init(&sched->workers[i].mtx, NULL);
+        pthread_create(&sched->workers[i].thread, NULL, worker_loop,
+                       &sched->workers[i]);
+    }
+
+    zlog_notice(sched->log, "create scheduler with %d workers", n_worker);
+    return sched;
+}
+
+void neu_sched_close(neu_sched_t *sched)
+{
+    neu_event_close(sched->events);
+
+    pthread_mutex_lock(&sched->mtx);
+    sched->stop = true;
+    pthread_cond_broadcast(&sched->cond);
+    pthread_mutex_unlock(&sched->mtx);
+
+    for (int i = 0; i < sched->n_worker; i++) {
+        pthread_join(sched->workers[i].thread, NULL);
+        pthread_mutex_destroy(&sched->workers[i].mtx);
+    }
+
+    pthread_cond_destroy(&sched->cond);
+    pthread_mutex_destroy(&sched->mtx);
+    free(sched->workers);
+    free(sched);
+}
+
+int neu_sched_worker_num(neu_sched_t *sched)
+{
+    return sched->n_worker;
+}
+
+neu_sched_strand_t *neu_sched_strand_new(neu_sched_t *sched)
+{
+    neu_sched_strand_t *strand = calloc(1, sizeof(neu_sched_strand_t));
+
+    pthread_mutex_init(&strand->mtx, NULL);
+    pthread_cond_init(&strand->cond, NULL);
+
+    pthread_mutex_lock(&sched->mtx);
+    strand->home     = sched->next_home;
+    sched->next_home = (sched->next_home + 1) % sched->n_worker;
+    pthread_mutex_unlock(&sched->mtx);
+
+    return strand;
+}
+
+void neu_sched_strand_free(neu_sched_t *sched, neu_sched_strand_t *strand)
+{
+    (void) sched;
+
+    // a worker may still hold the strand after its last task was deleted
+    pthread_mutex_lock(&strand->mtx);
+    while (strand->scheduled) {
+        pthread_cond_wait(&strand->cond, &strand->mtx);
+    }
+    pthread_mutex_unlock(&strand->mtx);
+
+    pthread_cond_destroy(&strand->cond);
+    pthread_mutex_destroy(&strand->mtx);
+    free(strand);
+}
+
+neu_sched_task_t *neu_sched_add_timer(neu_sched_t *           sched,
+                                      neu_sched_strand_t *    strand,
+                                      neu_event_timer_param_t timer)
+{
+    neu_sched_task_t *task = calloc(1, sizeof(neu_sched_task_t));
+
+    task->sched    = sched;
+    task->strand   = strand;
+    task->cb       = timer.cb;
+    task->usr_data = timer.usr_data;
+
+    timer.cb       = task_fire;
+    timer.usr_data = task;
+    timer.type     = NEU_EVENT_TIMER_NOBLOCK;
+    task->timer    = neu_event_add_timer(sched->events, timer);
+
+    return task;
+}
+
+neu_sched_task_t *neu_sched_add_task(neu_sched_t *            sched,
+                                     neu_sched_strand_t *     strand,
+                                     neu_event_timer_callback cb,
+                                     void *                   usr_data)
+{
+    neu_sched_task_t *task = calloc(1, sizeof(neu_sched_task_t));
+
+    task->sched    = sched;
+    task->strand   = strand;
+    task->cb       = cb;
+    task->usr_data = usr_data;
+
+    return task;
+}
+
+void neu_sched_post(neu_sched_task_t *task)
+{
+    // a posted task may run again right after the current run
+    post(task, false);
+}
+
+int neu_sched_del_task(neu_sched_t *sched, neu_sched_task_t *task)
+{
+    neu_sched_strand_t *strand = task->strand;
+
+    if (task->timer != NULL) {
+        neu_event_del_timer(sched->events, task->timer);
+    }
+
+    pthread_mutex_lock(&strand->mtx);
+    task->deleted = true;
+    if (task->queued) {
+        DL_DELETE(strand->tasks, task);
+        task->queued = false;
+    }
+
+    if (task->running) {
+        if (pthread_equal(task->runner, pthread_self())) {
+            task->detached = true;
+            pthread_mutex_unlock(&strand->mtx);
+            return 0;
+        }
+
+        while (task->running) {
+            pthread_cond_wait(&strand->cond, &strand->mtx);
+        }
+    }
+    pthread_mutex_unlock(&strand->mtx);
+
+    free(task);
+    return 0;
+}
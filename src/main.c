@@ -27,7 +27,10 @@
 #include <sys/wait.h>
 #include <unistd.h>
 
+#include "adapter/driver/tick.h"
+#include "adapter/msg_q.h"
 #include "core/manager.h"
+#include "event/sched.h"
 #include "modbus_tcp_simulator.h"
 #include "utils/log.h"
 #include "utils/time.h"
@@ -36,14 +39,18 @@
 #include "daemon.h"
 #include "version.h"
 
-static bool      exit_flag         = false;
-neu_manager_t *  g_manager         = NULL;
-zlog_category_t *neuron            = NULL;
-bool             sub_filter_err    = false;
-int              default_log_level = ZLOG_LEVEL_NOTICE;
-char             host_port[32]     = { 0 };
-char             g_status[32]      = { 0 };
-static bool      sig_trigger       = false;
+static bool            exit_flag         = false;
+neu_manager_t *        g_manager         = NULL;
+neu_sched_t *          g_sched           = NULL;
+adapter_msg_q_policy_e g_msg_q_policy    = ADAPTER_MSG_Q_DROP_NEWEST;
+uint32_t               g_group_phases    = 1;
+neu_driver_deadline_e  g_group_deadline  = NEU_DRIVER_DEADLINE_DRIFT;
+zlog_category_t *      neuron            = NULL;
+bool                   sub_filter_err    = false;
+int                    default_log_level = ZLOG_LEVEL_NOTICE;
+char                   host_port[32]     = { 0 };
+char                   g_status[32]      = { 0 };
+static bool            sig_trigger       = false;
 
 int64_t global_timestamp = 0;
 
@@ -149,6 +156,10 @@ static int neuron_run(const neu_cli_args_t *args)
     zlog_notice(neuron, "neuron start, daemon: %d, version: %s (%s %s)",
                 args->daemonized, NEURON_VERSION,
                 NEURON_GIT_REV NEURON_GIT_DIFF, NEURON_BUILD_DATE);
+    if (args->scheduler >= 0) {
+        g_sched = neu_sched_new("scheduler", args->scheduler);
+    }
+
     g_manager = neu_manager_create();
     if (g_manager == NULL) {
         nlog_fatal("neuron process failed to create neuron manager, exit!");
@@ -179,8 +190,11 @@ int main(int argc, char *argv[])
         return rv;
     }
 
-    disable_jwt    = args.disable_auth;
-    sub_filter_err = args.sub_filter_err;
+    disable_jwt      = args.disable_auth;
+    sub_filter_err   = args.sub_filter_err;
+    g_msg_q_policy   = args.msg_q_policy;
+    g_group_phases   = args.group_phases;
+    g_group_deadline = args.group_deadline;
     snprintf(host_port, sizeof(host_port), "http://%s:%d", args.ip, args.port);
 
     if (args.daemonized) {
@@ -50,6 +50,11 @@ int neu_json_encode_add_group_config_req(void *json_object, void *param)
                                         .name = "interval",
                                         .t    = NEU_JSON_INT,
                                         .v.val_int = req->interval,
+                                    },
+                                    {
+                                        .name = "aggregate",
+                                        .t    = NEU_JSON_INT,
+                                        .v.val_int = req->aggregate,
                                     } };
     ret = neu_json_encode_field(json_object, req_elems,
                                 NEU_JSON_ELEM_SIZE(req_elems));
@@ -69,27 +74,35 @@ int neu_json_decode_add_group_config_req(
 
     json_obj = neu_json_decode_new(buf);
 
-    neu_json_elem_t req_elems[] = { {
-                                        .name = "node",
-                                        .t    = NEU_JSON_STR,
-                                    },
-                                    {
-                                        .name = "group",
-                                        .t    = NEU_JSON_STR,
-                                    },
-                                    {
-                                        .name = "interval",
-                                        .t    = NEU_JSON_INT,
-                                    } };
+    neu_json_elem_t req_elems[] = {
+        {
+            .name = "node",
+            .t    = NEU_JSON_STR,
+        },
+        {
+            .name = "group",
+            .t    = NEU_JSON_STR,
+        },
+        {
+            .name = "interval",
+            .t    = NEU_JSON_INT,
+        },
+        {
+            .name      = "aggregate",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+    };
     ret = neu_json_decode_by_json(json_obj, NEU_JSON_ELEM_SIZE(req_elems),
                                   req_elems);
     if (ret != 0) {
         goto decode_fail;
     }
 
-    req->node     = req_elems[0].v.val_str;
-    req->group    = req_elems[1].v.val_str;
-    req->interval = req_elems[2].v.val_int;
+    req->node      = req_elems[0].v.val_str;
+    req->group     = req_elems[1].v.val_str;
+    req->interval  = req_elems[2].v.val_int;
+    req->aggregate = req_elems[3].v.val_int;
 
     *result = req;
     goto decode_exit;
@@ -211,6 +224,11 @@ int neu_json_encode_get_group_config_resp(void *json_object, void *param)
                 .name      = "interval",
                 .t         = NEU_JSON_INT,
                 .v.val_int = p_group_config->interval,
+            },
+            {
+                .name      = "aggregate",
+                .t         = NEU_JSON_INT,
+                .v.val_int = p_group_config->aggregate,
             }
         };
         group_config_array =
@@ -672,6 +690,14 @@ int neu_json_encode_update_group_config_req(void *json_object, void *param)
         };
         ret = neu_json_encode_field(json_object, &interval_elem, 1);
     }
+    if (0 == ret && req->set_aggregate) {
+        neu_json_elem_t aggregate_elem = {
+            .name      = "aggregate",
+            .t         = NEU_JSON_INT,
+            .v.val_int = req->aggregate,
+        };
+        ret = neu_json_encode_field(json_object, &aggregate_elem, 1);
+    }
     return ret;
 }
 
@@ -723,8 +749,20 @@ int neu_json_decode_update_group_config_req(
         }
         req->set_interval = true;
         req->interval     = json_integer_value(json_interval);
-    } else if (NULL == req->new_name) {
-        // at least one of `new_name` or `interval` should be provided
+    }
+
+    json_t *json_aggregate = json_object_get(json_obj, "aggregate");
+    if (NULL != json_aggregate) {
+        if (!json_is_integer(json_aggregate)) {
+            nlog_error("decode aggregate is not integer");
+            goto error;
+        }
+        req->set_aggregate = true;
+        req->aggregate     = json_integer_value(json_aggregate);
+    }
+
+    // at least one of `new_name`, `interval` or `aggregate` should be provided
+    if (NULL == req->new_name && !req->set_interval && !req->set_aggregate) {
         goto error;
     }
 
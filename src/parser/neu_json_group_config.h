@@ -35,6 +35,7 @@ typedef struct {
     char *  group;
     char *  node;
     int64_t interval;
+    int64_t aggregate; // see neu_req_add_group_t, optional
 } neu_json_add_group_config_req_t, neu_json_update_group_req_t;
 
 int neu_json_encode_add_group_config_req(void *json_object, void *param);
@@ -49,6 +50,8 @@ typedef struct {
     char *  new_name;
     bool    set_interval;
     int64_t interval;
+    bool    set_aggregate;
+    int64_t aggregate;
 } neu_json_update_group_config_req_t;
 
 int neu_json_encode_update_group_config_req(void *json_object, void *param);
@@ -72,6 +75,7 @@ typedef struct {
     char *  name;
     int64_t interval;
     int64_t tag_count;
+    int64_t aggregate;
 } neu_json_get_group_config_resp_group_config_t;
 
 typedef struct {
@@ -35,6 +35,60 @@
 
 #include "json/neu_json_rw.h"
 
+static void *encode_history(const neu_tag_history_t *history)
+{
+    void *          object   = neu_json_encode_new();
+    neu_json_elem_t elems[6] = { 0 };
+    int             n_elem   = 1;
+
+    elems[0].name      = "count";
+    elems[0].t         = NEU_JSON_INT;
+    elems[0].v.val_int = history->count;
+
+    if (history->count > 0) {
+        char *       names[]  = { "min", "max", "avg", "last" };
+        const double values[] = { history->min, history->max, history->avg,
+                                  history->last };
+
+        for (int i = 0; i < 4; i++) {
+            elems[n_elem].name         = names[i];
+            elems[n_elem].t            = NEU_JSON_DOUBLE;
+            elems[n_elem].v.val_double = values[i];
+            n_elem += 1;
+        }
+    }
+
+    if (history->samples != NULL) {
+        void *samples = neu_json_array();
+
+        for (uint32_t i = 0; i < history->n_sample; i++) {
+            neu_json_elem_t sample_elems[] = {
+                {
+                    .name      = "timestamp",
+                    .t         = NEU_JSON_INT,
+                    .v.val_int = history->samples[i].timestamp,
+                },
+                {
+                    .name         = "value",
+                    .t            = NEU_JSON_DOUBLE,
+                    .v.val_double = history->samples[i].value,
+                },
+            };
+
+            samples = neu_json_encode_array(samples, sample_elems,
+                                            NEU_JSON_ELEM_SIZE(sample_elems));
+        }
+
+        elems[n_elem].name         = "samples";
+        elems[n_elem].t            = NEU_JSON_OBJECT;
+        elems[n_elem].v.val_object = samples;
+        n_elem += 1;
+    }
+
+    neu_json_encode_field(object, elems, n_elem);
+    return object;
+}
+
 int neu_json_encode_read_resp(void *json_object, void *param)
 {
     int                   ret  = 0;
@@ -43,8 +97,9 @@ int neu_json_encode_read_resp(void *json_object, void *param)
     void *                    tag_array = neu_json_array();
     neu_json_read_resp_tag_t *p_tag     = resp->tags;
     for (int i = 0; i < resp->n_tag; i++) {
-        neu_json_elem_t tag_elems[2 + NEU_TAG_META_SIZE] = { 0 };
+        neu_json_elem_t tag_elems[4 + NEU_TAG_META_SIZE] = { 0 };
         int             if_precision                     = 0;
+        int             n_elem                           = 0;
 
         tag_elems[0].name      = "name";
         tag_elems[0].t         = NEU_JSON_STR;
@@ -76,8 +131,15 @@ int neu_json_encode_read_resp(void *json_object, void *param)
             tag_elems[if_precision + 2 + k].v    = p_tag->metas[k].value;
         }
 
-        tag_array = neu_json_encode_array(tag_array, tag_elems,
-                                          2 + if_precision + p_tag->n_meta);
+        n_elem = 2 + if_precision + p_tag->n_meta;
+        if (p_tag->history != NULL) {
+            tag_elems[n_elem].name         = "history";
+            tag_elems[n_elem].t            = NEU_JSON_OBJECT;
+            tag_elems[n_elem].v.val_object = encode_history(p_tag->history);
+            n_elem += 1;
+        }
+
+        tag_array = neu_json_encode_array(tag_array, tag_elems, n_elem);
         p_tag++;
     }
 
@@ -818,6 +880,11 @@ int neu_json_decode_read_req(char *buf, neu_json_read_req_t **result)
             .v.val_array_str.length = 0,
             .v.val_array_str.p_strs = NULL,
         },
+        {
+            .name      = "history",
+            .t         = NEU_JSON_OBJECT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
     };
 
     neu_json_elem_t query_elems[] = {
@@ -833,6 +900,29 @@ int neu_json_decode_read_req(char *buf, neu_json_read_req_t **result)
         },
     };
 
+    neu_json_elem_t history_elems[] = {
+        {
+            .name      = "last",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "from",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "to",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "aggregate",
+            .t         = NEU_JSON_BOOL,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+    };
+
     ret = neu_json_decode_by_json(json_obj, NEU_JSON_ELEM_SIZE(req_elems),
                                   req_elems);
     if (ret != 0) {
@@ -856,6 +946,22 @@ int neu_json_decode_read_req(char *buf, neu_json_read_req_t **result)
         req->desc = query_elems[1].v.val_str;
     }
 
+    if (req_elems[5].v.val_object) {
+        ret = neu_json_decode_by_json(req_elems[5].v.val_object,
+                                      NEU_JSON_ELEM_SIZE(history_elems),
+                                      history_elems);
+        if (ret != 0 || history_elems[0].v.val_int < 0 ||
+            history_elems[0].v.val_int > NEU_TAG_WINDOW_DEPTH_MAX) {
+            ret = -1;
+            goto error;
+        }
+        req->history                 = true;
+        req->history_query.last      = history_elems[0].v.val_int;
+        req->history_query.from      = history_elems[1].v.val_int;
+        req->history_query.to        = history_elems[2].v.val_int;
+        req->history_query.aggregate = history_elems[3].v.val_bool;
+    }
+
     *result = req;
     neu_json_decode_free(json_obj);
     return ret;
@@ -89,6 +89,36 @@ int neu_json_encode_tag(void *json_obj, void *param)
             .t         = NEU_JSON_STR,
             .v.val_str = tag->unit,
         },
+        {
+            .name         = "deadband",
+            .t            = NEU_JSON_DOUBLE,
+            .v.val_double = tag->deadband,
+        },
+        {
+            .name         = "deadband_percent",
+            .t            = NEU_JSON_DOUBLE,
+            .v.val_double = tag->deadband_percent,
+        },
+        {
+            .name      = "min_interval",
+            .t         = NEU_JSON_INT,
+            .v.val_int = tag->min_interval,
+        },
+        {
+            .name      = "max_interval",
+            .t         = NEU_JSON_INT,
+            .v.val_int = tag->max_interval,
+        },
+        {
+            .name      = "window_depth",
+            .t         = NEU_JSON_INT,
+            .v.val_int = tag->window_depth,
+        },
+        {
+            .name      = "window_duration",
+            .t         = NEU_JSON_INT,
+            .v.val_int = tag->window_duration,
+        },
     };
 
     ret = neu_json_encode_field(json_obj, tag_elems,
@@ -150,6 +180,36 @@ int neu_json_decode_tag_json(void *json_obj, neu_json_tag_t *tag_p)
             .t         = NEU_JSON_STR,
             .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
         },
+        {
+            .name      = "deadband",
+            .t         = NEU_JSON_DOUBLE,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "deadband_percent",
+            .t         = NEU_JSON_DOUBLE,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "min_interval",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "max_interval",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "window_depth",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "window_duration",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
     };
 
     int ret = neu_json_decode_by_json(json_obj, NEU_JSON_ELEM_SIZE(tag_elems),
@@ -157,17 +217,23 @@ int neu_json_decode_tag_json(void *json_obj, neu_json_tag_t *tag_p)
 
     // set the fields before check for easy clean up on error
     neu_json_tag_t tag = {
-        .type        = tag_elems[0].v.val_int,
-        .name        = tag_elems[1].v.val_str,
-        .attribute   = tag_elems[2].v.val_int,
-        .address     = tag_elems[3].v.val_str,
-        .decimal     = tag_elems[4].v.val_double,
-        .precision   = tag_elems[5].v.val_int,
-        .description = tag_elems[6].v.val_str,
-        .t           = tag_elems[7].t,
-        .value       = tag_elems[7].v,
-        .bias        = tag_elems[8].v.val_double,
-        .unit        = tag_elems[9].v.val_str,
+        .type             = tag_elems[0].v.val_int,
+        .name             = tag_elems[1].v.val_str,
+        .attribute        = tag_elems[2].v.val_int,
+        .address          = tag_elems[3].v.val_str,
+        .decimal          = tag_elems[4].v.val_double,
+        .precision        = tag_elems[5].v.val_int,
+        .description      = tag_elems[6].v.val_str,
+        .t                = tag_elems[7].t,
+        .value            = tag_elems[7].v,
+        .bias             = tag_elems[8].v.val_double,
+        .unit             = tag_elems[9].v.val_str,
+        .deadband         = tag_elems[10].v.val_double,
+        .deadband_percent = tag_elems[11].v.val_double,
+        .min_interval     = tag_elems[12].v.val_int,
+        .max_interval     = tag_elems[13].v.val_int,
+        .window_depth     = tag_elems[14].v.val_int,
+        .window_duration  = tag_elems[15].v.val_int,
     };
 
     if (0 != ret) {
@@ -178,6 +244,17 @@ int neu_json_decode_tag_json(void *json_obj, neu_json_tag_t *tag_p)
         goto decode_fail;
     }
 
+    if (tag.deadband < 0 || tag.deadband_percent < 0 || tag.min_interval < 0 ||
+        tag.min_interval > UINT32_MAX || tag.max_interval < 0 ||
+        tag.max_interval > UINT32_MAX) {
+        goto decode_fail;
+    }
+
+    if (tag.window_depth < 0 || tag.window_depth > NEU_TAG_WINDOW_DEPTH_MAX ||
+        tag.window_duration < 0 || tag.window_duration > UINT32_MAX) {
+        goto decode_fail;
+    }
+
     *tag_p = tag;
     return 0;
 
@@ -203,6 +280,43 @@ int neu_json_tag_check_type(neu_json_tag_t *tag)
     return NEU_JSON_UNDEFINE == tag->t;
 }
 
+neu_tag_deadband_t neu_json_tag_get_deadband(const neu_json_tag_t *tag)
+{
+    neu_tag_deadband_t deadband = {
+        .absolute     = tag->deadband,
+        .percent      = tag->deadband_percent,
+        .min_interval = (uint32_t) tag->min_interval,
+        .max_interval = (uint32_t) tag->max_interval,
+    };
+
+    return deadband;
+}
+
+void neu_json_tag_set_deadband(neu_json_tag_t *          tag,
+                               const neu_tag_deadband_t *deadband)
+{
+    tag->deadband         = deadband->absolute;
+    tag->deadband_percent = deadband->percent;
+    tag->min_interval     = deadband->min_interval;
+    tag->max_interval     = deadband->max_interval;
+}
+
+neu_tag_window_t neu_json_tag_get_window(const neu_json_tag_t *tag)
+{
+    neu_tag_window_t window = {
+        .depth    = (uint32_t) tag->window_depth,
+        .duration = (uint32_t) tag->window_duration,
+    };
+
+    return window;
+}
+
+void neu_json_tag_set_window(neu_json_tag_t *tag, const neu_tag_window_t *window)
+{
+    tag->window_depth    = window->depth;
+    tag->window_duration = window->duration;
+}
+
 int neu_json_encode_tag_array(void *json_obj, void *param)
 {
     neu_json_tag_array_t *array = param;
@@ -26,6 +26,7 @@
 #define _NEU_JSON_API_NEU_JSON_TAG_H_
 
 #include "json/json.h"
+#include "tag.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -43,6 +44,12 @@ typedef struct {
     neu_json_type_e  t;
     neu_json_value_u value;
     char *           unit;
+    double           deadband;
+    double           deadband_percent;
+    int64_t          min_interval;
+    int64_t          max_interval;
+    int64_t          window_depth;
+    int64_t          window_duration;
 } neu_json_tag_t;
 
 int  neu_json_encode_tag(void *json_obj, void *param);
@@ -50,6 +57,13 @@ int  neu_json_decode_tag_json(void *json_obj, neu_json_tag_t *tag_p);
 void neu_json_decode_tag_fini(neu_json_tag_t *tag);
 int  neu_json_tag_check_type(neu_json_tag_t *tag);
 
+neu_tag_deadband_t neu_json_tag_get_deadband(const neu_json_tag_t *tag);
+void neu_json_tag_set_deadband(neu_json_tag_t *          tag,
+                               const neu_tag_deadband_t *deadband);
+neu_tag_window_t   neu_json_tag_get_window(const neu_json_tag_t *tag);
+void               neu_json_tag_set_window(neu_json_tag_t *        tag,
+                                           const neu_tag_window_t *window);
+
 typedef struct {
     int             len;
     neu_json_tag_t *tags;
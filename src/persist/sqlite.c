@@ -626,11 +626,16 @@ int neu_sqlite_persister_store_tag(neu_persister_t *    self,
         ((neu_sqlite_persister_t *) self)->db,
         "INSERT INTO tags ("
         " driver_name, group_name, name, address, attribute,"
-        " precision, type, decimal, bias, description, value, format, unit"
-        ") VALUES (%Q, %Q, %Q, %Q, %i, %i, %i, %lf, %lf, %Q, %Q, %Q, %Q)",
+        " precision, type, decimal, bias, description, value, format, unit,"
+        " deadband, deadband_percent, min_interval, max_interval,"
+        " window_depth, window_duration"
+        ") VALUES (%Q, %Q, %Q, %Q, %i, %i, %i, %lf, %lf, %Q, %Q, %Q, %Q,"
+        " %lf, %lf, %u, %u, %u, %u)",
         driver_name, group_name, tag->name, tag->address, tag->attribute,
         tag->precision, tag->type, tag->decimal, tag->bias, tag->description,
-        "", format_buf, tag->unit);
+        "", format_buf, tag->unit, tag->deadband.absolute,
+        tag->deadband.percent, tag->deadband.min_interval,
+        tag->deadband.max_interval, tag->window.depth, tag->window.duration);
 
     return rv;
 }
@@ -715,6 +720,25 @@ static int put_tags(sqlite3 *db, const char *query, sqlite3_stmt *stmt,
             return -1;
         }
 
+        if (SQLITE_OK !=
+                sqlite3_bind_double(stmt, 14, tag->deadband.absolute) ||
+            SQLITE_OK != sqlite3_bind_double(stmt, 15, tag->deadband.percent) ||
+            SQLITE_OK !=
+                sqlite3_bind_int64(stmt, 16, tag->deadband.min_interval) ||
+            SQLITE_OK !=
+                sqlite3_bind_int64(stmt, 17, tag->deadband.max_interval)) {
+            nlog_error("bind `%s` with deadband fail: %s", query,
+                       sqlite3_errmsg(db));
+            return -1;
+        }
+
+        if (SQLITE_OK != sqlite3_bind_int64(stmt, 18, tag->window.depth) ||
+            SQLITE_OK != sqlite3_bind_int64(stmt, 19, tag->window.duration)) {
+            nlog_error("bind `%s` with window fail: %s", query,
+                       sqlite3_errmsg(db));
+            return -1;
+        }
+
         if (SQLITE_DONE != sqlite3_step(stmt)) {
             nlog_error("sqlite3_step fail: %s", sqlite3_errmsg(db));
             return -1;
@@ -735,8 +759,11 @@ int neu_sqlite_persister_store_tags(neu_persister_t *    self,
     const char *  query =
         "INSERT INTO tags ("
         " driver_name, group_name, name, address, attribute,"
-        " precision, type, decimal, bias, description, value, format, unit"
-        ") VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13)";
+        " precision, type, decimal, bias, description, value, format, unit,"
+        " deadband, deadband_percent, min_interval, max_interval,"
+        " window_depth, window_duration"
+        ") VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13,"
+        " ?14, ?15, ?16, ?17, ?18, ?19)";
 
     if (SQLITE_OK != sqlite3_exec(persister->db, "BEGIN", NULL, NULL, NULL)) {
         nlog_error("begin transaction fail: %s", sqlite3_errmsg(persister->db));
@@ -798,6 +825,16 @@ static int collect_tag_info(sqlite3_stmt *stmt, UT_array **tags)
             .bias        = sqlite3_column_double(stmt, 6),
             .description = (char *) sqlite3_column_text(stmt, 7),
             .unit        = (char *) sqlite3_column_text(stmt, 10),
+            .deadband    = {
+                .absolute     = sqlite3_column_double(stmt, 11),
+                .percent      = sqlite3_column_double(stmt, 12),
+                .min_interval = (uint32_t) sqlite3_column_int64(stmt, 13),
+                .max_interval = (uint32_t) sqlite3_column_int64(stmt, 14),
+            },
+            .window      = {
+                .depth    = (uint32_t) sqlite3_column_int64(stmt, 15),
+                .duration = (uint32_t) sqlite3_column_int64(stmt, 16),
+            },
         };
 
         tag.n_format = neu_format_from_str(format, tag.format);
@@ -822,7 +859,9 @@ int neu_sqlite_persister_load_tags(neu_persister_t *self,
 
     sqlite3_stmt *stmt  = NULL;
     const char *  query = "SELECT name, address, attribute, precision, type, "
-                        "decimal, bias, description, value, format, unit "
+                        "decimal, bias, description, value, format, unit, "
+                        "deadband, deadband_percent, min_interval, "
+                        "max_interval, window_depth, window_duration "
                         "FROM tags WHERE driver_name=? AND group_name=? "
                         "ORDER BY rowid ASC";
 
@@ -870,11 +909,16 @@ int neu_sqlite_persister_update_tag(neu_persister_t *    self,
         execute_sql(((neu_sqlite_persister_t *) self)->db,
                     "UPDATE tags SET"
                     " address=%Q, attribute=%i, precision=%i, type=%i,"
-                    " decimal=%lf, bias=%lf, description=%Q, value=%Q, unit=%Q "
+                    " decimal=%lf, bias=%lf, description=%Q, value=%Q, unit=%Q,"
+                    " deadband=%lf, deadband_percent=%lf, min_interval=%u,"
+                    " max_interval=%u, window_depth=%u, window_duration=%u "
                     "WHERE driver_name=%Q AND group_name=%Q AND name=%Q",
                     tag->address, tag->attribute, tag->precision, tag->type,
                     tag->decimal, tag->bias, tag->description, "", tag->unit,
-                    driver_name, group_name, tag->name);
+                    tag->deadband.absolute, tag->deadband.percent,
+                    tag->deadband.min_interval, tag->deadband.max_interval,
+                    tag->window.depth, tag->window.duration, driver_name,
+                    group_name, tag->name);
     return rv;
 }
 
@@ -1049,9 +1093,10 @@ int neu_sqlite_persister_store_group(neu_persister_t *         self,
 {
     return execute_sql(((neu_sqlite_persister_t *) self)->db,
                        "INSERT INTO groups (driver_name, name, interval, "
-                       "context) VALUES (%Q, %Q, %u, %Q)",
+                       "context, aggregate) VALUES (%Q, %Q, %u, %Q, %u)",
                        driver_name, group_info->name,
-                       (unsigned) group_info->interval, context);
+                       (unsigned) group_info->interval, context,
+                       (unsigned) group_info->aggregate);
 }
 
 int neu_sqlite_persister_update_group(neu_persister_t *         self,
@@ -1061,7 +1106,7 @@ int neu_sqlite_persister_update_group(neu_persister_t *         self,
 {
     neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
 
-    int  ret             = -1;
+    int  ret             = 0;
     bool update_name     = (0 != strcmp(group_name, group_info->name));
     bool update_interval = (NEU_GROUP_INTERVAL_LIMIT <= group_info->interval);
 
@@ -1083,6 +1128,14 @@ int neu_sqlite_persister_update_group(neu_persister_t *         self,
                           group_info->interval, driver_name, group_name);
     }
 
+    if (0 == ret) {
+        ret = execute_sql(persister->db,
+                          "UPDATE groups SET aggregate=%u "
+                          "WHERE driver_name=%Q AND name=%Q",
+                          (unsigned) group_info->aggregate, driver_name,
+                          group_info->name);
+    }
+
     return ret;
 }
 
@@ -1105,7 +1158,8 @@ static int collect_group_info(sqlite3_stmt *stmt, UT_array **group_infos)
         }
 
         info.name     = name;
-        info.interval = sqlite3_column_int(stmt, 1);
+        info.interval  = sqlite3_column_int(stmt, 1);
+        info.aggregate = (uint32_t) sqlite3_column_int64(stmt, 3);
         char *context = (char *) sqlite3_column_text(stmt, 2);
         if (NULL != context) {
             info.context = strdup(context);
@@ -1132,7 +1186,8 @@ int neu_sqlite_persister_load_groups(neu_persister_t *self,
 
     sqlite3_stmt *stmt = NULL;
     const char *  query =
-        "SELECT name, interval, context FROM groups WHERE driver_name=?";
+        "SELECT name, interval, context, aggregate FROM groups "
+        "WHERE driver_name=?";
 
     utarray_new(*group_infos, &group_info_icd);
 
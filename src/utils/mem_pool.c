@@ -0,0 +1,315 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/mem_pool.h"
+#include "utils/uthash.h"
+
+#define N_CLASS 8
+#define MIN_CLASS_SHIFT 6 // 64 bytes
+#define NO_CLASS 0xff
+// blocks a thread caches per class before it flushes half to the depot
+#define MAGAZINE_SIZE 64
+// bytes of free blocks the depot keeps per class, the rest is released
+#define DEPOT_BYTES (4 * 1024 * 1024)
+
+// block header, keeps the payload 16 bytes aligned
+typedef union {
+    struct {
+        uint8_t cls;
+        uint8_t pool;
+    };
+    uint8_t pad[16];
+} block_t;
+
+typedef struct free_block {
+    struct free_block *next;
+} free_block_t;
+
+struct magazine {
+    uint32_t n;
+    block_t *blocks[MAGAZINE_SIZE];
+};
+
+struct thread_cache {
+    struct magazine mags[N_CLASS];
+};
+
+struct depot {
+    pthread_mutex_t mtx;
+    free_block_t *  head;
+    uint32_t        n;
+    uint32_t        max;
+};
+
+struct counter {
+    uint64_t in_use;
+    uint64_t allocs;
+    uint64_t mallocs;
+};
+
+struct intern {
+    UT_hash_handle hh;
+    uint32_t       ref;
+    char           str[];
+};
+
+static const char *pool_names[] = {
+    [NEU_MEM_POOL_MSG]       = "msg",
+    [NEU_MEM_POOL_TRANS_CTX] = "trans_ctx",
+    [NEU_MEM_POOL_NAME]      = "name",
+};
+
+static struct depot   depots[N_CLASS];
+static struct counter counters[NEU_MEM_POOL_MAX];
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+static pthread_key_t  cache_key;
+
+static __thread struct thread_cache *cache_ = NULL;
+
+static pthread_mutex_t intern_mtx = PTHREAD_MUTEX_INITIALIZER;
+static struct intern * interns    = NULL;
+
+static inline size_t class_size(uint8_t cls)
+{
+    return (size_t) 1 << (cls + MIN_CLASS_SHIFT);
+}
+
+static inline uint8_t size_class(size_t size)
+{
+    for (uint8_t cls = 0; cls < N_CLASS; cls++) {
+        if (size <= class_size(cls)) {
+            return cls;
+        }
+    }
+    return NO_CLASS;
+}
+
+static void depot_put(uint8_t cls, block_t **blocks, uint32_t n)
+{
+    struct depot *depot = &depots[cls];
+    uint32_t      i     = 0;
+
+    pthread_mutex_lock(&depot->mtx);
+    for (; i < n && depot->n < depot->max; i++) {
+        free_block_t *fb = (free_block_t *) blocks[i];
+        fb->next         = depot->head;
+        depot->head      = fb;
+        depot->n += 1;
+    }
+    pthread_mutex_unlock(&depot->mtx);
+
+    for (; i < n; i++) {
+        free(blocks[i]);
+    }
+}
+
+static uint32_t depot_get(uint8_t cls, block_t **blocks, uint32_t n)
+{
+    struct depot *depot = &depots[cls];
+    uint32_t      i     = 0;
+
+    pthread_mutex_lock(&depot->mtx);
+    for (; i < n && depot->head != NULL; i++) {
+        blocks[i]   = (block_t *) depot->head;
+        depot->head = depot->head->next;
+        depot->n -= 1;
+    }
+    pthread_mutex_unlock(&depot->mtx);
+
+    return i;
+}
+
+static void cache_flush(void *arg)
+{
+    struct thread_cache *cache = (struct thread_cache *) arg;
+
+    for (uint8_t cls = 0; cls < N_CLASS; cls++) {
+        depot_put(cls, cache->mags[cls].blocks, cache->mags[cls].n);
+    }
+    free(cache);
+    cache_ = NULL;
+}
+
+static void pool_init()
+{
+    for (uint8_t cls = 0; cls < N_CLASS; cls++) {
+        pthread_mutex_init(&depots[cls].mtx, NULL);
+        depots[cls].max = DEPOT_BYTES / class_size(cls);
+    }
+    // hands the blocks of an exiting thread back to the depot
+    pthread_key_create(&cache_key, cache_flush);
+}
+
+static struct thread_cache *thread_cache()
+{
+    if (cache_ == NULL) {
+        pthread_once(&once, pool_init);
+        cache_ = calloc(1, sizeof(struct thread_cache));
+        pthread_setspecific(cache_key, cache_);
+    }
+    return cache_;
+}
+
+void *neu_mem_pool_alloc(neu_mem_pool_e pool, size_t size)
+{
+    uint8_t  cls   = size_class(size);
+    block_t *block = NULL;
+
+    if (cls != NO_CLASS) {
+        struct magazine *mag = &thread_cache()->mags[cls];
+
+        if (mag->n == 0) {
+            mag->n = depot_get(cls, mag->blocks, MAGAZINE_SIZE / 2);
+        }
+        if (mag->n > 0) {
+            block = mag->blocks[--mag->n];
+        } else {
+            block = malloc(sizeof(block_t) + class_size(cls));
+            __atomic_add_fetch(&counters[pool].mallocs, 1, __ATOMIC_RELAXED);
+        }
+    } else {
+        block = malloc(sizeof(block_t) + size);
+        __atomic_add_fetch(&counters[pool].mallocs, 1, __ATOMIC_RELAXED);
+    }
+
+    if (block == NULL) {
+        return NULL;
+    }
+
+    block->cls  = cls;
+    block->pool = pool;
+    __atomic_add_fetch(&counters[pool].in_use, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&counters[pool].allocs, 1, __ATOMIC_RELAXED);
+
+    memset(&block[1], 0, size);
+    return &block[1];
+}
+
+void neu_mem_pool_free(void *ptr)
+{
+    if (ptr == NULL) {
+        return;
+    }
+
+    block_t *block = (block_t *) ptr - 1;
+    __atomic_sub_fetch(&counters[block->pool].in_use, 1, __ATOMIC_RELAXED);
+
+    if (block->cls == NO_CLASS) {
+        free(block);
+        return;
+    }
+
+    struct magazine *mag = &thread_cache()->mags[block->cls];
+    if (mag->n == MAGAZINE_SIZE) {
+        mag->n -= MAGAZINE_SIZE / 2;
+        depot_put(block->cls, &mag->blocks[mag->n], MAGAZINE_SIZE / 2);
+    }
+    mag->blocks[mag->n++] = block;
+}
+
+const char *neu_mem_pool_name(neu_mem_pool_e pool)
+{
+    if (pool >= NEU_MEM_POOL_MAX) {
+        return "unknown";
+    }
+    return pool_names[pool];
+}
+
+void neu_mem_pool_stats(neu_mem_pool_e pool, neu_mem_pool_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    if (pool >= NEU_MEM_POOL_MAX) {
+        return;
+    }
+
+    stats->in_use = __atomic_load_n(&counters[pool].in_use, __ATOMIC_RELAXED);
+    stats->allocs = __atomic_load_n(&counters[pool].allocs, __ATOMIC_RELAXED);
+    stats->mallocs =
+        __atomic_load_n(&counters[pool].mallocs, __ATOMIC_RELAXED);
+
+    // the depot is shared by the pools, report it under the message pool
+    if (pool == NEU_MEM_POOL_MSG) {
+        pthread_once(&once, pool_init);
+        for (uint8_t cls = 0; cls < N_CLASS; cls++) {
+            pthread_mutex_lock(&depots[cls].mtx);
+            stats->cached += depots[cls].n;
+            pthread_mutex_unlock(&depots[cls].mtx);
+        }
+    }
+}
+
+char *neu_str_intern(const char *str)
+{
+    struct intern *in  = NULL;
+    size_t         len = strlen(str);
+
+    pthread_mutex_lock(&intern_mtx);
+    HASH_FIND(hh, interns, str, len, in);
+    if (in != NULL) {
+        __atomic_add_fetch(&in->ref, 1, __ATOMIC_RELAXED);
+    } else {
+        in = neu_mem_pool_alloc(NEU_MEM_POOL_NAME,
+                                sizeof(struct intern) + len + 1);
+        if (in != NULL) {
+            in->ref = 1;
+            memcpy(in->str, str, len);
+            HASH_ADD_KEYPTR(hh, interns, in->str, len, in);
+        }
+    }
+    pthread_mutex_unlock(&intern_mtx);
+
+    return in != NULL ? in->str : NULL;
+}
+
+char *neu_str_ref(char *str)
+{
+    struct intern *in = (struct intern *) (str - offsetof(struct intern, str));
+
+    __atomic_add_fetch(&in->ref, 1, __ATOMIC_RELAXED);
+    return str;
+}
+
+void neu_str_release(char *str)
+{
+    if (str == NULL) {
+        return;
+    }
+
+    struct intern *in  = (struct intern *) (str - offsetof(struct intern, str));
+    uint32_t       ref = __atomic_load_n(&in->ref, __ATOMIC_RELAXED);
+
+    // only the last reference is dropped under the table lock
+    while (ref > 1) {
+        if (__atomic_compare_exchange_n(&in->ref, &ref, ref - 1, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            return;
+        }
+    }
+
+    pthread_mutex_lock(&intern_mtx);
+    if (__atomic_sub_fetch(&in->ref, 1, __ATOMIC_ACQ_REL) == 0) {
+        HASH_DEL(interns, in);
+        neu_mem_pool_free(in);
+    }
+    pthread_mutex_unlock(&intern_mtx);
+}
@@ -0,0 +1,100 @@
+#include <math.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "adapter/driver/aggregate.h"
+#include "errcodes.h"
+}
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+TEST(DriverAggregateTest, statistics)
+{
+    neu_driver_acc_t acc                          = {};
+    const double     values[]                     = { 2, 4, 4, 4, 5, 5, 7, 9 };
+    neu_tag_meta_t   metas[NEU_DRIVER_ACC_N_META] = {};
+
+    neu_driver_acc_reset(&acc);
+    EXPECT_EQ(0U, acc.count);
+    EXPECT_DOUBLE_EQ(0, neu_driver_acc_stddev(&acc));
+
+    for (double v : values) {
+        neu_driver_acc_add(&acc, v);
+    }
+
+    EXPECT_EQ(8U, acc.count);
+    EXPECT_DOUBLE_EQ(2, acc.first);
+    EXPECT_DOUBLE_EQ(9, acc.last);
+    EXPECT_DOUBLE_EQ(2, acc.min);
+    EXPECT_DOUBLE_EQ(9, acc.max);
+    EXPECT_DOUBLE_EQ(40, acc.sum);
+    EXPECT_DOUBLE_EQ(5, acc.mean);
+    EXPECT_DOUBLE_EQ(2, neu_driver_acc_stddev(&acc));
+
+    EXPECT_EQ(NEU_DRIVER_ACC_N_META, neu_driver_acc_metas(&acc, metas));
+    EXPECT_STREQ("min", metas[0].name);
+    EXPECT_DOUBLE_EQ(2, metas[0].value.value.d64);
+    EXPECT_STREQ("mean", metas[2].name);
+    EXPECT_DOUBLE_EQ(5, metas[2].value.value.d64);
+    EXPECT_STREQ("count", metas[4].name);
+    EXPECT_EQ(NEU_TYPE_INT64, metas[4].value.type);
+    EXPECT_EQ(8, metas[4].value.value.i64);
+    EXPECT_STREQ("stddev", metas[7].name);
+    EXPECT_DOUBLE_EQ(2, metas[7].value.value.d64);
+}
+
+TEST(DriverAggregateTest, stddev_keeps_precision)
+{
+    neu_driver_acc_t acc = {};
+
+    // a big offset loses the variance with the naive sum of squares
+    for (int i = 0; i < 1000; i++) {
+        neu_driver_acc_add(&acc, 1e9 + (i % 2 == 0 ? 1 : -1));
+    }
+
+    EXPECT_DOUBLE_EQ(1e9, acc.mean);
+    EXPECT_NEAR(1, neu_driver_acc_stddev(&acc), 1e-6);
+}
+
+TEST(DriverAggregateTest, values)
+{
+    neu_driver_acc_t acc   = {};
+    neu_dvalue_t     value = {};
+
+    value.type      = NEU_TYPE_INT16;
+    value.value.i16 = -3;
+    EXPECT_TRUE(neu_driver_acc_add_value(&acc, &value));
+
+    value.type      = NEU_TYPE_FLOAT;
+    value.value.f32 = 1.5;
+    EXPECT_TRUE(neu_driver_acc_add_value(&acc, &value));
+
+    value.type          = NEU_TYPE_BOOL;
+    value.value.boolean = true;
+    EXPECT_TRUE(neu_driver_acc_add_value(&acc, &value));
+
+    EXPECT_EQ(3U, acc.count);
+    EXPECT_DOUBLE_EQ(-3, acc.min);
+    EXPECT_DOUBLE_EQ(1.5, acc.max);
+    EXPECT_EQ(0, acc.error);
+
+    // errors are remembered, strings and nan are not accumulated
+    value.type      = NEU_TYPE_ERROR;
+    value.value.i32 = NEU_ERR_PLUGIN_READ_FAILURE;
+    EXPECT_FALSE(neu_driver_acc_add_value(&acc, &value));
+    EXPECT_EQ(NEU_ERR_PLUGIN_READ_FAILURE, acc.error);
+
+    value.type = NEU_TYPE_STRING;
+    strcpy(value.value.str, "1");
+    EXPECT_FALSE(neu_driver_acc_add_value(&acc, &value));
+
+    value.type      = NEU_TYPE_DOUBLE;
+    value.value.d64 = NAN;
+    EXPECT_FALSE(neu_driver_acc_add_value(&acc, &value));
+    EXPECT_EQ(NEU_ERR_PLUGIN_TAG_VALUE_EXPIRED, acc.error);
+
+    EXPECT_EQ(3U, acc.count);
+}
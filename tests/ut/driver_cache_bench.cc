@@ -0,0 +1,259 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "define.h"
+#include "tag.h"
+
+extern "C" {
+#include "adapter/driver/cache.h"
+}
+#include "utils/log.h"
+#include "utils/uthash.h"
+
+zlog_category_t *neuron         = NULL;
+bool             sub_filter_err = false;
+
+static neu_dvalue_t int_value(int32_t v)
+{
+    neu_dvalue_t value = {};
+
+    value.type      = NEU_TYPE_INT32;
+    value.value.i32 = v;
+    return value;
+}
+
+static int64_t now_ns()
+{
+    struct timespec ts = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ * Microbenchmark against the previous engine: one uthash table keyed by
+ * group[128] + tag[128] behind a single mutex.
+ *
+ * Not a unit test, built as driver_cache_bench and run by hand.
+ */
+typedef struct {
+    char group[NEU_GROUP_NAME_LEN];
+    char tag[NEU_TAG_NAME_LEN];
+} legacy_key_t;
+
+struct legacy_elem {
+    int64_t        timestamp;
+    neu_dvalue_t   value;
+    legacy_key_t   key;
+    UT_hash_handle hh;
+};
+
+struct legacy_cache {
+    pthread_mutex_t     mtx;
+    struct legacy_elem *table;
+};
+
+static legacy_key_t legacy_to_key(const char *group, const char *tag)
+{
+    legacy_key_t key = {};
+
+    strncpy(key.group, group, sizeof(key.group) - 1);
+    strncpy(key.tag, tag, sizeof(key.tag) - 1);
+    return key;
+}
+
+static void legacy_update(struct legacy_cache *cache, const char *group,
+                          const char *tag, int64_t ts, neu_dvalue_t value)
+{
+    struct legacy_elem *elem = NULL;
+    legacy_key_t        key  = legacy_to_key(group, tag);
+
+    pthread_mutex_lock(&cache->mtx);
+    HASH_FIND(hh, cache->table, &key, sizeof(legacy_key_t), elem);
+    if (elem != NULL) {
+        elem->timestamp = ts;
+        elem->value     = value;
+    }
+    pthread_mutex_unlock(&cache->mtx);
+}
+
+static int legacy_get(struct legacy_cache *cache, const char *group,
+                      const char *tag, neu_dvalue_t *value)
+{
+    struct legacy_elem *elem = NULL;
+    legacy_key_t        key  = legacy_to_key(group, tag);
+    int                 ret  = -1;
+
+    pthread_mutex_lock(&cache->mtx);
+    HASH_FIND(hh, cache->table, &key, sizeof(legacy_key_t), elem);
+    if (elem != NULL) {
+        *value = elem->value;
+        ret    = 0;
+    }
+    pthread_mutex_unlock(&cache->mtx);
+    return ret;
+}
+
+static void report(const char *name, int n_tag, int64_t ops, int64_t ns)
+{
+    printf("%-24s %8d tags: %8.2f Mops/s\n", name, n_tag,
+           ns > 0 ? (double) ops * 1000.0 / (double) ns : 0.0);
+}
+
+static void bench(int n_tag)
+{
+    const int           n_thread = 4;
+    struct legacy_cache legacy   = {};
+    neu_driver_cache_t *cache    = neu_driver_cache_new();
+    std::vector<std::string>             names(n_tag);
+    std::vector<neu_driver_cache_slot_t> slots(n_tag);
+    neu_dvalue_t                         value = {};
+    int64_t                              start = 0;
+
+    pthread_mutex_init(&legacy.mtx, NULL);
+    for (int i = 0; i < n_tag; i++) {
+        char name[32] = { 0 };
+
+        snprintf(name, sizeof(name), "tag%d", i);
+        names[i] = name;
+
+        struct legacy_elem *elem =
+            (struct legacy_elem *) calloc(1, sizeof(struct legacy_elem));
+        elem->key = legacy_to_key("group", name);
+        HASH_ADD(hh, legacy.table, key, sizeof(legacy_key_t), elem);
+
+        slots[i] = neu_driver_cache_add(cache, "group", name, int_value(0));
+        ASSERT_GE(slots[i], 0);
+    }
+
+    start = now_ns();
+    for (int i = 0; i < n_tag; i++) {
+        legacy_update(&legacy, "group", names[i].c_str(), 1, int_value(i));
+    }
+    report("legacy update", n_tag, n_tag, now_ns() - start);
+
+    start = now_ns();
+    for (int i = 0; i < n_tag; i++) {
+        neu_driver_cache_update(cache, "group", names[i].c_str(), 1,
+                                int_value(i), NULL, 0);
+    }
+    report("by name update", n_tag, n_tag, now_ns() - start);
+
+    start = now_ns();
+    for (int i = 0; i < n_tag; i++) {
+        neu_driver_cache_update_slot(cache, slots[i], 2, int_value(i + 1),
+                                     NULL, 0, false);
+    }
+    report("by slot update", n_tag, n_tag, now_ns() - start);
+
+    start = now_ns();
+    for (int i = 0; i < n_tag; i++) {
+        EXPECT_EQ(0, legacy_get(&legacy, "group", names[i].c_str(), &value));
+    }
+    report("legacy read", n_tag, n_tag, now_ns() - start);
+
+    start = now_ns();
+    for (int i = 0; i < n_tag; i++) {
+        neu_driver_cache_value_t v     = {};
+        neu_tag_meta_t *         metas = NULL;
+        int                      n     = 0;
+
+        EXPECT_EQ(0,
+                  neu_driver_cache_meta_get(cache, "group", names[i].c_str(),
+                                            &v, &metas, &n));
+    }
+    report("by name read", n_tag, n_tag, now_ns() - start);
+
+    start = now_ns();
+    for (int i = 0; i < n_tag; i++) {
+        neu_driver_cache_value_t v     = {};
+        neu_tag_meta_t *         metas = NULL;
+        int                      n     = 0;
+
+        EXPECT_EQ(0,
+                  neu_driver_cache_meta_get_slot(cache, slots[i], &v, &metas,
+                                                 &n, false));
+        EXPECT_EQ(i + 1, v.value.value.i32);
+    }
+    report("by slot read", n_tag, n_tag, now_ns() - start);
+
+    // one reader and n_thread - 1 writers hitting the cache concurrently
+    std::vector<std::thread> threads;
+    start = now_ns();
+    for (int t = 0; t < n_thread; t++) {
+        threads.emplace_back([&, t]() {
+            neu_dvalue_t v = {};
+
+            for (int i = t; i < n_tag; i += n_thread) {
+                if (t == 0) {
+                    legacy_get(&legacy, "group", names[i].c_str(), &v);
+                } else {
+                    legacy_update(&legacy, "group", names[i].c_str(), 3,
+                                  int_value(i));
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    report("legacy mixed", n_tag, n_tag, now_ns() - start);
+
+    threads.clear();
+    start = now_ns();
+    for (int t = 0; t < n_thread; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = t; i < n_tag; i += n_thread) {
+                if (t == 0) {
+                    neu_driver_cache_value_t v     = {};
+                    neu_tag_meta_t *         metas = NULL;
+                    int                      n     = 0;
+
+                    neu_driver_cache_meta_get_slot(cache, slots[i], &v,
+                                                   &metas, &n, false);
+                } else {
+                    neu_driver_cache_update_slot(cache, slots[i], 3,
+                                                 int_value(i), NULL, 0, false);
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    report("by slot mixed", n_tag, n_tag, now_ns() - start);
+
+    struct legacy_elem *elem = NULL;
+    struct legacy_elem *tmp  = NULL;
+    HASH_ITER(hh, legacy.table, elem, tmp)
+    {
+        HASH_DEL(legacy.table, elem);
+        free(elem);
+    }
+    pthread_mutex_destroy(&legacy.mtx);
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheBench, tags_10k)
+{
+    bench(10000);
+}
+
+TEST(DriverCacheBench, tags_100k)
+{
+    bench(100000);
+}
+
+TEST(DriverCacheBench, tags_1m)
+{
+    bench(1000000);
+}
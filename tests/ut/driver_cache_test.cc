@@ -0,0 +1,395 @@
+#include <stdlib.h>
+
+#include <gtest/gtest.h>
+
+#include "define.h"
+#include "errcodes.h"
+#include "tag.h"
+
+extern "C" {
+#include "adapter/driver/cache.h"
+#include "adapter/driver/transform.h"
+}
+#include "utils/log.h"
+
+zlog_category_t *neuron         = NULL;
+bool             sub_filter_err = false;
+
+static neu_dvalue_t int_value(int32_t v)
+{
+    neu_dvalue_t value = {};
+
+    value.type      = NEU_TYPE_INT32;
+    value.value.i32 = v;
+    return value;
+}
+
+TEST(DriverCacheTest, add_update_get)
+{
+    neu_driver_cache_t *     cache = neu_driver_cache_new();
+    neu_driver_cache_value_t value = {};
+    neu_tag_meta_t *         metas = NULL;
+    int                      n     = 0;
+
+    neu_driver_cache_slot_t slot =
+        neu_driver_cache_add(cache, "grp", "tag", int_value(0));
+    ASSERT_GE(slot, 0);
+    EXPECT_EQ(slot, neu_driver_cache_slot(cache, "grp", "tag"));
+    EXPECT_EQ(-1, neu_driver_cache_slot(cache, "grp", "none"));
+    EXPECT_EQ(-1, neu_driver_cache_slot(cache, "none", "tag"));
+
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 10,
+                                               int_value(7), NULL, 0, false));
+    EXPECT_FALSE(neu_driver_cache_update_slot(cache, slot, 11, int_value(7),
+                                              NULL, 0, false));
+
+    EXPECT_EQ(0, neu_driver_cache_meta_get(cache, "grp", "tag", &value, &metas,
+                                           &n));
+    EXPECT_EQ(7, value.value.value.i32);
+    EXPECT_EQ(11, value.timestamp);
+
+    EXPECT_EQ(0,
+              neu_driver_cache_meta_get_slot(cache, slot, &value, &metas, &n,
+                                             true));
+    EXPECT_EQ(1,
+              neu_driver_cache_meta_get_slot(cache, slot, &value, &metas, &n,
+                                             true));
+    EXPECT_EQ(-1, neu_driver_cache_meta_get_changed(cache, "grp", "tag",
+                                                    &value, &metas, &n));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, stale_slot)
+{
+    neu_driver_cache_t *     cache = neu_driver_cache_new();
+    neu_driver_cache_value_t value = {};
+    neu_tag_meta_t *         metas = NULL;
+    int                      n     = 0;
+
+    neu_driver_cache_slot_t s1 =
+        neu_driver_cache_add(cache, "grp", "tag1", int_value(1));
+    neu_driver_cache_del(cache, "grp", "tag1");
+
+    // the released slot is reused by the next tag
+    neu_driver_cache_slot_t s2 =
+        neu_driver_cache_add(cache, "grp", "tag2", int_value(2));
+    EXPECT_NE(s1, s2);
+    EXPECT_EQ(-1,
+              neu_driver_cache_meta_get_slot(cache, s1, &value, &metas, &n,
+                                             false));
+    EXPECT_FALSE(neu_driver_cache_update_slot(cache, s1, 1, int_value(3),
+                                              NULL, 0, false));
+    EXPECT_EQ(0,
+              neu_driver_cache_meta_get_slot(cache, s2, &value, &metas, &n,
+                                             false));
+    EXPECT_EQ(2, value.value.value.i32);
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, rename_keeps_slot)
+{
+    neu_driver_cache_t *cache = neu_driver_cache_new();
+
+    neu_driver_cache_slot_t slot =
+        neu_driver_cache_add(cache, "grp", "old", int_value(1));
+    neu_driver_cache_rename(cache, "grp", "old", "new");
+
+    EXPECT_EQ(-1, neu_driver_cache_slot(cache, "grp", "old"));
+    EXPECT_EQ(slot, neu_driver_cache_slot(cache, "grp", "new"));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, trace)
+{
+    neu_driver_cache_t *cache = neu_driver_cache_new();
+    int                 ctx   = 0;
+
+    EXPECT_EQ(NULL, neu_driver_cache_get_trace(cache, "grp"));
+    neu_driver_cache_update_trace(cache, "grp", &ctx);
+    EXPECT_EQ(&ctx, neu_driver_cache_get_trace(cache, "grp"));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, update_many)
+{
+    neu_driver_cache_t *     cache    = neu_driver_cache_new();
+    neu_driver_cache_value_t value    = {};
+    neu_tag_meta_t *         metas    = NULL;
+    int                      n        = 0;
+    neu_tag_update_t         items[3] = {};
+
+    neu_driver_cache_add(cache, "grp", "tag1", int_value(0));
+    neu_driver_cache_add(cache, "grp", "tag2", int_value(0));
+    items[0].tag   = "tag1";
+    items[0].value = int_value(1);
+    items[1].tag   = "none";
+    items[1].value = int_value(2);
+    items[2].tag   = "tag2";
+    items[2].value = int_value(3);
+
+    // tags missing from the cache are skipped
+    EXPECT_EQ(2, neu_driver_cache_update_many(cache, "grp", 5, items, 3));
+    EXPECT_EQ(0, neu_driver_cache_update_many(cache, "none", 6, items, 3));
+
+    EXPECT_EQ(0, neu_driver_cache_meta_get(cache, "grp", "tag1", &value,
+                                           &metas, &n));
+    EXPECT_EQ(1, value.value.value.i32);
+    EXPECT_EQ(5, value.timestamp);
+    EXPECT_EQ(0, neu_driver_cache_meta_get(cache, "grp", "tag2", &value,
+                                           &metas, &n));
+    EXPECT_EQ(3, value.value.value.i32);
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, deadband)
+{
+    neu_driver_cache_t *     cache      = neu_driver_cache_new();
+    neu_driver_cache_value_t value      = {};
+    neu_tag_meta_t *         metas      = NULL;
+    int                      n          = 0;
+    uint64_t                 forwarded  = 0;
+    uint64_t                 suppressed = 0;
+    neu_tag_deadband_t       deadband   = {};
+
+    neu_driver_cache_add(cache, "grp", "tag", int_value(0));
+    deadband.absolute = 5;
+    EXPECT_EQ(-1,
+              neu_driver_cache_set_deadband(cache, "grp", "none", &deadband,
+                                            NULL));
+    EXPECT_EQ(0,
+              neu_driver_cache_set_deadband(cache, "grp", "tag", &deadband,
+                                            NULL));
+
+    // the first value is always reported
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 0,
+                                               int_value(100), NULL, 0, false));
+    EXPECT_EQ(0, neu_driver_cache_meta_get_changed(cache, "grp", "tag", &value,
+                                                   &metas, &n));
+    EXPECT_FALSE(neu_driver_cache_update_change(
+        cache, "grp", "tag", 10, int_value(103), NULL, 0, false));
+    EXPECT_EQ(-1, neu_driver_cache_meta_get_changed(cache, "grp", "tag",
+                                                    &value, &metas, &n));
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 20,
+                                               int_value(106), NULL, 0, false));
+    // a pending change is kept, the latest value is read out
+    EXPECT_FALSE(neu_driver_cache_update_change(
+        cache, "grp", "tag", 30, int_value(108), NULL, 0, false));
+    EXPECT_EQ(0, neu_driver_cache_meta_get_changed(cache, "grp", "tag", &value,
+                                                   &metas, &n));
+    EXPECT_EQ(108, value.value.value.i32);
+
+    // percent of the last reported value
+    deadband.absolute = 0;
+    deadband.percent  = 10;
+    neu_driver_cache_set_deadband(cache, "grp", "tag", &deadband, NULL);
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 40,
+                                               int_value(100), NULL, 0, false));
+    EXPECT_FALSE(neu_driver_cache_update_change(cache, "grp", "tag", 50,
+                                                int_value(90), NULL, 0, false));
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 60,
+                                               int_value(111), NULL, 0, false));
+
+    neu_driver_cache_take_filtered(cache, "grp", &forwarded, &suppressed);
+    EXPECT_EQ(4U, forwarded);
+    EXPECT_EQ(3U, suppressed);
+    neu_driver_cache_take_filtered(cache, "grp", &forwarded, &suppressed);
+    EXPECT_EQ(0U, forwarded);
+    EXPECT_EQ(0U, suppressed);
+
+    // removing the deadband reports every change again
+    neu_driver_cache_set_deadband(cache, "grp", "tag", NULL, NULL);
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 70,
+                                               int_value(112), NULL, 0, false));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, deadband_interval)
+{
+    neu_driver_cache_t *     cache    = neu_driver_cache_new();
+    neu_driver_cache_value_t value    = {};
+    neu_tag_meta_t *         metas    = NULL;
+    int                      n        = 0;
+    neu_tag_deadband_t       deadband = {};
+
+    neu_driver_cache_add(cache, "grp", "tag", int_value(0));
+    deadband.min_interval = 100;
+    deadband.max_interval = 1000;
+    neu_driver_cache_set_deadband(cache, "grp", "tag", &deadband, NULL);
+
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 0,
+                                               int_value(1), NULL, 0, false));
+    EXPECT_FALSE(neu_driver_cache_update_change(cache, "grp", "tag", 50,
+                                                int_value(2), NULL, 0, false));
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 150,
+                                               int_value(3), NULL, 0, false));
+    EXPECT_EQ(0, neu_driver_cache_meta_get_changed(cache, "grp", "tag", &value,
+                                                   &metas, &n));
+    EXPECT_FALSE(neu_driver_cache_update_change(cache, "grp", "tag", 500,
+                                                int_value(3), NULL, 0, false));
+    EXPECT_EQ(-1, neu_driver_cache_meta_get_changed(cache, "grp", "tag",
+                                                    &value, &metas, &n));
+
+    // an unchanged value is reported again after max_interval
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 1150,
+                                               int_value(3), NULL, 0, false));
+    EXPECT_EQ(0, neu_driver_cache_meta_get_changed(cache, "grp", "tag", &value,
+                                                   &metas, &n));
+    EXPECT_EQ(3, value.value.value.i32);
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, deadband_decimal)
+{
+    neu_driver_cache_t *cache    = neu_driver_cache_new();
+    neu_tag_deadband_t  deadband = {};
+    neu_tag_transform_t plan     = {};
+    neu_datatag_t       tag      = {};
+
+    // bands are in the units of the reported value, raw 10 is 1.0
+    tag.type    = NEU_TYPE_INT32;
+    tag.decimal = 0.1;
+    neu_tag_transform_compile(&plan, &tag);
+
+    neu_driver_cache_add(cache, "grp", "tag", int_value(0));
+    deadband.absolute = 1;
+    neu_driver_cache_set_deadband(cache, "grp", "tag", &deadband, &plan);
+
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 0,
+                                               int_value(100), NULL, 0, false));
+    EXPECT_FALSE(neu_driver_cache_update_change(
+        cache, "grp", "tag", 10, int_value(108), NULL, 0, false));
+    EXPECT_FALSE(neu_driver_cache_update_change(
+        cache, "grp", "tag", 20, int_value(110), NULL, 0, false));
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 30,
+                                               int_value(111), NULL, 0, false));
+
+    // percent of the last reported value, 11.1
+    deadband.absolute = 0;
+    deadband.percent  = 10;
+    neu_driver_cache_set_deadband(cache, "grp", "tag", &deadband, &plan);
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 40,
+                                               int_value(100), NULL, 0, false));
+    EXPECT_FALSE(neu_driver_cache_update_change(
+        cache, "grp", "tag", 50, int_value(109), NULL, 0, false));
+    EXPECT_TRUE(neu_driver_cache_update_change(cache, "grp", "tag", 60,
+                                               int_value(111), NULL, 0, false));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, window)
+{
+    neu_driver_cache_t *    cache   = neu_driver_cache_new();
+    neu_tag_window_t        window  = {};
+    neu_tag_history_query_t query   = {};
+    neu_tag_history_t       history = {};
+
+    neu_driver_cache_add(cache, "grp", "tag", int_value(0));
+    EXPECT_EQ(-1,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+
+    window.depth = 4;
+    EXPECT_EQ(0, neu_driver_cache_set_window(cache, "grp", "tag", &window,
+                                             NULL));
+    EXPECT_EQ(-1, neu_driver_cache_set_window(cache, "grp", "none", &window,
+                                              NULL));
+    EXPECT_EQ(0,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+    EXPECT_EQ(0U, history.count);
+    EXPECT_EQ(NULL, history.samples);
+
+    // the oldest samples are overwritten once the ring is full
+    for (int i = 1; i <= 6; i++) {
+        neu_driver_cache_update(cache, "grp", "tag", i * 100, int_value(i),
+                                NULL, 0);
+    }
+    EXPECT_EQ(0,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+    EXPECT_EQ(4U, history.count);
+    ASSERT_EQ(4U, history.n_sample);
+    EXPECT_EQ(300, history.samples[0].timestamp);
+    EXPECT_EQ(6, history.samples[3].value);
+    EXPECT_EQ(3, history.min);
+    EXPECT_EQ(6, history.max);
+    EXPECT_DOUBLE_EQ(4.5, history.avg);
+    EXPECT_EQ(6, history.last);
+    free(history.samples);
+
+    // the last samples of a range
+    query.from = 350;
+    query.to   = 550;
+    EXPECT_EQ(0,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+    EXPECT_EQ(2U, history.count);
+    EXPECT_EQ(4, history.min);
+    free(history.samples);
+
+    query.last      = 1;
+    query.aggregate = true;
+    EXPECT_EQ(0,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+    EXPECT_EQ(1U, history.count);
+    EXPECT_EQ(NULL, history.samples);
+    EXPECT_EQ(5, history.last);
+
+    // errors are not sampled
+    neu_dvalue_t error = {};
+    error.type         = NEU_TYPE_ERROR;
+    error.value.i32    = NEU_ERR_PLUGIN_TAG_NOT_READY;
+    neu_driver_cache_update(cache, "grp", "tag", 700, error, NULL, 0);
+    query = {};
+    EXPECT_EQ(0,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+    EXPECT_EQ(4U, history.count);
+    EXPECT_EQ(6, history.last);
+    free(history.samples);
+
+    neu_driver_cache_set_window(cache, "grp", "tag", NULL, NULL);
+    EXPECT_EQ(-1,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, window_duration)
+{
+    neu_driver_cache_t *    cache   = neu_driver_cache_new();
+    neu_tag_window_t        window  = {};
+    neu_tag_history_query_t query   = {};
+    neu_tag_history_t       history = {};
+    neu_tag_transform_t     plan    = {};
+    neu_datatag_t           tag     = {};
+
+    // samples are kept as reported, scaled by the tag
+    tag.type    = NEU_TYPE_INT32;
+    tag.decimal = 0.5;
+    neu_tag_transform_compile(&plan, &tag);
+
+    neu_driver_cache_add(cache, "grp", "tag", int_value(0));
+    window.depth    = 100;
+    window.duration = 1000;
+    neu_driver_cache_set_window(cache, "grp", "tag", &window, &plan);
+
+    for (int i = 0; i < 30; i++) {
+        neu_driver_cache_update(cache, "grp", "tag", i * 100, int_value(i),
+                                NULL, 0);
+    }
+
+    // samples older than the duration are dropped
+    query.aggregate = true;
+    EXPECT_EQ(0,
+              neu_driver_cache_history(cache, "grp", "tag", &query, &history));
+    EXPECT_EQ(11U, history.count);
+    EXPECT_DOUBLE_EQ(9.5, history.min);
+    EXPECT_DOUBLE_EQ(14.5, history.last);
+    EXPECT_DOUBLE_EQ(12, history.avg);
+
+    neu_driver_cache_destroy(cache);
+}
@@ -0,0 +1,157 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "adapter/driver/sync.h"
+}
+#include "event/event.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+// a group as the driver runs it on its event loop, without the driver
+struct sync_group {
+    neu_driver_sync_t *sync;
+    neu_events_t *     events;
+    neu_event_timer_t *write;
+    std::atomic<int>   n_read;
+};
+
+// the write timer of the group, starts a read the plugin ends later
+static int sync_write_cb(void *usr_data)
+{
+    struct sync_group *group = (struct sync_group *) usr_data;
+
+    if (neu_driver_sync_waiting(group->sync) &&
+        neu_driver_sync_begin(group->sync, true, NULL)) {
+        group->n_read += 1;
+    }
+    return 0;
+}
+
+TEST(DriverSyncTest, concurrent_sync_reads_share_one_read)
+{
+    const int         n_req = 8;
+    struct sync_group group;
+    int               reqs[n_req] = { 0 };
+
+    group.sync   = neu_driver_sync_new();
+    group.events = neu_event_new("driver_sync_test");
+    group.n_read = 0;
+
+    // far longer than the test, only posts run it
+    neu_event_timer_param_t param = {};
+    param.second                  = 10;
+    param.usr_data                = &group;
+    param.cb                      = sync_write_cb;
+    param.type                    = NEU_EVENT_TIMER_NOBLOCK;
+    group.write = neu_event_add_timer(group.events, param);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n_req; i++) {
+        threads.emplace_back([&group, &reqs, i]() {
+            neu_driver_sync_push(group.sync, &reqs[i]);
+            neu_event_post_timer(group.events, group.write);
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+
+    for (int i = 0; i < 100 && group.n_read == 0; i++) {
+        usleep(2 * 1000);
+    }
+    usleep(20 * 1000);
+    EXPECT_EQ(1, group.n_read);
+
+    // the plugin ends its group read once
+    UT_array *answered = neu_driver_sync_end(group.sync, false);
+    ASSERT_NE(nullptr, answered);
+    EXPECT_EQ((unsigned) n_req, utarray_len(answered));
+    for (unsigned i = 0; i < utarray_len(answered); i++) {
+        **(int **) utarray_eltptr(answered, i) += 1;
+    }
+    utarray_free(answered);
+    for (int i = 0; i < n_req; i++) {
+        EXPECT_EQ(1, reqs[i]);
+    }
+
+    EXPECT_FALSE(neu_driver_sync_waiting(group.sync));
+    EXPECT_EQ(nullptr, neu_driver_sync_end(group.sync, false));
+
+    neu_event_del_timer(group.events, group.write);
+    neu_event_close(group.events);
+    neu_driver_sync_free(group.sync);
+}
+
+TEST(DriverSyncTest, sync_reads_share_periodic_read)
+{
+    neu_driver_sync_t *sync    = neu_driver_sync_new();
+    bool               overrun = false;
+    int64_t            start   = 0;
+    int64_t            spend   = 0;
+    int                req     = 0;
+
+    ASSERT_TRUE(neu_driver_sync_begin(sync, false, NULL));
+    neu_driver_sync_push(sync, &req);
+
+    // the periodic read in flight serves the queue, as the next period would
+    EXPECT_FALSE(neu_driver_sync_begin(sync, true, &overrun));
+    EXPECT_FALSE(neu_driver_sync_begin(sync, false, &overrun));
+    EXPECT_TRUE(overrun);
+
+    UT_array *answered = neu_driver_sync_end(sync, false);
+    ASSERT_NE(nullptr, answered);
+    EXPECT_EQ(1u, utarray_len(answered));
+    utarray_free(answered);
+
+    EXPECT_TRUE(neu_driver_sync_take_done(sync, &start, &spend));
+    EXPECT_GE(spend, 0);
+    EXPECT_FALSE(neu_driver_sync_take_done(sync, &start, &spend));
+
+    // a sync read is not accounted as a periodic one
+    overrun = false;
+    ASSERT_TRUE(neu_driver_sync_begin(sync, true, NULL));
+    EXPECT_FALSE(neu_driver_sync_begin(sync, false, &overrun));
+    EXPECT_FALSE(overrun);
+    EXPECT_EQ(nullptr, neu_driver_sync_end(sync, false));
+    EXPECT_FALSE(neu_driver_sync_take_done(sync, &start, &spend));
+
+    neu_driver_sync_free(sync);
+}
+
+TEST(DriverSyncTest, flush_answers_without_read)
+{
+    neu_driver_sync_t *sync = neu_driver_sync_new();
+    int                req  = 0;
+
+    ASSERT_TRUE(neu_driver_sync_begin(sync, true, NULL));
+    neu_driver_sync_push(sync, &req);
+
+    UT_array *answered = neu_driver_sync_end(sync, true);
+    ASSERT_NE(nullptr, answered);
+    EXPECT_EQ(1u, utarray_len(answered));
+    utarray_free(answered);
+
+    // the end of the read dropped by the flush leaves later requests queued
+    neu_driver_sync_push(sync, &req);
+    EXPECT_EQ(nullptr, neu_driver_sync_end(sync, false));
+    EXPECT_TRUE(neu_driver_sync_waiting(sync));
+
+    // a read begun but not started leaves them for the next one
+    ASSERT_TRUE(neu_driver_sync_begin(sync, true, NULL));
+    neu_driver_sync_cancel(sync);
+    EXPECT_TRUE(neu_driver_sync_waiting(sync));
+    EXPECT_TRUE(neu_driver_sync_begin(sync, true, NULL));
+
+    answered = neu_driver_sync_end(sync, false);
+    ASSERT_NE(nullptr, answered);
+    utarray_free(answered);
+    neu_driver_sync_free(sync);
+}
@@ -0,0 +1,225 @@
+#include <stdint.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "adapter/driver/tick.h"
+}
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+// count how often each member is due over n fires of a tick
+static std::vector<int> due_counts(neu_driver_tick_t *tick, uint64_t n_fire)
+{
+    std::vector<int> counts(neu_driver_tick_size(tick), 0);
+
+    for (uint64_t count = 0; count < n_fire; count++) {
+        for (int i = 0; i < neu_driver_tick_size(tick); i++) {
+            neu_driver_tick_member_t *m = neu_driver_tick_member(tick, i);
+            if (neu_driver_tick_due(tick, m, count)) {
+                counts[i] += 1;
+            }
+        }
+    }
+
+    return counts;
+}
+
+TEST(DriverTickTest, same_interval_shares_tick)
+{
+    neu_driver_ticks_t *ticks = neu_driver_ticks_new(1);
+    int                 data[200];
+
+    // 200 groups at 1s fire from one tick instead of one timer each
+    for (int i = 0; i < 200; i++) {
+        neu_driver_tick_t *tick = neu_driver_ticks_find(ticks, 1000);
+        if (tick == NULL) {
+            tick = neu_driver_ticks_add(ticks, 1000);
+        }
+        EXPECT_EQ(0, neu_driver_tick_join(tick, &data[i], 1000, 10));
+    }
+    EXPECT_EQ(1, neu_driver_ticks_size(ticks));
+
+    neu_driver_tick_t *tick = neu_driver_ticks_find(ticks, 1000);
+    EXPECT_EQ(1000U, neu_driver_tick_period(tick));
+    for (int n : due_counts(tick, 5)) {
+        EXPECT_EQ(5, n);
+    }
+
+    for (int i = 0; i < 200; i++) {
+        EXPECT_EQ(199 - i, neu_driver_tick_leave(tick, &data[i]));
+    }
+    neu_driver_ticks_del(ticks, tick);
+    EXPECT_EQ(0, neu_driver_ticks_size(ticks));
+
+    neu_driver_ticks_free(ticks);
+}
+
+TEST(DriverTickTest, harmonic_intervals)
+{
+    neu_driver_ticks_t *ticks = neu_driver_ticks_new(1);
+    int                 a = 0, b = 0, c = 0;
+
+    neu_driver_tick_t *t500  = neu_driver_ticks_add(ticks, 500);
+    neu_driver_tick_t *t1000 = neu_driver_ticks_add(ticks, 1000);
+
+    // the biggest base interval dividing the interval wins
+    EXPECT_EQ(t1000, neu_driver_ticks_find(ticks, 3000));
+    EXPECT_EQ(t500, neu_driver_ticks_find(ticks, 1500));
+    EXPECT_EQ(NULL, neu_driver_ticks_find(ticks, 1200));
+    EXPECT_EQ(NULL, neu_driver_ticks_find(ticks, 0));
+    EXPECT_EQ(-1, neu_driver_tick_join(t1000, &a, 1500, 1));
+
+    EXPECT_EQ(0, neu_driver_tick_join(t500, &a, 500, 1));
+    EXPECT_EQ(0, neu_driver_tick_join(t500, &b, 1500, 1));
+    EXPECT_EQ(0, neu_driver_tick_join(t1000, &c, 3000, 1));
+
+    std::vector<int> n500 = due_counts(t500, 12);
+    EXPECT_EQ(12, n500[0]);
+    EXPECT_EQ(4, n500[1]);
+    EXPECT_EQ(2, due_counts(t1000, 6)[0]);
+
+    neu_driver_ticks_free(ticks);
+}
+
+TEST(DriverTickTest, phases_spread_load)
+{
+    neu_driver_ticks_t *ticks = neu_driver_ticks_new(4);
+    neu_driver_tick_t * tick  = neu_driver_ticks_add(ticks, 1000);
+    int                 data[8];
+    std::vector<int>    per_phase(4, 0);
+
+    EXPECT_EQ(4U, neu_driver_tick_phases(tick));
+    EXPECT_EQ(250U, neu_driver_tick_period(tick));
+
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(0, neu_driver_tick_join(tick, &data[i], 1000, 100));
+    }
+
+    for (int i = 0; i < neu_driver_tick_size(tick); i++) {
+        per_phase[neu_driver_tick_member(tick, i)->phase] += 1;
+    }
+    for (int n : per_phase) {
+        EXPECT_EQ(2, n);
+    }
+
+    // each group still fires once per interval
+    for (int n : due_counts(tick, 4 * 3)) {
+        EXPECT_EQ(3, n);
+    }
+
+    // a heavy group takes a phase of its own
+    int heavy = 0;
+    neu_driver_tick_leave(tick, &data[0]);
+    neu_driver_tick_leave(tick, &data[4]);
+    EXPECT_EQ(0, neu_driver_tick_join(tick, &heavy, 1000, 1000));
+    EXPECT_EQ(0U, neu_driver_tick_member(tick, 6)->phase);
+    EXPECT_EQ(0, neu_driver_tick_join(tick, &data[0], 1000, 100));
+    EXPECT_NE(0U, neu_driver_tick_member(tick, 7)->phase);
+
+    neu_driver_ticks_free(ticks);
+}
+
+TEST(DriverTickTest, phases_fit_base)
+{
+    neu_driver_ticks_t *ticks = neu_driver_ticks_new(4);
+
+    // 30 is not divisible by 4, phases are never shorter than 10ms
+    EXPECT_EQ(3U, neu_driver_tick_phases(neu_driver_ticks_add(ticks, 30)));
+    EXPECT_EQ(1U, neu_driver_tick_phases(neu_driver_ticks_add(ticks, 15)));
+    EXPECT_EQ(4U, neu_driver_tick_phases(neu_driver_ticks_add(ticks, 100)));
+
+    neu_driver_ticks_free(ticks);
+}
+
+TEST(DriverTickTest, due_between_skips)
+{
+    neu_driver_ticks_t *ticks = neu_driver_ticks_new(2);
+    neu_driver_tick_t * tick  = neu_driver_ticks_add(ticks, 1000);
+    int                 a = 0, b = 0;
+
+    // phase 0 and phase 1 of a 2s cycle of four 500ms fires
+    EXPECT_EQ(0, neu_driver_tick_join(tick, &a, 2000, 1));
+    EXPECT_EQ(0, neu_driver_tick_join(tick, &b, 2000, 1));
+    neu_driver_tick_member_t *ma = neu_driver_tick_member(tick, 0);
+    neu_driver_tick_member_t *mb = neu_driver_tick_member(tick, 1);
+    EXPECT_EQ(0U, ma->phase);
+    EXPECT_EQ(1U, mb->phase);
+
+    EXPECT_EQ(1U, neu_driver_tick_due_between(tick, ma, 0, 1));
+    EXPECT_EQ(0U, neu_driver_tick_due_between(tick, mb, 0, 1));
+    EXPECT_EQ(1U, neu_driver_tick_due_between(tick, mb, 1, 2));
+
+    // an overrun jumping over fires still reaches every member once
+    EXPECT_EQ(1U, neu_driver_tick_due_between(tick, ma, 1, 6));
+    EXPECT_EQ(2U, neu_driver_tick_due_between(tick, mb, 0, 6));
+    EXPECT_EQ(3U, neu_driver_tick_due_between(tick, ma, 0, 12));
+
+    // back-off doubles the cycle
+    ma->backoff = 1;
+    EXPECT_EQ(2U, neu_driver_tick_due_between(tick, ma, 0, 16));
+    EXPECT_TRUE(neu_driver_tick_due(tick, ma, 8));
+    EXPECT_FALSE(neu_driver_tick_due(tick, ma, 4));
+
+    neu_driver_ticks_free(ticks);
+}
+
+TEST(DriverTickTest, backoff_recovers)
+{
+    neu_driver_ticks_t *ticks = neu_driver_ticks_new(1);
+    neu_driver_tick_t * tick  = neu_driver_ticks_add(ticks, 100);
+    int                 a     = 0;
+
+    EXPECT_EQ(0, neu_driver_tick_join(tick, &a, 100, 1));
+    neu_driver_tick_member_t *m = neu_driver_tick_member(tick, 0);
+    EXPECT_EQ(100U, neu_driver_tick_interval(tick, m));
+
+    // reads of 150ms overrun 100ms, the interval is doubled
+    for (int i = 1; i < NEU_DRIVER_TICK_BACKOFF_CYCLES; i++) {
+        EXPECT_FALSE(neu_driver_tick_pace(tick, m, 150, false));
+    }
+    EXPECT_TRUE(neu_driver_tick_pace(tick, m, 150, false));
+    EXPECT_EQ(1U, m->backoff);
+    EXPECT_EQ(200U, neu_driver_tick_interval(tick, m));
+
+    // they fit the backed-off interval, it is not stretched further
+    for (int i = 0; i < 2 * NEU_DRIVER_TICK_BACKOFF_CYCLES; i++) {
+        EXPECT_FALSE(neu_driver_tick_pace(tick, m, 150, false));
+    }
+    EXPECT_EQ(1U, m->backoff);
+
+    // skipped fires are late whatever the reads took
+    for (int i = 1; i < NEU_DRIVER_TICK_BACKOFF_CYCLES; i++) {
+        EXPECT_FALSE(neu_driver_tick_pace(tick, m, 0, true));
+    }
+    EXPECT_TRUE(neu_driver_tick_pace(tick, m, 0, true));
+    EXPECT_EQ(2U, m->backoff);
+
+    // reads that keep up with headroom restore the interval step by step
+    for (int i = 1; i < NEU_DRIVER_TICK_RESTORE_CYCLES; i++) {
+        EXPECT_FALSE(neu_driver_tick_pace(tick, m, 70, false));
+    }
+    EXPECT_TRUE(neu_driver_tick_pace(tick, m, 70, false));
+    EXPECT_EQ(1U, m->backoff);
+    for (int i = 1; i < NEU_DRIVER_TICK_RESTORE_CYCLES; i++) {
+        EXPECT_FALSE(neu_driver_tick_pace(tick, m, 70, false));
+    }
+    EXPECT_TRUE(neu_driver_tick_pace(tick, m, 70, false));
+    EXPECT_EQ(0U, m->backoff);
+    EXPECT_EQ(100U, neu_driver_tick_interval(tick, m));
+
+    neu_driver_ticks_free(ticks);
+}
+
+TEST(DriverTickTest, deadline_policy)
+{
+    EXPECT_EQ(NEU_DRIVER_DEADLINE_DRIFT, neu_driver_deadline_parse("drift"));
+    EXPECT_EQ(NEU_DRIVER_DEADLINE_SKIP, neu_driver_deadline_parse("skip"));
+    EXPECT_EQ(NEU_DRIVER_DEADLINE_BACKOFF,
+              neu_driver_deadline_parse("backoff"));
+    EXPECT_EQ(-1, neu_driver_deadline_parse("none"));
+    EXPECT_STREQ("skip", neu_driver_deadline_str(NEU_DRIVER_DEADLINE_SKIP));
+}
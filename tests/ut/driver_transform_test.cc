@@ -0,0 +1,246 @@
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "adapter/driver/transform.h"
+}
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+static int64_t now_ns()
+{
+    struct timespec ts = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static neu_datatag_t make_tag(neu_type_e type, double decimal, double bias,
+                              uint8_t precision)
+{
+    neu_datatag_t tag = {};
+
+    tag.type      = type;
+    tag.decimal   = decimal;
+    tag.bias      = bias;
+    tag.precision = precision;
+    return tag;
+}
+
+// rounding of the read path before it was compiled into a plan
+static void legacy_format(neu_dvalue_t *value)
+{
+    double scale    = pow(10, 5);
+    int    negative = 1;
+
+    if (value->value.d64 < 0) {
+        value->value.d64 *= -1;
+        negative = -1;
+    }
+
+    int64_t integer_part = (int64_t) value->value.d64;
+    double  decimal_part = value->value.d64 - integer_part;
+    decimal_part *= scale;
+    decimal_part = round(decimal_part);
+    char str[6]  = { 0 };
+    snprintf(str, sizeof(str), "%05" PRId64 "", (int64_t) decimal_part);
+    int i = 0, flag = 0;
+    for (; i < 4; i++) {
+        if (str[i] == '0' && str[i + 1] == '0') {
+            flag = 1;
+            break;
+        } else if (str[i] == '9' && str[i + 1] == '9') {
+            flag = 2;
+            break;
+        }
+    }
+    if (flag != 0 && i != 0) {
+        decimal_part     = round(decimal_part / pow(10, 5 - i));
+        value->value.d64 = (double) integer_part + decimal_part / pow(10, i);
+    } else {
+        value->value.d64 = (double) integer_part + decimal_part / scale;
+    }
+
+    value->value.d64 *= negative;
+}
+
+TEST(DriverTransformTest, round_matches_legacy)
+{
+    const double values[] = { 0,        1.2999999, -1.2999999, 0.1000001,
+                              3.14159,  2.00001,   12.99999,   -0.0049,
+                              99.99999, 0.99999,   7.123456,   1e9 + 0.25 };
+
+    for (double v : values) {
+        neu_dvalue_t legacy = {};
+
+        legacy.value.d64 = v;
+        legacy_format(&legacy);
+        EXPECT_EQ(legacy.value.d64, neu_tag_transform_round(v)) << v;
+    }
+
+    srand(1);
+    for (int i = 0; i < 100000; i++) {
+        neu_dvalue_t legacy = {};
+        double       v      = ((double) rand() / RAND_MAX - 0.5) * 2e4;
+
+        legacy.value.d64 = v;
+        legacy_format(&legacy);
+        ASSERT_EQ(legacy.value.d64, neu_tag_transform_round(v)) << v;
+    }
+
+    EXPECT_DOUBLE_EQ(1.3, neu_tag_transform_round(1.2999999));
+    EXPECT_DOUBLE_EQ(-0.1, neu_tag_transform_round(-0.1000001));
+}
+
+TEST(DriverTransformTest, plan_steps)
+{
+    neu_tag_transform_t plan  = {};
+    neu_dvalue_t        value = {};
+
+    // nothing to do
+    neu_datatag_t tag = make_tag(NEU_TYPE_INT32, 0, 0, 0);
+    neu_tag_transform_compile(&plan, &tag);
+    EXPECT_EQ(0, plan.n_step);
+
+    // swap, then scale and offset into a double
+    tag                       = make_tag(NEU_TYPE_INT32, 0.5, 10, 0);
+    tag.option.value32.endian = NEU_DATATAG_ENDIAN_BB32;
+    neu_tag_transform_compile(&plan, &tag);
+    EXPECT_EQ(2, plan.n_step);
+    value.type      = NEU_TYPE_INT32;
+    value.value.u32 = htonl(100);
+    neu_tag_transform_apply(&plan, &value);
+    EXPECT_EQ(NEU_TYPE_DOUBLE, value.type);
+    EXPECT_DOUBLE_EQ(60, value.value.d64);
+
+    // doubles without precision are rounded
+    tag = make_tag(NEU_TYPE_DOUBLE, 0, 0, 0);
+    neu_tag_transform_compile(&plan, &tag);
+    value.type      = NEU_TYPE_DOUBLE;
+    value.value.d64 = 2.0999999;
+    neu_tag_transform_apply(&plan, &value);
+    EXPECT_DOUBLE_EQ(2.1, value.value.d64);
+
+    // non numeric types keep their value and take the type of the tag
+    tag = make_tag(NEU_TYPE_STRING, 2, 0, 0);
+    neu_tag_transform_compile(&plan, &tag);
+    EXPECT_EQ(0, plan.n_step);
+    EXPECT_EQ(NEU_TYPE_STRING, plan.type);
+}
+
+/*
+ * Benchmark of the plan against the read path it replaced, below. Disabled,
+ * run with --gtest_also_run_disabled_tests
+ * --gtest_filter='DriverTransformBench.*'.
+ */
+static void legacy_transform(const neu_datatag_t *tag, neu_dvalue_t *value)
+{
+    switch (tag->type) {
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_INT32:
+        switch (tag->option.value32.endian) {
+        case NEU_DATATAG_ENDIAN_BB32:
+            value->value.u32 = htonl(value->value.u32);
+            break;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (tag->decimal != 0 || tag->bias != 0) {
+        double decimal = tag->decimal != 0 ? tag->decimal : 1;
+
+        value->type = NEU_TYPE_DOUBLE;
+        switch (tag->type) {
+        case NEU_TYPE_INT32:
+            value->value.d64 = (double) value->value.i32 * decimal + tag->bias;
+            break;
+        case NEU_TYPE_FLOAT:
+            value->value.d64 = (double) value->value.f32 * decimal + tag->bias;
+            break;
+        case NEU_TYPE_DOUBLE:
+            value->value.d64 = value->value.d64 * decimal + tag->bias;
+            break;
+        default:
+            value->type = tag->type;
+            break;
+        }
+    }
+    if (tag->precision == 0 && tag->bias == 0 &&
+        tag->type == NEU_TYPE_DOUBLE) {
+        legacy_format(value);
+    }
+}
+
+static void bench(const char *name, neu_datatag_t tag, neu_dvalue_t value)
+{
+    const int                 n_tag   = 10000;
+    const int                 n_round = 100;
+    std::vector<neu_dvalue_t> values(n_tag, value);
+    neu_tag_transform_t       plan = {};
+    double                    sum  = 0;
+    int64_t                   start, legacy_ns, plan_ns;
+
+    start = now_ns();
+    for (int r = 0; r < n_round; r++) {
+        for (int i = 0; i < n_tag; i++) {
+            neu_dvalue_t v = values[i];
+
+            legacy_transform(&tag, &v);
+            sum += v.value.d64;
+        }
+    }
+    legacy_ns = now_ns() - start;
+
+    neu_tag_transform_compile(&plan, &tag);
+    start = now_ns();
+    for (int r = 0; r < n_round; r++) {
+        for (int i = 0; i < n_tag; i++) {
+            neu_dvalue_t v = values[i];
+
+            neu_tag_transform_apply(&plan, &v);
+            sum += v.value.d64;
+        }
+    }
+    plan_ns = now_ns() - start;
+
+    printf("%-16s legacy %8.2f Mtags/s, plan %8.2f Mtags/s (%g)\n", name,
+           (double) n_tag * n_round * 1000.0 / (double) legacy_ns,
+           (double) n_tag * n_round * 1000.0 / (double) plan_ns, sum);
+}
+
+TEST(DriverTransformBench, DISABLED_tags_per_second)
+{
+    neu_datatag_t tag   = {};
+    neu_dvalue_t  value = {};
+
+    tag                       = make_tag(NEU_TYPE_FLOAT, 0.1, 2, 0);
+    tag.option.value32.endian = NEU_DATATAG_ENDIAN_BB32;
+    value.type                = NEU_TYPE_FLOAT;
+    value.value.f32           = 12.5;
+    bench("float scaled", tag, value);
+
+    tag             = make_tag(NEU_TYPE_INT32, 0.01, 0, 0);
+    value.type      = NEU_TYPE_INT32;
+    value.value.i32 = 12345;
+    bench("int32 scaled", tag, value);
+
+    tag             = make_tag(NEU_TYPE_DOUBLE, 0, 0, 0);
+    value.type      = NEU_TYPE_DOUBLE;
+    value.value.d64 = 1.2999999;
+    bench("double rounded", tag, value);
+}
@@ -0,0 +1,316 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "event/event.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+struct counter {
+    pthread_mutex_t mtx;
+    int             n;
+    int             sleep_ms;
+};
+
+static int count_cb(void *usr_data)
+{
+    struct counter *c = (struct counter *) usr_data;
+
+    pthread_mutex_lock(&c->mtx);
+    c->n += 1;
+    pthread_mutex_unlock(&c->mtx);
+
+    if (c->sleep_ms > 0) {
+        usleep(c->sleep_ms * 1000);
+    }
+    return 0;
+}
+
+static int count(struct counter *c)
+{
+    pthread_mutex_lock(&c->mtx);
+    int n = c->n;
+    pthread_mutex_unlock(&c->mtx);
+    return n;
+}
+
+TEST(EventTest, timers_fire_periodically)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct counter          fast   = { PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+    struct counter          slow   = { PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+    struct counter          idle   = { PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+    neu_event_timer_param_t param  = {};
+
+    param.millisecond = 10;
+    param.usr_data    = &fast;
+    param.cb          = count_cb;
+    param.type        = NEU_EVENT_TIMER_NOBLOCK;
+    neu_event_timer_t *t1 = neu_event_add_timer(events, param);
+
+    param.millisecond = 100;
+    param.usr_data    = &slow;
+    param.type        = NEU_EVENT_TIMER_BLOCK;
+    neu_event_timer_t *t2 = neu_event_add_timer(events, param);
+
+    param.millisecond = 0;
+    param.usr_data    = &idle;
+    neu_event_timer_t *t3 = neu_event_add_timer(events, param);
+
+    usleep(550 * 1000);
+
+    EXPECT_GE(count(&fast), 40);
+    EXPECT_LE(count(&fast), 56);
+    EXPECT_GE(count(&slow), 4);
+    EXPECT_LE(count(&slow), 6);
+    EXPECT_EQ(0, count(&idle));
+
+    neu_event_del_timer(events, t1);
+    neu_event_del_timer(events, t2);
+    neu_event_del_timer(events, t3);
+
+    int n = count(&fast);
+    usleep(50 * 1000);
+    EXPECT_EQ(n, count(&fast));
+
+    neu_event_close(events);
+}
+
+TEST(EventTest, long_timer_cascades)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct counter          c      = { PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+    neu_event_timer_param_t param  = {};
+
+    // beyond level 0 of the wheel, fires after a cascade
+    param.millisecond = 300;
+    param.usr_data    = &c;
+    param.cb          = count_cb;
+    param.type        = NEU_EVENT_TIMER_BLOCK;
+    neu_event_timer_t *timer = neu_event_add_timer(events, param);
+
+    usleep(250 * 1000);
+    EXPECT_EQ(0, count(&c));
+    usleep(150 * 1000);
+    EXPECT_EQ(1, count(&c));
+
+    neu_event_del_timer(events, timer);
+    neu_event_close(events);
+}
+
+TEST(EventTest, timer_after_idle_loop)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct counter          c      = { PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+    neu_event_timer_param_t param  = {};
+
+    // the wheel of an idle loop catches up with the clock on insertion
+    usleep(200 * 1000);
+    param.millisecond = 30;
+    param.usr_data    = &c;
+    param.cb          = count_cb;
+    param.type        = NEU_EVENT_TIMER_BLOCK;
+    neu_event_timer_t *timer = neu_event_add_timer(events, param);
+
+    usleep(20 * 1000);
+    EXPECT_EQ(0, count(&c));
+    usleep(25 * 1000);
+    EXPECT_EQ(1, count(&c));
+
+    neu_event_del_timer(events, timer);
+    neu_event_close(events);
+}
+
+TEST(EventTest, timer_first_fire_delay)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct counter          c      = { PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+    neu_event_timer_param_t param  = {};
+
+    // first fire after the delay, then every period
+    param.millisecond = 100;
+    param.delay       = 30;
+    param.usr_data    = &c;
+    param.cb          = count_cb;
+    param.type        = NEU_EVENT_TIMER_BLOCK;
+    neu_event_timer_t *timer = neu_event_add_timer(events, param);
+
+    usleep(20 * 1000);
+    EXPECT_EQ(0, count(&c));
+    usleep(30 * 1000);
+    EXPECT_EQ(1, count(&c));
+    usleep(100 * 1000);
+    EXPECT_EQ(2, count(&c));
+
+    neu_event_del_timer(events, timer);
+    neu_event_close(events);
+}
+
+TEST(EventTest, post_timer_fires_early)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct counter          c      = { PTHREAD_MUTEX_INITIALIZER, 0, 0 };
+    neu_event_timer_param_t param  = {};
+
+    param.millisecond = 500;
+    param.usr_data    = &c;
+    param.cb          = count_cb;
+    param.type        = NEU_EVENT_TIMER_NOBLOCK;
+    neu_event_timer_t *timer = neu_event_add_timer(events, param);
+
+    EXPECT_EQ(0, neu_event_post_timer(events, timer));
+    usleep(20 * 1000);
+    EXPECT_EQ(1, count(&c));
+
+    // the next period is counted from the posted fire
+    usleep(400 * 1000);
+    EXPECT_EQ(1, count(&c));
+    usleep(150 * 1000);
+    EXPECT_EQ(2, count(&c));
+
+    neu_event_del_timer(events, timer);
+    neu_event_close(events);
+}
+
+TEST(EventTest, post_timer_while_running)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct counter          c      = { PTHREAD_MUTEX_INITIALIZER, 0, 50 };
+    neu_event_timer_param_t param  = {};
+
+    param.millisecond = 500;
+    param.usr_data    = &c;
+    param.cb          = count_cb;
+    param.type        = NEU_EVENT_TIMER_BLOCK;
+    neu_event_timer_t *timer = neu_event_add_timer(events, param);
+
+    neu_event_post_timer(events, timer);
+    usleep(20 * 1000);
+    EXPECT_EQ(1, count(&c));
+
+    // runs once more after the running callback, not once per post
+    neu_event_post_timer(events, timer);
+    neu_event_post_timer(events, timer);
+    usleep(100 * 1000);
+    EXPECT_EQ(2, count(&c));
+    usleep(200 * 1000);
+    EXPECT_EQ(2, count(&c));
+
+    neu_event_del_timer(events, timer);
+    neu_event_close(events);
+}
+
+TEST(EventTest, del_waits_running_callback)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct counter          c      = { PTHREAD_MUTEX_INITIALIZER, 0, 100 };
+    neu_event_timer_param_t param  = {};
+
+    param.millisecond = 5;
+    param.usr_data    = &c;
+    param.cb          = count_cb;
+    param.type        = NEU_EVENT_TIMER_BLOCK;
+    neu_event_timer_t *timer = neu_event_add_timer(events, param);
+
+    usleep(20 * 1000);
+    EXPECT_EQ(1, count(&c));
+    neu_event_del_timer(events, timer);
+
+    usleep(150 * 1000);
+    EXPECT_EQ(1, count(&c));
+
+    neu_event_close(events);
+}
+
+struct self_del {
+    neu_events_t *     events;
+    neu_event_timer_t *timer;
+    int                n;
+};
+
+static int self_del_cb(void *usr_data)
+{
+    struct self_del *ctx = (struct self_del *) usr_data;
+
+    ctx->n += 1;
+    neu_event_del_timer(ctx->events, ctx->timer);
+    return 0;
+}
+
+TEST(EventTest, del_timer_in_callback)
+{
+    neu_events_t *          events = neu_event_new("event_test");
+    struct self_del         ctx    = { events, NULL, 0 };
+    neu_event_timer_param_t param  = {};
+
+    param.millisecond = 5;
+    param.usr_data    = &ctx;
+    param.cb          = self_del_cb;
+    param.type        = NEU_EVENT_TIMER_NOBLOCK;
+
+    ctx.timer = neu_event_add_timer(events, param);
+    usleep(50 * 1000);
+    EXPECT_EQ(1, ctx.n);
+
+    neu_event_close(events);
+}
+
+struct io_ctx {
+    pthread_mutex_t mtx;
+    int             n_read;
+};
+
+static int io_cb(enum neu_event_io_type type, int fd, void *usr_data)
+{
+    struct io_ctx *ctx = (struct io_ctx *) usr_data;
+    char           buf[16];
+
+    if (type == NEU_EVENT_IO_READ) {
+        ssize_t size = read(fd, buf, sizeof(buf));
+        (void) size;
+
+        pthread_mutex_lock(&ctx->mtx);
+        ctx->n_read += 1;
+        pthread_mutex_unlock(&ctx->mtx);
+    }
+    return 0;
+}
+
+TEST(EventTest, many_io)
+{
+    const int       n_io   = 600;
+    neu_events_t *  events = neu_event_new("event_test");
+    struct io_ctx   ctx    = { PTHREAD_MUTEX_INITIALIZER, 0 };
+    int             fds[n_io][2];
+    neu_event_io_t *ios[n_io];
+
+    // more fds than a single slot chunk
+    for (int i = 0; i < n_io; i++) {
+        neu_event_io_param_t param = {};
+
+        ASSERT_EQ(0, pipe(fds[i]));
+        param.fd       = fds[i][0];
+        param.usr_data = &ctx;
+        param.cb       = io_cb;
+        ios[i]         = neu_event_add_io(events, param);
+    }
+
+    for (int i = 0; i < n_io; i++) {
+        ASSERT_EQ(1, write(fds[i][1], "x", 1));
+    }
+    usleep(100 * 1000);
+
+    pthread_mutex_lock(&ctx.mtx);
+    EXPECT_EQ(n_io, ctx.n_read);
+    pthread_mutex_unlock(&ctx.mtx);
+
+    for (int i = 0; i < n_io; i++) {
+        neu_event_del_io(events, ios[i]);
+        close(fds[i][0]);
+        close(fds[i][1]);
+    }
+
+    neu_event_close(events);
+}
@@ -0,0 +1,153 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/log.h"
+#include "utils/mem_pool.h"
+
+zlog_category_t *neuron = NULL;
+
+static neu_mem_pool_stats_t stats(neu_mem_pool_e pool)
+{
+    neu_mem_pool_stats_t s = {};
+
+    neu_mem_pool_stats(pool, &s);
+    return s;
+}
+
+TEST(MemPoolTest, alloc_zeroed_and_aligned)
+{
+    uint64_t in_use = stats(NEU_MEM_POOL_MSG).in_use;
+
+    for (size_t size = 1; size <= 16384; size *= 3) {
+        uint8_t *p = (uint8_t *) neu_mem_pool_alloc(NEU_MEM_POOL_MSG, size);
+
+        ASSERT_NE(nullptr, p);
+        EXPECT_EQ(0U, (uintptr_t) p % 16);
+        for (size_t i = 0; i < size; i++) {
+            ASSERT_EQ(0, p[i]);
+        }
+        memset(p, 0xff, size);
+        EXPECT_EQ(in_use + 1, stats(NEU_MEM_POOL_MSG).in_use);
+        neu_mem_pool_free(p);
+    }
+
+    EXPECT_EQ(in_use, stats(NEU_MEM_POOL_MSG).in_use);
+    neu_mem_pool_free(NULL);
+}
+
+TEST(MemPoolTest, reuse_freed_blocks)
+{
+    void *p1 = neu_mem_pool_alloc(NEU_MEM_POOL_TRANS_CTX, 40);
+    neu_mem_pool_free(p1);
+
+    uint64_t mallocs = stats(NEU_MEM_POOL_TRANS_CTX).mallocs;
+    void *   p2      = neu_mem_pool_alloc(NEU_MEM_POOL_TRANS_CTX, 40);
+
+    EXPECT_EQ(p1, p2);
+    EXPECT_EQ(mallocs, stats(NEU_MEM_POOL_TRANS_CTX).mallocs);
+    neu_mem_pool_free(p2);
+}
+
+TEST(MemPoolTest, large_block_bypasses_classes)
+{
+    uint64_t mallocs = stats(NEU_MEM_POOL_MSG).mallocs;
+
+    void *p = neu_mem_pool_alloc(NEU_MEM_POOL_MSG, 64 * 1024);
+    ASSERT_NE(nullptr, p);
+    neu_mem_pool_free(p);
+
+    p = neu_mem_pool_alloc(NEU_MEM_POOL_MSG, 64 * 1024);
+    neu_mem_pool_free(p);
+
+    EXPECT_EQ(mallocs + 2, stats(NEU_MEM_POOL_MSG).mallocs);
+}
+
+// blocks allocated by a producer and freed by a consumer flow back to the
+// producer through the depot
+TEST(MemPoolTest, cross_thread_steady_state)
+{
+    const int           n_round = 200;
+    const int           n_batch = 256;
+    std::vector<void *> batch(n_batch);
+    uint64_t            mallocs = 0;
+    uint64_t            in_use  = stats(NEU_MEM_POOL_MSG).in_use;
+
+    for (int round = 0; round < n_round; round++) {
+        if (round == 1) {
+            mallocs = stats(NEU_MEM_POOL_MSG).mallocs;
+        }
+
+        for (int i = 0; i < n_batch; i++) {
+            batch[i] = neu_mem_pool_alloc(NEU_MEM_POOL_MSG, 200);
+        }
+
+        std::thread consumer([&]() {
+            for (int i = 0; i < n_batch; i++) {
+                neu_mem_pool_free(batch[i]);
+            }
+        });
+        consumer.join();
+    }
+
+    // only the first round misses the caches
+    EXPECT_LE(stats(NEU_MEM_POOL_MSG).mallocs - mallocs, (uint64_t) n_batch);
+    EXPECT_EQ(in_use, stats(NEU_MEM_POOL_MSG).in_use);
+    EXPECT_GT(stats(NEU_MEM_POOL_MSG).cached, 0U);
+}
+
+TEST(MemPoolTest, intern_shares_copies)
+{
+    char  name[16] = "driver";
+    char *s1       = neu_str_intern(name);
+    char *s2       = neu_str_intern("driver");
+    char *s3       = neu_str_intern("group");
+
+    EXPECT_STREQ("driver", s1);
+    EXPECT_EQ(s1, s2);
+    EXPECT_NE(s1, s3);
+    EXPECT_EQ(s1, neu_str_ref(s1));
+
+    neu_str_release(s1);
+    neu_str_release(s1);
+    EXPECT_STREQ("driver", s2);
+    neu_str_release(s2);
+    neu_str_release(s3);
+    neu_str_release(NULL);
+
+    uint64_t in_use = stats(NEU_MEM_POOL_NAME).in_use;
+    char *   s4     = neu_str_intern("driver");
+    EXPECT_EQ(in_use + 1, stats(NEU_MEM_POOL_NAME).in_use);
+    neu_str_release(s4);
+    EXPECT_EQ(in_use, stats(NEU_MEM_POOL_NAME).in_use);
+}
+
+TEST(MemPoolTest, intern_concurrent_release)
+{
+    const int                n_thread = 4;
+    const int                n_loop   = 20000;
+    std::vector<std::thread> threads;
+    uint64_t                 in_use = stats(NEU_MEM_POOL_NAME).in_use;
+
+    for (int t = 0; t < n_thread; t++) {
+        threads.emplace_back([&]() {
+            for (int i = 0; i < n_loop; i++) {
+                char *s = neu_str_intern("shared");
+                char *r = neu_str_ref(s);
+
+                ASSERT_STREQ("shared", r);
+                neu_str_release(s);
+                neu_str_release(r);
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    EXPECT_EQ(in_use, stats(NEU_MEM_POOL_NAME).in_use);
+}
@@ -1,9 +1,28 @@
+#include <condition_variable>
 #include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
 #include <gtest/gtest.h>
 #include <neuron.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 extern "C" {
 #include "modbus.h"
+#include "modbus_bus.h"
+#include "modbus_coalesce.h"
+#include "modbus_decode.h"
+#include "modbus_health.h"
+#include "modbus_pace.h"
 #include "modbus_point.h"
+#include "modbus_req.h"
+#include "modbus_window.h"
 }
 
 zlog_category_t *neuron           = NULL;
@@ -154,6 +173,1088 @@ TEST(test_modbus_data_unwrap, should_return_right_data_value)
     EXPECT_EQ(0x44, *(bytes + 3));
 }
 
+TEST(test_modbus_window, should_match_out_of_order_responses)
+{
+    modbus_window_t *window = modbus_window_new(3);
+    modbus_txn_t *   txns[3] = { NULL };
+
+    for (uint16_t i = 0; i < 3; i++) {
+        txns[i] = modbus_window_get(window);
+        ASSERT_NE(nullptr, txns[i]);
+        modbus_window_sent(window, txns[i], i, 100 + i, 17, 0, 1000);
+    }
+    EXPECT_EQ(nullptr, modbus_window_get(window));
+    EXPECT_EQ(3, modbus_window_inflight(window));
+
+    modbus_txn_t *txn = modbus_window_match(window, 102);
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(2, txn->cmd);
+    modbus_window_done(window, txn);
+    EXPECT_EQ(nullptr, modbus_window_match(window, 102));
+
+    txn = modbus_window_match(window, 100);
+    ASSERT_NE(nullptr, txn);
+    EXPECT_EQ(0, txn->cmd);
+    modbus_window_done(window, txn);
+
+    EXPECT_EQ(1, modbus_window_busy(window));
+    EXPECT_NE(nullptr, modbus_window_get(window));
+
+    modbus_window_free(window);
+}
+
+TEST(test_modbus_window, should_expire_and_resend_transactions)
+{
+    modbus_window_t *window = modbus_window_new(2);
+    modbus_txn_t *   t1     = modbus_window_get(window);
+
+    modbus_window_sent(window, t1, 0, 1, 17, 0, 100);
+    modbus_txn_t *t2 = modbus_window_get(window);
+    modbus_window_sent(window, t2, 1, 2, 25, 50, 100);
+    EXPECT_EQ(25, modbus_window_response_size(window));
+    EXPECT_EQ(100, modbus_window_next(window));
+
+    EXPECT_EQ(nullptr, modbus_window_expired(window, 99));
+    EXPECT_EQ(t1, modbus_window_expired(window, 200));
+
+    // a resend gets a new transaction id, the old one is no longer matched
+    modbus_window_retry(window, t1, 120);
+    EXPECT_EQ(1, modbus_window_inflight(window));
+    EXPECT_EQ(2, modbus_window_busy(window));
+    EXPECT_EQ(nullptr, modbus_window_due(window, 110));
+    EXPECT_EQ(t1, modbus_window_due(window, 120));
+
+    modbus_window_sent(window, t1, 0, 3, 17, 120, 100);
+    EXPECT_EQ(1, t1->retries);
+    EXPECT_EQ(nullptr, modbus_window_match(window, 1));
+    EXPECT_EQ(t1, modbus_window_match(window, 3));
+
+    modbus_window_reset(window);
+    EXPECT_EQ(0, modbus_window_busy(window));
+    EXPECT_EQ(-1, modbus_window_next(window));
+
+    modbus_window_free(window);
+}
+
+TEST(test_modbus_health, should_back_off_unanswered_probes)
+{
+    modbus_health_t *health = modbus_health_new();
+
+    modbus_health_config(health, 2, 1000, 3000, 0);
+
+    // one failed cycle is tolerated, a response clears it
+    EXPECT_EQ(0, modbus_health_failure(health, 1, 0));
+    modbus_health_success(health, 1);
+    EXPECT_EQ(0, modbus_health_failure(health, 1, 0));
+    EXPECT_EQ(1000, modbus_health_failure(health, 1, 10));
+    EXPECT_EQ(MODBUS_SLAVE_DOWN, modbus_health_get(health, 1)->state);
+    EXPECT_TRUE(modbus_health_usable(health, 2, 10));
+    EXPECT_EQ(1, modbus_health_down(health));
+
+    // one probe once the wait is over, the wait doubles up to the max
+    EXPECT_FALSE(modbus_health_usable(health, 1, 1009));
+    EXPECT_TRUE(modbus_health_usable(health, 1, 1010));
+    EXPECT_FALSE(modbus_health_usable(health, 1, 1011));
+    EXPECT_EQ(2000, modbus_health_failure(health, 1, 1100));
+    EXPECT_TRUE(modbus_health_usable(health, 1, 3100));
+    EXPECT_EQ(3000, modbus_health_failure(health, 1, 3200));
+    EXPECT_TRUE(modbus_health_usable(health, 1, 6200));
+    EXPECT_EQ(3000, modbus_health_failure(health, 1, 6300));
+
+    // an answered probe brings the slave back
+    EXPECT_TRUE(modbus_health_usable(health, 1, 9300));
+    modbus_health_success(health, 1);
+    EXPECT_EQ(MODBUS_SLAVE_UP, modbus_health_get(health, 1)->state);
+    EXPECT_EQ(0, modbus_health_down(health));
+
+    modbus_health_free(health);
+}
+
+TEST(test_modbus_health, should_spread_probes_by_jitter)
+{
+    modbus_health_t *health = modbus_health_new();
+    int64_t          min    = INT64_MAX;
+    int64_t          max    = 0;
+
+    modbus_health_config(health, 1, 1000, 1000, 20);
+    modbus_health_seed(health, 42);
+
+    // slaves down together are not probed together
+    for (int i = 0; i < 200; i++) {
+        int64_t wait = modbus_health_failure(health, (uint8_t) i, 0);
+
+        EXPECT_GE(wait, 800);
+        EXPECT_LE(wait, 1200);
+        min = wait < min ? wait : min;
+        max = wait > max ? wait : max;
+    }
+    EXPECT_GT(max - min, 200);
+
+    // a probe without verdict is retried after another wait
+    EXPECT_TRUE(modbus_health_usable(health, 0, 1200));
+    EXPECT_FALSE(modbus_health_usable(health, 0, 1300));
+    EXPECT_TRUE(modbus_health_usable(health, 0, 2400));
+
+    modbus_health_free(health);
+}
+
+TEST(test_modbus_pace, should_space_requests_by_interval)
+{
+    modbus_pace_t pace = { 0 };
+
+    modbus_pace_init(&pace, 100, 1);
+
+    // the first request goes at once, the gap counts from the response
+    EXPECT_EQ(0, modbus_pace_wait(&pace, 1000));
+    modbus_pace_take(&pace, 1050);
+    EXPECT_EQ(70, modbus_pace_wait(&pace, 1080));
+    EXPECT_EQ(0, modbus_pace_wait(&pace, 1150));
+
+    // idle time is not saved up beyond the burst
+    modbus_pace_take(&pace, 5000);
+    EXPECT_EQ(100, modbus_pace_wait(&pace, 5000));
+
+    modbus_pace_init(&pace, 100, 3);
+    modbus_pace_take(&pace, 1000);
+    modbus_pace_take(&pace, 1000);
+    EXPECT_EQ(0, modbus_pace_wait(&pace, 1000));
+    modbus_pace_take(&pace, 1000);
+    EXPECT_EQ(100, modbus_pace_wait(&pace, 1000));
+
+    // no interval never waits
+    modbus_pace_init(&pace, 0, 1);
+    modbus_pace_take(&pace, 1000);
+    EXPECT_EQ(0, modbus_pace_wait(&pace, 1000));
+}
+
+static modbus_point_t *hold_point(uint8_t slave_id, uint16_t start_address,
+                                  uint16_t n_register)
+{
+    modbus_point_t *p = (modbus_point_t *) calloc(1, sizeof(modbus_point_t));
+
+    p->slave_id      = slave_id;
+    p->area          = MODBUS_AREA_HOLD_REGISTER;
+    p->start_address = start_address;
+    p->n_register    = n_register;
+    p->type          = NEU_TYPE_UINT16;
+    return p;
+}
+
+static UT_array *sparse_points(void)
+{
+    UT_array *tags = NULL;
+    // holes of 3 and 40 registers
+    modbus_point_t *points[] = { hold_point(1, 0, 2), hold_point(1, 5, 1),
+                                 hold_point(1, 46, 2) };
+
+    utarray_new(tags, &ut_ptr_icd);
+    for (modbus_point_t *p : points) {
+        utarray_push_back(tags, &p);
+    }
+    return tags;
+}
+
+static void free_points(UT_array *tags)
+{
+    utarray_foreach(tags, modbus_point_t **, p) { free(*p); }
+    utarray_free(tags);
+}
+
+TEST(test_modbus_read_plan, should_only_merge_contiguous_without_plan)
+{
+    UT_array *              tags = sparse_points();
+    modbus_read_cmd_sort_t *sort = modbus_tag_sort(tags, 250, NULL);
+
+    EXPECT_EQ(3, sort->n_cmd);
+    EXPECT_EQ(10U, sort->n_byte);
+    EXPECT_EQ(0U, sort->n_gap_byte);
+
+    modbus_tag_sort_free(sort);
+    free_points(tags);
+}
+
+TEST(test_modbus_read_plan, should_bridge_holes_cheaper_than_a_cmd)
+{
+    UT_array *         tags = sparse_points();
+    modbus_read_plan_t plan = { 0 };
+
+    // 10ms at 1000 bytes/s moves 10 bytes, plus 21 bytes of framing
+    plan.rtt       = 10;
+    plan.bandwidth = 1000;
+    plan.overhead  = 21;
+    EXPECT_EQ(31U, modbus_read_plan_max_gap(&plan));
+
+    modbus_read_cmd_sort_t *sort = modbus_tag_sort(tags, 250, &plan);
+    ASSERT_EQ(2, sort->n_cmd);
+    EXPECT_EQ(0, sort->cmd[0].start_address);
+    EXPECT_EQ(6, sort->cmd[0].n_register);
+    EXPECT_EQ(2U, utarray_len(sort->cmd[0].tags));
+    EXPECT_EQ(46, sort->cmd[1].start_address);
+    EXPECT_EQ(6U, sort->n_gap_byte);
+    EXPECT_EQ(16U, sort->n_byte);
+    modbus_tag_sort_free(sort);
+
+    // a slow link reads the 40 registers hole rather than paying a round trip
+    plan.rtt = 100;
+    sort     = modbus_tag_sort(tags, 250, &plan);
+    ASSERT_EQ(1, sort->n_cmd);
+    EXPECT_EQ(48, sort->cmd[0].n_register);
+    EXPECT_EQ(86U, sort->n_gap_byte);
+    modbus_tag_sort_free(sort);
+
+    // unless the command would exceed the biggest response
+    sort = modbus_tag_sort(tags, 60, &plan);
+    EXPECT_EQ(2, sort->n_cmd);
+    modbus_tag_sort_free(sort);
+
+    modbus_read_plan_fini(&plan);
+    free_points(tags);
+}
+
+TEST(test_modbus_read_plan, should_not_bridge_forbidden_ranges)
+{
+    UT_array *         tags = sparse_points();
+    modbus_read_plan_t plan = { 0 };
+
+    plan.rtt       = 100;
+    plan.bandwidth = 1000;
+
+    EXPECT_EQ(-1, modbus_read_plan_forbid(&plan, "1!4x-10", base_0));
+    EXPECT_EQ(-1, modbus_read_plan_forbid(&plan, "1!40020-40010", base_0));
+    EXPECT_EQ(0, plan.n_forbidden);
+
+    // 400021-400030 are holding registers 20 to 29 of slave 1 with base 1
+    EXPECT_EQ(0,
+              modbus_read_plan_forbid(&plan, "1!400021-400030, 2!400001-400010",
+                                      base_1));
+    ASSERT_EQ(2, plan.n_forbidden);
+    EXPECT_EQ(20U, plan.forbidden[0].start);
+    EXPECT_EQ(30U, plan.forbidden[0].end);
+
+    modbus_read_cmd_sort_t *sort = modbus_tag_sort(tags, 250, &plan);
+    ASSERT_EQ(2, sort->n_cmd);
+    EXPECT_EQ(6, sort->cmd[0].n_register);
+    modbus_tag_sort_free(sort);
+
+    modbus_read_plan_fini(&plan);
+    free_points(tags);
+}
+
+static modbus_point_write_t write_point(uint8_t slave_id, modbus_area_e area,
+                                        uint16_t start_address, neu_type_e type,
+                                        uint16_t n_register, uint32_t value)
+{
+    modbus_point_write_t w = {};
+
+    w.point.slave_id      = slave_id;
+    w.point.area          = area;
+    w.point.start_address = start_address;
+    w.point.type          = type;
+    w.point.n_register    = n_register;
+    if (type == NEU_TYPE_BIT) {
+        w.value.i8 = (int8_t) value;
+    } else if (n_register == 1) {
+        w.value.u16 = (uint16_t) value;
+    } else {
+        w.value.u32 = value;
+    }
+    return w;
+}
+
+typedef std::vector<std::pair<void *, int>> write_resps_t;
+
+static int record_resp(void *ctx, void *req, int error)
+{
+    ((write_resps_t *) ctx)->push_back(std::make_pair(req, error));
+    return 0;
+}
+
+TEST(test_modbus_coalesce, should_merge_contiguous_writes_of_requests)
+{
+    modbus_coalesce_t *  coalesce = modbus_coalesce_new();
+    write_resps_t        resps;
+    int                  a = 0, b = 0, c = 0, d = 0;
+    modbus_point_write_t pa =
+        write_point(1, MODBUS_AREA_HOLD_REGISTER, 0, NEU_TYPE_UINT16, 1, 1);
+    modbus_point_write_t pb =
+        write_point(1, MODBUS_AREA_HOLD_REGISTER, 1, NEU_TYPE_UINT16, 1, 2);
+    modbus_point_write_t pc[] = {
+        write_point(1, MODBUS_AREA_COIL, 5, NEU_TYPE_BIT, 1, 1),
+        write_point(1, MODBUS_AREA_COIL, 6, NEU_TYPE_BIT, 1, 0),
+        write_point(1, MODBUS_AREA_COIL, 7, NEU_TYPE_BIT, 1, 1),
+    };
+    modbus_point_write_t pd =
+        write_point(2, MODBUS_AREA_HOLD_REGISTER, 1, NEU_TYPE_UINT16, 1, 3);
+
+    EXPECT_EQ(NULL, modbus_coalesce_take(coalesce, MODBUS_ABCD, MODBUS_LL));
+    EXPECT_EQ(-1, modbus_coalesce_oldest(coalesce));
+
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &a, &pa, 1, 100));
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &b, &pb, 1, 105));
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &c, pc, 3, 110));
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &d, &pd, 1, 120));
+    EXPECT_EQ(6, modbus_coalesce_pending(coalesce));
+    EXPECT_EQ(100, modbus_coalesce_oldest(coalesce));
+
+    // 6 single writes become 3 frames, one per slave and area
+    modbus_write_batch_t *batch =
+        modbus_coalesce_take(coalesce, MODBUS_ABCD, MODBUS_LL);
+    ASSERT_NE(nullptr, batch);
+    EXPECT_EQ(0, modbus_coalesce_pending(coalesce));
+    ASSERT_EQ(3, batch->n_cmd);
+
+    EXPECT_EQ(MODBUS_AREA_COIL, batch->cmd[0].area);
+    EXPECT_EQ(5, batch->cmd[0].start_address);
+    EXPECT_EQ(3, batch->cmd[0].n_register);
+    EXPECT_EQ(0x05, batch->cmd[0].bytes[0]);
+
+    EXPECT_EQ(MODBUS_AREA_HOLD_REGISTER, batch->cmd[1].area);
+    EXPECT_EQ(0, batch->cmd[1].start_address);
+    EXPECT_EQ(2, batch->cmd[1].n_register);
+    EXPECT_EQ(4, batch->cmd[1].n_byte);
+    uint8_t regs[] = { 0, 1, 0, 2 };
+    EXPECT_EQ(0, memcmp(regs, batch->cmd[1].bytes, sizeof(regs)));
+
+    EXPECT_EQ(2, batch->cmd[2].slave_id);
+
+    // each request is answered once, with the result of its own frames
+    modbus_write_batch_done(batch, 0, NEU_ERR_SUCCESS);
+    modbus_write_batch_done(batch, 1, NEU_ERR_SUCCESS);
+    modbus_write_batch_done(batch, 2, NEU_ERR_PLUGIN_DISCONNECTED);
+    modbus_write_batch_free(batch, record_resp, &resps);
+
+    write_resps_t expect = { { &a, NEU_ERR_SUCCESS },
+                             { &b, NEU_ERR_SUCCESS },
+                             { &c, NEU_ERR_SUCCESS },
+                             { &d, NEU_ERR_PLUGIN_DISCONNECTED } };
+    EXPECT_EQ(expect, resps);
+
+    modbus_coalesce_free(coalesce);
+}
+
+TEST(test_modbus_coalesce, should_keep_the_order_of_overlapping_writes)
+{
+    modbus_coalesce_t *  coalesce = modbus_coalesce_new();
+    write_resps_t        resps;
+    int                  a = 0, b = 0, c = 0, d = 0, e = 0;
+    modbus_point_write_t pa =
+        write_point(1, MODBUS_AREA_HOLD_REGISTER, 10, NEU_TYPE_UINT16, 1, 1);
+    modbus_point_write_t pb =
+        write_point(1, MODBUS_AREA_HOLD_REGISTER, 10, NEU_TYPE_UINT16, 1, 2);
+    modbus_point_write_t pc =
+        write_point(1, MODBUS_AREA_HOLD_REGISTER, 20, NEU_TYPE_UINT32, 2, 7);
+    modbus_point_write_t pd =
+        write_point(1, MODBUS_AREA_HOLD_REGISTER, 21, NEU_TYPE_UINT16, 1, 3);
+    modbus_point_write_t pe =
+        write_point(1, MODBUS_AREA_HOLD_REGISTER, 30, NEU_TYPE_BIT, 1, 1);
+
+    // the last value of a point is written
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &a, &pa, 1, 0));
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &b, &pb, 1, 0));
+
+    // a partial overlap waits for the pending writes to be sent
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &c, &pc, 1, 0));
+    EXPECT_EQ(-1, modbus_coalesce_add(coalesce, &d, &pd, 1, 0));
+    EXPECT_EQ(3, modbus_coalesce_pending(coalesce));
+
+    // bits of a register are never merged
+    EXPECT_TRUE(modbus_coalesce_mergeable(&pc.point));
+    EXPECT_FALSE(modbus_coalesce_mergeable(&pe.point));
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &e, &pe, 1, 0));
+
+    modbus_write_batch_t *batch =
+        modbus_coalesce_take(coalesce, MODBUS_ABCD, MODBUS_LL);
+    ASSERT_EQ(3, batch->n_cmd);
+    EXPECT_EQ(10, batch->cmd[0].start_address);
+    EXPECT_EQ(1, batch->cmd[0].n_register);
+    EXPECT_EQ(2, batch->cmd[0].bytes[1]);
+    EXPECT_EQ(20, batch->cmd[1].start_address);
+    EXPECT_EQ(30, batch->cmd[2].start_address);
+
+    modbus_write_batch_done(batch, 0, NEU_ERR_PLUGIN_DISCONNECTED);
+    modbus_write_batch_done(batch, 1, NEU_ERR_SUCCESS);
+    modbus_write_batch_done(batch, 2, NEU_ERR_SUCCESS);
+    modbus_write_batch_free(batch, record_resp, &resps);
+
+    write_resps_t expect = { { &a, NEU_ERR_PLUGIN_DISCONNECTED },
+                             { &b, NEU_ERR_PLUGIN_DISCONNECTED },
+                             { &c, NEU_ERR_SUCCESS },
+                             { &e, NEU_ERR_SUCCESS } };
+    EXPECT_EQ(expect, resps);
+
+    EXPECT_EQ(0, modbus_coalesce_add(coalesce, &d, &pd, 1, 0));
+    modbus_coalesce_free(coalesce);
+}
+
+static modbus_point_t *typed_point(modbus_area_e area, uint16_t start_address,
+                                   uint16_t n_register, neu_type_e type)
+{
+    modbus_point_t *p = (modbus_point_t *) calloc(1, sizeof(modbus_point_t));
+
+    p->slave_id      = 1;
+    p->area          = area;
+    p->start_address = start_address;
+    p->n_register    = n_register;
+    p->type          = type;
+    snprintf(p->name, sizeof(p->name), "tag%hu", start_address);
+    return p;
+}
+
+// the per point decode of a read response before the decode plans
+static void legacy_decode(const modbus_read_cmd_t *cmd, uint8_t slave_id,
+                          const uint8_t *bytes, uint16_t n_byte,
+                          modbus_endianess           endianess,
+                          modbus_endianess_64        endianess_64,
+                          std::vector<neu_dvalue_t> &values)
+{
+    values.clear();
+    utarray_foreach(cmd->tags, modbus_point_t **, p_tag)
+    {
+        neu_dvalue_t    dvalue = {};
+        modbus_point_t *p      = *p_tag;
+        uint16_t        offset = p->start_address - cmd->start_address;
+
+        if (p->start_address + p->n_register >
+                cmd->start_address + cmd->n_register ||
+            slave_id != p->slave_id) {
+            dvalue.type      = NEU_TYPE_ERROR;
+            dvalue.value.i32 = NEU_ERR_PLUGIN_READ_FAILURE;
+            values.push_back(dvalue);
+            continue;
+        }
+
+        if (p->area == MODBUS_AREA_HOLD_REGISTER ||
+            p->area == MODBUS_AREA_INPUT_REGISTER) {
+            if (n_byte >= offset * 2 + p->n_register * 2) {
+                memcpy(dvalue.value.bytes.bytes, bytes + offset * 2,
+                       p->n_register * 2);
+                dvalue.value.bytes.length = p->n_register * 2;
+            }
+        } else if (n_byte > offset / 8) {
+            neu_value8_u u8 = { .value = bytes[offset / 8] };
+
+            dvalue.value.u8 = neu_value8_get_bit(u8, offset % 8);
+        }
+
+        dvalue.type = p->type;
+        switch (p->type) {
+        case NEU_TYPE_UINT16:
+        case NEU_TYPE_INT16:
+            dvalue.value.u16 = ntohs(dvalue.value.u16);
+            break;
+        case NEU_TYPE_FLOAT:
+        case NEU_TYPE_INT32:
+        case NEU_TYPE_UINT32:
+            if (p->option.value32.is_default) {
+                modbus_convert_endianess(&dvalue.value, endianess);
+            }
+            dvalue.value.u32 = ntohl(dvalue.value.u32);
+            break;
+        case NEU_TYPE_DOUBLE:
+        case NEU_TYPE_INT64:
+        case NEU_TYPE_UINT64:
+            if (p->option.value64.is_default) {
+                modbus_convert_endianess_64(&dvalue.value, endianess_64);
+            }
+            dvalue.value.u64 = neu_ntohll(dvalue.value.u64);
+            break;
+        case NEU_TYPE_BIT:
+            if (p->area == MODBUS_AREA_HOLD_REGISTER ||
+                p->area == MODBUS_AREA_INPUT_REGISTER) {
+                neu_value16_u v16 = { 0 };
+
+                v16.value = htons(*(uint16_t *) dvalue.value.bytes.bytes);
+                memset(&dvalue.value, 0, sizeof(dvalue.value));
+                dvalue.value.u8 = neu_value16_get_bit(v16, p->option.bit.bit);
+            }
+            break;
+        case NEU_TYPE_STRING:
+            if (p->option.string.type == NEU_DATATAG_STRING_TYPE_L) {
+                neu_datatag_string_ltoh(dvalue.value.str,
+                                        strlen(dvalue.value.str));
+            }
+            if (!neu_datatag_string_is_utf8(dvalue.value.str,
+                                            strlen(dvalue.value.str))) {
+                dvalue.value.str[0] = '?';
+                dvalue.value.str[1] = 0;
+            }
+            break;
+        default:
+            break;
+        }
+        values.push_back(dvalue);
+    }
+}
+
+static modbus_read_cmd_t mixed_cmd(void)
+{
+    modbus_read_cmd_t cmd = {};
+    modbus_area_e     hold = MODBUS_AREA_HOLD_REGISTER;
+    modbus_point_t *  points[] = {
+        typed_point(hold, 0, 1, NEU_TYPE_UINT16),
+        typed_point(hold, 1, 1, NEU_TYPE_INT16),
+        typed_point(hold, 2, 2, NEU_TYPE_UINT32),
+        typed_point(hold, 4, 2, NEU_TYPE_FLOAT),
+        typed_point(hold, 6, 2, NEU_TYPE_INT32),
+        typed_point(hold, 8, 4, NEU_TYPE_UINT64),
+        typed_point(hold, 12, 4, NEU_TYPE_DOUBLE),
+        typed_point(hold, 16, 1, NEU_TYPE_BIT),
+        typed_point(hold, 17, 3, NEU_TYPE_STRING),
+        typed_point(hold, 20, 3, NEU_TYPE_STRING),
+        typed_point(hold, 23, 2, NEU_TYPE_UINT32),
+        typed_point(hold, 24, 1, NEU_TYPE_UINT16), // inside the last value
+        typed_point(hold, 29, 2, NEU_TYPE_UINT32), // past the command
+    };
+
+    points[2]->option.value32.is_default  = true;
+    points[3]->option.value32.is_default  = true;
+    points[5]->option.value64.is_default  = true;
+    points[6]->option.value64.is_default  = true;
+    points[7]->option.bit.bit             = 3;
+    points[8]->option.string.length       = 6;
+    points[9]->option.string.length       = 6;
+    points[9]->option.string.type         = NEU_DATATAG_STRING_TYPE_L;
+    points[10]->option.value32.is_default = true;
+
+    cmd.slave_id      = 1;
+    cmd.area          = hold;
+    cmd.start_address = 0;
+    cmd.n_register    = 30;
+    utarray_new(cmd.tags, &ut_ptr_icd);
+    for (modbus_point_t *p : points) {
+        utarray_push_back(cmd.tags, &p);
+    }
+    return cmd;
+}
+
+static void expect_same_values(const std::vector<neu_dvalue_t> &expect,
+                               const neu_tag_update_t *         values,
+                               uint16_t                         n_value)
+{
+    ASSERT_EQ(expect.size(), n_value);
+    for (uint16_t i = 0; i < n_value; i++) {
+        EXPECT_EQ(expect[i].type, values[i].value.type) << i;
+        EXPECT_EQ(0,
+                  memcmp(&expect[i].value, &values[i].value.value,
+                         sizeof(neu_value_u)))
+            << i;
+    }
+}
+
+TEST(test_modbus_decode, should_decode_as_each_point_alone)
+{
+    modbus_read_cmd_t         cmd       = mixed_cmd();
+    uint8_t                   bytes[60] = { 0 };
+    uint16_t                  n_value   = 0;
+    std::vector<neu_dvalue_t> expect;
+
+    for (uint16_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (uint8_t)(i * 7 + 1);
+    }
+    memcpy(bytes + 34, "abcdef", 6);
+    memcpy(bytes + 40, "badcfe", 6);
+
+    for (int e = MODBUS_ABCD; e <= MODBUS_CDAB; e++) {
+        for (int e64 = MODBUS_LL; e64 <= MODBUS_WR; e64++) {
+            modbus_decode_plan_t *plan = modbus_decode_plan_new(
+                &cmd, (modbus_endianess) e, (modbus_endianess_64) e64);
+
+            // u16 and i16, u32 and float, u64 and double, the last u32, and
+            // the i32 out of the default endianess unless it is a no-op
+            EXPECT_EQ(e == MODBUS_ABCD ? 4 : 5, modbus_decode_plan_runs(plan));
+
+            // a full response, short ones and one from another slave
+            for (uint16_t n_byte : { 60, 20, 0 }) {
+                const neu_tag_update_t *values =
+                    modbus_decode_plan_run(plan, 1, bytes, n_byte, &n_value);
+                legacy_decode(&cmd, 1, bytes, n_byte, (modbus_endianess) e,
+                              (modbus_endianess_64) e64, expect);
+                expect_same_values(expect, values, n_value);
+            }
+            const neu_tag_update_t *values =
+                modbus_decode_plan_run(plan, 2, bytes, 60, &n_value);
+            legacy_decode(&cmd, 2, bytes, 60, (modbus_endianess) e,
+                          (modbus_endianess_64) e64, expect);
+            expect_same_values(expect, values, n_value);
+
+            modbus_decode_plan_free(plan);
+        }
+    }
+
+    free_points(cmd.tags);
+}
+
+static int64_t now_ns(void)
+{
+    struct timespec ts = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// a command of 125 registers read as values of n_register registers
+static modbus_read_cmd_t full_cmd(neu_type_e type, uint16_t n_register)
+{
+    modbus_read_cmd_t cmd = {};
+
+    cmd.slave_id   = 1;
+    cmd.area       = MODBUS_AREA_HOLD_REGISTER;
+    cmd.n_register = 125;
+    utarray_new(cmd.tags, &ut_ptr_icd);
+    for (uint16_t i = 0; i + n_register <= cmd.n_register; i += n_register) {
+        modbus_point_t *p =
+            typed_point(MODBUS_AREA_HOLD_REGISTER, i, n_register, type);
+
+        p->option.value32.is_default = true;
+        utarray_push_back(cmd.tags, &p);
+    }
+    return cmd;
+}
+
+// disabled, run with --gtest_also_run_disabled_tests
+TEST(test_modbus_decode, DISABLED_benchmark_125_register_responses)
+{
+    const int n_loop = 20000;
+    struct {
+        const char *name;
+        neu_type_e  type;
+        uint16_t    n_register;
+    } layouts[] = {
+        { "uint16", NEU_TYPE_UINT16, 1 },
+        { "float cdab", NEU_TYPE_FLOAT, 2 },
+        { "uint64", NEU_TYPE_UINT64, 4 },
+    };
+    uint8_t                   bytes[250] = { 0 };
+    std::vector<neu_dvalue_t> expect;
+
+    for (uint16_t i = 0; i < sizeof(bytes); i++) {
+        bytes[i] = (uint8_t) i;
+    }
+
+    for (auto &layout : layouts) {
+        modbus_read_cmd_t       cmd = full_cmd(layout.type, layout.n_register);
+        modbus_decode_plan_t *  plan =
+            modbus_decode_plan_new(&cmd, MODBUS_CDAB, MODBUS_LL);
+        const neu_tag_update_t *values  = NULL;
+        uint16_t                n_value = 0;
+        int64_t                 start   = now_ns();
+
+        for (int i = 0; i < n_loop; i++) {
+            legacy_decode(&cmd, 1, bytes, sizeof(bytes), MODBUS_CDAB,
+                          MODBUS_LL, expect);
+        }
+        int64_t legacy_ns = now_ns() - start;
+
+        start = now_ns();
+        for (int i = 0; i < n_loop; i++) {
+            values = modbus_decode_plan_run(plan, 1, bytes, sizeof(bytes),
+                                            &n_value);
+        }
+        int64_t plan_ns = now_ns() - start;
+
+        printf("%-10s %3hu values: legacy %10.0f resp/s, plan %10.0f resp/s\n",
+               layout.name, n_value, n_loop * 1e9 / legacy_ns,
+               n_loop * 1e9 / plan_ns);
+        expect_same_values(expect, values, n_value);
+
+        modbus_decode_plan_free(plan);
+        free_points(cmd.tags);
+    }
+}
+
+// silence of 8 data bits characters
+static uint32_t silence_us(neu_conn_tty_baud_e   baud,
+                           neu_conn_tty_parity_e parity,
+                           neu_conn_tty_stop_e   stop)
+{
+    return modbus_bus_silence_us(baud, NEU_CONN_TTY_DATA_8, parity, stop);
+}
+
+TEST(test_modbus_bus, should_space_frames_by_3_5_characters)
+{
+    // 8N1 is 10 bits a character
+    EXPECT_EQ(3646U,
+              silence_us(NEU_CONN_TTY_BAUD_9600, NEU_CONN_TTY_PARITY_NONE,
+                         NEU_CONN_TTY_STOP_1));
+    EXPECT_EQ(1823U,
+              silence_us(NEU_CONN_TTY_BAUD_19200, NEU_CONN_TTY_PARITY_NONE,
+                         NEU_CONN_TTY_STOP_1));
+    // 8E1 and 8N2 are 11 bits
+    EXPECT_EQ(4011U,
+              silence_us(NEU_CONN_TTY_BAUD_9600, NEU_CONN_TTY_PARITY_EVEN,
+                         NEU_CONN_TTY_STOP_1));
+    EXPECT_EQ(32084U,
+              silence_us(NEU_CONN_TTY_BAUD_1200, NEU_CONN_TTY_PARITY_NONE,
+                         NEU_CONN_TTY_STOP_2));
+    // fixed above 19200 bauds
+    EXPECT_EQ(1750U,
+              silence_us(NEU_CONN_TTY_BAUD_115200, NEU_CONN_TTY_PARITY_NONE,
+                         NEU_CONN_TTY_STOP_1));
+}
+
+static neu_conn_param_t bus_param(const char *device, neu_conn_tty_baud_e baud)
+{
+    neu_conn_param_t param = {};
+
+    param.type                      = NEU_CONN_TTY_CLIENT;
+    param.params.tty_client.device  = (char *) device;
+    param.params.tty_client.baud    = baud;
+    param.params.tty_client.data    = NEU_CONN_TTY_DATA_8;
+    param.params.tty_client.parity  = NEU_CONN_TTY_PARITY_NONE;
+    param.params.tty_client.stop    = NEU_CONN_TTY_STOP_1;
+    param.params.tty_client.timeout = 100;
+
+    return param;
+}
+
+static void bus_callback(void *data, int fd)
+{
+    (void) data;
+    (void) fd;
+}
+
+TEST(test_modbus_bus, should_share_a_device_between_nodes)
+{
+    neu_conn_param_t p9600  = bus_param("/tmp/modbus_test_bus",
+                                        NEU_CONN_TTY_BAUD_9600);
+    neu_conn_param_t p19200 = bus_param("/tmp/modbus_test_bus",
+                                        NEU_CONN_TTY_BAUD_19200);
+    neu_conn_param_t other  = bus_param("/tmp/modbus_test_bus_other",
+                                        NEU_CONN_TTY_BAUD_19200);
+    int              a = 0, b = 0, c = 0;
+
+    modbus_bus_member_t *ma =
+        modbus_bus_attach(&p9600, &a, bus_callback, bus_callback);
+    modbus_bus_member_t *mb =
+        modbus_bus_attach(&p9600, &b, bus_callback, bus_callback);
+    ASSERT_NE(nullptr, ma);
+    ASSERT_NE(nullptr, mb);
+    EXPECT_EQ(modbus_bus_conn(ma), modbus_bus_conn(mb));
+    EXPECT_TRUE(modbus_bus_match(mb, &p9600));
+    EXPECT_FALSE(modbus_bus_match(mb, &p19200));
+
+    // the line settings of a shared device can not differ
+    EXPECT_EQ(nullptr,
+              modbus_bus_attach(&p19200, &c, bus_callback, bus_callback));
+    modbus_bus_member_t *mc =
+        modbus_bus_attach(&other, &c, bus_callback, bus_callback);
+    ASSERT_NE(nullptr, mc);
+    EXPECT_NE(modbus_bus_conn(ma), modbus_bus_conn(mc));
+
+    modbus_bus_stats_t stats = {};
+    modbus_bus_stats(ma, &stats);
+    EXPECT_EQ(2, stats.n_member);
+
+    modbus_bus_detach(mb);
+    modbus_bus_stats(ma, &stats);
+    EXPECT_EQ(1, stats.n_member);
+
+    modbus_bus_detach(ma);
+    modbus_bus_detach(mc);
+}
+
+TEST(test_modbus_bus, should_take_turns_in_order)
+{
+    neu_conn_param_t param = bus_param("/tmp/modbus_test_bus",
+                                       NEU_CONN_TTY_BAUD_9600);
+    int              a = 0, b = 0;
+    std::string      order;
+
+    modbus_bus_member_t *ma =
+        modbus_bus_attach(&param, &a, bus_callback, bus_callback);
+    modbus_bus_member_t *mb =
+        modbus_bus_attach(&param, &b, bus_callback, bus_callback);
+
+    // back to back exchanges are spaced by the silence
+    modbus_bus_acquire(ma);
+    modbus_bus_release(ma);
+    EXPECT_GE(modbus_bus_acquire(ma), 3646);
+    modbus_bus_release(ma);
+
+    // a node waiting for the line is served before the holder comes back
+    modbus_bus_acquire(ma);
+    std::thread waiter([&]() {
+        modbus_bus_acquire(mb);
+        order += "b";
+        modbus_bus_release(mb);
+    });
+    struct timespec t = { 0, 20 * 1000 * 1000 };
+    nanosleep(&t, NULL);
+    modbus_bus_release(ma);
+    modbus_bus_acquire(ma);
+    order += "a";
+    modbus_bus_release(ma);
+    waiter.join();
+    EXPECT_EQ("ba", order);
+
+    modbus_bus_stats_t stats = {};
+    modbus_bus_stats(mb, &stats);
+    EXPECT_GE(stats.wait_ms, 10U);
+    EXPECT_GT(stats.utilization, 0U);
+    EXPECT_LE(stats.utilization, 100U);
+
+    modbus_bus_detach(ma);
+    modbus_bus_detach(mb);
+}
+
+// a modbus tcp server answering each register with 100 * slave id + address,
+// it records the slave ids asked on each of its connections
+struct links_server {
+    int                        fd = -1;
+    uint16_t                   port;
+    std::mutex                 mtx;
+    std::vector<std::set<int>> slaves;
+    std::thread                accepter;
+    std::vector<std::thread>   threads;
+    std::vector<int>           conns;
+};
+
+static void links_serve(links_server *server, int conn, size_t index)
+{
+    uint8_t req[12] = { 0 };
+
+    while (recv(conn, req, sizeof(req), MSG_WAITALL) == sizeof(req)) {
+        uint16_t addr     = (uint16_t)(req[8] << 8 | req[9]);
+        uint16_t n_reg    = (uint16_t)(req[10] << 8 | req[11]);
+        uint8_t  res[260] = { 0 };
+
+        {
+            std::lock_guard<std::mutex> lock(server->mtx);
+            server->slaves[index].insert(req[6]);
+        }
+
+        memcpy(res, req, 8);
+        res[4] = 0;
+        res[5] = (uint8_t)(3 + n_reg * 2);
+        res[8] = (uint8_t)(n_reg * 2);
+        for (uint16_t i = 0; i < n_reg; i++) {
+            uint16_t v = (uint16_t)(req[6] * 100 + addr + i);
+
+            res[9 + i * 2]     = (uint8_t)(v >> 8);
+            res[9 + i * 2 + 1] = (uint8_t) v;
+        }
+        send(conn, res, 9 + n_reg * 2, MSG_NOSIGNAL);
+    }
+}
+
+static void links_server_start(links_server *server)
+{
+    struct sockaddr_in addr = {};
+    socklen_t          len  = sizeof(addr);
+    int                on   = 1;
+
+    server->fd           = socket(AF_INET, SOCK_STREAM, 0);
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    setsockopt(server->fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    ASSERT_EQ(0, bind(server->fd, (struct sockaddr *) &addr, sizeof(addr)));
+    ASSERT_EQ(0, listen(server->fd, 4));
+    getsockname(server->fd, (struct sockaddr *) &addr, &len);
+    server->port = ntohs(addr.sin_port);
+
+    server->accepter = std::thread([server]() {
+        int conn = -1;
+
+        while ((conn = accept(server->fd, NULL, NULL)) >= 0) {
+            std::lock_guard<std::mutex> lock(server->mtx);
+
+            server->slaves.emplace_back();
+            server->conns.push_back(conn);
+            server->threads.emplace_back(links_serve, server, conn,
+                                         server->slaves.size() - 1);
+        }
+    });
+}
+
+static void links_server_stop(links_server *server)
+{
+    shutdown(server->fd, SHUT_RDWR);
+    close(server->fd);
+    server->accepter.join();
+    for (std::thread &thread : server->threads) {
+        thread.join();
+    }
+    for (int conn : server->conns) {
+        close(conn);
+    }
+}
+
+// what the node receives from the plugin
+static std::mutex                      links_mtx;
+static std::condition_variable         links_cv;
+static std::map<std::string, uint16_t> links_values;
+static int                             links_ends = 0;
+
+static void links_update_many(neu_adapter_t *adapter, const char *group,
+                              const neu_tag_update_t *items, int n)
+{
+    std::lock_guard<std::mutex> lock(links_mtx);
+
+    (void) adapter;
+    (void) group;
+    for (int i = 0; i < n; i++) {
+        links_values[items[i].tag] = items[i].value.value.u16;
+    }
+}
+
+static void links_update_with_trace(neu_adapter_t *adapter, const char *group,
+                                    const char *tag, neu_dvalue_t value,
+                                    neu_tag_meta_t *metas, int n_meta,
+                                    void *trace_ctx)
+{
+    std::lock_guard<std::mutex> lock(links_mtx);
+
+    (void) adapter;
+    (void) group;
+    (void) metas;
+    (void) n_meta;
+    (void) trace_ctx;
+    links_values[tag] = value.value.u16;
+}
+
+static void links_update(neu_adapter_t *adapter, const char *group,
+                         const char *tag, neu_dvalue_t value)
+{
+    (void) adapter;
+    (void) group;
+    (void) tag;
+    (void) value;
+}
+
+static void links_group_read_end(neu_adapter_t *           adapter,
+                                 struct neu_plugin_group *group)
+{
+    std::lock_guard<std::mutex> lock(links_mtx);
+
+    (void) adapter;
+    (void) group;
+    links_ends += 1;
+    links_cv.notify_all();
+}
+
+static int links_update_metric(neu_adapter_t *adapter, const char *name,
+                               uint64_t n, const char *group)
+{
+    (void) adapter;
+    (void) name;
+    (void) n;
+    (void) group;
+    return 0;
+}
+
+static int links_register_group_metric(neu_adapter_t *adapter,
+                                       const char *group, const char *name,
+                                       const char *help, neu_metric_type_e type,
+                                       uint64_t init)
+{
+    (void) adapter;
+    (void) group;
+    (void) name;
+    (void) help;
+    (void) type;
+    (void) init;
+    return 0;
+}
+
+TEST(ModbusLinkTest, ShardsSlavesAcrossLinks)
+{
+    links_server        server;
+    adapter_callbacks_t callbacks = {};
+    neu_plugin_t *      plugin    = (neu_plugin_t *) calloc(1, sizeof(*plugin));
+    neu_conn_param_t    param     = {};
+    neu_plugin_group_t  grp       = {};
+    char                name[]    = "grp";
+
+    links_values.clear();
+    links_ends = 0;
+    links_server_start(&server);
+
+    callbacks.update_metric                = links_update_metric;
+    callbacks.driver.update                = links_update;
+    callbacks.driver.update_with_trace     = links_update_with_trace;
+    callbacks.driver.update_many           = links_update_many;
+    callbacks.driver.group_read_end        = links_group_read_end;
+    callbacks.driver.register_group_metric = links_register_group_metric;
+
+    neu_plugin_common_init(&plugin->common);
+    plugin->common.adapter_callbacks = &callbacks;
+    plugin->common.log               = neuron;
+    plugin->protocol                 = MODBUS_PROTOCOL_TCP;
+    plugin->address_base             = base_1;
+    plugin->events                   = neu_event_new("modbus-links");
+    plugin->stack = modbus_stack_create((void *) plugin, MODBUS_PROTOCOL_TCP,
+                                        modbus_send_msg, modbus_value_handle,
+                                        modbus_write_resp);
+    plugin->health = modbus_health_new();
+    modbus_cycles_init(plugin);
+    plugin->timeout        = 1000;
+    plugin->retry_interval = 100;
+    plugin->max_inflight   = 2;
+    modbus_pace_init(&plugin->pace, 0, 1);
+
+    param.type                      = NEU_CONN_TCP_CLIENT;
+    param.log                       = neuron;
+    param.params.tcp_client.ip      = (char *) "127.0.0.1";
+    param.params.tcp_client.port    = server.port;
+    param.params.tcp_client.timeout = 1000;
+    plugin->conn = neu_conn_new(&param, (void *) plugin, modbus_conn_connected,
+                                modbus_conn_disconnected);
+    modbus_links_config(plugin, 2, &param);
+    neu_conn_start(plugin->conn);
+    modbus_links_start(plugin);
+
+    grp.group_name = name;
+    utarray_new(grp.tags, neu_tag_get_icd());
+    for (int slave = 1; slave <= 4; slave++) {
+        std::string   tag_name = "tag" + std::to_string(slave);
+        std::string   address  = std::to_string(slave) + "!400001";
+        neu_datatag_t tag      = {};
+
+        tag.name      = (char *) tag_name.c_str();
+        tag.address   = (char *) address.c_str();
+        tag.attribute = NEU_ATTRIBUTE_READ;
+        tag.type      = NEU_TYPE_UINT16;
+        utarray_push_back(grp.tags, &tag);
+    }
+
+    EXPECT_EQ(NEU_PLUGIN_GROUP_READ_PENDING,
+              modbus_group_timer(plugin, &grp, 0xfa));
+    {
+        std::unique_lock<std::mutex> lock(links_mtx);
+
+        EXPECT_TRUE(links_cv.wait_for(lock, std::chrono::seconds(5),
+                                      []() { return links_ends > 0; }));
+    }
+
+    // the values of both links are merged into the read of the group
+    EXPECT_EQ(1, links_ends);
+    EXPECT_EQ(100U, links_values["tag1"]);
+    EXPECT_EQ(200U, links_values["tag2"]);
+    EXPECT_EQ(300U, links_values["tag3"]);
+    EXPECT_EQ(400U, links_values["tag4"]);
+
+    // the commands of a slave go on the link of slave id % n_link
+    {
+        std::lock_guard<std::mutex> lock(server.mtx);
+        std::set<std::set<int>>     slaves(server.slaves.begin(),
+                                       server.slaves.end());
+
+        EXPECT_EQ((std::set<std::set<int>> { { 1, 3 }, { 2, 4 } }), slaves);
+    }
+
+    modbus_cycles_fini(plugin);
+    grp.group_free(&grp);
+    utarray_free(grp.tags);
+    modbus_links_free(plugin);
+    neu_conn_destory(plugin->conn);
+    modbus_stack_destroy(plugin->stack);
+    modbus_read_plan_fini(&plugin->plan);
+    modbus_health_free(plugin->health);
+    neu_event_close(plugin->events);
+    free(plugin);
+    links_server_stop(&server);
+}
+
 int main(int argc, char **argv)
 {
     zlog_init("./config/dev.conf");
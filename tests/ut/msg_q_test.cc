@@ -0,0 +1,505 @@
+#include <poll.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "adapter/msg_q.h"
+#include "core/route.h"
+}
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+static neu_msg_t *new_msg(int seq)
+{
+    UT_array *               tags  = NULL;
+    UT_icd                   icd   = { sizeof(neu_datatag_t), NULL, NULL };
+    neu_reqresp_trans_data_t data  = {};
+    neu_tag_names_t *        names = NULL;
+
+    utarray_new(tags, &icd);
+    names = neu_tag_names_new(tags);
+    utarray_free(tags);
+
+    data.driver    = neu_str_intern("driver");
+    data.group     = neu_str_intern("group");
+    data.trace_ctx = (void *) (intptr_t) seq;
+    data.snapshot  = neu_group_snapshot_new(names);
+    data.ctx       = neu_trans_data_ctx_new(1);
+    neu_tag_names_unref(names);
+
+    return neu_msg_new(NEU_REQRESP_TRANS_DATA, NULL, &data);
+}
+
+static int msg_seq(neu_msg_t *msg)
+{
+    neu_reqresp_head_t *header = (neu_reqresp_head_t *) neu_msg_get_header(msg);
+
+    return (int) (intptr_t)((neu_reqresp_trans_data_t *) &header[1])->trace_ctx;
+}
+
+static void free_msg(neu_msg_t *msg)
+{
+    neu_reqresp_head_t *header = (neu_reqresp_head_t *) neu_msg_get_header(msg);
+
+    neu_trans_data_free((neu_reqresp_trans_data_t *) &header[1]);
+    neu_msg_free(msg);
+}
+
+TEST(MsgQTest, fifo_batch)
+{
+    adapter_msg_q_t *q =
+        adapter_msg_q_new("app", 16, ADAPTER_MSG_Q_DROP_NEWEST);
+    neu_msg_t *msgs[4];
+    int        next = 0;
+
+    for (int i = 0; i < 10; i++) {
+        ASSERT_EQ(0, adapter_msg_q_push(q, new_msg(i)));
+    }
+
+    const uint32_t sizes[] = { 4, 4, 2 };
+    for (uint32_t size : sizes) {
+        ASSERT_EQ(size, adapter_msg_q_pop_batch(q, msgs, 4));
+        for (uint32_t i = 0; i < size; i++) {
+            EXPECT_EQ(next++, msg_seq(msgs[i]));
+            free_msg(msgs[i]);
+        }
+    }
+
+    adapter_msg_q_free(q);
+}
+
+TEST(MsgQTest, drop_newest)
+{
+    adapter_msg_q_t *q = adapter_msg_q_new("app", 4, ADAPTER_MSG_Q_DROP_NEWEST);
+    adapter_msg_q_stats_t stats = {};
+    neu_msg_t *           msgs[8];
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(0, adapter_msg_q_push(q, new_msg(i)));
+    }
+    neu_msg_t *msg = new_msg(4);
+    EXPECT_EQ(-1, adapter_msg_q_push(q, msg));
+    free_msg(msg);
+
+    adapter_msg_q_stats(q, &stats);
+    EXPECT_EQ(4, stats.depth);
+    EXPECT_EQ(1, stats.dropped);
+
+    ASSERT_EQ(4, adapter_msg_q_pop_batch(q, msgs, 8));
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(i, msg_seq(msgs[i]));
+        free_msg(msgs[i]);
+    }
+
+    adapter_msg_q_free(q);
+}
+
+TEST(MsgQTest, drop_oldest)
+{
+    adapter_msg_q_t *q = adapter_msg_q_new("app", 4, ADAPTER_MSG_Q_DROP_OLDEST);
+    adapter_msg_q_stats_t stats = {};
+    neu_msg_t *           msgs[8];
+
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQ(0, adapter_msg_q_push(q, new_msg(i)));
+    }
+
+    adapter_msg_q_stats(q, &stats);
+    EXPECT_EQ(2, stats.dropped);
+
+    ASSERT_EQ(4, adapter_msg_q_pop_batch(q, msgs, 8));
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(i + 2, msg_seq(msgs[i]));
+        free_msg(msgs[i]);
+    }
+
+    adapter_msg_q_free(q);
+}
+
+TEST(MsgQTest, block)
+{
+    adapter_msg_q_t *q = adapter_msg_q_new("app", 2, ADAPTER_MSG_Q_BLOCK);
+    neu_msg_t *      msgs[1];
+
+    std::thread producer([q]() {
+        for (int i = 0; i < 20; i++) {
+            EXPECT_EQ(0, adapter_msg_q_push(q, new_msg(i)));
+        }
+    });
+
+    for (int i = 0; i < 20; i++) {
+        usleep(1000);
+        ASSERT_EQ(1, adapter_msg_q_pop_batch(q, msgs, 1));
+        EXPECT_EQ(i, msg_seq(msgs[0]));
+        free_msg(msgs[0]);
+    }
+    producer.join();
+
+    adapter_msg_q_free(q);
+}
+
+TEST(MsgQTest, exit_wakes_waiters)
+{
+    adapter_msg_q_t *q = adapter_msg_q_new("app", 2, ADAPTER_MSG_Q_BLOCK);
+    neu_msg_t *      msgs[1];
+
+    std::thread consumer(
+        [q, &msgs]() { EXPECT_EQ(0, adapter_msg_q_pop_batch(q, msgs, 1)); });
+    usleep(20 * 1000);
+    adapter_msg_q_exit(q);
+    consumer.join();
+
+    adapter_msg_q_free(q);
+}
+
+TEST(MsgQTest, multi_producer)
+{
+    const int        n_producer = 4;
+    const int        n_msg      = 20000;
+    adapter_msg_q_t *q = adapter_msg_q_new("app", 256, ADAPTER_MSG_Q_BLOCK);
+    std::vector<int> next(n_producer, 0);
+    std::vector<std::thread> producers;
+    neu_msg_t *              msgs[32];
+    int                      total = 0;
+
+    // the sequence encodes the producer, order must hold per producer
+    for (int p = 0; p < n_producer; p++) {
+        producers.emplace_back([q, p]() {
+            for (int i = 0; i < n_msg; i++) {
+                EXPECT_EQ(0, adapter_msg_q_push(q, new_msg(p * n_msg + i)));
+            }
+        });
+    }
+
+    while (total < n_producer * n_msg) {
+        uint32_t n = adapter_msg_q_pop_batch(q, msgs, 32);
+        ASSERT_GT(n, 0);
+        for (uint32_t i = 0; i < n; i++) {
+            int seq = msg_seq(msgs[i]);
+            int p   = seq / n_msg;
+
+            EXPECT_EQ(next[p], seq % n_msg);
+            next[p] = seq % n_msg + 1;
+            free_msg(msgs[i]);
+        }
+        total += n;
+    }
+
+    for (auto &th : producers) {
+        th.join();
+    }
+    adapter_msg_q_free(q);
+}
+
+TEST(MsgQTest, push_to_port)
+{
+    adapter_msg_q_t *q = adapter_msg_q_new("app", 4, ADAPTER_MSG_Q_DROP_NEWEST);
+    neu_msg_t *      msgs[1];
+
+    neu_msg_t *msg = new_msg(0);
+    EXPECT_EQ(1, adapter_msg_q_push_to(9000, msg));
+
+    EXPECT_EQ(0, adapter_msg_q_bind(q, 9000));
+    EXPECT_EQ(-1, adapter_msg_q_bind(q, 9000));
+    EXPECT_EQ(0, adapter_msg_q_push_to(9000, msg));
+    ASSERT_EQ(1, adapter_msg_q_pop_batch(q, msgs, 1));
+    EXPECT_EQ(msg, msgs[0]);
+    free_msg(msgs[0]);
+
+    adapter_msg_q_unbind(9000);
+    msg = new_msg(1);
+    EXPECT_EQ(1, adapter_msg_q_push_to(9000, msg));
+    free_msg(msg);
+
+    adapter_msg_q_free(q);
+}
+
+TEST(MsgQTest, push_to_blocked)
+{
+    adapter_msg_q_t * q     = adapter_msg_q_new("app", 2, ADAPTER_MSG_Q_BLOCK);
+    adapter_msg_q_t * other = adapter_msg_q_new("app2", 2, ADAPTER_MSG_Q_BLOCK);
+    std::atomic<bool> done(false);
+
+    ASSERT_EQ(0, adapter_msg_q_bind(q, 9001));
+    EXPECT_EQ(0, adapter_msg_q_push_to(9001, new_msg(0)));
+    EXPECT_EQ(0, adapter_msg_q_push_to(9001, new_msg(1)));
+
+    // a push to the full queue waits for room
+    std::thread producer([&done]() {
+        neu_msg_t *msg = new_msg(2);
+
+        EXPECT_EQ(-1, adapter_msg_q_push_to(9001, msg));
+        free_msg(msg);
+        done = true;
+    });
+    usleep(20 * 1000);
+    EXPECT_FALSE(done);
+
+    // the ports of the other apps are bound and unbound meanwhile
+    EXPECT_EQ(0, adapter_msg_q_bind(other, 9002));
+    adapter_msg_q_unbind(9002);
+    adapter_msg_q_unbind(9001);
+
+    // the queue outlives its owner until the waiting push returns
+    adapter_msg_q_free(q);
+    producer.join();
+    EXPECT_TRUE(done);
+
+    adapter_msg_q_free(other);
+}
+
+static bool readable(adapter_msg_q_t *q)
+{
+    struct pollfd pfd = { adapter_msg_q_fd(q), POLLIN, 0 };
+
+    return poll(&pfd, 1, 0) == 1;
+}
+
+TEST(MsgQTest, try_pop_batch)
+{
+    adapter_msg_q_t *q =
+        adapter_msg_q_new("node", 8, ADAPTER_MSG_Q_DROP_NEWEST);
+    neu_msg_t *msgs[2];
+
+    EXPECT_FALSE(readable(q));
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(0, adapter_msg_q_push(q, new_msg(i)));
+    }
+    EXPECT_TRUE(readable(q));
+
+    // a full batch keeps the fd readable for the rest
+    ASSERT_EQ(2, adapter_msg_q_try_pop_batch(q, msgs, 2));
+    EXPECT_EQ(0, msg_seq(msgs[0]));
+    EXPECT_EQ(1, msg_seq(msgs[1]));
+    free_msg(msgs[0]);
+    free_msg(msgs[1]);
+    EXPECT_TRUE(readable(q));
+
+    ASSERT_EQ(1, adapter_msg_q_try_pop_batch(q, msgs, 2));
+    EXPECT_EQ(2, msg_seq(msgs[0]));
+    free_msg(msgs[0]);
+    EXPECT_FALSE(readable(q));
+
+    ASSERT_EQ(0, adapter_msg_q_push(q, new_msg(3)));
+    EXPECT_TRUE(readable(q));
+
+    adapter_msg_q_free(q);
+}
+
+TEST(RouteTest, publish_and_send)
+{
+    adapter_msg_q_t *q1 = adapter_msg_q_new("n1", 4, ADAPTER_MSG_Q_DROP_NEWEST);
+    adapter_msg_q_t *q2 = adapter_msg_q_new("n2", 4, ADAPTER_MSG_Q_DROP_NEWEST);
+    neu_route_table_t *table = neu_route_table_new();
+    neu_msg_t *        msgs[4];
+
+    neu_msg_t *msg = new_msg(0);
+    EXPECT_EQ(1, neu_route_send("n1", msg));
+
+    EXPECT_EQ(0, neu_route_table_add(table, "n1", q1));
+    EXPECT_EQ(0, neu_route_table_add(table, "n2", q2));
+    EXPECT_EQ(-1, neu_route_table_add(table, "n1", q2));
+    neu_route_publish(table);
+
+    EXPECT_EQ(1, neu_route_send("n3", msg));
+    EXPECT_EQ(0, neu_route_send("n1", msg));
+    ASSERT_EQ(1, adapter_msg_q_try_pop_batch(q1, msgs, 4));
+    EXPECT_EQ(msg, msgs[0]);
+    free_msg(msgs[0]);
+    EXPECT_EQ(0, adapter_msg_q_try_pop_batch(q2, msgs, 4));
+
+    // a full inbox rejects the message and the sender keeps it
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(0, neu_route_send("n2", new_msg(i)));
+    }
+    msg = new_msg(4);
+    EXPECT_EQ(-1, neu_route_send("n2", msg));
+
+    table = neu_route_table_new();
+    EXPECT_EQ(0, neu_route_table_add(table, "n1", q1));
+    neu_route_publish(table);
+    EXPECT_EQ(1, neu_route_send("n2", msg));
+    free_msg(msg);
+
+    neu_route_publish(NULL);
+    adapter_msg_q_free(q1);
+    adapter_msg_q_free(q2);
+}
+
+static void drain(adapter_msg_q_t *q)
+{
+    neu_msg_t *msgs[64];
+    uint32_t   n = 0;
+
+    while ((n = adapter_msg_q_try_pop_batch(q, msgs, 64)) > 0) {
+        for (uint32_t i = 0; i < n; i++) {
+            free_msg(msgs[i]);
+        }
+    }
+}
+
+TEST(RouteTest, publish_waits_senders)
+{
+    adapter_msg_q_t *q =
+        adapter_msg_q_new("node", 1024, ADAPTER_MSG_Q_DROP_NEWEST);
+    std::atomic<bool> stop(false);
+    std::thread       sender([&]() {
+        while (!stop) {
+            neu_msg_t *msg = new_msg(0);
+            if (neu_route_send("node", msg) != 0) {
+                free_msg(msg);
+            }
+        }
+    });
+
+    for (int i = 0; i < 200; i++) {
+        neu_route_table_t *table = neu_route_table_new();
+        if (i % 2 == 0) {
+            neu_route_table_add(table, "node", q);
+        }
+        neu_route_publish(table);
+        drain(q);
+    }
+
+    // no push reaches the inbox once it is out of the published table
+    usleep(10 * 1000);
+    neu_msg_t *msgs[1];
+    EXPECT_EQ(0, adapter_msg_q_try_pop_batch(q, msgs, 1));
+
+    stop = true;
+    sender.join();
+    neu_route_publish(NULL);
+    adapter_msg_q_free(q);
+}
+
+/*
+ * Driver to app delivery: the message pointer over an abstract datagram
+ * socket, received by the app event loop and queued for the consumer, against
+ * pushing into the queue bound to the app port. Disabled, run with
+ * --gtest_also_run_disabled_tests --gtest_filter='MsgQBench.*'.
+ */
+static int64_t now_ns()
+{
+    struct timespec ts = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void report(const char *name, int n, int pace_us, int64_t ns,
+                   std::vector<int64_t> &latency)
+{
+    std::sort(latency.begin(), latency.end());
+    printf("%-7s %6d msgs, pace %3dus: %8.0f msgs/s, latency p50 %8ldns, "
+           "p99 %9ldns\n",
+           name, n, pace_us, (double) n * 1e9 / (double) ns,
+           (long) latency[latency.size() / 2],
+           (long) latency[latency.size() * 99 / 100]);
+}
+
+static void run(bool inbox, int n_producer, int n_msg, int pace_us)
+{
+    const uint16_t       port  = 9100;
+    const int            total = n_producer * n_msg;
+    std::vector<int64_t> sent(total);
+    std::vector<int64_t> latency(total);
+    neu_msg_t *          msgs[32];
+    struct sockaddr_un   addr = {};
+    std::thread          loop;
+
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%cneuron-%u", '\0', port);
+
+    adapter_msg_q_t *q = adapter_msg_q_new("app", 1024, ADAPTER_MSG_Q_BLOCK);
+    int              rfd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    ASSERT_EQ(0, bind(rfd, (struct sockaddr *) &addr, sizeof(addr)));
+
+    if (inbox) {
+        adapter_msg_q_bind(q, port);
+    } else {
+        // the app event loop queues what it receives from the socket
+        loop = std::thread([&]() {
+            for (int i = 0; i < total; i++) {
+                neu_msg_t *msg = NULL;
+                ASSERT_EQ(0, neu_recv_msg(rfd, &msg));
+                adapter_msg_q_push(q, msg);
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    int64_t                  start = now_ns();
+    for (int p = 0; p < n_producer; p++) {
+        producers.emplace_back([&, p]() {
+            int sfd = socket(AF_UNIX, SOCK_DGRAM, 0);
+            for (int i = 0; i < n_msg; i++) {
+                int        seq = p * n_msg + i;
+                neu_msg_t *msg = new_msg(seq);
+
+                sent[seq] = now_ns();
+                if (inbox) {
+                    EXPECT_EQ(0, adapter_msg_q_push_to(port, msg));
+                } else {
+                    EXPECT_EQ(0, neu_send_msg_to(sfd, &addr, msg));
+                }
+                if (pace_us > 0) {
+                    usleep(pace_us);
+                }
+            }
+            close(sfd);
+        });
+    }
+
+    for (int n = 0; n < total;) {
+        uint32_t cnt = adapter_msg_q_pop_batch(q, msgs, 32);
+        for (uint32_t i = 0; i < cnt; i++) {
+            latency[n++] = now_ns() - sent[msg_seq(msgs[i])];
+            free_msg(msgs[i]);
+        }
+    }
+    int64_t elapsed = now_ns() - start;
+
+    for (auto &th : producers) {
+        th.join();
+    }
+    if (inbox) {
+        adapter_msg_q_unbind(port);
+    } else {
+        loop.join();
+    }
+    close(rfd);
+    adapter_msg_q_free(q);
+    report(inbox ? "inbox" : "socket", total, pace_us, elapsed, latency);
+}
+
+// saturated for throughput, paced for latency without queueing
+TEST(MsgQBench, DISABLED_one_driver)
+{
+    run(false, 1, 100000, 0);
+    run(true, 1, 100000, 0);
+    run(false, 1, 5000, 100);
+    run(true, 1, 5000, 100);
+}
+
+TEST(MsgQBench, DISABLED_four_drivers)
+{
+    run(false, 4, 50000, 0);
+    run(true, 4, 50000, 0);
+    run(false, 4, 2000, 200);
+    run(true, 4, 2000, 200);
+}
@@ -0,0 +1,306 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "event/event.h"
+#include "event/sched.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+static int64_t now_us()
+{
+    struct timespec ts = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+struct strand_ctx {
+    pthread_mutex_t mtx;
+    int             active;
+    int             overlap;
+    int             n;
+};
+
+static int strand_cb(void *usr_data)
+{
+    struct strand_ctx *ctx = (struct strand_ctx *) usr_data;
+
+    pthread_mutex_lock(&ctx->mtx);
+    ctx->active += 1;
+    if (ctx->active > 1) {
+        ctx->overlap += 1;
+    }
+    pthread_mutex_unlock(&ctx->mtx);
+
+    usleep(1000);
+
+    pthread_mutex_lock(&ctx->mtx);
+    ctx->active -= 1;
+    ctx->n += 1;
+    pthread_mutex_unlock(&ctx->mtx);
+    return 0;
+}
+
+TEST(SchedTest, strand_is_serialized)
+{
+    neu_sched_t *           sched = neu_sched_new("sched_test", 4);
+    struct strand_ctx       ctx   = { PTHREAD_MUTEX_INITIALIZER, 0, 0, 0 };
+    neu_sched_task_t *      tasks[4];
+    neu_event_timer_param_t param = {};
+
+    EXPECT_EQ(4, neu_sched_worker_num(sched));
+    neu_sched_strand_t *strand = neu_sched_strand_new(sched);
+
+    // four timers of one strand, never run in parallel
+    param.millisecond = 2;
+    param.usr_data    = &ctx;
+    param.cb          = strand_cb;
+    param.type        = NEU_EVENT_TIMER_NOBLOCK;
+    for (int i = 0; i < 4; i++) {
+        tasks[i] = neu_sched_add_timer(sched, strand, param);
+    }
+
+    usleep(200 * 1000);
+    for (int i = 0; i < 4; i++) {
+        neu_sched_del_task(sched, tasks[i]);
+    }
+
+    EXPECT_GT(ctx.n, 20);
+    EXPECT_EQ(0, ctx.overlap);
+
+    neu_sched_strand_free(sched, strand);
+    neu_sched_close(sched);
+}
+
+TEST(SchedTest, post_coalesces)
+{
+    neu_sched_t *       sched  = neu_sched_new("sched_test", 2);
+    neu_sched_strand_t *strand = neu_sched_strand_new(sched);
+    struct strand_ctx   ctx    = { PTHREAD_MUTEX_INITIALIZER, 0, 0, 0 };
+
+    neu_sched_task_t *task = neu_sched_add_task(sched, strand, strand_cb, &ctx);
+
+    // queued posts of one task run once
+    for (int i = 0; i < 100; i++) {
+        neu_sched_post(task);
+    }
+    usleep(50 * 1000);
+    EXPECT_GE(ctx.n, 1);
+    EXPECT_LE(ctx.n, 2);
+
+    neu_sched_del_task(sched, task);
+    neu_sched_strand_free(sched, strand);
+    neu_sched_close(sched);
+}
+
+struct slow_ctx {
+    pthread_mutex_t mtx;
+    int             n;
+};
+
+static int slow_cb(void *usr_data)
+{
+    struct slow_ctx *ctx = (struct slow_ctx *) usr_data;
+
+    pthread_mutex_lock(&ctx->mtx);
+    ctx->n += 1;
+    pthread_mutex_unlock(&ctx->mtx);
+    usleep(100 * 1000);
+    return 0;
+}
+
+TEST(SchedTest, del_waits_running_task)
+{
+    neu_sched_t *           sched  = neu_sched_new("sched_test", 2);
+    neu_sched_strand_t *    strand = neu_sched_strand_new(sched);
+    struct slow_ctx         ctx    = { PTHREAD_MUTEX_INITIALIZER, 0 };
+    neu_event_timer_param_t param  = {};
+
+    param.millisecond = 5;
+    param.usr_data    = &ctx;
+    param.cb          = slow_cb;
+    param.type        = NEU_EVENT_TIMER_BLOCK;
+    neu_sched_task_t *task = neu_sched_add_timer(sched, strand, param);
+
+    usleep(20 * 1000);
+    int64_t start = now_us();
+    EXPECT_EQ(0, neu_sched_del_task(sched, task));
+    EXPECT_GE(now_us() - start, 50 * 1000);
+    EXPECT_EQ(1, ctx.n);
+
+    usleep(50 * 1000);
+    EXPECT_EQ(1, ctx.n);
+
+    neu_sched_strand_free(sched, strand);
+    neu_sched_close(sched);
+}
+
+struct self_del {
+    neu_sched_t *     sched;
+    neu_sched_task_t *task;
+    int               n;
+};
+
+static int self_del_cb(void *usr_data)
+{
+    struct self_del *ctx = (struct self_del *) usr_data;
+
+    ctx->n += 1;
+    neu_sched_del_task(ctx->sched, ctx->task);
+    return 0;
+}
+
+TEST(SchedTest, del_task_in_callback)
+{
+    neu_sched_t *           sched  = neu_sched_new("sched_test", 2);
+    neu_sched_strand_t *    strand = neu_sched_strand_new(sched);
+    struct self_del         ctx    = { sched, NULL, 0 };
+    neu_event_timer_param_t param  = {};
+
+    param.millisecond = 5;
+    param.usr_data    = &ctx;
+    param.cb          = self_del_cb;
+    param.type        = NEU_EVENT_TIMER_NOBLOCK;
+
+    ctx.task = neu_sched_add_timer(sched, strand, param);
+    usleep(50 * 1000);
+    EXPECT_EQ(1, ctx.n);
+
+    neu_sched_strand_free(sched, strand);
+    neu_sched_close(sched);
+}
+
+/*
+ * Benchmark of thread-per-node against the shared pool: every node runs one
+ * 100ms group timer, callbacks record how late they fire. Disabled, run with
+ * --gtest_also_run_disabled_tests --gtest_filter='SchedBench.*'.
+ */
+struct node {
+    int64_t              next;
+    int64_t              interval;
+    std::vector<int64_t> late;
+};
+
+static int node_cb(void *usr_data)
+{
+    struct node *node = (struct node *) usr_data;
+    int64_t      now  = now_us();
+
+    if (node->next > 0) {
+        node->late.push_back(std::max<int64_t>(0, now - node->next));
+    }
+    node->next = now + node->interval;
+    // a short piece of plugin work
+    usleep(50);
+    return 0;
+}
+
+static int thread_num()
+{
+    FILE *fp = fopen("/proc/self/status", "r");
+    char  line[256];
+    int   n = -1;
+
+    if (fp == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, "Threads:", 8) == 0) {
+            n = atoi(line + 8);
+            break;
+        }
+    }
+    fclose(fp);
+    return n;
+}
+
+static void report(const char *mode, int n_node, int n_thread,
+                   std::vector<node> &nodes)
+{
+    std::vector<int64_t> late;
+
+    for (auto &node : nodes) {
+        late.insert(late.end(), node.late.begin(), node.late.end());
+    }
+    if (late.empty()) {
+        return;
+    }
+    std::sort(late.begin(), late.end());
+
+    printf("%-14s %5d nodes: %5d threads, %7zu runs, late p50 %6ldus, p99 "
+           "%6ldus, max %6ldus\n",
+           mode, n_node, n_thread, late.size(), (long) late[late.size() / 2],
+           (long) late[late.size() * 99 / 100], (long) late.back());
+}
+
+static void bench(int n_node)
+{
+    const int               run_ms = 1000;
+    std::vector<node>       nodes(n_node);
+    neu_event_timer_param_t param = {};
+    int                     base  = thread_num();
+
+    param.millisecond = 100;
+    param.cb          = node_cb;
+    param.type        = NEU_EVENT_TIMER_NOBLOCK;
+
+    std::vector<neu_events_t *>      events(n_node);
+    std::vector<neu_event_timer_t *> timers(n_node);
+    for (int i = 0; i < n_node; i++) {
+        nodes[i].interval = param.millisecond * 1000;
+        param.usr_data    = &nodes[i];
+        events[i]         = neu_event_new("node");
+        timers[i]         = neu_event_add_timer(events[i], param);
+    }
+    usleep(run_ms * 1000);
+    int n_thread = thread_num() - base;
+    for (int i = 0; i < n_node; i++) {
+        neu_event_del_timer(events[i], timers[i]);
+        neu_event_close(events[i]);
+    }
+    report("thread/node", n_node, n_thread, nodes);
+
+    nodes.assign(n_node, node());
+    neu_sched_t *                     sched = neu_sched_new("sched", 0);
+    std::vector<neu_sched_strand_t *> strands(n_node);
+    std::vector<neu_sched_task_t *>   tasks(n_node);
+    for (int i = 0; i < n_node; i++) {
+        nodes[i].interval = param.millisecond * 1000;
+        param.usr_data    = &nodes[i];
+        strands[i]        = neu_sched_strand_new(sched);
+        tasks[i]          = neu_sched_add_timer(sched, strands[i], param);
+    }
+    usleep(run_ms * 1000);
+    n_thread = thread_num() - base;
+    for (int i = 0; i < n_node; i++) {
+        neu_sched_del_task(sched, tasks[i]);
+        neu_sched_strand_free(sched, strands[i]);
+    }
+    neu_sched_close(sched);
+    report("shared pool", n_node, n_thread, nodes);
+}
+
+TEST(SchedBench, DISABLED_nodes_100)
+{
+    bench(100);
+}
+
+TEST(SchedBench, DISABLED_nodes_500)
+{
+    bench(500);
+}
+
+TEST(SchedBench, DISABLED_nodes_1000)
+{
+    bench(1000);
+}
@@ -0,0 +1,131 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+#include "msg.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+static UT_array *make_tags(int n)
+{
+    UT_array *tags = NULL;
+    UT_icd    icd  = { sizeof(neu_datatag_t), NULL, NULL, NULL };
+
+    utarray_new(tags, &icd);
+    for (int i = 0; i < n; i++) {
+        neu_datatag_t tag = {};
+        char          name[32];
+
+        snprintf(name, sizeof(name), "tag%d", i);
+        tag.name = strdup(name);
+        tag.bias = i;
+        utarray_push_back(tags, &tag);
+    }
+
+    return tags;
+}
+
+static void free_tags(UT_array *tags)
+{
+    utarray_foreach(tags, neu_datatag_t *, tag) { free(tag->name); }
+    utarray_free(tags);
+}
+
+TEST(SnapshotTest, tag_names)
+{
+    UT_array *       tags  = make_tags(3);
+    neu_tag_names_t *names = neu_tag_names_new(tags);
+
+    free_tags(tags);
+
+    EXPECT_EQ(3, neu_tag_names_size(names));
+    EXPECT_STREQ("tag0", neu_tag_names_name(names, 0));
+    EXPECT_STREQ("tag2", neu_tag_names_name(names, 2));
+    EXPECT_EQ(2.0, neu_tag_names_bias(names, 2));
+
+    // a reference keeps the table alive past the first unref
+    EXPECT_EQ(names, neu_tag_names_ref(names));
+    neu_tag_names_unref(names);
+    EXPECT_STREQ("tag1", neu_tag_names_name(names, 1));
+    neu_tag_names_unref(names);
+}
+
+TEST(SnapshotTest, push_and_access)
+{
+    UT_array *            tags  = make_tags(4);
+    neu_tag_names_t *     names = neu_tag_names_new(tags);
+    neu_group_snapshot_t *snap  = neu_group_snapshot_new(names);
+    neu_dvalue_t          value = {};
+
+    neu_tag_names_unref(names);
+    free_tags(tags);
+
+    value.type      = NEU_TYPE_INT16;
+    value.value.i16 = -12;
+    neu_group_snapshot_push(snap, 0, &value, NULL, 0);
+
+    memset(&value, 0, sizeof(value));
+    value.type = NEU_TYPE_STRING;
+    strcpy(value.value.str, "hello");
+    neu_group_snapshot_push(snap, 2, &value, NULL, 0);
+
+    memset(&value, 0, sizeof(value));
+    value.type                 = NEU_TYPE_BYTES;
+    value.value.bytes.length   = 3;
+    value.value.bytes.bytes[0] = 1;
+    value.value.bytes.bytes[2] = 3;
+    neu_group_snapshot_push(snap, 3, &value, NULL, 0);
+
+    neu_group_snapshot_seal(snap);
+
+    ASSERT_EQ(3, neu_group_snapshot_size(snap));
+    EXPECT_STREQ("tag0", neu_group_snapshot_tag(snap, 0));
+    EXPECT_EQ(NEU_TYPE_INT16, neu_group_snapshot_type(snap, 0));
+    EXPECT_EQ(-12, neu_group_snapshot_value(snap, 0)->i16);
+
+    EXPECT_STREQ("tag2", neu_group_snapshot_tag(snap, 1));
+    EXPECT_EQ(2.0, neu_group_snapshot_bias(snap, 1));
+    EXPECT_STREQ("hello", neu_group_snapshot_value(snap, 1)->str);
+
+    EXPECT_EQ(3, neu_group_snapshot_value(snap, 2)->bytes.length);
+    EXPECT_EQ(3, neu_group_snapshot_value(snap, 2)->bytes.u8s[2]);
+
+    int n_meta = -1;
+    EXPECT_EQ(NULL, neu_group_snapshot_metas(snap, 0, &n_meta));
+    EXPECT_EQ(0, n_meta);
+
+    neu_group_snapshot_free(snap);
+}
+
+TEST(SnapshotTest, shared_by_trans_data)
+{
+    UT_array *               tags  = make_tags(1);
+    neu_tag_names_t *        names = neu_tag_names_new(tags);
+    neu_reqresp_trans_data_t data  = {};
+    neu_dvalue_t             value = {};
+
+    free_tags(tags);
+
+    data.driver   = neu_str_intern("driver");
+    data.group    = neu_str_intern("group");
+    data.snapshot = neu_group_snapshot_new(names);
+    neu_tag_names_unref(names);
+
+    value.type      = NEU_TYPE_DOUBLE;
+    value.value.d64 = 1.5;
+    neu_group_snapshot_push(data.snapshot, 0, &value, NULL, 0);
+    neu_group_snapshot_seal(data.snapshot);
+
+    data.ctx = neu_trans_data_ctx_new(2);
+
+    // every app receives a shallow copy of the same trans data
+    neu_reqresp_trans_data_t app1 = data;
+    neu_reqresp_trans_data_t app2 = data;
+
+    EXPECT_EQ(app1.snapshot, app2.snapshot);
+    neu_trans_data_free(&app1);
+    EXPECT_EQ(1.5, neu_group_snapshot_value(app2.snapshot, 0)->d64);
+    neu_trans_data_free(&app2);
+}
@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "tag_sort.h"
+
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+struct tag {
+    uint8_t  station;
+    uint8_t  area;
+    uint16_t address;
+    uint8_t  type;
+};
+
+static bool tag_sort_fn(neu_tag_sort_t *sort, void *tag, void *tag_to_be_sorted)
+{
+    struct tag *p_tag  = (struct tag *) tag;
+    struct tag *p_tag1 = (struct tag *) tag_to_be_sorted;
+
+    if (p_tag->station != p_tag1->station) {
+        return false;
+    }
+
+    if (p_tag->area != p_tag1->area) {
+        return false;
+    }
+
+    if (p_tag->address + 1 < p_tag1->address) {
+        return false;
+    }
+
+    return true;
+}
+
+// tags of 16 stations and 2 areas, batches of up to 100 contiguous addresses
+static std::vector<struct tag> bench_tags(int n_tag)
+{
+    std::vector<struct tag> tags(n_tag);
+    std::mt19937            rng(n_tag);
+
+    for (int i = 0; i < n_tag; i++) {
+        tags[i].station = i % 16;
+        tags[i].area    = (i / 16) % 2;
+        tags[i].address = (uint16_t)(i / 32);
+        tags[i].type    = 1;
+    }
+    std::shuffle(tags.begin(), tags.end(), rng);
+    return tags;
+}
+
+static bool bench_sort_fn(neu_tag_sort_t *sort, void *tag,
+                          void *tag_to_be_sorted)
+{
+    return sort->info.size < 100 && tag_sort_fn(sort, tag, tag_to_be_sorted);
+}
+
+static int bench_cmp(neu_tag_sort_elem_t *tag1, neu_tag_sort_elem_t *tag2)
+{
+    struct tag *t1 = (struct tag *) tag1->tag;
+    struct tag *t2 = (struct tag *) tag2->tag;
+
+    if (t1->station != t2->station) {
+        return t1->station < t2->station ? -1 : 1;
+    }
+    if (t1->area != t2->area) {
+        return t1->area < t2->area ? -1 : 1;
+    }
+    return (int) t1->address - (int) t2->address;
+}
+
+static int64_t now_ns()
+{
+    struct timespec ts = {};
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*
+ * The previous engine: DL_SORT over a calloc'd list and every tag offered to
+ * every batch. Not a unit test, built as tag_sort_bench and run by hand.
+ */
+static neu_tag_sort_result_t *legacy_tag_sort(UT_array *tags,
+                                              neu_tag_sort_fn  fn,
+                                              neu_tag_sort_cmp cmp)
+{
+    neu_tag_sort_result_t *result =
+        (neu_tag_sort_result_t *) calloc(1, sizeof(neu_tag_sort_result_t));
+    neu_tag_sort_elem_t *head = NULL, *elt = NULL, *tmp = NULL;
+
+    for (void **tag = (void **) utarray_front(tags); tag != NULL;
+         tag        = (void **) utarray_next(tags, tag)) {
+        elt = (neu_tag_sort_elem_t *) calloc(1, sizeof(neu_tag_sort_elem_t));
+        elt->tag = *tag;
+        DL_APPEND(head, elt);
+    }
+
+    DL_SORT(head, cmp);
+    DL_FOREACH_SAFE(head, elt, tmp)
+    {
+        void *tag    = elt->tag;
+        bool  sorted = false;
+
+        for (uint32_t i = 0; i < result->n_sort; i++) {
+            if (fn(&result->sorts[i],
+                   *(void **) utarray_back(result->sorts[i].tags), tag)) {
+                utarray_push_back(result->sorts[i].tags, &tag);
+                result->sorts[i].info.size += 1;
+                sorted = true;
+                break;
+            }
+        }
+
+        if (!sorted) {
+            result->n_sort += 1;
+            result->sorts = (neu_tag_sort_t *) realloc(
+                result->sorts, sizeof(neu_tag_sort_t) * result->n_sort);
+
+            neu_tag_sort_t *sort = &result->sorts[result->n_sort - 1];
+            memset(sort, 0, sizeof(neu_tag_sort_t));
+            utarray_new(sort->tags, &tags->icd);
+            utarray_push_back(sort->tags, &tag);
+            sort->info.size = 1;
+        }
+
+        DL_DELETE(head, elt);
+        free(elt);
+    }
+
+    return result;
+}
+
+static void bench(int n_tag, bool legacy)
+{
+    std::vector<struct tag> tags = bench_tags(n_tag);
+    UT_array *              array = NULL;
+    int64_t                 start = 0;
+
+    utarray_new(array, &ut_ptr_icd);
+    for (struct tag &tag : tags) {
+        struct tag *p = &tag;
+        utarray_push_back(array, &p);
+    }
+
+    start = now_ns();
+    neu_tag_sort_result_t *result =
+        neu_tag_sort(array, bench_sort_fn, bench_cmp);
+    int64_t  ns     = now_ns() - start;
+    uint32_t n_sort = result->n_sort;
+    int      expect = 0;
+
+    printf("%-16s %8d tags: %10.3f ms, %u batches\n", "tag sort", n_tag,
+           ns / 1e6, n_sort);
+
+    // each station and area holds a run of addresses, cut every 100 tags
+    for (int key = 0; key < 32; key++) {
+        int n = n_tag / 32 + (n_tag % 32 > key ? 1 : 0);
+        expect += (n + 99) / 100;
+    }
+    EXPECT_EQ(expect, n_sort);
+    for (uint32_t i = 1; i < result->n_sort; i++) {
+        neu_tag_sort_elem_t last  = {};
+        neu_tag_sort_elem_t first = {};
+
+        last.tag  = *(void **) utarray_back(result->sorts[i - 1].tags);
+        first.tag = *(void **) utarray_front(result->sorts[i].tags);
+        EXPECT_LE(bench_cmp(&last, &first), 0);
+    }
+    neu_tag_sort_free(result);
+
+    if (legacy) {
+        start  = now_ns();
+        result = legacy_tag_sort(array, bench_sort_fn, bench_cmp);
+        ns     = now_ns() - start;
+        printf("%-16s %8d tags: %10.3f ms, %u batches\n", "legacy tag sort",
+               n_tag, ns / 1e6, result->n_sort);
+        EXPECT_EQ(n_sort, result->n_sort);
+        neu_tag_sort_free(result);
+    }
+
+    utarray_free(array);
+}
+
+TEST(TagSortBench, tags_1k)
+{
+    bench(1000, true);
+}
+
+TEST(TagSortBench, tags_20k)
+{
+    bench(20000, true);
+}
+
+TEST(TagSortBench, tags_200k)
+{
+    bench(200000, false);
+}
+
+int main(int argc, char **argv)
+{
+    zlog_init("./config/dev.conf");
+    neuron = zlog_get_category("neuron");
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
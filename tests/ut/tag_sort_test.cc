@@ -1,6 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <random>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "tag_sort.h"
@@ -220,6 +224,113 @@ TEST(TagSortTest, SortDiff)
     free(tag4);
 }
 
+// tags of 16 stations and 2 areas in random order
+static std::vector<struct tag> shuffled_tags(int n_tag)
+{
+    std::vector<struct tag> tags(n_tag);
+    std::mt19937            rng(n_tag);
+
+    for (int i = 0; i < n_tag; i++) {
+        tags[i].station = i % 16;
+        tags[i].area    = (i / 16) % 2;
+        tags[i].address = (uint16_t)(i / 32);
+        tags[i].type    = 1;
+    }
+    std::shuffle(tags.begin(), tags.end(), rng);
+    return tags;
+}
+
+static int address_cmp(neu_tag_sort_elem_t *tag1, neu_tag_sort_elem_t *tag2)
+{
+    struct tag *t1 = (struct tag *) tag1->tag;
+    struct tag *t2 = (struct tag *) tag2->tag;
+
+    if (t1->station != t2->station) {
+        return t1->station < t2->station ? -1 : 1;
+    }
+    if (t1->area != t2->area) {
+        return t1->area < t2->area ? -1 : 1;
+    }
+    return (int) t1->address - (int) t2->address;
+}
+
+TEST(TagSortTest, SortStable)
+{
+    std::vector<struct tag> tags = shuffled_tags(1000);
+    UT_array *              array = NULL;
+
+    utarray_new(array, &ut_ptr_icd);
+    for (struct tag &tag : tags) {
+        struct tag *p = &tag;
+        utarray_push_back(array, &p);
+    }
+
+    // a batch per tag exposes the sorted order
+    neu_tag_sort_result_t *result = neu_tag_sort(
+        array, [](neu_tag_sort_t *, void *, void *) { return false; },
+        address_cmp);
+    ASSERT_EQ(1000, result->n_sort);
+
+    std::vector<struct tag> sorted = tags;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const struct tag &t1, const struct tag &t2) {
+                         neu_tag_sort_elem_t e1 = { (void *) &t1, NULL, NULL };
+                         neu_tag_sort_elem_t e2 = { (void *) &t2, NULL, NULL };
+                         return address_cmp(&e1, &e2) < 0;
+                     });
+    for (uint32_t i = 0; i < result->n_sort; i++) {
+        struct tag *t = *(struct tag **) utarray_front(result->sorts[i].tags);
+        EXPECT_EQ(sorted[i].station, t->station);
+        EXPECT_EQ(sorted[i].area, t->area);
+        EXPECT_EQ(sorted[i].address, t->address);
+    }
+
+    neu_tag_sort_free(result);
+    utarray_free(array);
+}
+
+TEST(TagSortTest, SortManyBatches)
+{
+    const int               n_tag = 70000;
+    std::vector<struct tag> tags  = shuffled_tags(n_tag);
+    UT_array *              array = NULL;
+
+    utarray_new(array, &ut_ptr_icd);
+    for (struct tag &tag : tags) {
+        struct tag *p = &tag;
+        utarray_push_back(array, &p);
+    }
+
+    // more single tag batches than 16 bits count
+    neu_tag_sort_result_t *result = neu_tag_sort(
+        array, [](neu_tag_sort_t *, void *, void *) { return false; },
+        address_cmp);
+    ASSERT_EQ((uint32_t) n_tag, result->n_sort);
+    for (uint32_t i = 1; i < result->n_sort; i++) {
+        neu_tag_sort_elem_t e1 = {
+            *(void **) utarray_front(result->sorts[i - 1].tags), NULL, NULL
+        };
+        neu_tag_sort_elem_t e2 = {
+            *(void **) utarray_front(result->sorts[i].tags), NULL, NULL
+        };
+
+        EXPECT_EQ(1U, result->sorts[i].info.size);
+        EXPECT_LE(address_cmp(&e1, &e2), 0);
+    }
+    neu_tag_sort_free(result);
+
+    // and a batch of more tags than 16 bits count
+    result = neu_tag_sort(
+        array, [](neu_tag_sort_t *, void *, void *) { return true; },
+        address_cmp);
+    ASSERT_EQ(1U, result->n_sort);
+    EXPECT_EQ((uint32_t) n_tag, result->sorts[0].info.size);
+    EXPECT_EQ((unsigned int) n_tag, utarray_len(result->sorts[0].tags));
+    neu_tag_sort_free(result);
+
+    utarray_free(array);
+}
+
 int main(int argc, char **argv)
 {
     zlog_init("./config/dev.conf");